@@ -0,0 +1,51 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Mini-framework per i benchmark (nessuna dipendenza esterna).
+// Ogni file bench_*.cpp registra le sue funzioni con TAIKUTSU_BENCH(nome);
+// bench_main.cpp le esegue tutte, oppure solo quelle passate su riga di comando.
+
+using BenchFn = void (*)();
+
+int registerBench(const char* name, BenchFn fn);
+
+#define TAIKUTSU_BENCH(name)                                                     \
+    static void bench_##name();                                                  \
+    [[maybe_unused]] static const int bench_reg_##name = registerBench(#name, &bench_##name); \
+    static void bench_##name()
+
+// valori degli argomenti "--name valore" passati a taikutsu_bench (ripetibili, in ordine)
+std::vector<std::string> benchOption(const char* name);
+
+// heap del processo (operator new globale, contato in bench_main.cpp): byte vivi e picco
+// dall'ultimo resetPeakBytes()
+size_t liveBytes();
+size_t peakBytes();
+void resetPeakBytes();
+
+// millisecondi impiegati da fn()
+template <class F>
+double timeMs(F&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// impedisce al compilatore di eliminare il calcolo di un risultato non usato
+template <class T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// riga di report allineata: "  nome ............ valore unità"
+inline void report(const std::string& label, double value, const char* unit) {
+    std::printf("  %-44s %12.2f %s\n", label.c_str(), value, unit);
+}
+
+#endif //BENCH_H
@@ -0,0 +1,58 @@
+#ifndef BENCHQUERIES_H
+#define BENCHQUERIES_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/GridMap.h"
+
+// Coppie start/goal ripetibili per i benchmark (stesso seed = stesse query). Le mappe
+// vengono da MapGenerators.h (makeRandomMap & co.), così tutti i bench usano gli stessi grid.
+
+struct Query { Cell start, goal; };
+
+// coppie di celle libere a caso (Grid: GridMap, ChunkedGridMap, ...)
+template <class Grid>
+std::vector<Query> randomQueries(const Grid& g, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    std::vector<Query> out;
+    while (static_cast<int>(out.size()) < count) {
+        const Query q{Cell{rx(rng), ry(rng)}, Cell{rx(rng), ry(rng)}};
+        if (g.isWalkable(q.start) && g.isWalkable(q.goal)) out.push_back(q);
+    }
+    return out;
+}
+
+// come randomQueries, con il goal a distanza <= maxDist (per asse) dallo start
+template <class Grid>
+std::vector<Query> nearbyQueries(const Grid& g, int count, int maxDist, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1), rd(-maxDist, maxDist);
+    std::vector<Query> out;
+    while (static_cast<int>(out.size()) < count) {
+        const Cell s{rx(rng), ry(rng)};
+        const Cell t{s.x + rd(rng), s.y + rd(rng)};
+        if (g.isWalkable(s) && g.isWalkable(t)) out.push_back({s, t});
+    }
+    return out;
+}
+
+// coppie collegate (niente NoPath) ad almeno minDistance celle (Chebyshev) l'una dall'altra
+inline std::vector<Query> connectedQueries(const GridMap& g, int count, unsigned seed, int minDistance = 0) {
+    const ConnectivityIndex cc(g);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    std::vector<Query> out;
+    while (static_cast<int>(out.size()) < count) {
+        const Query q{Cell{rx(rng), ry(rng)}, Cell{rx(rng), ry(rng)}};
+        if (std::max(std::abs(q.start.x - q.goal.x), std::abs(q.start.y - q.goal.y)) < minDistance) continue;
+        if (cc.connected(q.start, q.goal)) out.push_back(q);
+    }
+    return out;
+}
+
+#endif //BENCHQUERIES_H
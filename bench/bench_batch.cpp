@@ -0,0 +1,28 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <thread>
+#include <vector>
+
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/PathBatch.h"
+
+// query/s del batch al variare del numero di thread (stesso grid, stesso buffer dei risultati)
+TAIKUTSU_BENCH(search_batch) {
+    const GridMap g = makeRandomMap(512, 512, 0.2, 11);
+    std::vector<PathRequest> requests;
+    for (const Query& q : randomQueries(g, 2000, 13)) requests.push_back(PathRequest{q.start, q.goal});
+    std::vector<AStarResult> results(requests.size());
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf(" 512x512, 20%% obstacles, %zu queries (hardware threads: %u)\n", requests.size(), hw);
+
+    for (unsigned threads = 1; threads <= std::max(hw, 4u); threads *= 2) {
+        ThreadPool pool(threads);
+        PathBatch batch(pool);
+        batch.run(g, requests, results); // warm-up: alloca i context
+        const double ms = timeMs([&] { batch.run(g, requests, results); });
+        doNotOptimize(results.back().cost);
+        report(std::to_string(threads) + " threads queries/s", static_cast<double>(requests.size()) / (ms / 1000.0),
+               "q/s");
+    }
+}
@@ -0,0 +1,91 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <random>
+#include <string>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/BidirectionalAStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapGenerators.h"
+
+// Query lunghe (start e goal ad almeno metà lato) su mappe grandi, 8 direzioni: AStarPathfinder
+// contro BidirectionalAStar (due thread) in ms/query e nodi espansi, più query corte per il
+// costo del ripiego. Il guadagno dipende dai core liberi: con un solo core i due lati si alternano.
+// taikutsu_bench bidirectional [--side 1024]
+TAIKUTSU_BENCH(bidirectional) {
+    const std::vector<std::string> sideOpt = benchOption("side");
+    const int side = sideOpt.empty() ? 1024 : std::stoi(sideOpt.back());
+    constexpr int kQueries = 40;
+    struct Arena {
+        std::string name;
+        GridMap grid;
+    };
+    std::vector<Arena> arenas;
+    arenas.push_back({"rooms 32x32", makeRoomsMap(side, side, 32, 151)});
+    arenas.push_back({"random 30%", makeRandomMap(side, side, 0.3, 152)});
+    arenas.push_back({"maze (corridor 4)", makeMazeMap(side, side, 4, 153)});
+
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    for (const Arena& a : arenas) {
+        const std::vector<Query> queries = connectedQueries(a.grid, kQueries, 154, side / 2);
+        AStarSearchContext uni(a.grid);
+        BidirectionalSearchContext bi;
+        size_t uniExpanded = 0, biExpanded = 0, mismatches = 0;
+        for (const Query& q : queries) { // warm-up e verifica dei costi
+            const AStarResult& r = AStarPathfinder::findPath(uni, a.grid, q.start, q.goal, opts);
+            uniExpanded += r.expanded;
+            const AStarResult& b = BidirectionalAStar::findPath(bi, a.grid, q.start, q.goal, opts);
+            biExpanded += b.expanded;
+            mismatches += b.cost != r.cost;
+        }
+        const double uniMs = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(AStarPathfinder::findPath(uni, a.grid, q.start, q.goal, opts).cost);
+        });
+        const double biMs = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(BidirectionalAStar::findPath(bi, a.grid, q.start, q.goal, opts).cost);
+        });
+        const auto n = static_cast<double>(queries.size());
+        std::printf(" %s %dx%d, %d long queries\n", a.name.c_str(), side, side, kQueries);
+        report("AStarPathfinder", uniMs / n, "ms/query");
+        report("BidirectionalAStar", biMs / n, "ms/query");
+        report("  speedup", uniMs / biMs, "x");
+        report("expanded (A*)", static_cast<double>(uniExpanded) / n, "nodes/query");
+        report("expanded (both sides)", static_cast<double>(biExpanded) / n, "nodes/query");
+        report("cost mismatches vs A*", static_cast<double>(mismatches), "queries");
+    }
+
+    // query corte sulla prima arena: con la soglia di default vanno su A* normale, con soglia 0
+    // pagano comunque l'avvio del secondo lato
+    const GridMap& g = arenas.front().grid;
+    const ConnectivityIndex cc(g);
+    std::mt19937 rng(155);
+    std::uniform_int_distribution<int> r(0, side - 1), near(-40, 40);
+    std::vector<Query> shortQueries;
+    while (shortQueries.size() < 300) {
+        const Cell s{r(rng), r(rng)};
+        const Cell t{std::clamp(s.x + near(rng), 0, side - 1), std::clamp(s.y + near(rng), 0, side - 1)};
+        if (cc.connected(s, t)) shortQueries.push_back(Query{s, t});
+    }
+    BidirectionalSearchContext fallback, always(0);
+    AStarSearchContext uni(g);
+    for (const Query& q : shortQueries) { // warm-up
+        BidirectionalAStar::findPath(fallback, g, q.start, q.goal, opts);
+        BidirectionalAStar::findPath(always, g, q.start, q.goal, opts);
+    }
+    const double uniMs = timeMs([&] {
+        for (const Query& q : shortQueries) doNotOptimize(AStarPathfinder::findPath(uni, g, q.start, q.goal, opts).cost);
+    });
+    const double fallbackMs = timeMs([&] {
+        for (const Query& q : shortQueries) doNotOptimize(BidirectionalAStar::findPath(fallback, g, q.start, q.goal, opts).cost);
+    });
+    const double alwaysMs = timeMs([&] {
+        for (const Query& q : shortQueries) doNotOptimize(BidirectionalAStar::findPath(always, g, q.start, q.goal, opts).cost);
+    });
+    const auto n = static_cast<double>(shortQueries.size());
+    std::printf(" short queries (<= 40 cells apart) on %s, %zu queries\n", arenas.front().name.c_str(), shortQueries.size());
+    report("AStarPathfinder", 1000.0 * uniMs / n, "us/query");
+    report("BidirectionalAStar (default threshold)", 1000.0 * fallbackMs / n, "us/query");
+    report("BidirectionalAStar (always two sides)", 1000.0 * alwaysMs / n, "us/query");
+}
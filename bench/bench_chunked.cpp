@@ -0,0 +1,89 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ChunkedAStar.h"
+#include "taikutsu/core/ChunkedGridMap.h"
+
+namespace {
+    // mondo aperto: gruppi sparsi di ostacoli (un blocco pieno e qualche roccia) su fondo libero
+    template <class Grid>
+    void scatter(Grid& g, int clusters, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1), rs(4, 80);
+        for (int i = 0; i < clusters; ++i) {
+            const Cell c{rx(rng), ry(rng)};
+            g.fillRect(c, rs(rng), rs(rng), true);
+            for (int k = 0; k < 40; ++k) g.setBlocked(Cell{c.x + rs(rng) - 40, c.y + rs(rng) - 40}, true);
+        }
+    }
+
+    SearchOptions octileOptions() {
+        SearchOptions opts;
+        opts.connectivity = Connectivity::Eight;
+        return opts;
+    }
+
+    double mib(size_t bytes) { return static_cast<double>(bytes) / (1 << 20); }
+}
+
+// Stesso mondo aperto come GridMap e come ChunkedGridMap: memoria del grid e del contesto
+// di ricerca, tempo per query (8 direzioni). Poi un mondo che GridMap non può rappresentare.
+TAIKUTSU_BENCH(chunked_grid) {
+    constexpr int kSide = 4096;
+    const SearchOptions opts = octileOptions();
+    {
+        size_t base = liveBytes();
+        GridMap flat(kSide, kSide);
+        scatter(flat, 400, 71);
+        const size_t flatBytes = liveBytes() - base;
+        base = liveBytes();
+        const ChunkedGridMap chunked(flat);
+        const size_t chunkedBytes = liveBytes() - base;
+        const std::vector<Query> queries = nearbyQueries(flat, 200, 600, 61);
+        std::printf(" %dx%d open world, 400 obstacle clusters, %zu of %d tiles mixed, %zu queries\n", kSide, kSide,
+                    chunked.mixedTileCount(), chunked.tilesX() * chunked.tilesY(), queries.size());
+
+        AStarSearchContext actx(flat);
+        ChunkedSearchContext cctx;
+        for (const Query& q : queries) { // warm-up (anche le pagine dei nodi di actx)
+            AStarPathfinder::findPath(actx, flat, q.start, q.goal, opts);
+            ChunkedAStar::findPath(cctx, chunked, q.start, q.goal, opts);
+        }
+        size_t expanded = 0;
+        const double flatMs = timeMs([&] {
+            for (const Query& q : queries) expanded += AStarPathfinder::findPath(actx, flat, q.start, q.goal, opts).expanded;
+        });
+        const double chunkedMs = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(ChunkedAStar::findPath(cctx, chunked, q.start, q.goal, opts).cost);
+        });
+        const auto n = static_cast<double>(queries.size());
+        report("GridMap bits", mib(flatBytes), "MiB");
+        report("ChunkedGridMap directory + tiles", mib(chunkedBytes), "MiB");
+        report("AStarSearchContext", mib(actx.memoryBytes()), "MiB");
+        report("ChunkedSearchContext", mib(cctx.memoryBytes()), "MiB");
+        report("expanded/query", static_cast<double>(expanded) / n, "nodes");
+        report("AStarPathfinder", flatMs / n, "ms/query");
+        report("ChunkedAStar", chunkedMs / n, "ms/query");
+    }
+    {
+        constexpr int kHuge = 1 << 18; // 2^36 celle
+        const size_t base = liveBytes();
+        ChunkedGridMap world(kHuge, kHuge);
+        const double buildMs = timeMs([&] { scatter(world, 20000, 72); });
+        const size_t bytes = liveBytes() - base;
+        const std::vector<Query> queries = nearbyQueries(world, 100, 600, 61);
+        std::printf(" %dx%d world (GridMap::fits = %d), 20000 clusters, %zu tiles mixed\n", kHuge, kHuge,
+                    GridMap::fits(kHuge, kHuge), world.mixedTileCount());
+        ChunkedSearchContext ctx;
+        const double ms = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(ChunkedAStar::findPath(ctx, world, q.start, q.goal, opts).cost);
+        });
+        report("build", buildMs, "ms");
+        report("ChunkedGridMap directory + tiles", mib(bytes), "MiB");
+        report("  bitset of the same area would be", mib(static_cast<size_t>(kHuge) * kHuge / 8), "MiB");
+        report("ChunkedAStar", ms / static_cast<double>(queries.size()), "ms/query");
+    }
+}
@@ -0,0 +1,50 @@
+#include "Bench.h"
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapGenerators.h"
+
+// costruzione, aggiornamenti incrementali e query irraggiungibili con/senza indice
+TAIKUTSU_BENCH(connectivity) {
+    GridMap g = makeRandomMap(2048, 2048, 0.3, 31);
+    // muro che divide la mappa: metà delle query sono irraggiungibili
+    g.fillRect(Cell{1024, 0}, 1, 2048, true);
+
+    std::optional<ConnectivityIndex> index;
+    report("build 2048x2048", timeMs([&] { index.emplace(g); }), "ms");
+    report("components", static_cast<double>(index->componentCount()), "ids");
+
+    std::mt19937 rng(37);
+    std::uniform_int_distribution<int> r(0, 2047);
+    const int edits = 20000;
+    const double editMs = timeMs([&] {
+        for (int i = 0; i < edits; ++i) {
+            const Cell c{r(rng), r(rng)};
+            if (c.x == 1024) continue;
+            g.toggleBlocked(c);
+            index->notifyChanged(c);
+        }
+    });
+    report("notifyChanged (random toggles)", editMs * 1000.0 / edits, "us");
+
+    // start a sinistra, goal a destra del muro, nella componente grande
+    std::vector<std::pair<Cell, Cell>> queries;
+    while (queries.size() < 5) {
+        const Cell s{r(rng) % 1000, r(rng)}, t{1030 + r(rng) % 1000, r(rng)};
+        if (g.isWalkable(s) && g.isWalkable(t)) queries.emplace_back(s, t);
+    }
+    AStarSearchContext ctx;
+    SearchOptions withIndex;
+    withIndex.components = &*index;
+    const double plainMs = timeMs([&] {
+        for (const auto& [s, t] : queries) doNotOptimize(AStarPathfinder::findPath(ctx, g, s, t).success);
+    });
+    const double indexMs = timeMs([&] {
+        for (const auto& [s, t] : queries) doNotOptimize(AStarPathfinder::findPath(ctx, g, s, t, withIndex).success);
+    });
+    report("unreachable query, A*", plainMs / static_cast<double>(queries.size()), "ms");
+    report("unreachable query, A* + index", indexMs / static_cast<double>(queries.size()), "ms");
+}
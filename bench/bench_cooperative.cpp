@@ -0,0 +1,120 @@
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/CooperativePlanner.h"
+#include "taikutsu/core/FlatHashMap.h"
+#include "taikutsu/core/MapGenerators.h"
+
+namespace {
+    // start e goal distinti, nella stessa componente
+    void makeAgents(const GridMap& g, int count, unsigned seed, std::vector<Cell>& starts, std::vector<Cell>& goals) {
+        const ConnectivityIndex cc(g);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+        FlatHashMap64 usedStart, usedGoal;
+        starts.clear();
+        goals.clear();
+        while (static_cast<int>(starts.size()) < count) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            if (!g.isWalkable(s) || !cc.connected(s, t)) continue;
+            if (usedStart.find(static_cast<std::uint32_t>(g.index(s))) || usedGoal.find(static_cast<std::uint32_t>(g.index(t)))) continue;
+            usedStart.insert(static_cast<std::uint32_t>(g.index(s)), 0);
+            usedGoal.insert(static_cast<std::uint32_t>(g.index(t)), 0);
+            starts.push_back(s);
+            goals.push_back(t);
+        }
+    }
+}
+
+// Molti agenti sulla stessa mappa per kTicks tick: percorsi indipendenti (un A* per agente,
+// seguiti alla cieca) contro CooperativePlanner (window 16). Il primo plan() pianifica tutti
+// (partenza a freddo: anche le ricerche all'indietro delle distanze vere), poi tick a regime
+// senza budget (con e senza holdPlanEnd) e con un budget per tick. Agenti pianificati al
+// secondo, conflitti (vertice + scambio) e agenti arrivati.
+// taikutsu_bench cooperative [--side 128]
+TAIKUTSU_BENCH(cooperative) {
+    const std::vector<std::string> sideOpt = benchOption("side");
+    const int side = sideOpt.empty() ? 128 : std::stoi(sideOpt.back());
+    constexpr int kTicks = 192;
+    constexpr auto kBudget = std::chrono::microseconds(2000);
+    const GridMap g = makeRoomsMap(side, side, 16, 171, 1.0);
+
+    for (const int agents : {250, 1000, 2000}) {
+        std::vector<Cell> starts, goals;
+        makeAgents(g, agents, 172, starts, goals);
+        std::printf(" rooms 16x16 %dx%d, %d agents, %d ticks\n", side, side, agents, kTicks);
+
+        // indipendenti
+        std::vector<std::vector<Cell>> paths(starts.size());
+        AStarSearchContext ctx(g);
+        const double astarMs = timeMs([&] {
+            for (size_t i = 0; i < starts.size(); ++i) paths[i] = AStarPathfinder::findPath(ctx, g, starts[i], goals[i]).path;
+        });
+        size_t independentConflicts = 0, independentArrived = 0;
+        std::vector<Cell> from(starts.size()), to(starts.size());
+        for (int t = 0; t < kTicks; ++t) {
+            for (size_t i = 0; i < paths.size(); ++i) {
+                from[i] = paths[i][std::min(static_cast<size_t>(t), paths[i].size() - 1)];
+                to[i] = paths[i][std::min(static_cast<size_t>(t) + 1, paths[i].size() - 1)];
+            }
+            independentConflicts += countConflicts(g, from, to);
+        }
+        for (const std::vector<Cell>& p : paths) independentArrived += p.size() <= kTicks + 1;
+        report("independent A*", 1000.0 * static_cast<double>(agents) / astarMs, "agents/s");
+        report("  conflicts", static_cast<double>(independentConflicts), "");
+        report("  arrived (ignoring collisions)", static_cast<double>(independentArrived), "agents");
+
+        struct Mode {
+            const char* name;
+            bool budgeted, hold;
+        };
+        for (const Mode mode : {Mode{"WHCA* steady state (no budget)", false, true},
+                                Mode{"WHCA* steady state (no budget, holdPlanEnd off)", false, false},
+                                Mode{"WHCA* steady state (2 ms budget per tick)", true, true}}) {
+            const bool budgeted = mode.budgeted;
+            CooperativeOptions opts;
+            opts.holdPlanEnd = mode.hold;
+            CooperativePlanner planner(g, opts);
+            for (size_t i = 0; i < starts.size(); ++i) planner.addAgent(starts[i], goals[i]);
+            CooperativeTickStats cold;
+            const double coldMs = timeMs([&] { cold = planner.plan(); });
+            size_t planned = 0, conflicts = planner.advance(), failed = cold.failed, deferred = 0, expanded = 0;
+            double planMs = 0, worstTickMs = 0;
+            for (int t = 1; t < kTicks; ++t) {
+                CooperativeTickStats s;
+                const double ms = timeMs([&] { s = budgeted ? planner.plan(kBudget) : planner.plan(); });
+                planMs += ms;
+                worstTickMs = std::max(worstTickMs, ms);
+                planned += s.planned;
+                failed += s.failed;
+                deferred += s.deferred;
+                expanded += s.expanded;
+                conflicts += planner.advance();
+            }
+            int arrived = 0;
+            for (int i = 0; i < agents; ++i) arrived += planner.atGoal(i);
+            if (!budgeted && mode.hold) {
+                report("WHCA* cold start (all agents)", 1000.0 * static_cast<double>(cold.planned) / coldMs, "agents/s");
+                report("  first plan()", coldMs, "ms");
+                report("  true-distance nodes per agent",
+                       static_cast<double>(cold.heuristicExpanded) / static_cast<double>(cold.planned), "nodes");
+            }
+            const auto steady = static_cast<double>(kTicks - 1);
+            report(mode.name, 1000.0 * static_cast<double>(planned) / planMs, "agents/s");
+            report("  plan time per tick (mean)", planMs / steady, "ms");
+            report("  plan time per tick (worst)", worstTickMs, "ms");
+            report("  replans per tick (mean)", static_cast<double>(planned) / steady, "agents");
+            report("  space-time nodes per plan", static_cast<double>(expanded) / static_cast<double>(planned), "nodes");
+            if (budgeted) report("  deferred per tick (mean)", static_cast<double>(deferred) / steady, "agents");
+            report("  failed plans (waiting)", static_cast<double>(failed), "");
+            report("  conflicts", static_cast<double>(conflicts), "");
+            report("  arrived", static_cast<double>(arrived), "agents");
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "Bench.h"
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/FlowField.h"
+#include "taikutsu/core/MapGenerators.h"
+
+// un flow field verso il punto di raccolta contro un A* per agente
+TAIKUTSU_BENCH(flowfield) {
+    GridMap g = makeRandomMap(1024, 1024, 0.2, 41);
+    const Cell rally{512, 512};
+    g.setBlocked(rally, false);
+    const Cell goals[] = {rally};
+
+    std::mt19937 rng(43);
+    std::uniform_int_distribution<int> r(0, 1023);
+    std::vector<Cell> agents;
+    while (agents.size() < 500) {
+        const Cell c{r(rng), r(rng)};
+        if (g.isWalkable(c)) agents.push_back(c);
+    }
+    std::printf(" 1024x1024, 20%% obstacles, %zu agents -> 1 goal\n", agents.size());
+
+    FlowField field;
+    SearchOptions eight;
+    eight.connectivity = Connectivity::Eight;
+    report("build 4-dir unit (wavefront)", timeMs([&] { field.build(g, goals); }), "ms");
+    report("build 8-dir (Dial)", timeMs([&] { field.build(g, goals, eight); }), "ms");
+
+    field.build(g, goals);
+    size_t steps = 0;
+    const double walkMs = timeMs([&] {
+        for (Cell c : agents) {
+            while (field.direction(c) != FlowField::kNoDir) {
+                c = field.next(c);
+                ++steps;
+            }
+        }
+    });
+    report("all agents walk to goal (lookups)", walkMs, "ms");
+    report("lookups", static_cast<double>(steps), "steps");
+
+    AStarSearchContext ctx;
+    const double astarMs = timeMs([&] {
+        for (const Cell& c : agents) doNotOptimize(AStarPathfinder::findPath(ctx, g, c, rally).cost);
+    });
+    report("A* per agent (total)", astarMs, "ms");
+
+    GridMap weighted = g;
+    for (int i = 0; i < 100000; ++i) weighted.setCost(Cell{r(rng), r(rng)}, static_cast<std::uint8_t>(1 + r(rng) % 8));
+    report("build 4-dir weighted (Dial)", timeMs([&] { field.build(weighted, goals); }), "ms");
+}
@@ -0,0 +1,99 @@
+#include "Bench.h"
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/GridMap.h"
+
+namespace {
+    // copia del GridMap originale (std::vector<bool> + neighbors4 che alloca),
+    // tenuta qui solo come riferimento "before" per il confronto
+    class LegacyGrid {
+    public:
+        LegacyGrid(int w, int h) : w_(w), h_(h), blocked_(static_cast<size_t>(w) * static_cast<size_t>(h), false) {}
+
+        bool inBounds(Cell c) const { return c.x >= 0 && c.x < w_ && c.y >= 0 && c.y < h_; }
+        bool isBlocked(Cell c) const { return !inBounds(c) || blocked_[static_cast<size_t>(c.y * w_ + c.x)]; }
+        bool isWalkable(Cell c) const { return inBounds(c) && !isBlocked(c); }
+        void setBlocked(Cell c, bool b) { blocked_[static_cast<size_t>(c.y * w_ + c.x)] = b; }
+
+        std::vector<Cell> neighbors4(Cell c) const {
+            std::vector<Cell> out;
+            out.reserve(4);
+            const Cell cand[4] = {{c.x + 1, c.y}, {c.x - 1, c.y}, {c.x, c.y + 1}, {c.x, c.y - 1}};
+            for (Cell n : cand) if (isWalkable(n)) out.push_back(n);
+            return out;
+        }
+
+    private:
+        int w_, h_;
+        std::vector<bool> blocked_;
+    };
+
+    constexpr int kSide = 2048;
+    constexpr double kDensity = 0.2;
+}
+
+// throughput dell'espansione dei vicini (il loop interno di A*), before/after
+TAIKUTSU_BENCH(grid_expansion) {
+    LegacyGrid legacy(kSide, kSide);
+    GridMap grid(kSide, kSide);
+    std::mt19937 rng(1);
+    std::bernoulli_distribution blocked(kDensity);
+    for (int y = 0; y < kSide; ++y) {
+        for (int x = 0; x < kSide; ++x) {
+            const bool b = blocked(rng);
+            legacy.setBlocked(Cell{x, y}, b);
+            grid.setBlocked(Cell{x, y}, b);
+        }
+    }
+
+    const double cells = static_cast<double>(kSide) * kSide;
+    std::int64_t sumLegacy = 0;
+    std::int64_t sumMask = 0;
+
+    const double msLegacy = timeMs([&] {
+        for (int y = 0; y < kSide; ++y)
+            for (int x = 0; x < kSide; ++x)
+                for (Cell n : legacy.neighbors4(Cell{x, y})) sumLegacy += n.x + n.y;
+    });
+
+    const double msMask = timeMs([&] {
+        for (int y = 0; y < kSide; ++y) {
+            for (int x = 0; x < kSide; ++x) {
+                for (unsigned m = grid.neighborMask(Cell{x, y}); m != 0; m &= m - 1) {
+                    const int d = std::countr_zero(m);
+                    sumMask += (x + kDirDx[d]) + (y + kDirDy[d]);
+                }
+            }
+        }
+    });
+    doNotOptimize(sumLegacy);
+    doNotOptimize(sumMask);
+
+    report("legacy neighbors4 (vector<bool> + alloc)", cells / msLegacy / 1000.0, "Mexp/s");
+    report("bitset neighborMask", cells / msMask / 1000.0, "Mexp/s");
+    report("speedup", msLegacy / msMask, "x");
+    if (sumLegacy != sumMask) std::printf("  !! checksum mismatch\n");
+}
+
+// operazioni bulk: fillRect word-at-a-time contro setBlocked cella per cella
+TAIKUTSU_BENCH(grid_bulk) {
+    GridMap grid(kSide, kSide);
+    constexpr int kReps = 20;
+
+    const double msPerCell = timeMs([&] {
+        for (int r = 0; r < kReps; ++r)
+            for (int y = 0; y < kSide; ++y)
+                for (int x = 0; x < kSide; ++x) grid.setBlocked(Cell{x, y}, (r & 1) == 0);
+    });
+    const double msFill = timeMs([&] {
+        for (int r = 0; r < kReps; ++r) grid.fillRect(Cell{0, 0}, kSide, kSide, (r & 1) == 0);
+    });
+    doNotOptimize(grid.words()[1]);
+
+    report("setBlocked per cell (2048x2048)", msPerCell / kReps, "ms");
+    report("fillRect (2048x2048)", msFill / kReps, "ms");
+}
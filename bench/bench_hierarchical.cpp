@@ -0,0 +1,68 @@
+#include "Bench.h"
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/Hierarchical.h"
+
+namespace {
+    // stanze 64x64 con porte: molte query lunghe passano per corridoi stretti
+    GridMap roomsGrid(int side, unsigned seed) {
+        GridMap g(side, side);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> door(4, 59);
+        for (int y = 0; y < side; y += 64) g.fillRect(Cell{0, y}, side, 1, true);
+        for (int x = 0; x < side; x += 64) g.fillRect(Cell{x, 0}, 1, side, true);
+        for (int y = 0; y < side; y += 64) {
+            for (int x = 0; x < side; x += 64) {
+                if (y > 0) g.fillRect(Cell{x + door(rng), y}, 3, 1, false);
+                if (x > 0) g.fillRect(Cell{x, y + door(rng)}, 1, 3, false);
+            }
+        }
+        return g;
+    }
+}
+
+// HPA* su 4096x4096: costruzione, query lunghe contro A*, costo di una modifica (pennello dell'app)
+TAIKUTSU_BENCH(search_hierarchical) {
+    GridMap g = roomsGrid(4096, 3);
+    std::printf(" 4096x4096 rooms, cluster 32\n");
+
+    std::optional<HierarchicalPathfinder> hpa;
+    const double buildMs = timeMs([&] { hpa.emplace(g, 32); });
+    report("build", buildMs, "ms");
+    report("abstract nodes", static_cast<double>(hpa->nodeCount()), "nodes");
+
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> r(1, 4094);
+    std::vector<std::pair<Cell, Cell>> queries;
+    while (queries.size() < 10) {
+        const Cell s{r(rng), r(rng)}, t{r(rng), r(rng)};
+        if (g.isWalkable(s) && g.isWalkable(t)) queries.emplace_back(s, t);
+    }
+
+    long long hpaCost = 0, astarCost = 0;
+    const double hpaMs = timeMs([&] {
+        for (const auto& [s, t] : queries) hpaCost += hpa->findPath(s, t).cost;
+    });
+    AStarSearchContext ctx;
+    const double astarMs = timeMs([&] {
+        for (const auto& [s, t] : queries) astarCost += AStarPathfinder::findPath(ctx, g, s, t).cost;
+    });
+    report("HPA* ms/query", hpaMs / static_cast<double>(queries.size()), "ms");
+    report("A* ms/query", astarMs / static_cast<double>(queries.size()), "ms");
+    report("HPA* cost / A* cost", static_cast<double>(hpaCost) / static_cast<double>(astarCost), "x");
+
+    // un tratto di pennello (come nell'app): 20 celle, poi la query successiva
+    const double paintMs = timeMs([&] {
+        for (int i = 0; i < 20; ++i) {
+            const Cell c{1000 + i, 1000};
+            g.toggleBlocked(c);
+            hpa->notifyChanged(c);
+        }
+        hpa->update();
+    });
+    report("paint 20 cells + update", paintMs, "ms");
+    report("clusters rebuilt", static_cast<double>(hpa->lastRebuiltClusters()), "clusters");
+}
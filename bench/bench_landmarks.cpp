@@ -0,0 +1,76 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <string>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/Landmarks.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/ThreadPool.h"
+
+namespace {
+    struct Run {
+        double ms;
+        double expanded;
+    };
+
+    Run run(const GridMap& g, const std::vector<Query>& queries, const SearchOptions& opts) {
+        AStarSearchContext ctx(g);
+        size_t expanded = 0;
+        AStarPathfinder::findPath(ctx, g, queries[0].start, queries[0].goal, opts); // warm-up
+        const double ms = timeMs([&] {
+            for (const Query& q : queries) expanded += AStarPathfinder::findPath(ctx, g, q.start, q.goal, opts).expanded;
+        });
+        const auto n = static_cast<double>(queries.size());
+        return {ms / n, static_cast<double>(expanded) / n};
+    }
+}
+
+// ALT contro Octile (8 direzioni, senza corner-cutting) sulle famiglie dove l'euristica
+// geometrica è peggiore: espansioni e tempo per query, costo della preparazione (sequenziale
+// e con un ThreadPool) e memoria delle tabelle.
+TAIKUTSU_BENCH(landmarks) {
+    constexpr int kSide = 512;
+    constexpr int kQueries = 200;
+    struct Family {
+        std::string name;
+        GridMap grid;
+    };
+    std::vector<Family> families;
+    families.push_back({"maze (corridor 4)", makeMazeMap(kSide, kSide, 4, 82)});
+    families.push_back({"maze (corridor 1)", makeMazeMap(kSide, kSide, 1, 83)});
+    families.push_back({"rooms 32x32", makeRoomsMap(kSide, kSide, 32, 84)});
+    families.push_back({"random 30%", makeRandomMap(kSide, kSide, 0.3, 85)});
+
+    ThreadPool pool;
+    SearchOptions octile;
+    octile.connectivity = Connectivity::Eight;
+    for (const Family& f : families) {
+        // query tra celle collegate (niente NoPath: misuriamo la qualità della stima)
+        const std::vector<Query> queries = connectedQueries(f.grid, kQueries, 81);
+        std::printf(" %s %dx%d, %d queries\n", f.name.c_str(), kSide, kSide, kQueries);
+        const Run base = run(f.grid, queries, octile);
+        report("Octile", base.ms, "ms/query");
+        report("  expanded", base.expanded, "nodes/query");
+        for (const int k : {4, 8, 16}) {
+            LandmarkOptions lo;
+            lo.count = k;
+            LandmarkTable table;
+            const double seqMs = timeMs([&] { table.build(f.grid, lo); });
+            lo.pool = &pool;
+            const double parMs = timeMs([&] { table.build(f.grid, lo); });
+
+            SearchOptions alt = octile;
+            alt.landmarks = &table;
+            const Run r = run(f.grid, queries, alt);
+            const std::string label = "ALT K=" + std::to_string(k);
+            report(label, r.ms, "ms/query");
+            report("  expanded", r.expanded, "nodes/query");
+            report("  expansion reduction", 100.0 * (1.0 - r.expanded / base.expanded), "%");
+            report("  build (1 thread)", seqMs, "ms");
+            report("  build (" + std::to_string(pool.size()) + " threads)", parMs, "ms");
+            report(std::string("  tables (") + (table.wide() ? "uint32" : "uint16") + ")",
+                   static_cast<double>(table.memoryBytes()) / (1 << 20), "MiB");
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include "Bench.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct Entry {
+        const char* name;
+        BenchFn fn;
+    };
+
+    // registro statico (function-local per evitare problemi di ordine di inizializzazione)
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> r;
+        return r;
+    }
+
+    std::vector<std::pair<std::string, std::string>>& options() {
+        static std::vector<std::pair<std::string, std::string>> o;
+        return o;
+    }
+
+    // ---- conteggio dell'heap: ogni blocco porta la sua dimensione in un header ----
+    constexpr size_t kHeader = alignof(std::max_align_t);
+    std::atomic<size_t> gLive{0};
+    std::atomic<size_t> gPeak{0};
+
+    void* countedAlloc(size_t n) {
+        void* p = std::malloc(n + kHeader);
+        if (p == nullptr) throw std::bad_alloc();
+        *static_cast<size_t*>(p) = n;
+        const size_t live = gLive.fetch_add(n, std::memory_order_relaxed) + n;
+        size_t peak = gPeak.load(std::memory_order_relaxed);
+        while (peak < live && !gPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        return static_cast<char*>(p) + kHeader;
+    }
+
+    void countedFree(void* q) noexcept {
+        if (q == nullptr) return;
+        void* p = static_cast<char*>(q) - kHeader;
+        gLive.fetch_sub(*static_cast<size_t*>(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void* operator new(size_t n) { return countedAlloc(n); }
+void* operator new[](size_t n) { return countedAlloc(n); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+size_t liveBytes() { return gLive.load(std::memory_order_relaxed); }
+size_t peakBytes() { return gPeak.load(std::memory_order_relaxed); }
+void resetPeakBytes() { gPeak.store(gLive.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+int registerBench(const char* name, BenchFn fn) {
+    registry().push_back({name, fn});
+    return static_cast<int>(registry().size());
+}
+
+std::vector<std::string> benchOption(const char* name) {
+    std::vector<std::string> values;
+    for (const auto& [key, value] : options())
+        if (key == name) values.push_back(value);
+    return values;
+}
+
+// uso: taikutsu_bench [nome...] [--opzione valore...]   (senza nomi esegue tutto)
+int main(int argc, char** argv) {
+    std::vector<const char*> names;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) == 0 && i + 1 < argc) {
+            options().emplace_back(argv[i] + 2, argv[i + 1]);
+            ++i;
+        } else {
+            names.push_back(argv[i]);
+        }
+    }
+
+    for (const Entry& e : registry()) {
+        bool selected = names.empty();
+        for (const char* n : names) selected |= std::strcmp(n, e.name) == 0;
+        if (!selected) continue;
+
+        std::printf("[%s]\n", e.name);
+        e.fn();
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "Bench.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapFile.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/MovingAI.h"
+
+// Avvio a freddo di una mappa grande: dal testo MovingAI, dal .tkmap copiato in un GridMap,
+// dal .tkmap mappato (GridMapView), più la prima query. Le componenti: flood vs copia dal file.
+// taikutsu_bench map_startup [--side 4096]
+TAIKUTSU_BENCH(map_startup) {
+    const std::vector<std::string> sideOpt = benchOption("side");
+    const int side = sideOpt.empty() ? 4096 : std::stoi(sideOpt.back());
+    const GridMap g = makeRandomMap(side, side, 0.2, 51);
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string text = (dir / "taikutsu_bench.map").string();
+    const std::string bin = (dir / "taikutsu_bench.tkmap").string();
+    {
+        std::ofstream out(text);
+        saveMovingAIMap(out, g);
+    }
+    if (!saveMapFile(bin, g, MapFileOptions{true, true})) {
+        std::printf(" cannot write %s\n", bin.c_str());
+        return;
+    }
+    std::printf(" %dx%d, 20%% obstacles; .map %.1f MiB, .tkmap %.1f MiB (with components)\n", side, side,
+                static_cast<double>(std::filesystem::file_size(text)) / (1 << 20),
+                static_cast<double>(std::filesystem::file_size(bin)) / (1 << 20));
+
+    // prima query: attraversa la mappa (la vista tocca le pagine solo adesso)
+    const Cell s{0, 0}, t{side - 1, side - 1};
+    auto firstQuery = [&](const GridMap& grid) {
+        return timeMs([&] { doNotOptimize(AStarPathfinder::findPath(grid, s, t).cost); });
+    };
+
+    std::optional<GridMap> parsed;
+    const double parseMs = timeMs([&] { parsed = loadMovingAIMap(text); });
+    const double parseQuery = firstQuery(*parsed);
+    std::optional<GridMap> copied;
+    const double copyMs = timeMs([&] { copied = loadMapFile(bin); });
+    const double copyQuery = firstQuery(*copied);
+    std::unique_ptr<GridMapView> view;
+    const double openMs = timeMs([&] { view = GridMapView::open(bin); });
+    const double viewQuery = firstQuery(*view);
+
+    report("MovingAI text parse", parseMs, "ms");
+    report("  + first query", parseQuery, "ms");
+    report(".tkmap load (copy)", copyMs, "ms");
+    report("  + first query", copyQuery, "ms");
+    report(".tkmap GridMapView::open", openMs, "ms");
+    report("  + first query", viewQuery, "ms");
+
+    std::optional<ConnectivityIndex> cc;
+    report("ConnectivityIndex build", timeMs([&] { cc.emplace(*parsed); }), "ms");
+    report("ConnectivityIndex from file", timeMs([&] { cc = view->components(); }), "ms");
+
+    std::filesystem::remove(text);
+    std::filesystem::remove(bin);
+}
@@ -0,0 +1,58 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/MapGenerators.h"
+
+namespace {
+    // conta inserimenti e stale pop (non registra il closed set)
+    struct CountingRecorder : NoRecorder {
+        size_t expanded = 0;
+        size_t pushes = 0;
+        size_t stalePops = 0;
+        void onExpand(AStarResult&, Cell, int) { ++expanded; }
+        void onPush() { ++pushes; }
+        void onStalePop() { ++stalePops; }
+    };
+
+    template <class TieBreak, template <class> class Open>
+    void run(const char* label, const GridMap& grid, const std::vector<Query>& queries) {
+        using Finder = BasicAStar<Neighbors4, ManhattanHeuristic, TerrainCost, TieBreak, CountingRecorder, Open>;
+        AStarSearchContext ctx(grid);
+        CountingRecorder rec;
+        const double ms = timeMs([&] {
+            for (const Query& q : queries) Finder::findPath(ctx, grid, q.start, q.goal, rec);
+        });
+        const double nq = static_cast<double>(queries.size());
+        std::printf("  %-28s %8.2f ms/q  %9.0f exp/q  %9.0f push/q  %9.0f stale/q\n", label, ms / nq,
+                    static_cast<double>(rec.expanded) / nq, static_cast<double>(rec.pushes) / nq,
+                    static_cast<double>(rec.stalePops) / nq);
+    }
+
+    void runAll(const GridMap& grid, const std::vector<Query>& queries) {
+        run<TieBreakByF, BinaryHeapOpen>("binary heap, f", grid, queries);
+        run<TieBreakLargerG, BinaryHeapOpen>("binary heap, f + larger g", grid, queries);
+        run<TieBreakLargerG, IndexedHeapOpen>("4-ary indexed, f + larger g", grid, queries);
+        run<TieBreakLargerG, RadixOpen>("radix queue", grid, queries);
+    }
+}
+
+// open list a confronto: terreno aperto, ostacoli sparsi, terreno pesato (tanti decrease-key)
+TAIKUTSU_BENCH(search_openlist) {
+    GridMap open = makeRandomMap(1024, 1024, 0.0, 1);
+    std::printf(" open 1024x1024\n");
+    runAll(open, randomQueries(open, 30, 9));
+
+    GridMap cluttered = makeRandomMap(1024, 1024, 0.3, 2);
+    std::printf(" 30%% obstacles 1024x1024\n");
+    runAll(cluttered, randomQueries(cluttered, 30, 9));
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> cost(1, 8);
+    for (int y = 0; y < cluttered.height(); ++y)
+        for (int x = 0; x < cluttered.width(); ++x) cluttered.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+    std::printf(" 30%% obstacles + terrain 1..8\n");
+    runAll(cluttered, randomQueries(cluttered, 30, 9));
+}
@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/PathCache.h"
+
+namespace {
+    struct Query {
+        Cell start, goal;
+        Cell edit{-1, -1}; // cella da invertire prima della query (-1: nessuna modifica)
+    };
+
+    // log di query "da gioco": poche rotte frequenti (distribuzione tipo Zipf) e ogni tanto
+    // una modifica al grid, come un edificio costruito o abbattuto
+    std::vector<Query> makeLog(const GridMap& g, int routes, int queries, double editRate, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+        std::vector<std::pair<Cell, Cell>> pairs;
+        while (static_cast<int>(pairs.size()) < routes) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            if (g.isWalkable(s) && g.isWalkable(t)) pairs.emplace_back(s, t);
+        }
+        std::vector<double> weights;
+        for (int i = 1; i <= routes; ++i) weights.push_back(1.0 / i);
+        std::discrete_distribution<int> pick(weights.begin(), weights.end());
+        std::bernoulli_distribution edit(editRate);
+
+        std::vector<Query> log;
+        for (int i = 0; i < queries; ++i) {
+            const auto& p = pairs[static_cast<size_t>(pick(rng))];
+            Query q{p.first, p.second};
+            if (edit(rng)) q.edit = Cell{rx(rng), ry(rng)};
+            log.push_back(q);
+        }
+        return log;
+    }
+}
+
+// Log di query rigiocato con e senza PathCache davanti ad A*, a vari tassi di modifica.
+// "hit latency" = tempo medio di una query servita dalla cache (validazione + decodifica).
+TAIKUTSU_BENCH(search_pathcache) {
+    constexpr int kSide = 512;
+    constexpr int kRoutes = 150;
+    constexpr int kQueries = 1500;
+    const GridMap base = makeRandomMap(kSide, kSide, 0.2, 21);
+    std::printf(" %dx%d, 20%% obstacles, %d queries over %d routes (Zipf), cache 256 paths\n", kSide, kSide,
+                kQueries, kRoutes);
+
+    for (const double editRate : {0.0, 0.01, 0.1}) {
+        const std::vector<Query> log = makeLog(base, kRoutes, kQueries, editRate, 22);
+        const std::string label = "edits " + std::to_string(static_cast<int>(editRate * 100)) + "% ";
+
+        GridMap g = base;
+        AStarSearchContext ctx;
+        const double astarMs = timeMs([&] {
+            for (const Query& q : log) {
+                if (q.edit.x >= 0) g.toggleBlocked(q.edit);
+                doNotOptimize(AStarPathfinder::findPath(ctx, g, q.start, q.goal).cost);
+            }
+        });
+
+        g = base;
+        PathCache cache(g, 256);
+        double hitMs = 0.0;
+        const double cachedMs = timeMs([&] {
+            for (const Query& q : log) {
+                if (q.edit.x >= 0) g.toggleBlocked(q.edit);
+                const std::uint64_t hits = cache.stats().hits;
+                const auto t0 = std::chrono::steady_clock::now();
+                doNotOptimize(cache.findPath(q.start, q.goal).cost);
+                if (cache.stats().hits != hits)
+                    hitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            }
+        });
+
+        const PathCacheStats& st = cache.stats();
+        report(label + "A* only", astarMs, "ms");
+        report(label + "with cache", cachedMs, "ms");
+        report(label + "hit rate", 100.0 * static_cast<double>(st.hits) / kQueries, "%");
+        report(label + "hit latency", st.hits ? 1000.0 * hitMs / static_cast<double>(st.hits) : 0.0, "us/query");
+        report(label + "A* latency", 1000.0 * astarMs / kQueries, "us/query");
+        report(label + "invalidations", static_cast<double>(st.invalidations), "paths");
+        report(label + "cache memory", static_cast<double>(cache.memoryBytes()) / 1024.0, "KiB");
+    }
+}
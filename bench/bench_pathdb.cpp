@@ -0,0 +1,98 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/PathDatabase.h"
+#include "taikutsu/core/ThreadPool.h"
+
+namespace {
+    double mib(double bytes) { return bytes / (1 << 20); }
+}
+
+// Database delle prime mosse su arene statiche (8 direzioni, senza corner-cutting): tempo di
+// build (sequenziale e con un ThreadPool), run e dimensione su disco, caricamento, e latenza
+// della query (percorso completo a colpi di lookup) contro AStarPathfinder.
+// taikutsu_bench path_database [--side 96]
+TAIKUTSU_BENCH(path_database) {
+    const std::vector<std::string> sideOpt = benchOption("side");
+    const int side = sideOpt.empty() ? 96 : std::stoi(sideOpt.back());
+    constexpr int kQueries = 2000;
+    struct Arena {
+        std::string name;
+        GridMap grid;
+    };
+    std::vector<Arena> arenas;
+    arenas.push_back({"rooms 16x16", makeRoomsMap(side, side, 16, 102)});
+    arenas.push_back({"random 25%", makeRandomMap(side, side, 0.25, 103)});
+    arenas.push_back({"maze (corridor 2)", makeMazeMap(side, side, 2, 104)});
+
+    ThreadPool pool;
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    const std::string file = (std::filesystem::temp_directory_path() / "taikutsu_bench.tkcpd").string();
+    for (const Arena& a : arenas) {
+        PathDatabaseOptions po;
+        po.connectivity = Connectivity::Eight;
+        PathDatabase db;
+        const double seqMs = timeMs([&] { db.build(a.grid, po); });
+        po.pool = &pool;
+        const double parMs = timeMs([&] { db.build(a.grid, po); });
+        if (!db.save(file)) {
+            std::printf(" cannot write %s\n", file.c_str());
+            return;
+        }
+        const auto fileBytes = static_cast<double>(std::filesystem::file_size(file));
+        std::optional<PathDatabase> loaded;
+        const double loadMs = timeMs([&] { loaded = PathDatabase::load(file); });
+        std::filesystem::remove(file);
+        if (!loaded || !loaded->matches(a.grid)) {
+            std::printf(" reload failed\n");
+            return;
+        }
+
+        size_t sources = 0;
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x) sources += a.grid.isWalkable(Cell{x, y});
+        std::printf(" %s %dx%d, %zu walkable cells, %d queries\n", a.name.c_str(), side, side, sources, kQueries);
+        report("build (1 thread)", seqMs, "ms");
+        report("build (" + std::to_string(pool.size()) + " threads)", parMs, "ms");
+        report("runs per source", static_cast<double>(loaded->runCount()) / static_cast<double>(sources), "runs");
+        report("file", mib(fileBytes), "MiB");
+        report("  uncompressed first-move table", mib(static_cast<double>(sources) * static_cast<double>(sources) / 2),
+               "MiB (4 bits per pair)");
+        report("load", loadMs, "ms");
+
+        const std::vector<Query> queries = connectedQueries(a.grid, kQueries, 101);
+        AStarSearchContext ctx(a.grid);
+        AStarResult r;
+        size_t mismatches = 0, steps = 0;
+        for (const Query& q : queries) { // warm-up e verifica dei costi
+            loaded->findPath(a.grid, q.start, q.goal, r);
+            mismatches += r.cost != AStarPathfinder::findPath(ctx, a.grid, q.start, q.goal, opts).cost;
+            steps += r.path.size();
+        }
+        const double astarMs = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(AStarPathfinder::findPath(ctx, a.grid, q.start, q.goal, opts).cost);
+        });
+        const double dbMs = timeMs([&] {
+            for (const Query& q : queries) {
+                loaded->findPath(a.grid, q.start, q.goal, r);
+                doNotOptimize(r.cost);
+            }
+        });
+        const double moveMs = timeMs([&] {
+            for (const Query& q : queries) doNotOptimize(loaded->firstMove(q.start, q.goal));
+        });
+        const auto n = static_cast<double>(queries.size());
+        report("AStarPathfinder", 1000.0 * astarMs / n, "us/query");
+        report("PathDatabase::findPath", 1000.0 * dbMs / n, "us/query");
+        report("  per step", 1e6 * dbMs / static_cast<double>(steps), "ns");
+        report("PathDatabase::firstMove", 1e6 * moveMs / n, "ns/query");
+        report("cost mismatches vs A*", static_cast<double>(mismatches), "queries");
+    }
+}
@@ -0,0 +1,211 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+
+namespace {
+    // AStarPathfinder com'era prima di BasicAStar (e25c397, user-004), ricostruito qui riga
+    // per riga: stesso contesto (NodeRecord con stamp di generazione, heap su un vector), stesso
+    // dispatch per query su <Eight, Weighted, Heuristic>, closed set registrato. È il codice che
+    // le istanze di BasicAStar hanno sostituito, quindi il riferimento giusto per il confronto.
+    class LegacyAStar {
+    public:
+        const AStarResult& findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+            const bool eight = opts.connectivity == Connectivity::Eight;
+            const bool weighted = opts.useTerrainCost && grid.hasCosts();
+            const bool octile = opts.heuristic == HeuristicKind::Octile || (opts.heuristic == HeuristicKind::Auto && eight);
+            const bool cut = opts.cornerCutting;
+            if (!eight) {
+                if (!weighted) return octile ? search<false, false, Octile>(grid, start, goal, cut)
+                                             : search<false, false, Manhattan>(grid, start, goal, cut);
+                return octile ? search<false, true, Octile>(grid, start, goal, cut)
+                              : search<false, true, Manhattan>(grid, start, goal, cut);
+            }
+            if (!weighted) return octile ? search<true, false, Octile>(grid, start, goal, cut)
+                                         : search<true, false, Manhattan>(grid, start, goal, cut);
+            return octile ? search<true, true, Octile>(grid, start, goal, cut)
+                          : search<true, true, Manhattan>(grid, start, goal, cut);
+        }
+
+    private:
+        struct Manhattan {
+            int operator()(Cell a, Cell b) const { return manhattanCost(a, b); }
+        };
+        struct Octile {
+            int operator()(Cell a, Cell b) const { return octileCost(a, b); }
+        };
+
+        enum : std::uint8_t { kNew = 0, kOpen = 1, kClosed = 2 };
+        struct NodeRecord {
+            std::uint32_t stamp{0};
+            int g{0};
+            int parent{-1};
+            std::uint8_t state{kNew};
+        };
+        struct OpenEntry { int idx, f, g; };
+        struct PQCmp {
+            bool operator()(const OpenEntry& a, const OpenEntry& b) const { return a.f > b.f; }
+        };
+
+        // AStarSearchContext::resize + beginQuery di allora
+        void beginQuery(const GridMap& grid) {
+            if (grid.stride() != stride_ || grid.height() != h_ || nodes_.empty()) {
+                stride_ = grid.stride();
+                h_ = grid.height();
+                nodes_.assign(grid.indexCount(), NodeRecord{});
+                generation_ = 0;
+            }
+            if (++generation_ == 0) {
+                for (NodeRecord& n : nodes_) n.stamp = 0;
+                generation_ = 1;
+            }
+            open_.clear();
+            result_.clear();
+        }
+
+        NodeRecord& touch(int idx) {
+            NodeRecord& n = nodes_[static_cast<size_t>(idx)];
+            if (n.stamp != generation_) {
+                n.stamp = generation_;
+                n.g = 0;
+                n.parent = -1;
+                n.state = kNew;
+            }
+            return n;
+        }
+
+        template <bool Eight, bool Weighted, class Heuristic>
+        const AStarResult& search(const GridMap& grid, Cell start, Cell goal, bool cornerCutting) {
+            beginQuery(grid);
+            AStarResult& result = result_;
+            const Heuristic h{};
+            if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return result;
+            if (start == goal) {
+                result.success = true;
+                result.path.push_back(start);
+                return result;
+            }
+
+            int offsets[8];
+            for (int d = 0; d < 8; ++d) offsets[d] = grid.offset(d);
+            const std::uint8_t* terrain = grid.costs();
+            auto& open = open_;
+            const int startIdx = grid.index(start);
+            const int goalIdx = grid.index(goal);
+            touch(startIdx).g = 0;
+            nodes_[static_cast<size_t>(startIdx)].state = kOpen;
+            open.push_back({startIdx, h(start, goal), 0});
+
+            while (!open.empty()) {
+                std::pop_heap(open.begin(), open.end(), PQCmp{});
+                const OpenEntry current = open.back();
+                open.pop_back();
+                auto& node = nodes_[static_cast<size_t>(current.idx)];
+                if (node.state == kClosed || current.g != node.g) continue;
+                node.state = kClosed;
+                const Cell cur = grid.cellAt(current.idx);
+                result.closed.push_back(cur);
+
+                if (current.idx == goalIdx) {
+                    result.success = true;
+                    result.cost = current.g;
+                    for (int i = goalIdx; i != -1; i = nodes_[static_cast<size_t>(i)].parent) result.path.push_back(grid.cellAt(i));
+                    std::reverse(result.path.begin(), result.path.end());
+                    return result;
+                }
+
+                unsigned mask;
+                if constexpr (Eight) mask = grid.moveMask8(current.idx, cornerCutting);
+                else                 mask = grid.walkableMask(current.idx);
+                for (; mask != 0; mask &= mask - 1) {
+                    const int d = std::countr_zero(mask);
+                    const int nbIdx = current.idx + offsets[d];
+                    const Cell nb{cur.x + kDirDx[d], cur.y + kDirDy[d]};
+                    auto& rec = touch(nbIdx);
+                    if (rec.state == kClosed) continue;
+                    int step = kCostStraight;
+                    if constexpr (Eight) step = d >= kDownRight ? kCostDiagonal : kCostStraight;
+                    if constexpr (Weighted) step *= terrain[nbIdx];
+                    const int tentativeG = current.g + step;
+                    if (rec.state == kNew || tentativeG < rec.g) {
+                        rec.parent = current.idx;
+                        rec.g = tentativeG;
+                        rec.state = kOpen;
+                        open.push_back({nbIdx, tentativeG + h(nb, goal), tentativeG});
+                        std::push_heap(open.begin(), open.end(), PQCmp{});
+                    }
+                }
+            }
+            return result;
+        }
+
+        int stride_{0};
+        int h_{0};
+        std::uint32_t generation_{0};
+        std::vector<NodeRecord> nodes_;
+        std::vector<OpenEntry> open_;
+        AStarResult result_;
+    };
+
+    // Instance: l'istanza di BasicAStar a cui AStarPathfinder::findPath(opts) mandava la query
+    // dopo user-005 (TieBreakByF + RecordClosed come il codice di prima: stesso lavoro)
+    template <class Instance>
+    void compare(const char* label, const GridMap& grid, const std::vector<Query>& queries, const SearchOptions& opts) {
+        LegacyAStar legacy;
+        AStarSearchContext ctx(grid);
+        long long sumRef = 0, sumPolicy = 0;
+        size_t expRef = 0, expPolicy = 0;
+        legacy.findPath(grid, queries[0].start, queries[0].goal, opts); // warm-up di entrambi
+        Instance::findPath(ctx, grid, queries[0].start, queries[0].goal);
+
+        const double msRef = timeMs([&] {
+            for (const Query& q : queries) {
+                const AStarResult& r = legacy.findPath(grid, q.start, q.goal, opts);
+                sumRef += r.cost;
+                expRef += r.closed.size();
+            }
+        });
+        const double msPolicy = timeMs([&] {
+            for (const Query& q : queries) {
+                const AStarResult& r = Instance::findPath(ctx, grid, q.start, q.goal);
+                sumPolicy += r.cost;
+                expPolicy += r.closed.size();
+            }
+        });
+
+        const double nq = static_cast<double>(queries.size());
+        report(std::string(label) + " pre-policy AStarPathfinder", msRef / nq, "ms/query");
+        report(std::string(label) + " BasicAStar instance", msPolicy / nq, "ms/query");
+        if (sumRef != sumPolicy) std::printf("  !! cost mismatch\n");
+        if (expRef != expPolicy)
+            std::printf("  (expanded/query %.0f vs %.0f)\n", static_cast<double>(expRef) / nq, static_cast<double>(expPolicy) / nq);
+    }
+}
+
+// istanze di BasicAStar contro l'AStarPathfinder di prima (dispatch per query su template bool)
+TAIKUTSU_BENCH(search_policies) {
+    GridMap grid(1024, 1024);
+    std::mt19937 rng(5);
+    std::bernoulli_distribution blocked(0.2);
+    for (int y = 0; y < grid.height(); ++y)
+        for (int x = 0; x < grid.width(); ++x) grid.setBlocked(Cell{x, y}, blocked(rng));
+    const auto queries = randomQueries(grid, 40, 9);
+
+    SearchOptions four, eight;
+    eight.connectivity = Connectivity::Eight;
+    compare<BasicAStar<Neighbors4, ManhattanHeuristic, UnitCost, TieBreakByF, RecordClosed>>(
+        "4-dir unit", grid, queries, four);
+    compare<BasicAStar<Neighbors8, OctileHeuristic, UnitCost, TieBreakByF, RecordClosed>>(
+        "8-dir unit", grid, queries, eight);
+
+    std::uniform_int_distribution<int> cost(1, 4);
+    for (int y = 0; y < grid.height(); ++y)
+        for (int x = 0; x < grid.width(); ++x) grid.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+
+    compare<BasicAStar<Neighbors8, OctileHeuristic, TerrainCost, TieBreakByF, RecordClosed>>(
+        "8-dir weighted", grid, queries, eight);
+}
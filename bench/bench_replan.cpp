@@ -0,0 +1,51 @@
+#include "Bench.h"
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/DStarLite.h"
+#include "taikutsu/core/MapGenerators.h"
+
+// D* Lite: riparazione dopo piccole modifiche sul percorso corrente contro A* da zero
+TAIKUTSU_BENCH(search_replan) {
+    GridMap g = makeRandomMap(1024, 1024, 0.2, 23);
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<int> r(0, 1023);
+
+    DStarLitePathfinder planner(g);
+    AStarSearchContext ctx;
+    double replanMs = 0.0, fullMs = 0.0;
+    size_t replanExpanded = 0, fullExpanded = 0, rounds = 0;
+
+    for (int q = 0; q < 10; ++q) {
+        const Cell s{r(rng), r(rng)}, t{r(rng), r(rng)};
+        g.setBlocked(s, false);
+        g.setBlocked(t, false);
+        if (!planner.plan(s, t).success) continue;
+
+        for (int round = 0; round < 10; ++round) {
+            // "si chiude una porta": blocca 3 celle del percorso attuale
+            const std::vector<Cell> path = planner.result().path;
+            if (path.size() < 10) break;
+            std::vector<Cell> changed;
+            std::uniform_int_distribution<size_t> at(1, path.size() - 2);
+            for (int e = 0; e < 3; ++e) {
+                const Cell c = path[at(rng)];
+                g.setBlocked(c, true);
+                changed.push_back(c);
+            }
+
+            replanMs += timeMs([&] { replanExpanded += planner.replan(changed).expanded; });
+            fullMs += timeMs([&] { fullExpanded += AStarPathfinder::findPath(ctx, g, s, t).expanded; });
+            ++rounds;
+            if (!planner.result().success) break;
+        }
+    }
+
+    const auto n = static_cast<double>(rounds);
+    std::printf(" 1024x1024, 20%% obstacles, %zu replans (3 cells blocked on the current path)\n", rounds);
+    report("D* Lite replan ms", replanMs / n, "ms");
+    report("A* full search ms", fullMs / n, "ms");
+    report("D* Lite replan expanded", static_cast<double>(replanExpanded) / n, "nodes");
+    report("A* full search expanded", static_cast<double>(fullExpanded) / n, "nodes");
+}
@@ -0,0 +1,218 @@
+#include "Bench.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/Hierarchical.h"
+#include "taikutsu/core/JumpPoint.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/MovingAI.h"
+
+// Runner di scenari nello stile dei benchmark MovingAI: 8 direzioni senza corner-cutting,
+// lunghezze con diagonale = sqrt(2). Per ogni algoritmo, a gruppi di bucket (bucket = lunghezza
+// ottima / 4): latenza media e p99, nodi espansi (closed), subottimalità media e massima
+// rispetto alla lunghezza ottima dello scenario. Il picco di heap è quello del processo durante
+// le query (più la costruzione per HPA*), sopra la memoria già viva prima di iniziare.
+
+namespace {
+    struct Solver {
+        const char* name;
+        // costruito per mappa (HPA* preprocessa qui); restituisce la funzione di query
+        std::function<std::function<const AStarResult&(Cell, Cell)>(const GridMap&)> make;
+    };
+
+    SearchOptions octileOptions() {
+        SearchOptions opts;
+        opts.connectivity = Connectivity::Eight; // cornerCutting = false come MovingAI
+        return opts;
+    }
+
+    std::vector<Solver> solvers() {
+        return {
+            {"A*", [](const GridMap& g) {
+                 auto ctx = std::make_shared<AStarSearchContext>(g);
+                 return std::function<const AStarResult&(Cell, Cell)>([ctx, &g](Cell s, Cell t) -> const AStarResult& {
+                     return AStarPathfinder::findPath(*ctx, g, s, t, octileOptions());
+                 });
+             }},
+            {"JPS", [](const GridMap& g) {
+                 auto ctx = std::make_shared<AStarSearchContext>(g);
+                 return std::function<const AStarResult&(Cell, Cell)>([ctx, &g](Cell s, Cell t) -> const AStarResult& {
+                     return JumpPointPathfinder::findPath(*ctx, g, s, t, octileOptions());
+                 });
+             }},
+            {"HPA*", [](const GridMap& g) {
+                 auto hpa = std::make_shared<HierarchicalPathfinder>(g, 32, octileOptions());
+                 return std::function<const AStarResult&(Cell, Cell)>(
+                     [hpa](Cell s, Cell t) -> const AStarResult& { return hpa->findPath(s, t); });
+             }},
+        };
+    }
+
+    // lunghezza "reale" del percorso (diagonale = sqrt(2)), come nei file .scen
+    double octileLength(const std::vector<Cell>& path) {
+        int straight = 0, diagonal = 0;
+        for (size_t i = 1; i < path.size(); ++i) {
+            if (path[i].x != path[i - 1].x && path[i].y != path[i - 1].y) ++diagonal;
+            else ++straight;
+        }
+        return straight + std::sqrt(2.0) * diagonal;
+    }
+
+    struct Sample {
+        int bucket;
+        double us;
+        size_t expanded;
+        double subopt; // lunghezza / ottima (0 se non calcolabile)
+        bool failed;   // percorso mancante o diverso da quanto atteso
+    };
+
+    void printGroup(const char* solver, int b0, int b1, std::vector<Sample>& s) {
+        if (s.empty()) return;
+        std::sort(s.begin(), s.end(), [](const Sample& a, const Sample& b) { return a.us < b.us; });
+        double us = 0.0, expanded = 0.0, subopt = 0.0, worst = 0.0;
+        int failed = 0, measured = 0;
+        for (const Sample& x : s) {
+            us += x.us;
+            expanded += static_cast<double>(x.expanded);
+            failed += x.failed;
+            if (x.subopt > 0.0) {
+                subopt += x.subopt;
+                worst = std::max(worst, x.subopt);
+                ++measured;
+            }
+        }
+        const double n = static_cast<double>(s.size());
+        const double p99 = s[std::min(s.size() - 1, static_cast<size_t>(0.99 * (n - 1) + 0.5))].us;
+        std::printf("  %-5s buckets %4d-%-4d %6zu  %10.1f %10.1f %10.0f %8.4f %8.4f %6d\n", solver, b0, b1, s.size(),
+                    us / n, p99, expanded / n, measured ? subopt / measured : 0.0, worst, failed);
+    }
+
+    // esegue le query con ogni algoritmo e stampa la tabella a gruppi di bucket
+    void runScenarios(const GridMap& grid, const std::vector<MovingAIScenario>& queries) {
+        if (queries.empty()) return;
+        int maxBucket = 0;
+        for (const auto& q : queries) maxBucket = std::max(maxBucket, q.bucket);
+        const int groupWidth = std::max(1, (maxBucket + 5) / 5); // ~5 righe per algoritmo
+
+        std::printf("  %-5s %-17s %6s  %10s %10s %10s %8s %8s %6s\n", "algo", "", "n", "mean us", "p99 us", "expanded",
+                    "subopt", "worst", "fail");
+        for (const Solver& solver : solvers()) {
+            const size_t baseline = liveBytes();
+            resetPeakBytes();
+            std::function<const AStarResult&(Cell, Cell)> query;
+            const double buildMs = timeMs([&] { query = solver.make(grid); });
+
+            std::map<int, std::vector<Sample>> groups;
+            for (const auto& q : queries) {
+                const AStarResult* r = nullptr;
+                const auto t0 = std::chrono::steady_clock::now();
+                r = &query(q.start, q.goal);
+                const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+                const bool expectPath = q.optimalLength > 0.0 || q.start == q.goal;
+                Sample s{q.bucket, us, r->expanded, 0.0, r->success != expectPath};
+                if (r->success && q.optimalLength > 0.0) s.subopt = octileLength(r->path) / q.optimalLength;
+                groups[q.bucket / groupWidth].push_back(s);
+            }
+            const size_t peak = peakBytes() > baseline ? peakBytes() - baseline : 0;
+
+            for (auto& [g, samples] : groups) printGroup(solver.name, g * groupWidth, (g + 1) * groupWidth - 1, samples);
+            std::printf("  %-5s build %.2f ms, heap peak %.1f KiB\n", solver.name, buildMs, static_cast<double>(peak) / 1024.0);
+        }
+    }
+
+    // query casuali tra celle della stessa componente; ottimo e bucket dal percorso di A*
+    std::vector<MovingAIScenario> makeScenarios(const GridMap& g, int count, unsigned seed) {
+        const ConnectivityIndex cc(g);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+        AStarSearchContext ctx(g);
+        std::vector<MovingAIScenario> out;
+        for (int tries = 0; static_cast<int>(out.size()) < count && tries < count * 100; ++tries) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            if (!cc.connected(s, t)) continue;
+            MovingAIScenario q;
+            q.start = s;
+            q.goal = t;
+            q.optimalLength = octileLength(AStarPathfinder::findPath(ctx, g, s, t, octileOptions()).path);
+            q.bucket = static_cast<int>(q.optimalLength / 4.0);
+            out.push_back(q);
+        }
+        return out;
+    }
+
+    // la mappa citata nel .scen: --map-dir, poi accanto al .scen, poi com'è scritta
+    std::optional<GridMap> findMap(const std::filesystem::path& scen, const std::string& map,
+                                   const std::vector<std::string>& mapDirs) {
+        namespace fs = std::filesystem;
+        std::vector<fs::path> candidates;
+        for (const auto& dir : mapDirs) candidates.push_back(fs::path(dir) / fs::path(map).filename());
+        candidates.push_back(scen.parent_path() / map);
+        candidates.push_back(scen.parent_path() / fs::path(map).filename());
+        candidates.push_back(map);
+        for (const auto& p : candidates) {
+            if (!fs::exists(p)) continue;
+            std::string error;
+            if (auto g = loadMovingAIMap(p.string(), &error)) return g;
+            std::printf("  %s: %s\n", p.string().c_str(), error.c_str());
+            return std::nullopt;
+        }
+        std::printf("  map %s not found (try --map-dir)\n", map.c_str());
+        return std::nullopt;
+    }
+}
+
+// Famiglie sintetiche (nessun dato esterno): per seguire le regressioni tra un commit e l'altro.
+TAIKUTSU_BENCH(scenarios_synthetic) {
+    constexpr int kSide = 512;
+    constexpr int kQueries = 120;
+    struct Family {
+        std::string name;
+        GridMap grid;
+    };
+    std::vector<Family> families;
+    families.push_back({"open", makeOpenMap(kSide, kSide)});
+    for (const int pct : {10, 20, 30, 40})
+        families.push_back({"random " + std::to_string(pct) + "%", makeRandomMap(kSide, kSide, pct / 100.0, 31)});
+    families.push_back({"maze (corridor 4)", makeMazeMap(kSide, kSide, 4, 32)});
+    families.push_back({"rooms 32x32", makeRoomsMap(kSide, kSide, 32, 33)});
+
+    for (const Family& f : families) {
+        std::printf(" %s %dx%d, %d queries\n", f.name.c_str(), kSide, kSide, kQueries);
+        runScenarios(f.grid, makeScenarios(f.grid, kQueries, 34));
+    }
+}
+
+// File .scen MovingAI: taikutsu_bench scenarios_movingai --scen file.scen [--scen ...] [--map-dir dir]
+TAIKUTSU_BENCH(scenarios_movingai) {
+    const std::vector<std::string> scens = benchOption("scen");
+    if (scens.empty()) {
+        std::printf(" no scenario files (use --scen file.scen [--map-dir dir])\n");
+        return;
+    }
+    const std::vector<std::string> mapDirs = benchOption("map-dir");
+
+    for (const std::string& file : scens) {
+        std::string error;
+        const auto scenarios = loadMovingAIScenarios(file, &error);
+        if (!scenarios) {
+            std::printf(" %s: %s\n", file.c_str(), error.c_str());
+            continue;
+        }
+        // un .scen di solito usa una mappa sola, ma il formato ne ammette più d'una
+        std::map<std::string, std::vector<MovingAIScenario>> byMap;
+        for (const auto& s : *scenarios) byMap[s.map].push_back(s);
+        for (const auto& [map, queries] : byMap) {
+            std::printf(" %s: %s, %zu queries\n", file.c_str(), map.c_str(), queries.size());
+            if (const auto grid = findMap(file, map, mapDirs)) runScenarios(*grid, queries);
+        }
+    }
+}
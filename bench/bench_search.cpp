@@ -0,0 +1,103 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <algorithm>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/JumpPoint.h"
+#include "taikutsu/core/MapGenerators.h"
+
+namespace {
+    // esegue tutte le query con lo stesso ctx, stampa ms/query e nodi espansi medi
+    template <class Finder>
+    void run(const char* label, const GridMap& g, const std::vector<Query>& queries, const SearchOptions& opts = {}) {
+        AStarSearchContext ctx(g);
+        size_t expanded = 0;
+        const double ms = timeMs([&] {
+            for (const Query& q : queries) expanded += Finder::findPath(ctx, g, q.start, q.goal, opts).expanded;
+        });
+        report(std::string(label) + " ms/query", ms / static_cast<double>(queries.size()), "ms");
+        report(std::string(label) + " expanded/query",
+               static_cast<double>(expanded) / static_cast<double>(queries.size()), "nodes");
+    }
+}
+
+// A* contro JPS su griglie grandi a costo uniforme
+TAIKUTSU_BENCH(search_jps) {
+    for (double density : {0.0, 0.2}) {
+        const GridMap g = makeRandomMap(1024, 1024, density, 5);
+        const auto queries = randomQueries(g, 50, 9);
+        std::printf(" 1024x1024, %.0f%% obstacles\n", density * 100.0);
+        run<AStarPathfinder>("A*", g, queries);
+        run<JumpPointPathfinder>("JPS", g, queries);
+
+        SearchOptions eight;
+        eight.connectivity = Connectivity::Eight;
+        run<AStarPathfinder>("A* 8-dir", g, queries, eight);
+        run<JumpPointPathfinder>("JPS 8-dir", g, queries, eight);
+    }
+}
+
+// terreno pesato: stesso grid con un layer di costi 1..4 contro il percorso veloce unitario
+TAIKUTSU_BENCH(search_weighted) {
+    GridMap g = makeRandomMap(1024, 1024, 0.2, 5);
+    const auto queries = randomQueries(g, 50, 9);
+    run<AStarPathfinder>("A* unit (fast path)", g, queries);
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> cost(1, 4);
+    for (int y = 0; y < g.height(); ++y)
+        for (int x = 0; x < g.width(); ++x) g.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+
+    run<AStarPathfinder>("A* weighted 4-dir", g, queries);
+    SearchOptions eight;
+    eight.connectivity = Connectivity::Eight;
+    run<AStarPathfinder>("A* weighted 8-dir", g, queries, eight);
+}
+
+// costo della registrazione del closed set e dei formati di output (8 direzioni, ctx caldo):
+// ms/query e byte del risultato rimasti nel contesto dopo le query
+TAIKUTSU_BENCH(search_output) {
+    const GridMap g = makeRandomMap(1024, 1024, 0.2, 5);
+    const auto queries = randomQueries(g, 50, 9);
+    std::vector<Cell> storage(static_cast<size_t>(g.width()) * static_cast<size_t>(g.height()));
+
+    struct Variant {
+        const char* name;
+        ClosedRecording closed;
+        PathFormat format;
+        bool span;
+    };
+    const Variant variants[] = {
+        {"closed list (debug)", ClosedRecording::List, PathFormat::Cells, false},
+        {"closed bitmap", ClosedRecording::Bitmap, PathFormat::Cells, false},
+        {"no recording (default)", ClosedRecording::None, PathFormat::Cells, false},
+        {"no recording, waypoints", ClosedRecording::None, PathFormat::Waypoints, false},
+        {"no recording, caller span", ClosedRecording::None, PathFormat::Cells, true},
+    };
+    for (const Variant& v : variants) {
+        SearchOptions opts;
+        opts.connectivity = Connectivity::Eight;
+        opts.recordClosed = v.closed;
+        opts.output.format = v.format;
+        if (v.span) opts.output.span = std::span<Cell>(storage);
+
+        AStarSearchContext ctx(g);
+        for (const Query& q : queries) AStarPathfinder::findPath(ctx, g, q.start, q.goal, opts); // warm-up
+        size_t cells = 0;
+        double best = 1e300;
+        for (int rep = 0; rep < 3; ++rep) {
+            const double ms = timeMs([&] {
+                for (const Query& q : queries) cells += AStarPathfinder::findPath(ctx, g, q.start, q.goal, opts).pathLength;
+            });
+            best = std::min(best, ms);
+        }
+        doNotOptimize(cells);
+        std::printf(" %s\n", v.name);
+        report("ms/query", best / static_cast<double>(queries.size()), "ms");
+        report("path cells/query", static_cast<double>(cells) / 3.0 / static_cast<double>(queries.size()), "cells");
+        report("context memory", static_cast<double>(ctx.memoryBytes()) / 1024.0, "KiB");
+    }
+}
@@ -0,0 +1,69 @@
+#include "Bench.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/PathService.h"
+
+// PathService al variare dei worker: 4 producer inviano tutte le richieste e attendono le
+// risposte; una richiesta su 4 ripete una delle precedenti (agenti con lo stesso obiettivo).
+// Latenza = submit -> risposta, coda compresa: con pochi worker cresce con la coda.
+TAIKUTSU_BENCH(search_service) {
+    const auto g = std::make_shared<const GridMap>(makeRandomMap(512, 512, 0.2, 11));
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 500;
+
+    std::vector<std::vector<std::pair<Cell, Cell>>> work(kProducers);
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> rc(0, 511);
+    std::bernoulli_distribution repeat(0.25);
+    for (auto& w : work) {
+        while (static_cast<int>(w.size()) < kPerProducer) {
+            if (!w.empty() && repeat(rng)) {
+                w.push_back(w[std::uniform_int_distribution<size_t>(0, w.size() - 1)(rng)]);
+                continue;
+            }
+            const Cell s{rc(rng), rc(rng)}, t{rc(rng), rc(rng)};
+            if (g->isWalkable(s) && g->isWalkable(t)) w.emplace_back(s, t);
+        }
+    }
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf(" 512x512, 20%% obstacles, %d producers x %d requests (hardware threads: %u)\n", kProducers,
+                kPerProducer, hw);
+
+    for (unsigned threads = 1; threads <= std::max(hw, 4u); threads *= 2) {
+        PathService service(g, threads);
+        size_t maxDepth = 0;
+        const double ms = timeMs([&] {
+            std::atomic<int> running{kProducers};
+            std::vector<std::thread> producers;
+            for (int p = 0; p < kProducers; ++p) {
+                producers.emplace_back([&, p] {
+                    std::vector<PathService::PathTicket> tickets;
+                    tickets.reserve(static_cast<size_t>(kPerProducer));
+                    for (const auto& q : work[static_cast<size_t>(p)]) tickets.push_back(service.submit(q.first, q.second));
+                    for (const auto& t : tickets) doNotOptimize(t.get().cost);
+                    --running;
+                });
+            }
+            // profondità massima della coda, campionata ogni ms
+            while (running.load() > 0) {
+                maxDepth = std::max(maxDepth, service.stats().queueDepth);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            for (auto& t : producers) t.join();
+        });
+
+        const PathServiceStats st = service.stats();
+        const std::string label = std::to_string(threads) + " workers ";
+        report(label + "requests/s", kProducers * kPerProducer / (ms / 1000.0), "req/s");
+        report(label + "latency p50", st.p50Us / 1000.0, "ms");
+        report(label + "latency p99", st.p99Us / 1000.0, "ms");
+        report(label + "coalesced", static_cast<double>(st.coalesced), "req");
+        report(label + "max queue depth", static_cast<double>(maxDepth), "req");
+    }
+}
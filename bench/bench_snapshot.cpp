@@ -0,0 +1,115 @@
+#include "Bench.h"
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ChunkedAStar.h"
+#include "taikutsu/core/GridSnapshot.h"
+#include "taikutsu/core/MapGenerators.h"
+
+namespace {
+    // pennellata dell'editor: un quadrato brush x brush attorno a c, bloccato o liberato
+    template <class Grid>
+    void paint(Grid& g, Cell c, int brush, bool blocked) {
+        for (int y = 0; y < brush; ++y)
+            for (int x = 0; x < brush; ++x) g.setBlocked(Cell{c.x + x, c.y + y}, blocked);
+    }
+}
+
+// Un editor che dipinge mentre le ricerche girano in background. Per ogni frame (kStrokes
+// pennellate) due modi di dare ai lettori una versione stabile del grid: copiare tutto il
+// GridMap, o VersionedGrid::publish() (copy-on-write delle sole tile toccate). Poi il costo
+// lato lettore (snapshot() e ricerca sullo snapshot contro A* sul GridMap) e un lettore che
+// cerca di continuo mentre lo scrittore pubblica.
+// taikutsu_bench snapshot [--side 2048]
+TAIKUTSU_BENCH(snapshot) {
+    const std::vector<std::string> sideOpt = benchOption("side");
+    const int side = sideOpt.empty() ? 2048 : std::stoi(sideOpt.back());
+    constexpr int kFrames = 200;
+    GridMap g = makeRoomsMap(side, side, 32, 181, 1.0);
+    VersionedGrid v(g);
+    std::printf(" rooms 32x32 %dx%d, %zu of %d tiles mixed, %d frames\n", side, side, v.snapshot()->mixedTileCount(),
+                v.snapshot()->tilesX() * v.snapshot()->tilesY(), kFrames);
+
+    std::mt19937 rng(182);
+    std::uniform_int_distribution<int> coord(0, side - 8);
+    for (const int strokes : {1, 16, 256}) {
+        std::printf(" %d strokes (4x4 brush) per frame\n", strokes);
+        std::vector<Cell> at(static_cast<size_t>(kFrames * strokes));
+        for (Cell& c : at) c = Cell{coord(rng), coord(rng)};
+
+        size_t i = 0;
+        const double copyMs = timeMs([&] {
+            for (int f = 0; f < kFrames; ++f) {
+                for (int s = 0; s < strokes; ++s, ++i) paint(g, at[i], 4, (i & 1) != 0);
+                const GridMap copy = g; // versione per i lettori
+                doNotOptimize(copy.width());
+            }
+        });
+        i = 0;
+        size_t touched = 0;
+        const double publishMs = timeMs([&] {
+            for (int f = 0; f < kFrames; ++f) {
+                for (int s = 0; s < strokes; ++s, ++i) paint(v, at[i], 4, (i & 1) != 0);
+                touched += v.pendingTiles();
+                doNotOptimize(v.publish()->version());
+            }
+        });
+        report("edits + GridMap copy per frame", 1000.0 * copyMs / kFrames, "us");
+        report("edits + VersionedGrid::publish() per frame", 1000.0 * publishMs / kFrames, "us");
+        report("  tiles copied per frame", static_cast<double>(touched) / kFrames, "tiles");
+    }
+
+    // lato lettore
+    const auto snap = v.snapshot();
+    constexpr int kLoads = 1000000;
+    const double loadMs = timeMs([&] {
+        for (int k = 0; k < kLoads; ++k) doNotOptimize(v.snapshot()->version());
+    });
+    report("snapshot() (atomic load + release)", 1e6 * loadMs / kLoads, "ns");
+
+    std::uniform_int_distribution<int> any(0, side - 1), near(-300, 300);
+    std::vector<std::pair<Cell, Cell>> queries;
+    while (queries.size() < 200) {
+        const Cell s{any(rng), any(rng)}, t{s.x + near(rng), s.y + near(rng)};
+        if (g.isWalkable(s) && g.isWalkable(t) && snap->isWalkable(s) && snap->isWalkable(t)) queries.emplace_back(s, t);
+    }
+    AStarSearchContext actx(g);
+    ChunkedSearchContext cctx;
+    const double astarMs = timeMs([&] {
+        for (const auto& [s, t] : queries) doNotOptimize(AStarPathfinder::findPath(actx, g, s, t).cost);
+    });
+    const double snapMs = timeMs([&] {
+        for (const auto& [s, t] : queries) doNotOptimize(ChunkedAStar::findPath(cctx, *snap, s, t).cost);
+    });
+    report("A* on GridMap per query", astarMs / static_cast<double>(queries.size()), "ms");
+    report("ChunkedAStar on snapshot per query", snapMs / static_cast<double>(queries.size()), "ms");
+
+    // un lettore in background, lo scrittore pubblica una pennellata per volta
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> searched{0};
+    std::thread reader([&] {
+        ChunkedSearchContext ctx;
+        for (size_t q = 0; !stop.load(std::memory_order_relaxed); ++q) {
+            const auto& [s, t] = queries[q % queries.size()];
+            doNotOptimize(ChunkedAStar::findPath(ctx, *v.snapshot(), s, t).cost);
+            searched.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    size_t published = 0;
+    const double concurrentMs = timeMs([&] {
+        for (int k = 0; k < 2000; ++k, ++published) {
+            paint(v, Cell{coord(rng), coord(rng)}, 4, (k & 1) != 0);
+            v.publish();
+            if (k % 64 == 0) std::this_thread::yield();
+        }
+    });
+    stop = true;
+    reader.join();
+    report("concurrent: versions published per second", 1000.0 * static_cast<double>(published) / concurrentMs, "versions/s");
+    report("concurrent: reader searches per second",
+           1000.0 * static_cast<double>(searched.load()) / concurrentMs, "queries/s");
+}
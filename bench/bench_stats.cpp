@@ -0,0 +1,52 @@
+#include "Bench.h"
+#include "BenchQueries.h"
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/SearchStats.h"
+
+namespace {
+    template <class Recorder>
+    double run(const GridMap& grid, const std::vector<Query>& queries, Recorder& rec) {
+        using Finder = BasicAStar<Neighbors8, OctileHeuristic, UnitCost, TieBreakLargerG, Recorder>;
+        AStarSearchContext ctx(grid);
+        Finder::findPath(ctx, grid, queries[0].start, queries[0].goal, rec); // warm-up
+        double best = 1e300;
+        for (int rep = 0; rep < 3; ++rep) {
+            best = std::min(best, timeMs([&] {
+                for (const Query& q : queries) doNotOptimize(Finder::findPath(ctx, grid, q.start, q.goal, rec).cost);
+            }));
+        }
+        return best / static_cast<double>(queries.size());
+    }
+}
+
+// Costo delle statistiche: stesse query con e senza StatsRecorder (miglior tempo su 3 giri).
+// Le istanze senza statistiche non leggono il clock: quelle sono le righe di riferimento.
+TAIKUTSU_BENCH(search_stats) {
+    const GridMap g = makeRandomMap(512, 512, 0.2, 41);
+    const std::vector<Query> queries = randomQueries(g, 200, 17);
+    std::printf(" 512x512, 20%% obstacles, 8-dir, %zu queries\n", queries.size());
+
+    NoRecorder none;
+    RecordClosed closed;
+    SearchStatsCollector collector;
+    StatsRecorder<NoRecorder> stats(&collector);
+    StatsRecorder<RecordClosed> statsClosed(&collector);
+
+    const double base = run(g, queries, none);
+    const double baseClosed = run(g, queries, closed);
+    const double withStats = run(g, queries, stats);
+    collector.reset();
+    const double withStatsClosed = run(g, queries, statsClosed);
+
+    report("NoRecorder", base, "ms/query");
+    report("StatsRecorder<NoRecorder>", withStats, "ms/query");
+    report("  overhead", 100.0 * (withStats / base - 1.0), "%");
+    report("RecordClosed (AStarPathfinder default)", baseClosed, "ms/query");
+    report("StatsRecorder<RecordClosed>", withStatsClosed, "ms/query");
+    report("  overhead", 100.0 * (withStatsClosed / baseClosed - 1.0), "%");
+
+    std::printf("%s", collector.toText().c_str());
+}
@@ -2,23 +2,119 @@
 #define ASTAR_H
 
 #include "GridMap.h"
+#include "BasicAStar.h" // template con policy + AStarSearchContext
+#include "Landmarks.h"
+#include "SearchOptions.h"
+#include "SearchStats.h"
+#include <type_traits>
 #include <vector>
 
-// risultato A*
-struct AStarResult {
-    // Strada percorsa, da start fino a goal (if sucecess=false, no path)
-    std::vector<Cell> path;    //start -> goal (inclusive)
-    std::vector<Cell> closed;  //nodi esplorati (debug) utile per colorarli
-    bool success{false}; //indica se ha trovato strada da percorrere
-};
+// istanze pronte di BasicAStar (tutte registrano il closed set per il debug e,
+// a parità di f, preferiscono g maggiore: molte meno espansioni su terreno aperto)
+using AStar4         = BasicAStar<Neighbors4, ManhattanHeuristic, UnitCost, TieBreakLargerG, RecordClosed>;
+using AStar8         = BasicAStar<Neighbors8, OctileHeuristic, UnitCost, TieBreakLargerG, RecordClosed>;
+using WeightedAStar4 = BasicAStar<Neighbors4, ManhattanHeuristic, TerrainCost, TieBreakLargerG, RecordClosed>;
+using WeightedAStar8 = BasicAStar<Neighbors8, OctileHeuristic, TerrainCost, TieBreakLargerG, RecordClosed>;
+
+// Scelta a runtime dell'istanza di BasicAStar per (grid, opts): recorder (opts.recordClosed,
+// opts.stats) -> vicinato -> modello di costo -> euristica -> open list.
+// Chiama fn.template operator()<Istanza>() e ne restituisce il risultato (stesso tipo per tutte le istanze). Usata da AStarPathfinder e ResumableSearch.
+// Il recorder dell'istanza va creato con makeRecorder (collega opts.stats), l'euristica con
+// makeHeuristic (collega opts.landmarks).
+template <class Fn>
+decltype(auto) dispatchAStar(const GridMap& grid, const SearchOptions& opts, Fn&& fn);
+
+template <class Recorder>
+Recorder makeRecorder(const SearchOptions& opts) {
+    if constexpr (std::is_constructible_v<Recorder, SearchStatsCollector*>) return Recorder(opts.stats);
+    else return Recorder{};
+}
+
+// come makeRecorder per l'euristica dell'istanza (collega opts.landmarks al goal della query)
+template <class Heuristic>
+Heuristic makeHeuristic(const SearchOptions& opts, Cell goal) {
+    if constexpr (std::is_constructible_v<Heuristic, const LandmarkTable&, Cell>) return Heuristic(*opts.landmarks, goal);
+    else return Heuristic{};
+}
 
 // Interfaccia A* (classe stateless, non imagazzina stato interno, offre solo funzione pura)
-class AStarPathfinder {
+// È l'istanza AStar4 (4 direzioni, costo unitario) più gli overload con SearchOptions,
+// che scelgono a runtime, una volta per query, l'istanza di BasicAStar giusta.
+// Di default non registra il closed set (opts.recordClosed) e scrive tutte le celle in
+// result.path (opts.output: buffer/span del chiamante, solo waypoint).
+class AStarPathfinder : public AStar4 {
 public:
     // Esegue A* sul grid, cercando strada tra start/goal
     // return di AStarResult con il path disegnato
-    static AStarResult findPath(const GridMap& grid, Cell start, Cell goal);
+    // (wrapper: crea un AStarSearchContext temporaneo ad ogni chiamata)
+    static AStarResult findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+
+    // Versione con stato riutilizzabile: nessuna allocazione su heap a regime.
+    // Il risultato vive dentro ctx ed è valido fino alla prossima query sullo stesso ctx.
+    static const AStarResult& findPath(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts = {});
 };
 
+// ---------------- dispatch (dettagli) ----------------
+
+template <class R, class N, class C, class H, class Fn>
+decltype(auto) dispatchAStarOpenList(const SearchOptions& opts, Fn& fn) {
+    switch (opts.openList) {
+        case OpenListKind::IndexedHeap:
+            return fn.template operator()<BasicAStar<N, H, C, TieBreakLargerG, R, IndexedHeapOpen>>();
+        case OpenListKind::Radix:
+            return fn.template operator()<BasicAStar<N, H, C, TieBreakLargerG, R, RadixOpen>>();
+        case OpenListKind::BinaryHeap:
+        default:
+            return fn.template operator()<BasicAStar<N, H, C, TieBreakLargerG, R, BinaryHeapOpen>>();
+    }
+}
+
+template <class R, class N, class C, class Fn>
+decltype(auto) dispatchAStarHeuristic(const SearchOptions& opts, bool octile, bool landmarks, Fn& fn) {
+    if (landmarks) {
+        if (octile) return dispatchAStarOpenList<R, N, C, LandmarkHeuristic<OctileHeuristic>>(opts, fn);
+        return dispatchAStarOpenList<R, N, C, LandmarkHeuristic<ManhattanHeuristic>>(opts, fn);
+    }
+    if (octile) return dispatchAStarOpenList<R, N, C, OctileHeuristic>(opts, fn);
+    return dispatchAStarOpenList<R, N, C, ManhattanHeuristic>(opts, fn);
+}
+
+template <class R, class N, class Fn>
+decltype(auto) dispatchAStarCost(const SearchOptions& opts, bool weighted, bool octile, bool landmarks, Fn& fn) {
+    // senza layer di costo si usa UnitCost: nessuna lettura del terreno nel loop
+    if (weighted) return dispatchAStarHeuristic<R, N, TerrainCost>(opts, octile, landmarks, fn);
+    return dispatchAStarHeuristic<R, N, UnitCost>(opts, octile, landmarks, fn);
+}
+
+template <class R, class Fn>
+decltype(auto) dispatchAStarNeighbors(const GridMap& grid, const SearchOptions& opts, Fn& fn) {
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool weighted = opts.useTerrainCost && grid.hasCosts();
+    const bool octile = opts.heuristic == HeuristicKind::Octile || (opts.heuristic == HeuristicKind::Auto && eight);
+    // tabella non valida per questa query (grid cambiato, mosse diverse): euristica geometrica
+    const bool landmarks = opts.landmarks != nullptr && opts.landmarks->usableFor(grid, opts);
+
+    if (!eight) return dispatchAStarCost<R, Neighbors4>(opts, weighted, octile, landmarks, fn);
+    if (opts.cornerCutting) return dispatchAStarCost<R, Neighbors8CornerCut>(opts, weighted, octile, landmarks, fn);
+    return dispatchAStarCost<R, Neighbors8>(opts, weighted, octile, landmarks, fn);
+}
+
+template <class R, class Fn>
+decltype(auto) dispatchAStarStats(const GridMap& grid, const SearchOptions& opts, Fn& fn) {
+    // statistiche richieste: istanze con StatsRecorder (le altre non leggono nemmeno il clock)
+    if (opts.stats != nullptr) return dispatchAStarNeighbors<StatsRecorder<R>>(grid, opts, fn);
+    return dispatchAStarNeighbors<R>(grid, opts, fn);
+}
+
+template <class Fn>
+decltype(auto) dispatchAStar(const GridMap& grid, const SearchOptions& opts, Fn&& fn) {
+    switch (opts.recordClosed) {
+        case ClosedRecording::List: return dispatchAStarStats<RecordClosed>(grid, opts, fn);
+        case ClosedRecording::Bitmap: return dispatchAStarStats<RecordClosedBitmap>(grid, opts, fn);
+        case ClosedRecording::None:
+        default: return dispatchAStarStats<NoRecorder>(grid, opts, fn);
+    }
+}
 
 #endif //ASTAR_H
@@ -0,0 +1,132 @@
+#ifndef ASTARPOLICIES_H
+#define ASTARPOLICIES_H
+
+#include "GridMap.h"
+#include "AStarSearchContext.h"
+#include "SearchOptions.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Policy per BasicAStar<Neighborhood, Heuristic, CostModel, TieBreak, Recorder>.
+// Ogni policy è una piccola struct con funzioni inline: il compilatore le espande
+// dentro il loop di A*, quindi una ricerca paga solo per le feature che usa.
+
+// ---------------- Neighborhood ----------------
+// mask(grid, idx): bit d (vedi Dir) = mossa valida da idx in direzione d
+// mask(grid, c): lo stesso per i grid a tile (ChunkedGridMap, GridSnapshot), che lavorano per cella
+
+struct Neighbors4 {
+    static constexpr bool kDiagonal = false;
+    static unsigned mask(const GridMap& g, int idx) { return g.walkableMask(idx); }
+    template <class Grid> static unsigned mask(const Grid& g, Cell c) { return g.walkableMask(c); }
+};
+
+// 8 direzioni, diagonale solo se entrambe le ortogonali sono libere
+struct Neighbors8 {
+    static constexpr bool kDiagonal = true;
+    static unsigned mask(const GridMap& g, int idx) { return g.moveMask8(idx, false); }
+    template <class Grid> static unsigned mask(const Grid& g, Cell c) { return g.moveMask8(c, false); }
+};
+
+// 8 direzioni, diagonale se almeno una ortogonale è libera
+struct Neighbors8CornerCut {
+    static constexpr bool kDiagonal = true;
+    static unsigned mask(const GridMap& g, int idx) { return g.moveMask8(idx, true); }
+    template <class Grid> static unsigned mask(const Grid& g, Cell c) { return g.moveMask8(c, true); }
+};
+
+// ---------------- Heuristic ----------------
+// estimate(a, b): stima ammissibile in fixed-point (vedi SearchOptions.h)
+// (LandmarkHeuristic in Landmarks.h: con stato, costruita per query da makeHeuristic)
+
+struct ManhattanHeuristic {
+    static int estimate(Cell a, Cell b) { return manhattanCost(a, b); }
+};
+
+struct OctileHeuristic {
+    static int estimate(Cell a, Cell b) { return octileCost(a, b); }
+};
+
+// h = 0 -> Dijkstra
+struct ZeroHeuristic {
+    static int estimate(Cell, Cell) { return 0; }
+};
+
+// ---------------- CostModel ----------------
+// costruito una volta per query dal grid; step(base, nbIdx) = costo per entrare in nbIdx
+// (base = kCostStraight o kCostDiagonal, già deciso da BasicAStar)
+
+struct UnitCost {
+    template <class Grid> explicit UnitCost(const Grid&) {}
+    template <class Key> int step(int base, Key) const { return base; }
+};
+
+// moltiplica per il costo del terreno della cella di arrivo (layer uint8 di GridMap)
+struct TerrainCost {
+    explicit TerrainCost(const GridMap& g) : terrain(g.costs()) {}
+    int step(int base, int nbIdx) const { return terrain ? base * terrain[nbIdx] : base; }
+
+    const std::uint8_t* terrain;
+};
+
+// ---------------- TieBreak ----------------
+// before(a, b) = true se a deve uscire dall'open set prima di b
+
+// solo f (comportamento classico)
+struct TieBreakByF {
+    static bool before(const AStarSearchContext::OpenEntry& a, const AStarSearchContext::OpenEntry& b) {
+        return a.f < b.f;
+    }
+};
+
+// a parità di f preferisce g maggiore (nodi più vicini al goal): meno espansioni su terreno aperto
+struct TieBreakLargerG {
+    static bool before(const AStarSearchContext::OpenEntry& a, const AStarSearchContext::OpenEntry& b) {
+        return a.f < b.f || (a.f == b.f && a.g > b.g);
+    }
+};
+
+// ---------------- Recorder ----------------
+// hook chiamati durante la ricerca (istanza passata dal chiamante o creata per query):
+//   onExpand(result, c, idx)   - cella estratta e chiusa (idx = indice paddato)
+//   onPush()                   - inserimento nell'open set (anche duplicati senza decrease-key)
+//   onOpenSize(n)              - dimensione dell'open set dopo un inserimento
+//   onStalePop()               - estratta una copia vecchia, scartata
+//   onQueryBegin(ctx)          - prima di preparare ctx (memoria non ancora allocata)
+//   onQueryEnd(status, ctx)    - ricerca conclusa (Found / NoPath; non chiamato se abbandonata)
+//   (ctx = il contesto della SearchSpace: AStarSearchContext per GridMap)
+//   onPhase(phase, durata)     - solo se kProfile: tempo speso in una fase
+// kProfile = false: BasicAStar non legge nemmeno il clock (hook vuoti, costo zero)
+
+// fasi di una query (vedi onPhase)
+enum class SearchPhase : std::uint8_t {
+    Setup,  // resize/reset del contesto e inserimento di start
+    Expand, // loop di espansione (somma delle step() per una ricerca a fette)
+    Path    // ricostruzione del percorso dai parent
+};
+
+// nessuna registrazione: result.closed resta vuoto (conta solo result.expanded)
+struct NoRecorder {
+    static constexpr bool kProfile = false;
+
+    void onExpand(AStarResult&, Cell, int) {}
+    void onPush() {}
+    void onOpenSize(size_t) {}
+    void onStalePop() {}
+    template <class Context> void onQueryBegin(const Context&) {}
+    template <class Context> void onQueryEnd(SearchStatus, const Context&) {}
+    void onPhase(SearchPhase, std::chrono::nanoseconds) {}
+};
+
+// salva le celle espanse in result.closed (visualizzazione/debug)
+struct RecordClosed : NoRecorder {
+    void onExpand(AStarResult& result, Cell c, int) { result.closed.push_back(c); }
+};
+
+// come RecordClosed ma in result.closedBits: 1 bit per cella (vedi AStarResult::markClosed)
+struct RecordClosedBitmap : NoRecorder {
+    void onExpand(AStarResult& result, Cell, int idx) { result.markClosed(idx); }
+};
+
+#endif //ASTARPOLICIES_H
@@ -0,0 +1,193 @@
+#ifndef ASTARSEARCHCONTEXT_H
+#define ASTARSEARCHCONTEXT_H
+
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// risultato A*
+struct AStarResult {
+    // Strada percorsa, da start fino a goal (if sucecess=false, no path)
+    std::vector<Cell> path;    //start -> goal (inclusive); vuoto se scritto in PathOutput::buffer/span
+    std::vector<Cell> closed;  //nodi esplorati (debug) utile per colorarli (ClosedRecording::List)
+    std::vector<std::uint64_t> closedBits; // nodi esplorati, 1 bit per indice paddato (ClosedRecording::Bitmap)
+    std::vector<std::uint32_t> closedWords; // word non nulle di closedBits: clear() azzera solo quelle
+    bool success{false}; //indica se ha trovato strada da percorrere
+    int cost{0}; // costo totale del path in fixed-point (kCostStraight per passo ortogonale)
+    size_t expanded{0};   // nodi espansi (sempre, anche senza registrazione)
+    size_t pathLength{0}; // celle (o waypoint) del percorso, ovunque sia stato scritto
+
+    // cella espansa secondo closedBits (stesso grid della query)
+    bool closedAt(const GridMap& grid, Cell c) const {
+        const auto idx = static_cast<size_t>(grid.index(c));
+        return (idx >> 6) < closedBits.size() && ((closedBits[idx >> 6] >> (idx & 63)) & 1u);
+    }
+
+    // segna idx in closedBits; la bitmap cresce fino all'indice più alto visto e poi resta
+    void markClosed(int idx) {
+        const auto word = static_cast<size_t>(idx) >> 6;
+        if (word >= closedBits.size()) closedBits.resize(word + 1, 0);
+        if (closedBits[word] == 0) closedWords.push_back(static_cast<std::uint32_t>(word));
+        closedBits[word] |= std::uint64_t{1} << (idx & 63);
+    }
+
+    // svuota mantenendo la capacità dei vettori (nessuna deallocazione). La bitmap torna a zero
+    // toccando solo le word della query precedente, non tutta l'area
+    void clear() {
+        path.clear();
+        closed.clear();
+        for (const std::uint32_t w : closedWords) closedBits[w] = 0;
+        closedWords.clear();
+        success = false;
+        cost = 0;
+        expanded = 0;
+        pathLength = 0;
+    }
+};
+
+// Percorso start -> goal seguendo parentOf(n) (-1 = start) da goal, con cellOf(n) la cella del
+// nodo n: parent anche non adiacenti, purché allineati come i jump point di JPS. Scritto dove
+// dice out. Due passate sulla catena: la prima conta, la seconda scrive dal fondo, così niente
+// push_back né reverse. (AStarSearchContext e ChunkedSearchContext, nodi numerati a modo loro)
+template <class CellOf, class ParentOf>
+void writeParentChain(AStarResult& result, int goal, CellOf cellOf, ParentOf parentOf, const PathOutput& out) {
+    const bool waypoints = out.format == PathFormat::Waypoints;
+    auto sign = [](int v) { return (v > 0) - (v < 0); };
+
+    // visita goal -> start: ogni cella (Cells) o solo goal, svolte e start (Waypoints)
+    auto walk = [&](auto&& emit) {
+        Cell c = cellOf(goal);
+        emit(c);
+        int dx = 0, dy = 0; // direzione del tratto precedente (0,0 = nessuno)
+        for (int i = goal; parentOf(i) != -1;) {
+            i = parentOf(i);
+            const Cell p = cellOf(i);
+            const int sx = sign(p.x - c.x), sy = sign(p.y - c.y);
+            if (waypoints) {
+                if ((dx != 0 || dy != 0) && (sx != dx || sy != dy)) emit(c); // c è una svolta
+                dx = sx;
+                dy = sy;
+                c = p;
+            } else {
+                while (!(c == p)) {
+                    c.x += sx;
+                    c.y += sy;
+                    emit(c);
+                }
+            }
+        }
+        if (waypoints && (dx != 0 || dy != 0)) emit(c); // start
+    };
+
+    size_t n = 0;
+    walk([&](Cell) { ++n; });
+    result.pathLength = n;
+
+    Cell* dst = nullptr;
+    if (!out.span.empty()) {
+        if (n > out.span.size()) return; // non ci sta: il chiamante rilegge pathLength
+        dst = out.span.data();
+    } else {
+        std::vector<Cell>& v = out.buffer ? *out.buffer : result.path;
+        v.resize(n);
+        dst = v.data();
+    }
+    walk([&](Cell c) { dst[--n] = c; });
+}
+
+// stato di una ricerca a fette (vedi BasicAStar::Search, ResumableSearch)
+enum class SearchStatus : std::uint8_t {
+    Idle,      // nessuna query avviata
+    Running,   // open set non vuoto, step() può continuare
+    Found,     // result.path valido
+    NoPath,    // open set esaurito (o start/goal non validi)
+    Cancelled  // interrotta dal chiamante: result.closed contiene solo le celle espanse fin lì
+};
+
+// Stato riutilizzabile di una ricerca A* (dimensionato su un GridMap).
+// Al posto di unordered_map/unordered_set creati ad ogni chiamata, teniamo array
+// piatti indicizzati per cella (idx = GridMap::index(c), indice paddato). Ogni record porta un "stamp"
+// di generazione: se stamp != generation_ il record è di una query precedente e
+// vale come "mai visto". Così il reset tra una query e l'altra è O(1).
+// Dopo la prima query (warm-up) non ci sono più allocazioni su heap.
+class AStarSearchContext {
+public:
+    AStarSearchContext() = default;
+    explicit AStarSearchContext(const GridMap& grid) { resize(grid); }
+
+    // adatta gli array alle dimensioni del grid (no-op se già giuste)
+    void resize(const GridMap& grid);
+
+    // risultato dell'ultima query (valido fino alla prossima findPath con questo ctx)
+    const AStarResult& result() const { return result_; }
+
+    // byte riservati dai buffer (nodi, open set, risultato): cresce solo quando una query
+    // ha bisogno di più spazio delle precedenti
+    size_t memoryBytes() const;
+
+    // elemento dell'open set
+    struct OpenEntry {
+        int idx; // cella (indice paddato)
+        int f;   // priorità (f = g + h)
+        int g;   // costo reale al momento del push (per skip degli stale)
+    };
+
+    // memoria delle varie implementazioni di open list (vedi OpenList.h);
+    // ognuna usa solo i campi che le servono, la capacità resta tra una query e l'altra
+    struct OpenStorage {
+        std::vector<OpenEntry> heap;                  // heap binario / 4-ario
+        std::vector<int> heapPos;                     // posizione nell'heap 4-ario (decrease-key)
+        std::array<std::vector<OpenEntry>, 33> radix; // bucket della radix queue
+    };
+
+private:
+    template <class, class, class, class, class, template <class> class, class> friend class BasicAStar;
+    template <class> friend struct SearchSpace;
+    friend class JumpPointPathfinder;
+    friend class AStarPathfinder;
+    friend class ResumableSearch;
+
+    // stato di un nodo per la query corrente
+    enum : std::uint8_t { kNew = 0, kOpen = 1, kClosed = 2 };
+
+    struct NodeRecord {
+        std::uint32_t stamp{0}; // generazione a cui appartiene il record
+        int g{0};               // miglior costo conosciuto da start
+        int parent{-1};         // idx della cella precedente (cameFrom)
+        std::uint8_t state{kNew};
+    };
+
+    // inizia una nuova query: incrementa la generazione, svuota open/result
+    void beginQuery();
+
+    // percorso start -> goalIdx seguendo i parent, scritto dove dice out (vedi writeParentChain)
+    void writePath(const GridMap& grid, int goalIdx, const PathOutput& out) {
+        writeParentChain(result_, goalIdx, [&](int i) { return grid.cellAt(i); },
+                         [&](int i) { return nodes_[static_cast<size_t>(i)].parent; }, out);
+    }
+
+    // record della cella per la query corrente (resetta se è "vecchio")
+    NodeRecord& touch(int idx) {
+        NodeRecord& n = nodes_[static_cast<size_t>(idx)];
+        if (n.stamp != generation_) {
+            n.stamp = generation_;
+            n.g = 0;
+            n.parent = -1;
+            n.state = kNew;
+        }
+        return n;
+    }
+
+    int stride_{0};
+    int h_{0};
+    std::uint32_t generation_{0};
+    std::vector<NodeRecord> nodes_; // grid.indexCount() record
+    OpenStorage open_;              // storage dell'open set, capacità riusata
+    AStarResult result_;
+};
+
+#endif //ASTARSEARCHCONTEXT_H
@@ -0,0 +1,293 @@
+#ifndef BASICASTAR_H
+#define BASICASTAR_H
+
+#include "AStarPolicies.h"
+#include "OpenList.h"
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+// cronometro delle fasi per i Recorder con kProfile; la versione spenta è vuota
+template <bool Enabled>
+class PhaseClock {
+public:
+    void restart() {}
+    template <class Recorder>
+    void lap(Recorder&, SearchPhase) {}
+};
+
+template <>
+class PhaseClock<true> {
+public:
+    void restart() { last_ = std::chrono::steady_clock::now(); }
+
+    // tempo dall'ultimo lap / restart (o dalla costruzione) attribuito a phase
+    template <class Recorder>
+    void lap(Recorder& recorder, SearchPhase phase) {
+        const auto now = std::chrono::steady_clock::now();
+        recorder.onPhase(phase, now - last_);
+        last_ = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last_{std::chrono::steady_clock::now()};
+};
+
+// Come BasicAStar vede un tipo di grid: contesto dei nodi, chiave di una cella (indice nel grid)
+// e handle di un nodo (quello che finisce in OpenEntry::idx e nei parent).
+//   prepare(ctx, grid)             - ctx pronto per una query nuova
+//   openCapacity(ctx)              - handle possibili (open list indicizzate), 0 = non noto
+//   offset(grid, d)                - key(vicino in direzione d) - key(cella)
+//   mask<Neighborhood>(grid, k, c) - mosse valide dalla cella c (chiave k)
+//   touch(ctx, key)                - {handle, nodo} della cella, kNew se mai vista nella query
+//   node(ctx, h) / keyOf(ctx, h)   - nodo e chiave di un handle
+//   writePath(ctx, grid, h, out)   - percorso fino al nodo h
+// Le specializzazioni per ChunkedGridMap / GridSnapshot sono in ChunkedAStar.h.
+template <class Grid>
+struct SearchSpace;
+
+// GridMap: array piatto per indice paddato (AStarSearchContext), handle = chiave
+template <>
+struct SearchSpace<GridMap> {
+    using Context = AStarSearchContext;
+    using Key = int;
+    struct Touched {
+        int handle;
+        AStarSearchContext::NodeRecord& node;
+    };
+
+    static void prepare(Context& ctx, const GridMap& grid) {
+        ctx.resize(grid);
+        ctx.beginQuery();
+    }
+    static size_t openCapacity(const Context& ctx) { return ctx.nodes_.size(); }
+    static Key offset(const GridMap& grid, int d) { return grid.offset(d); }
+    template <class Neighborhood>
+    static unsigned mask(const GridMap& grid, Key key, Cell) { return Neighborhood::mask(grid, key); }
+    static Touched touch(Context& ctx, Key key) { return {key, ctx.touch(key)}; }
+    static AStarSearchContext::NodeRecord& node(Context& ctx, int h) { return ctx.nodes_[static_cast<size_t>(h)]; }
+    static Key keyOf(const Context&, int h) { return h; }
+    static void writePath(Context& ctx, const GridMap& grid, int h, const PathOutput& out) { ctx.writePath(grid, h, out); }
+};
+
+// A* configurato a compile-time tramite policy (vedi AStarPolicies.h):
+//   Neighborhood - quali mosse (4 / 8 direzioni, regole sugli angoli)
+//   Heuristic    - stima verso il goal (un'istanza per query: può avere stato, vedi Landmarks.h)
+//   CostModel    - costo di un passo (unitario / terreno)
+//   TieBreak     - ordine dei nodi nell'open set a parità di f
+//   Recorder     - hook di registrazione (closed set per il debug, statistiche, ...)
+//   OpenList     - implementazione dell'open set (vedi OpenList.h)
+//   Grid         - su cosa si cerca (GridMap, oppure ChunkedGridMap / GridSnapshot con il loro
+//                  contesto a tabella hash): vedi SearchSpace
+// Ogni combinazione è un'istanza diversa: nessun branch a runtime per nodo.
+template <class Neighborhood, class Heuristic, class CostModel, class TieBreak, class Recorder,
+          template <class> class OpenList = BinaryHeapOpen, class Grid = GridMap>
+class BasicAStar {
+public:
+    using RecorderType = Recorder;
+    using HeuristicType = Heuristic;
+    using Space = SearchSpace<Grid>;
+    using Context = typename Space::Context;
+    using Key = typename Space::Key;
+
+    // Ricerca a fette: lo stato (open set, g, parent) resta in ctx tra una step() e l'altra,
+    // così il chiamante può distribuire la ricerca su più frame. findPath è una Search
+    // eseguita senza limite, quindi a fette o in un colpo il risultato è identico.
+    // Durante la ricerca grid, ctx e recorder non vanno toccati (né usati per altre query).
+    class Search {
+    public:
+        // output: dove scrivere il percorso (buffer/span devono restare vivi fino alla fine)
+        // heuristic: stima per questa query (le policy senza stato vanno bene di default)
+        Search(Context& ctx, const Grid& grid, Cell start, Cell goal, Recorder& recorder,
+               const PathOutput& output = {}, const Heuristic& heuristic = {});
+
+        // espande al massimo maxExpansions nodi; Running = da riprendere
+        SearchStatus step(size_t maxExpansions);
+
+        SearchStatus status() const { return status_; }
+        size_t expanded() const { return expanded_; } // nodi chiusi dall'inizio della query
+
+    private:
+        // ctx pronto per una query nuova prima di costruire l'open list sopra la sua memoria
+        static Context& prepare(Context& ctx, const Grid& grid, Recorder& recorder) {
+            recorder.onQueryBegin(ctx);
+            Space::prepare(ctx, grid);
+            return ctx;
+        }
+
+        SearchStatus finish(SearchStatus status) {
+            status_ = status;
+            ctx_.result_.expanded = expanded_;
+            recorder_.onQueryEnd(status, ctx_);
+            return status;
+        }
+
+        [[no_unique_address]] PhaseClock<Recorder::kProfile> clock_; // primo membro: parte prima di prepare()
+        Context& ctx_;
+        const Grid& grid_;
+        Recorder& recorder_;
+        OpenList<TieBreak> open_; // sopra la memoria di ctx
+        CostModel cost_;
+        Heuristic heuristic_;
+        PathOutput output_;
+        Key offsets_[8];          // offset di indice dei vicini, stesso ordine dei bit delle mask (vedi Dir)
+        Cell goal_;
+        Key goalIdx_;
+        size_t expanded_{0};
+        SearchStatus status_{SearchStatus::Running};
+    };
+
+    // wrapper: crea un contesto temporaneo ad ogni chiamata
+    static AStarResult findPath(const Grid& grid, Cell start, Cell goal) {
+        Context ctx;
+        findPath(ctx, grid, start, goal);
+        return ctx.result_;
+    }
+
+    // stato riutilizzabile: nessuna allocazione a regime; il risultato vive in ctx
+    static const AStarResult& findPath(Context& ctx, const Grid& grid, Cell start, Cell goal) {
+        Recorder recorder{};
+        return findPath(ctx, grid, start, goal, recorder);
+    }
+
+    // come sopra, con un Recorder del chiamante (es. statistiche accumulate tra più query)
+    // e, volendo, il percorso in un buffer del chiamante (vedi PathOutput) e un'euristica con stato
+    static const AStarResult& findPath(Context& ctx, const Grid& grid, Cell start, Cell goal,
+                                       Recorder& recorder, const PathOutput& output = {},
+                                       const Heuristic& heuristic = {}) {
+        Search search(ctx, grid, start, goal, recorder, output, heuristic);
+        search.step(SIZE_MAX);
+        return ctx.result_;
+    }
+};
+
+template <class Neighborhood, class Heuristic, class CostModel, class TieBreak, class Recorder,
+          template <class> class OpenList, class Grid>
+BasicAStar<Neighborhood, Heuristic, CostModel, TieBreak, Recorder, OpenList, Grid>::Search::Search(
+        Context& ctx, const Grid& grid, Cell start, Cell goal, Recorder& recorder,
+        const PathOutput& output, const Heuristic& heuristic)
+    : ctx_(prepare(ctx, grid, recorder)), grid_(grid), recorder_(recorder),
+      open_(ctx.open_, Space::openCapacity(ctx)), cost_(grid), heuristic_(heuristic), output_(output), goal_(goal),
+      goalIdx_(0) {
+    AStarResult& result = ctx_.result_;
+    if (output_.buffer != nullptr) output_.buffer->clear(); // nessun percorso finché non lo troviamo
+
+    //controllare se start/goal sono all'interno della mappa
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) {
+        clock_.lap(recorder_, SearchPhase::Setup);
+        finish(SearchStatus::NoPath);
+        return;
+    }
+
+    if (start == goal) {
+        result.success = true;
+        const int h = Space::touch(ctx_, grid.index(start)).handle; // parent = -1: percorso di una cella
+        Space::writePath(ctx_, grid, h, output_);
+        clock_.lap(recorder_, SearchPhase::Setup);
+        finish(SearchStatus::Found);
+        return;
+    }
+
+    for (int d = 0; d < 8; ++d) offsets_[d] = Space::offset(grid, d);
+    goalIdx_ = grid.index(goal);
+
+    const auto [startNode, startRec] = Space::touch(ctx_, grid.index(start));
+    startRec.state = Context::kOpen; //g(start) = 0
+    open_.push({startNode, heuristic_.estimate(start, goal), 0}); //mette start su open set
+    recorder_.onPush();
+    recorder_.onOpenSize(open_.size());
+    clock_.lap(recorder_, SearchPhase::Setup);
+}
+
+template <class Neighborhood, class Heuristic, class CostModel, class TieBreak, class Recorder,
+          template <class> class OpenList, class Grid>
+SearchStatus BasicAStar<Neighborhood, Heuristic, CostModel, TieBreak, Recorder, OpenList, Grid>::Search::step(
+        size_t maxExpansions) {
+    if (status_ != SearchStatus::Running) return status_;
+
+    Context& ctx = ctx_;
+    const Grid& grid = grid_;
+    AStarResult& result = ctx.result_;
+    const Cell goal = goal_;
+    const Key goalIdx = goalIdx_;
+    size_t budget = maxExpansions;
+
+    clock_.restart(); // il tempo tra una fetta e l'altra non è della ricerca
+    while (!open_.empty()) { //continua mentre ci sono candidati sulla 'frontiera' open set
+        if (budget == 0) { // fetta finita: si riprende dal prossimo pop
+            result.expanded = expanded_;
+            clock_.lap(recorder_, SearchPhase::Expand);
+            return status_;
+        }
+
+        const AStarSearchContext::OpenEntry current = open_.pop(); //seleciona nó com menor f
+
+        auto& node = Space::node(ctx, current.idx);
+
+        // “skip” entradas desatualizadas (sem decrease-key o nó antigo fica na fila)
+        // e células já no closed set
+        if constexpr (!OpenList<TieBreak>::kDecreaseKey) {
+            if (node.state == Context::kClosed || current.g != node.g) {
+                recorder_.onStalePop();
+                continue;
+            }
+        }
+
+        // marca current cell como explorada
+        node.state = Context::kClosed;
+        const Key curIdx = Space::keyOf(ctx, current.idx);
+        const Cell cur = grid.cellAt(curIdx);
+        recorder_.onExpand(result, cur, curIdx);
+        ++expanded_;
+        --budget;
+
+        //se chegamos no objetivo
+        if (curIdx == goalIdx) {
+            clock_.lap(recorder_, SearchPhase::Expand);
+            result.success = true;
+            result.cost = current.g;
+            //reconstrói o caminho de goal até start seguindo parent (direto no destino do chamador)
+            Space::writePath(ctx, grid, current.idx, output_);
+            clock_.lap(recorder_, SearchPhase::Path);
+            return finish(SearchStatus::Found);
+        }
+
+        //explora os vizinhos: só os bits 1 da mask (nenhum bounds check, nenhuma alocação)
+        for (unsigned mask = Space::template mask<Neighborhood>(grid, curIdx, cur); mask != 0; mask &= mask - 1) {
+            const int d = std::countr_zero(mask);
+            const Key nbIdx = curIdx + offsets_[d];
+
+            // (con il contesto a tabella hash touch può spostare i nodi: node non si usa più da qui)
+            const auto [nbNode, rec] = Space::touch(ctx, nbIdx);
+            if (rec.state == Context::kClosed) continue; //ignora os já explorados
+
+            int base = kCostStraight;
+            if constexpr (Neighborhood::kDiagonal) base = d >= kDownRight ? kCostDiagonal : kCostStraight;
+            const int tentativeG = current.g + cost_.step(base, nbIdx);
+
+            // vizinho nunca visto, ou caminho mais barato até ele
+            const bool fresh = rec.state == Context::kNew;
+            if (fresh || tentativeG < rec.g) {
+                rec.parent = current.idx;
+                rec.g = tentativeG;
+                rec.state = Context::kOpen;
+
+                // f = (custo real) g + heuristics (h)
+                const Cell nb{cur.x + kDirDx[d], cur.y + kDirDy[d]};
+                const AStarSearchContext::OpenEntry e{nbNode, tentativeG + heuristic_.estimate(nb, goal), tentativeG};
+                if (fresh) open_.push(e);
+                else       open_.decrease(e); // in place se l'open list lo supporta, altrimenti duplicato
+                if (fresh || !OpenList<TieBreak>::kDecreaseKey) {
+                    recorder_.onPush();
+                    recorder_.onOpenSize(open_.size());
+                }
+            }
+        }
+    }
+
+    // sem caminho
+    clock_.lap(recorder_, SearchPhase::Expand);
+    return finish(SearchStatus::NoPath);
+}
+
+#endif //BASICASTAR_H
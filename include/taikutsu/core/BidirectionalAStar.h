@@ -0,0 +1,115 @@
+#ifndef BIDIRECTIONALASTAR_H
+#define BIDIRECTIONALASTAR_H
+
+#include "AStarSearchContext.h"
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Stato riutilizzabile di BidirectionalAStar: due lati (avanti da start, indietro da goal) con
+// array piatti per indice paddato come AStarSearchContext, più un thread di aiuto (il lato
+// all'indietro gira lì, quello in avanti sul thread del chiamante) e un AStarSearchContext per
+// le query corte. Il thread parte alla prima query a due lati: un contesto che vede solo query
+// corte non ne crea. Un contesto serve una query alla volta.
+class BidirectionalSearchContext {
+public:
+    // sotto questa stima (fixed-point, Manhattan/Octile da start a goal) la query va su A*
+    // normale: far partire il secondo lato costa più di quanto fa risparmiare
+    static constexpr int kDefaultMinParallelEstimate = 128 * kCostStraight;
+
+    explicit BidirectionalSearchContext(int minParallelEstimate = kDefaultMinParallelEstimate)
+        : minParallelEstimate_(minParallelEstimate) {}
+
+    BidirectionalSearchContext(const BidirectionalSearchContext&) = delete;
+    BidirectionalSearchContext& operator=(const BidirectionalSearchContext&) = delete;
+
+    void resize(const GridMap& grid); // no-op se già giusto
+
+    int minParallelEstimate() const { return minParallelEstimate_; }
+    void setMinParallelEstimate(int estimate) { minParallelEstimate_ = estimate; }
+
+    // risultato dell'ultima query a due lati (quelle corte restano in AStarSearchContext)
+    const AStarResult& result() const { return result_; }
+    size_t memoryBytes() const;
+    bool helperStarted() const { return helper_ != nullptr; } // thread di aiuto già creato
+
+private:
+    friend class BidirectionalAStar;
+
+    // un lato della ricerca. g[idx] = generazione << 32 | costo: il lato lo scrive, l'altro lo
+    // legge (std::atomic_ref) per trovare gli incontri; il resto lo tocca solo il suo thread
+    struct Side {
+        std::vector<std::uint64_t> g;
+        std::vector<int> parent; // valido se g[idx] è della generazione corrente
+        AStarSearchContext::OpenStorage open;
+        std::vector<int> closed; // celle espanse (solo con opts.recordClosed)
+        size_t expanded{0};
+        // chiave dell'ultimo nodo estratto: tutte le chiavi più piccole sono già espanse
+        std::atomic<int> top{0};
+    };
+
+    Side forward_, backward_;
+    std::uint32_t generation_{0};
+    // miglior percorso trovato: costo << 32 | cella d'incontro (il minimo numerico è il migliore)
+    std::atomic<std::uint64_t> best_{0};
+    std::atomic<bool> stop_{false};
+    int minParallelEstimate_;
+    AStarSearchContext single_; // query corte (e ripiego, vedi BidirectionalAStar)
+    AStarResult result_;
+    std::vector<Cell> cells_;   // percorso completo prima di PathOutput
+    // un worker, creato alla prima query a due lati. Ultimo membro: distrutto per primo, il suo
+    // task non vede membri già distrutti
+    std::unique_ptr<ThreadPool> helper_;
+};
+
+// A* bidirezionale su due thread per le query lunghe: un lato espande in avanti da start,
+// l'altro all'indietro da goal, sugli stessi array piatti. Potenziale medio (Ikeda): chiave
+// in avanti 2g + h(v, goal) - h(v, start), all'indietro 2g + h(v, start) - h(v, goal); è il
+// doppio di Dijkstra sui costi ridotti, uguali nei due versi, quindi le chiavi estratte da ogni
+// lato non scendono mai (euristica consistente) e i due lati si dividono il lavoro invece di
+// rifare ognuno tutta la ricerca.
+// Incontri: ogni volta che un lato migliora g di una cella legge il g dell'altro lato nella
+// stessa cella; la somma è un percorso completo e il minimo (best) viene aggiornato con un CAS.
+// Scrittura propria e lettura altrui sono seq_cst: su due scritture "contemporanee" almeno uno
+// dei due lati vede quella dell'altro, quindi nessun incontro va perso.
+// Terminazione: ogni lato pubblica la chiave che estrae (top, release) e si ferma, fermando
+// l'altro, quando la sua + quella dell'altro (acquire, al più vecchia quindi più piccola) >=
+// 2 * best, o quando esaurisce la open list. Un percorso più corto di best avrebbe un arco
+// (u, w) con u già espanso in avanti e w all'indietro, e quell'incontro è già in best prima
+// della pubblicazione di top. Il percorso restituito è quindi ottimo.
+//
+// Stesso AStarResult di AStarPathfinder (stesso costo; a parità di costo il percorso può
+// essere un altro): expanded = somma dei due lati, closed = celle di entrambi.
+// Vanno su AStarPathfinder (con ctx.single_, stesso risultato e stessi opts): stima sotto
+// minParallelEstimate(), start == goal, e HeuristicKind::Manhattan con 8 direzioni (non
+// ammissibile: la condizione di stop non varrebbe). A due lati opts.landmarks e opts.stats
+// vengono ignorati.
+class BidirectionalAStar {
+public:
+    // Query singola. Le query corte (vedi sopra, soglia kDefaultMinParallelEstimate) vanno su
+    // AStarPathfinder::findPath(grid, ...) senza contesto a due lati né thread. Le altre creano
+    // un BidirectionalSearchContext (due array di g e parent da indexCount() celle) e ne fanno
+    // partire il thread di aiuto, poi buttano via tutto: per più di una query conviene tenere un
+    // contesto e usare l'overload qui sotto.
+    static AStarResult findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+    static const AStarResult& findPath(BidirectionalSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts = {});
+
+private:
+    using Side = BidirectionalSearchContext::Side;
+
+    // false = la query va su AStarPathfinder (stima sotto la soglia, start == goal, euristica
+    // non ammissibile)
+    static bool twoSided(Cell start, Cell goal, const SearchOptions& opts, int minParallelEstimate);
+
+    template <bool kEight, bool kWeighted>
+    static void searchSide(BidirectionalSearchContext& ctx, const GridMap& grid, Side& self, const Side& other,
+                           int from, Cell target, bool forward, bool cornerCutting, bool octile, bool record);
+    static void writePath(BidirectionalSearchContext& ctx, const GridMap& grid, int meet, const PathOutput& out);
+};
+
+#endif //BIDIRECTIONALASTAR_H
@@ -0,0 +1,33 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstdint>
+
+// Piccoli helper per leggere/scrivere sequenze di bit dentro una riga di word da 64 bit
+// (usati da GridMap per le operazioni bulk e da JPS per scandire 64 celle alla volta)
+
+constexpr std::uint64_t lowMask(int n) { return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1; }
+
+// legge n (<= 64) bit a partire da "bit" dentro una riga di word
+inline std::uint64_t loadBits(const std::uint64_t* row, int bit, int n) {
+    const int w = bit >> 6;
+    const int s = bit & 63;
+    std::uint64_t v = row[w] >> s;
+    if (s != 0 && s + n > 64) v |= row[w + 1] << (64 - s);
+    return v & lowMask(n);
+}
+
+// scrive i primi n (<= 64) bit di v a partire da "bit"
+inline void storeBits(std::uint64_t* row, int bit, int n, std::uint64_t v) {
+    const int w = bit >> 6;
+    const int s = bit & 63;
+    const std::uint64_t m = lowMask(n);
+    v &= m;
+    row[w] = (row[w] & ~(m << s)) | (v << s);
+    if (s + n > 64) {
+        const std::uint64_t m2 = lowMask(s + n - 64);
+        row[w + 1] = (row[w + 1] & ~m2) | ((v >> (64 - s)) & m2);
+    }
+}
+
+#endif //BITOPS_H
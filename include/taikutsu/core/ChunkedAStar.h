@@ -0,0 +1,118 @@
+#ifndef CHUNKEDASTAR_H
+#define CHUNKEDASTAR_H
+
+#include "AStarSearchContext.h"
+#include "BasicAStar.h"
+#include "ChunkedGridMap.h"
+#include "SearchOptions.h"
+#include <cstdint>
+#include <vector>
+
+class GridSnapshot;
+
+// Stato riutilizzabile di A* su ChunkedGridMap. Un array piatto per cella (come
+// AStarSearchContext) costerebbe quanto l'area: qui i nodi toccati dalla query stanno in un
+// vector e una tabella hash (indirizzamento aperto, chiave = indice a 64 bit) ne dà il numero.
+// Le voci della tabella portano uno stamp di generazione: reset tra due query O(1), e dopo la
+// prima query con la stessa frontiera nessuna allocazione.
+class ChunkedSearchContext {
+public:
+    // risultato dell'ultima query (valido fino alla prossima findPath con questo ctx)
+    const AStarResult& result() const { return result_; }
+    size_t memoryBytes() const;
+
+private:
+    friend class ChunkedAStar;
+    template <class, class, class, class, class, template <class> class, class> friend class BasicAStar;
+    template <class> friend struct ChunkedSearchSpace;
+
+    enum : std::uint8_t { kNew = 0, kOpen = 1, kClosed = 2 };
+
+    struct Node {
+        std::int64_t idx;   // cella (ChunkedGridMap::index)
+        int g;
+        std::int32_t parent; // numero del nodo precedente, -1 = start
+        std::uint8_t state;
+    };
+    struct Slot {
+        std::int64_t key{0};
+        std::uint32_t stamp{0}; // != generation_ -> vuoto
+        std::uint32_t node{0};
+    };
+
+    void beginQuery();
+    // numero del nodo di idx (creato kNew se è la prima volta nella query)
+    std::uint32_t touch(std::int64_t idx);
+    void grow();
+    template <class Grid>
+    void writePath(const Grid& grid, int goalNode, const PathOutput& out) {
+        writeParentChain(result_, goalNode, [&](int n) { return grid.cellAt(nodes_[static_cast<size_t>(n)].idx); },
+                         [&](int n) { return nodes_[static_cast<size_t>(n)].parent; }, out);
+    }
+
+    std::vector<Slot> table_; // potenza di due, carico <= 1/2
+    std::uint32_t generation_{0};
+    std::vector<Node> nodes_;
+    AStarSearchContext::OpenStorage open_; // OpenEntry::idx = numero del nodo
+    AStarResult result_;
+};
+
+// SearchSpace (BasicAStar.h) dei grid a tile: chiave = indice a 64 bit y * width + x, handle =
+// numero del nodo in ChunkedSearchContext. Le mask non escono mai dalla mappa, quindi il vicino
+// in direzione d è sempre key + dy * width + dx.
+template <class Grid>
+struct ChunkedSearchSpace {
+    using Context = ChunkedSearchContext;
+    using Key = std::int64_t;
+    struct Touched {
+        int handle;
+        ChunkedSearchContext::Node& node; // valido fino alla prossima touch
+    };
+
+    static void prepare(Context& ctx, const Grid&) { ctx.beginQuery(); }
+    static size_t openCapacity(const Context&) { return 0; } // i nodi crescono durante la query
+    static Key offset(const Grid& grid, int d) { return static_cast<Key>(kDirDy[d]) * grid.width() + kDirDx[d]; }
+    template <class Neighborhood>
+    static unsigned mask(const Grid& grid, Key, Cell c) { return Neighborhood::mask(grid, c); }
+    static Touched touch(Context& ctx, Key key) {
+        const std::uint32_t n = ctx.touch(key);
+        return {static_cast<int>(n), ctx.nodes_[n]};
+    }
+    static ChunkedSearchContext::Node& node(Context& ctx, int h) { return ctx.nodes_[static_cast<size_t>(h)]; }
+    static Key keyOf(const Context& ctx, int h) { return ctx.nodes_[static_cast<size_t>(h)].idx; }
+    static void writePath(Context& ctx, const Grid& grid, int h, const PathOutput& out) { ctx.writePath(grid, h, out); }
+};
+
+template <>
+struct SearchSpace<ChunkedGridMap> : ChunkedSearchSpace<ChunkedGridMap> {};
+template <>
+struct SearchSpace<GridSnapshot> : ChunkedSearchSpace<GridSnapshot> {};
+
+// A* su ChunkedGridMap: BasicAStar sulla SearchSpace qui sopra, quindi stesse opzioni e stesso
+// risultato di AStarPathfinder (costi unitari, la griglia a tile non ha layer di terreno). Le
+// celle dentro tile uniformi libere non leggono bit (vedi ChunkedGridMap::walkableMask8), quelle
+// in tile bloccate non vengono mai generate.
+// Costi in int come AStarPathfinder (percorsi fino a ~2*10^7 passi ortogonali).
+// opts.recordClosed: List come AStarPathfinder, Bitmap non disponibile (indici paddati di
+// GridMap); opts.output come AStarPathfinder; opts.stats e opts.openList ignorati (heap binario).
+// Le stesse ricerche girano su un GridSnapshot (GridSnapshot.h): lo snapshot non cambia, quindi
+// nessun lock anche se intanto il VersionedGrid da cui viene pubblica altre versioni.
+class ChunkedAStar {
+public:
+    static AStarResult findPath(const ChunkedGridMap& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+    static const AStarResult& findPath(ChunkedSearchContext& ctx, const ChunkedGridMap& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts = {});
+    static AStarResult findPath(const GridSnapshot& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+    static const AStarResult& findPath(ChunkedSearchContext& ctx, const GridSnapshot& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts = {});
+
+private:
+    template <class Grid>
+    static const AStarResult& dispatch(ChunkedSearchContext& ctx, const Grid& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts);
+    template <class Neighborhood, class Heuristic, class Grid>
+    static const AStarResult& search(ChunkedSearchContext& ctx, const Grid& grid, Cell start, Cell goal,
+                                     const SearchOptions& opts);
+};
+
+#endif //CHUNKEDASTAR_H
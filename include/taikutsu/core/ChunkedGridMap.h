@@ -0,0 +1,110 @@
+#ifndef CHUNKEDGRIDMAP_H
+#define CHUNKEDGRIDMAP_H
+
+#include "GridMap.h"
+#include "Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Grid a tile per mondi enormi e quasi vuoti: dove GridMap alloca bit (e costi) per tutta
+// l'area e indicizza con int, qui la memoria segue il dettaglio.
+//
+// Layout: tile kTileSize x kTileSize (64 x 64). Una directory con una voce da 4 byte per tile:
+//   kFreeTile / kBlockedTile -> tile uniforme, nessun payload
+//   altrimenti               -> slot nel pool: 64 word, una per riga (bit x = 1 se libera)
+// Le tile restano canoniche: una modifica che rende una tile uniforme ne libera lo slot,
+// quindi "mista" vuol dire davvero che contiene celle libere e bloccate.
+// Nelle tile di bordo (mappa non multipla di 64) i bit fuori dalla mappa valgono 0.
+//
+// Coordinate int come Cell, indici a 64 bit (index(c) = y * width + x): niente overflow anche
+// oltre 2^31 celle. Nessun layer di costo: ogni cella libera costa 1 (kCostStraight).
+// La ricerca sta in ChunkedAStar.h; window() copia un rettangolo in un GridMap normale per
+// gli algoritmi che vogliono gli indici paddati (JPS, HPA*, FlowField, ...).
+class ChunkedGridMap {
+public:
+    static constexpr int kTileShift = 6;
+    static constexpr int kTileSize = 1 << kTileShift;
+
+    enum class TileState : std::uint8_t { Free, Blocked, Mixed };
+
+    // tutte le tile uniformi (libere o bloccate): solo la directory viene allocata
+    ChunkedGridMap(int width, int height, bool blocked = false);
+    explicit ChunkedGridMap(const GridMap& grid); // stesse celle, tile uniformi riconosciute
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    int tilesX() const { return tilesX_; }
+    int tilesY() const { return tilesY_; }
+
+    bool inBounds(Cell c) const { return c.x >= 0 && c.x < w_ && c.y >= 0 && c.y < h_; }
+    bool isBlocked(Cell c) const { return !isWalkable(c); } // fuori mappa = bloccata
+    bool isWalkable(Cell c) const { return inBounds(c) && walkableAt(c.x, c.y); }
+
+    void setBlocked(Cell c, bool blocked);
+    void toggleBlocked(Cell c);
+    // rettangolo clippato ai bordi; le tile coperte per intero diventano uniformi senza payload
+    void fillRect(Cell min, int w, int h, bool blocked);
+    void clear(bool blocked = false);
+
+    TileState tileState(int tx, int ty) const;
+    TileState tileStateAt(Cell c) const { return tileState(c.x >> kTileShift, c.y >> kTileShift); }
+    size_t mixedTileCount() const { return pool_.size() / kTileSize - freeSlots_.size(); }
+    size_t memoryBytes() const; // directory + pool (capacità)
+
+    // ---- indici a 64 bit ----
+    std::int64_t index(Cell c) const { return static_cast<std::int64_t>(c.y) * w_ + c.x; }
+    Cell cellAt(std::int64_t idx) const { return Cell{static_cast<int>(idx % w_), static_cast<int>(idx / w_)}; }
+    std::int64_t cellCount() const { return static_cast<std::int64_t>(w_) * h_; }
+
+    // ---- mask dei vicini (stesso significato di GridMap, vedi Dir) ----
+    // c deve stare nella mappa. Cella interna a una tile uniforme libera: nessuna lettura
+    // di bit; interna a una tile mista: tre word della stessa tile. Sul bordo della tile:
+    // una lettura della directory per vicino.
+    unsigned walkableMask8(Cell c) const;
+    unsigned walkableMask(Cell c) const { return walkableMask8(c) & 0xFu; }
+    unsigned moveMask8(Cell c, bool cornerCutting = false) const {
+        const unsigned m = walkableMask8(c);
+        const unsigned r = m & 1u, l = (m >> kLeft) & 1u, d = (m >> kDown) & 1u, u = (m >> kUp) & 1u;
+        const unsigned allowed = cornerCutting
+            ? ((r | d) << kDownRight) | ((l | d) << kDownLeft) | ((r | u) << kUpRight) | ((l | u) << kUpLeft)
+            : ((r & d) << kDownRight) | ((l & d) << kDownLeft) | ((r & u) << kUpRight) | ((l & u) << kUpLeft);
+        return (m & 0xFu) | (m & allowed);
+    }
+    std::vector<Cell> neighbors4(Cell c) const;
+
+    // copia del rettangolo [min, min + (w, h)) in un GridMap w x h (fuori mappa = bloccato);
+    // w * h deve stare nei limiti di GridMap::fits
+    GridMap window(Cell min, int w, int h) const;
+
+private:
+    static constexpr std::uint32_t kFreeTile = UINT32_MAX;
+    static constexpr std::uint32_t kBlockedTile = UINT32_MAX - 1;
+
+    size_t tileIndex(int tx, int ty) const {
+        return static_cast<size_t>(ty) * static_cast<size_t>(tilesX_) + static_cast<size_t>(tx);
+    }
+    // nessun bounds check (una tile uniforme libera risponde true anche oltre il bordo)
+    bool walkableAt(int x, int y) const {
+        const std::uint32_t t = dir_[tileIndex(x >> kTileShift, y >> kTileShift)];
+        if (t >= kBlockedTile) return t == kFreeTile;
+        return (pool_[static_cast<size_t>(t) * kTileSize + static_cast<size_t>(y & (kTileSize - 1))] >>
+                (x & (kTileSize - 1))) & 1u;
+    }
+
+    // bit validi della riga ly di una tile (le celle dentro la mappa)
+    std::uint64_t rowMask(int tx) const;
+    int rowsIn(int ty) const;
+
+    std::uint64_t* materialize(size_t tile); // tile uniforme -> slot con le sue righe
+    void release(size_t tile, std::uint32_t state);
+    void collapseIfUniform(int tx, int ty);
+
+    int w_{}, h_{};
+    int tilesX_{}, tilesY_{};
+    std::vector<std::uint32_t> dir_;  // per tile (ty * tilesX + tx): stato uniforme o slot
+    std::vector<std::uint64_t> pool_; // kTileSize word per slot
+    std::vector<std::uint32_t> freeSlots_;
+};
+
+#endif //CHUNKEDGRIDMAP_H
@@ -0,0 +1,69 @@
+#ifndef CONNECTIVITYINDEX_H
+#define CONNECTIVITYINDEX_H
+
+#include "GridMap.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Componenti connesse del grid: un id per cella libera (0 = ostacolo).
+// Le componenti sono quelle a 4 direzioni, e valgono per tutte le opzioni di ricerca:
+// una mossa diagonale (con o senza corner-cutting) richiede almeno una ortogonale libera,
+// quindi non collega mai due componenti a 4 direzioni diverse.
+//
+// Costruzione: scanline sui run di celle libere (64 celle per word) + union-find.
+// Aggiornamento dopo setBlocked/toggleBlocked: chiamare notifyChanged(c).
+//   sblocco -> unione delle componenti vicine (union-find, nessun relabel)
+//   blocco  -> se i vicini restano collegati attorno alla cella non cambia nulla, altrimenti
+//              flood alternato dai vicini: il pezzo staccato (il più piccolo, finisce prima)
+//              riceve un id nuovo
+// Va tenuto allineato al grid: un indice non aggiornato può scartare query valide.
+class ConnectivityIndex {
+public:
+    explicit ConnectivityIndex(const GridMap& grid);
+
+    // forma compatta precalcolata (vedi exportCompact / MapFile.h): nessun flood, solo copia.
+    // labels: id per cella (y * width + x, 0 = ostacolo); sizes[id] = celle della componente
+    ConnectivityIndex(const GridMap& grid, std::span<const std::uint32_t> labels,
+                      std::span<const std::uint32_t> sizes);
+
+    // id compatti 1..componentCount() per cella e dimensioni per id (sizes[0] = 0)
+    void exportCompact(std::vector<std::uint32_t>& labels, std::vector<std::uint32_t>& sizes) const;
+
+    void rebuild();             // da zero (id compatti 1..componentCount())
+    void notifyChanged(Cell c); // c è appena stato bloccato/sbloccato
+
+    // id della componente di c (0 se bloccato o fuori dal grid); union by size: pochi salti
+    std::uint32_t component(Cell c) const;
+    bool connected(Cell a, Cell b) const {
+        const std::uint32_t ca = component(a);
+        return ca != 0 && ca == component(b);
+    }
+
+    size_t componentCount() const { return components_; }
+
+private:
+    size_t cellIndex(Cell c) const {
+        return static_cast<size_t>(c.y) * static_cast<size_t>(w_) + static_cast<size_t>(c.x);
+    }
+    std::uint32_t newId(std::uint32_t size);
+    std::uint32_t find(std::uint32_t id) const;
+    std::uint32_t findCompress(std::uint32_t id);
+    std::uint32_t unite(std::uint32_t a, std::uint32_t b);
+    void onBlocked(Cell c);
+    void onUnblocked(Cell c);
+
+    const GridMap* grid_;
+    int w_{0}, h_{0};
+    std::vector<std::uint32_t> label_;  // per cella (y * w + x), 0 = ostacolo
+    std::vector<std::uint32_t> parent_; // union-find sugli id; parent_[0] = 0
+    std::vector<std::uint32_t> size_;   // celle per radice
+    size_t components_{0};
+
+    // scratch del flood alternato (stamp per non azzerare)
+    std::vector<std::uint32_t> seen_;
+    std::vector<std::uint8_t> owner_;
+    std::uint32_t stamp_{0};
+};
+
+#endif //CONNECTIVITYINDEX_H
@@ -0,0 +1,158 @@
+#ifndef COOPERATIVEPLANNER_H
+#define COOPERATIVEPLANNER_H
+
+#include "AStarSearchContext.h"
+#include "FlatHashMap.h"
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct CooperativeOptions {
+    // regole delle mosse e dei costi, come SearchOptions
+    Connectivity connectivity{Connectivity::Four};
+    bool cornerCutting{false};
+    bool useTerrainCost{true};
+    int window{16};                  // passi pianificati con le prenotazioni (la w di WHCA*)
+    size_t maxExpansions{4096};      // nodi spazio-tempo per agente, poi attesa sul posto
+    size_t heuristicGoals{4096};     // goal con le distanze vere in cache (LRU)
+    // l'ultima cella di ogni piano resta prenotata anche dopo la fine del piano (vedi sotto)
+    bool holdPlanEnd{true};
+};
+
+struct CooperativeTickStats {
+    size_t planned{0};            // agenti ripianificati da questo plan()
+    size_t deferred{0};           // da ripianificare ma fuori budget: i primi del prossimo plan()
+    size_t failed{0};             // nessun percorso nella finestra: attesa sul posto
+    size_t expanded{0};           // nodi spazio-tempo
+    size_t heuristicExpanded{0};  // nodi delle ricerche all'indietro per le distanze vere
+};
+
+// Pianificazione cooperativa (Windowed Hierarchical Cooperative A*, Silver 2005) per molti
+// agenti sullo stesso GridMap. Ogni agente cerca in spazio-tempo (cella, tick) per window passi,
+// con l'attesa sul posto come mossa in più, evitando le celle prenotate dagli agenti pianificati
+// prima di lui; poi prenota le sue. Oltre la finestra conta solo la distanza vera dal goal,
+// che fa da euristica e da costo residuo.
+//
+//   - prenotazioni: FlatHashMap64 (tick << 32 | cella) -> agente, sempre e solo quelle future
+//     (advance() cancella quelle del tick lasciato). Vietati i conflitti di vertice (stessa
+//     cella nello stesso tick) e gli scambi (due agenti che si attraversano sullo stesso arco).
+//     Con holdPlanEnd l'ultima cella di ogni piano resta dell'agente anche dopo la fine del
+//     piano, finché non si ripianifica (sosta): chi resta senza piano per il budget è un
+//     ostacolo già noto a tutti, non un conflitto. Senza, la sosta vale solo da quando il piano
+//     è finito: più flusso nella folla (meno celle vietate in fondo alle finestre), ma un agente
+//     rimandato oltre la fine del suo piano può trovarsi addosso chi aveva già prenotato.
+//   - distanze vere: per goal una ricerca all'indietro riprendibile (RRA*): si espande dal goal
+//     solo finché la cella chiesta non è chiusa, e il lavoro resta per le richieste successive
+//     (anche di altri agenti con lo stesso goal). Tabelle sparse (hash), LRU su heuristicGoals.
+//   - ripianificazione: un agente si ripianifica quando gli restano <= window / 2 passi, o ha un
+//     goal nuovo. L'ordine di priorità ruota da un plan() all'altro; con un budget di tempo gli
+//     agenti rimasti restano sul piano prenotato e vengono per primi al plan() successivo.
+//
+// Uso per tick: plan(budget) e poi advance(). Il grid deve restare vivo; se cambia (version())
+// le distanze vengono ricalcolate e tutti gli agenti ripianificati. Non thread-safe: un planner
+// per mondo, usato da un thread alla volta.
+class CooperativePlanner {
+public:
+    static constexpr int kNoAgent = -1;
+    static constexpr int kUnreachable = 0x3fffffff;
+
+    explicit CooperativePlanner(const GridMap& grid, const CooperativeOptions& opts = {});
+
+    // nuovo agente in una cella libera (non bloccata e senza altri agenti), altrimenti kNoAgent
+    int addAgent(Cell position, Cell goal);
+    void setGoal(int agent, Cell goal);
+
+    size_t agentCount() const { return agents_.size(); }
+    std::uint32_t tick() const { return tick_; }
+    Cell position(int agent) const { return grid_->cellAt(agents_[static_cast<size_t>(agent)].pos); }
+    Cell goal(int agent) const { return grid_->cellAt(agents_[static_cast<size_t>(agent)].goal); }
+    bool atGoal(int agent) const { return agents_[static_cast<size_t>(agent)].pos == agents_[static_cast<size_t>(agent)].goal; }
+    // celle prenotate dal tick corrente in poi (la prima è la posizione attuale)
+    std::vector<Cell> plannedPath(int agent) const;
+
+    // ripianifica gli agenti che ne hanno bisogno, finché non scade budget (controllato dopo
+    // ogni agente, quindi almeno uno viene sempre pianificato)
+    CooperativeTickStats plan(std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+    // tutti avanzano di un tick sul loro piano (o restano fermi se è finito); ritorna i conflitti
+    // del passo (vedi countConflicts): 0 se tutti i piani sono stati fatti con le prenotazioni
+    size_t advance();
+
+    // distanza vera (fixed-point) da c al goal con le regole di opts, kUnreachable se non c'è
+    int trueDistance(Cell c, Cell goal);
+    size_t cachedGoals() const { return goalIndex_.size(); }
+    size_t reservationCount() const { return reservations_.size(); } // (tick, cella), soste escluse
+
+private:
+    struct Agent {
+        int pos;
+        int goal;
+        std::uint32_t planStart{0}; // plan[k] = cella al tick planStart + k
+        std::vector<int> plan;
+        bool dirty{true};           // da ripianificare (nuovo agente o nuovo goal)
+    };
+
+    // ricerca all'indietro riprendibile verso un goal: g + bit "chiusa" per cella, open list
+    // ordinata su g + distanza (octile/manhattan) dalla prima cella chiesta
+    struct GoalDistances {
+        int goal{-1};
+        Cell origin{};
+        FlatHashMap64 g{1024}; // cella -> g << 1 | chiusa
+        std::vector<AStarSearchContext::OpenEntry> open;
+        std::uint64_t lastUse{0};
+    };
+
+    // nodo della ricerca spazio-tempo (t relativo all'inizio del piano)
+    struct Node {
+        int idx;
+        int t;
+        int g;
+        int parent;
+    };
+
+    static std::uint64_t key(std::uint32_t tick, int idx) {
+        return static_cast<std::uint64_t>(tick) << 32 | static_cast<std::uint32_t>(idx);
+    }
+
+    static std::uint32_t planEnd(const Agent& a) { return a.planStart + static_cast<std::uint32_t>(a.plan.size()) - 1; }
+    bool needsPlan(const Agent& a) const;
+    void planAgent(std::uint32_t id, CooperativeTickStats& stats);
+    void releaseFuture(std::uint32_t id);
+    void reservePlan(std::uint32_t id);
+    bool reservedByOther(std::uint32_t tick, int idx, std::uint32_t id) const;
+    unsigned moves(int idx) const;
+    int stepCost(int d, int to) const;
+    int estimate(int from, Cell to) const;
+    GoalDistances& distancesFor(int goal, int origin);
+    int distance(GoalDistances& gd, int idx, size_t& expanded);
+    void syncWithGrid();
+
+    const GridMap* grid_;
+    CooperativeOptions opts_;
+    std::uint64_t epoch_{0}, version_{0};
+    std::uint32_t tick_{0};
+    std::uint32_t cursor_{0}; // primo agente del prossimo giro di priorità
+
+    std::vector<Agent> agents_;
+    FlatHashMap64 reservations_;
+    FlatHashMap64 parked_; // cella -> agente fermo lì dalla fine del suo piano in poi
+
+    std::vector<GoalDistances> goals_;
+    std::unordered_map<int, std::uint32_t> goalIndex_; // goal -> slot in goals_
+    std::uint64_t useCounter_{0};
+
+    // scratch della ricerca spazio-tempo
+    std::vector<Node> nodes_;
+    std::vector<AStarSearchContext::OpenEntry> open_; // idx = nodo in nodes_
+    FlatHashMap64 visited_;                          // (t, cella) -> nodo
+};
+
+// conflitti tra due posizioni consecutive degli stessi agenti (from[i] -> to[i]): agenti in più
+// nella stessa cella di arrivo, più le coppie che si scambiano di posto
+size_t countConflicts(const GridMap& grid, std::span<const Cell> from, std::span<const Cell> to);
+
+#endif //COOPERATIVEPLANNER_H
@@ -0,0 +1,80 @@
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+
+#include "AStarSearchContext.h" // AStarResult
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Ripianificazione incrementale (D* Lite, Koenig & Likhachev).
+// La ricerca va all'indietro dal goal: g(s) = costo da s al goal. Lo stato resta nell'oggetto
+// tra una chiamata e l'altra; dopo una modifica del grid si passano le celle cambiate e
+// vengono ri-espanse solo quelle la cui distanza dal goal è cambiata e serve al percorso.
+// Anche lo start può spostarsi (agente in movimento) senza ripartire da zero.
+//
+// Il risultato ha lo stesso formato di AStarResult: closed = celle espanse nell'ultima
+// chiamata (dopo una replan() di solito poche). Il costo è lo stesso di A* sul grid attuale.
+class DStarLitePathfinder {
+public:
+    explicit DStarLitePathfinder(const GridMap& grid, const SearchOptions& opts = {});
+
+    // nuova coppia start/goal: stato azzerato (O(1), stamp di generazione)
+    const AStarResult& plan(Cell start, Cell goal);
+
+    // l'agente si è spostato in start, stesso goal
+    const AStarResult& moveStart(Cell start);
+
+    // celle modificate nel grid (ostacoli o costi) dall'ultima chiamata
+    const AStarResult& replan(std::span<const Cell> changed);
+
+    const AStarResult& result() const { return result_; }
+    size_t lastExpanded() const { return result_.closed.size(); }
+
+private:
+    static constexpr int kInf = 0x3fffffff;
+
+    // chiave di D* Lite: [min(g, rhs) + h + km, min(g, rhs)], ordine lessicografico
+    struct Entry {
+        int k1, k2, idx;
+    };
+    struct Cmp { // min-heap sopra std::push_heap
+        bool operator()(const Entry& a, const Entry& b) const { return a.k1 > b.k1 || (a.k1 == b.k1 && a.k2 > b.k2); }
+    };
+
+    int g(int idx) const { return stamp_[static_cast<size_t>(idx)] == gen_ ? g_[static_cast<size_t>(idx)] : kInf; }
+    int rhs(int idx) const { return stamp_[static_cast<size_t>(idx)] == gen_ ? rhs_[static_cast<size_t>(idx)] : kInf; }
+    void set(int idx, int g, int rhs);
+
+    unsigned moves(int idx) const;
+    int stepCost(int d, int toIdx) const;
+    int heuristic(int idx) const; // da start a idx
+    Entry key(int idx) const;
+    void updateVertex(int idx);
+    void computeShortestPath();
+    void extractPath();
+    void ensureSize();
+
+    const GridMap* grid_;
+    SearchOptions opts_;
+    bool eight_{false};
+    bool weighted_{false};
+
+    int stride_{0}, h_{0};
+    Cell startCell_{}, goalCell_{}; // ultima query (anche se fallita)
+    bool hasQuery_{false};
+    bool planned_{false};           // start/goal validi, stato utilizzabile
+    int start_{-1}, goal_{-1};
+    int km_{0};
+
+    // stato per indice paddato, valido solo con stamp_ == gen_ (altrimenti g = rhs = inf)
+    std::vector<int> g_, rhs_;
+    std::vector<std::uint32_t> stamp_;
+    std::uint32_t gen_{0};
+    std::vector<Entry> open_; // lazy: voci vecchie scartate all'estrazione
+
+    AStarResult result_;
+};
+
+#endif //DSTARLITE_H
@@ -0,0 +1,116 @@
+#ifndef FLATHASHMAP_H
+#define FLATHASHMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tabella hash piatta uint64 -> uint32 (open addressing, probing lineare, capacità potenza di 2,
+// carico massimo 1/2). Un solo array di slot da 16 byte: niente nodi allocati, clear() riusa
+// la memoria. erase() con backward shift, quindi nessuna tombstone: le tabelle con molti
+// inserimenti e cancellazioni (prenotazioni spazio-tempo) non degradano.
+// La chiave ~0 è riservata (slot vuoto).
+class FlatHashMap64 {
+public:
+    static constexpr std::uint64_t kEmptyKey = ~std::uint64_t{0};
+
+    explicit FlatHashMap64(size_t initialCapacity = 16) { rehash(initialCapacity); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t memoryBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+    // puntatore al valore (nullptr se assente); valido fino al prossimo insert/erase
+    const std::uint32_t* find(std::uint64_t key) const {
+        for (size_t i = home(key);; i = (i + 1) & mask_) {
+            if (slots_[i].key == key) return &slots_[i].value;
+            if (slots_[i].key == kEmptyKey) return nullptr;
+        }
+    }
+    std::uint32_t* find(std::uint64_t key) {
+        return const_cast<std::uint32_t*>(static_cast<const FlatHashMap64*>(this)->find(key));
+    }
+
+    // inserisce key -> value se assente; ritorna false (e lascia il valore) se c'è già
+    bool insert(std::uint64_t key, std::uint32_t value) {
+        if (2 * (size_ + 1) > slots_.size()) rehash(2 * slots_.size());
+        size_t i = home(key);
+        for (; slots_[i].key != kEmptyKey; i = (i + 1) & mask_)
+            if (slots_[i].key == key) return false;
+        slots_[i] = {key, value};
+        ++size_;
+        return true;
+    }
+
+    // riferimento al valore di key, inserito con value se assente (un solo giro di probing)
+    std::uint32_t& findOrInsert(std::uint64_t key, std::uint32_t value) {
+        if (2 * (size_ + 1) > slots_.size()) rehash(2 * slots_.size());
+        size_t i = home(key);
+        for (; slots_[i].key != kEmptyKey; i = (i + 1) & mask_)
+            if (slots_[i].key == key) return slots_[i].value;
+        slots_[i] = {key, value};
+        ++size_;
+        return slots_[i].value;
+    }
+
+    bool erase(std::uint64_t key) {
+        size_t i = home(key);
+        while (slots_[i].key != key) {
+            if (slots_[i].key == kEmptyKey) return false;
+            i = (i + 1) & mask_;
+        }
+        // backward shift: riporta indietro gli slot successivi della stessa catena
+        for (size_t j = (i + 1) & mask_; slots_[j].key != kEmptyKey; j = (j + 1) & mask_) {
+            const size_t h = home(slots_[j].key);
+            // j può andare in i solo se la sua posizione di casa non sta in (i, j] (circolare)
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i].key = kEmptyKey;
+        --size_;
+        return true;
+    }
+
+    void clear() {
+        if (size_ == 0) return;
+        for (Slot& s : slots_) s.key = kEmptyKey;
+        size_ = 0;
+    }
+
+    template <class F> void forEach(F&& f) const {
+        for (const Slot& s : slots_)
+            if (s.key != kEmptyKey) f(s.key, s.value);
+    }
+
+private:
+    struct Slot {
+        std::uint64_t key{kEmptyKey};
+        std::uint32_t value{0};
+    };
+
+    size_t home(std::uint64_t key) const {
+        key ^= key >> 33; // mix di murmur3 (fmix64): chiavi (tempo, cella) vicine finiscono lontane
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<size_t>(key) & mask_;
+    }
+
+    void rehash(size_t capacity) {
+        size_t n = 16;
+        while (n < capacity) n *= 2;
+        std::vector<Slot> old(n);
+        old.swap(slots_);
+        mask_ = n - 1;
+        size_ = 0;
+        for (const Slot& s : old)
+            if (s.key != kEmptyKey) insert(s.key, s.value);
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_{0};
+    size_t size_{0};
+};
+
+#endif //FLATHASHMAP_H
@@ -0,0 +1,115 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+// Flow field (Dijkstra map): distanza di ogni cella dal goal più vicino e direzione del
+// passo successivo, per molti agenti con lo stesso obiettivo. Una ricerca per tutti,
+// poi ogni agente legge direction()/next() della sua cella: un accesso ad array.
+//
+// Costruzione all'indietro dai goal (anche più di uno) con le stesse regole di A*:
+//   4 direzioni a costo unitario -> wavefront bit-parallelo (64 celle per word, un'onda per passo)
+//   8 direzioni o terreno        -> Dijkstra con i bucket di Dial (costi interi limitati)
+// Distanze in fixed-point come AStarResult::cost.
+class FlowField {
+public:
+    static constexpr std::uint8_t kNoDir = 0xFF;              // goal o cella irraggiungibile
+    static constexpr std::uint32_t kUnreachable = 0xFFFFFFFFu;
+
+    // ricalcola il campo verso goals (celle bloccate/fuori dal grid ignorate); riusa la memoria
+    void build(const GridMap& grid, std::span<const Cell> goals, const SearchOptions& opts = {});
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    bool reachable(Cell c) const { return inside(c) && dist_[cellIndex(c)] != kUnreachable; }
+    std::uint32_t distance(Cell c) const { return inside(c) ? dist_[cellIndex(c)] : kUnreachable; }
+    std::span<const std::uint32_t> distances() const { return dist_; } // per cella (y * width + x)
+    std::uint8_t direction(Cell c) const { return inside(c) ? dir_[cellIndex(c)] : kNoDir; } // Dir
+    // cella successiva verso il goal (c stessa se è un goal o è irraggiungibile)
+    Cell next(Cell c) const {
+        const std::uint8_t d = direction(c);
+        return d == kNoDir ? c : Cell{c.x + kDirDx[d], c.y + kDirDy[d]};
+    }
+
+private:
+    bool inside(Cell c) const { return c.x >= 0 && c.y >= 0 && c.x < w_ && c.y < h_; }
+    size_t cellIndex(Cell c) const {
+        return static_cast<size_t>(c.y) * static_cast<size_t>(w_) + static_cast<size_t>(c.x);
+    }
+
+    void buildWavefront(const GridMap& grid, std::span<const Cell> goals);
+    void buildDial(const GridMap& grid, std::span<const Cell> goals, bool eight, bool cornerCutting, bool weighted);
+
+    int w_{0}, h_{0};
+    std::vector<std::uint32_t> dist_; // per cella (y * w + x)
+    std::vector<std::uint8_t> dir_;
+
+    // scratch: bitset paddati come GridMap (wavefront), bucket circolari (Dial)
+    std::vector<std::uint64_t> visited_, frontier_, next_;
+    std::vector<std::vector<int>> buckets_;
+};
+
+// Flow field condiviso tra thread: i lettori prendono il campo corrente (copia di uno
+// shared_ptr, sezione critica di pochi ns) e lo usano finché vogliono; una ricostruzione
+// lavora su un altro buffer e lo pubblica solo a lavoro finito, quindi il campo precedente
+// resta leggibile nel frattempo.
+class SharedFlowField {
+public:
+    SharedFlowField() = default;
+    ~SharedFlowField() { wait(); }
+
+    SharedFlowField(const SharedFlowField&) = delete;
+    SharedFlowField& operator=(const SharedFlowField&) = delete;
+
+    // campo corrente (nullptr prima della prima build)
+    std::shared_ptr<const FlowField> current() const {
+        std::lock_guard<std::mutex> lk(currentMutex_);
+        return current_;
+    }
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); } // campi pubblicati
+
+    // ricostruzione nel thread chiamante
+    void rebuild(const GridMap& grid, std::span<const Cell> goals, const SearchOptions& opts = {});
+
+    // ricostruzione su un worker del pool, su una copia del grid (il chiamante può continuare a modificarlo).
+    // Vince l'ultima richiesta: una ricostruzione superata da una più recente non viene pubblicata.
+    void rebuildAsync(ThreadPool& pool, const GridMap& grid, std::vector<Cell> goals, const SearchOptions& opts = {});
+
+    // attende le ricostruzioni asincrone in corso
+    void wait();
+
+private:
+    std::unique_ptr<FlowField> acquireBuffer();
+    void build(std::uint64_t seq, const GridMap& grid, std::span<const Cell> goals, const SearchOptions& opts);
+
+    mutable std::mutex currentMutex_; // protegge solo lo scambio del puntatore
+    std::shared_ptr<const FlowField> current_;
+    std::atomic<std::uint64_t> version_{0};
+    std::atomic<std::uint64_t> requested_{0}; // numero d'ordine dell'ultima richiesta
+
+    // Il campo sostituito torna qui dal deleter di chi lo rilascia per ultimo (lettore o
+    // scrittore), sotto il mutex: la build successiva lo riprende solo dopo quell'ultimo accesso.
+    struct Spare {
+        std::mutex m;
+        std::unique_ptr<FlowField> field;
+    };
+
+    std::mutex buildMutex_; // una ricostruzione alla volta, pubblicate in ordine
+    std::shared_ptr<Spare> spare_ = std::make_shared<Spare>(); // condiviso coi deleter: può sopravvivere all'oggetto
+
+    std::mutex pendingMutex_;
+    std::condition_variable pendingDone_;
+    int pending_{0};
+};
+
+#endif //FLOWFIELD_H
@@ -3,13 +3,39 @@
 
 
 #include "Types.h" //cell (x,y)
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 //Qui rappresentiamo il nostro gridmap
+//
+// Layout: un bit per cella (1 = walkable, 0 = obstacle), righe paddate a multipli
+// di 64 bit e una cornice "sentinella" di celle bloccate tutto intorno
+// (una colonna a sinistra, una riga sopra e una sotto; a destra c'è sempre
+// almeno un bit di padding, che vale 0). Grazie alla cornice i vicini di una
+// cella interna si leggono senza controlli di bounds.
+//
+// index(c) = (c.y + 1) * stride + (c.x + 1)  -> indice "paddato" usato anche da A*
+//
+// I bit (e il layer di costo) di solito stanno nei vector del GridMap; un GridMap "preso in
+// prestito" invece legge memoria di altri (file mappato, vedi GridMapView in MapFile.h) ed
+// esiste solo come const. Una copia è sempre un GridMap normale, modificabile.
 class GridMap {
 public:
     GridMap(int width, int height); //larghezza x altezza dell'intero grid (ctor)
 
+    // gli indici paddati sono int: (height + 2) * stride deve stare in INT_MAX (~2^31 celle,
+    // per esempio 46000 x 46000). I loader controllano con fits(); per mondi più grandi
+    // (e quasi vuoti) c'è ChunkedGridMap.
+    static bool fits(int width, int height);
+
+    // copia profonda (anche da un grid in prestito); lo spostamento tiene i puntatori
+    // (buffer dei vector o memoria esterna non si muovono)
+    GridMap(const GridMap& other);
+    GridMap& operator=(const GridMap& other);
+    GridMap(GridMap&&) = default;
+    GridMap& operator=(GridMap&&) = default;
+
     //getters
     int width() const { return w_; }
     int height() const { return h_; }
@@ -17,28 +43,162 @@ public:
     //controlli logici
     bool inBounds(Cell c) const;
     bool isBlocked(Cell c) const;
-    bool isWalkable(Cell c) const { return inBounds(c) && !isBlocked(c); }
+    bool isWalkable(Cell c) const { return inBounds(c) && walkable(index(c)); }
 
     //modifica stato griglia
     void setBlocked(Cell c, bool blocked);
     void toggleBlocked(Cell c);
 
+    // operazioni "bulk", lavorano una word (64 celle) alla volta
+    // rettangolo [min.x, min.x+w) x [min.y, min.y+h), clippato ai bordi
+    void fillRect(Cell min, int w, int h, bool blocked);
+    void clear(); // tutte le celle libere e a costo 1
+    // copia il rettangolo di src che parte da srcMin in questo grid a partire da dstMin
+    void copyRegion(const GridMap& src, Cell srcMin, int w, int h, Cell dstMin);
+
+    // ---- layer di costo del terreno (uint8 per cella, 1..255) ----
+    // Finché nessuna cella ha costo != 1 il layer non viene allocato (hasCosts() == false)
+    // e A* usa il percorso veloce a costo unitario.
+    bool hasCosts() const { return costData_ != nullptr; }
+    std::uint8_t cost(Cell c) const;
+    void setCost(Cell c, std::uint8_t cost); // 0 viene trattato come 1
+    void clearCosts(); // tutte le celle tornano a costo 1
+    const std::uint8_t* costs() const { return costData_; } // indicizzato con index(), nullptr se assente
+
+    // ---- versioni per regione (invalidazione delle cache, vedi PathCache) ----
+    // Il grid è diviso in regioni kRegionSize x kRegionSize; ogni modifica effettiva incrementa
+    // version() e lo scrive nelle regioni toccate. "relax" = modifiche che possono accorciare
+    // un percorso (sblocco, costo minore). Le versioni valgono solo a parità di epoch():
+    // l'epoch cambia ad ogni costruzione/copia/assegnazione del GridMap.
+    static constexpr int kRegionShift = 5;
+    static constexpr int kRegionSize = 1 << kRegionShift;
+    int regionsX() const { return regionsX_; }
+    int regionsY() const { return regionsY_; }
+    int regionOf(Cell c) const { return (c.y >> kRegionShift) * regionsX_ + (c.x >> kRegionShift); }
+    std::uint64_t epoch() const { return epoch_.value; }
+    std::uint64_t version() const { return version_; } // ultima modifica
+    std::uint64_t relaxVersion() const { return relaxVersion_; }
+    std::uint64_t regionVersion(int r) const { return regionVersion_[static_cast<size_t>(r)]; }
+    std::uint64_t regionRelaxVersion(int r) const { return regionRelax_[static_cast<size_t>(r)]; }
+
     // Para o A*: retorna os vizinhos em 4 direções (apenas walkable)
+    // (comodo ma alloca; nel loop di A* usare neighborMask/walkableMask)
     std::vector<Cell> neighbors4(Cell c) const;
 
+    // ---- accesso per indice paddato (nessun bounds check) ----
+    int stride() const { return stride_; } // celle per riga paddata
+    int index(Cell c) const { return (c.y + 1) * stride_ + (c.x + 1); }
+    Cell cellAt(int idx) const { return Cell{idx % stride_ - 1, idx / stride_ - 1}; }
+    size_t indexCount() const { return wordCount_ * 64; } // dimensione per array indicizzati con index()
+
+    bool walkable(int idx) const {
+        const auto i = static_cast<size_t>(idx);
+        return (words_[i >> 6] >> (i & 63)) & 1u;
+    }
+
+    // mask dei vicini walkable in 4 direzioni: bit d (vedi Dir) = 1 se idx + offset(d) è libero.
+    // idx deve essere una cella interna (la cornice garantisce che i vicini esistono)
+    unsigned walkableMask(int idx) const {
+        return  static_cast<unsigned>(walkable(idx + 1))
+             | (static_cast<unsigned>(walkable(idx - 1)) << kLeft)
+             | (static_cast<unsigned>(walkable(idx + stride_)) << kDown)
+             | (static_cast<unsigned>(walkable(idx - stride_)) << kUp);
+    }
+
+    // come walkableMask ma con le 8 direzioni (bit 4..7 = diagonali, senza regole di corner-cutting)
+    unsigned walkableMask8(int idx) const {
+        return walkableMask(idx)
+             | (static_cast<unsigned>(walkable(idx + stride_ + 1)) << kDownRight)
+             | (static_cast<unsigned>(walkable(idx + stride_ - 1)) << kDownLeft)
+             | (static_cast<unsigned>(walkable(idx - stride_ + 1)) << kUpRight)
+             | (static_cast<unsigned>(walkable(idx - stride_ - 1)) << kUpLeft);
+    }
+
+    // mask delle mosse valide in 8 direzioni con le regole sugli angoli:
+    // cornerCutting=false -> diagonale solo se entrambe le celle ortogonali adiacenti sono libere
+    // cornerCutting=true  -> basta una delle due (mai passare "in mezzo" a due ostacoli in diagonale)
+    unsigned moveMask8(int idx, bool cornerCutting = false) const {
+        const unsigned m = walkableMask8(idx);
+        const unsigned r = m & 1u, l = (m >> kLeft) & 1u, d = (m >> kDown) & 1u, u = (m >> kUp) & 1u;
+        const unsigned allowed = cornerCutting
+            ? ((r | d) << kDownRight) | ((l | d) << kDownLeft) | ((r | u) << kUpRight) | ((l | u) << kUpLeft)
+            : ((r & d) << kDownRight) | ((l & d) << kDownLeft) | ((r & u) << kUpRight) | ((l & u) << kUpLeft);
+        return (m & 0xFu) | (m & allowed);
+    }
+
+    unsigned neighborMask(Cell c) const { return walkableMask(index(c)); }
+
+    // offset di indice per ogni Dir (idx + offset(d) = vicino in direzione d)
+    int offset(int dir) const { return kDirDy[dir] * stride_ + kDirDx[dir]; }
+
+    // accesso diretto alle word (riga r paddata = words() + r * wordsPerRow())
+    const std::uint64_t* words() const { return words_; }
+    int wordsPerRow() const { return wordsPerRow_; }
+    size_t wordCount() const { return wordCount_; } // (height + 2) * wordsPerRow
+
 private:
+    friend class GridMapView;
+
+    // in prestito: words (wordCount() word, layout qui sopra) e costs (indexCount() byte o
+    // nullptr) restano di chi li fornisce e devono sopravvivere al GridMap
+    GridMap(int width, int height, const std::uint64_t* words, const std::uint8_t* costs);
+
+    // words_/costData_ sui vector propri (dopo ogni cambio di cost_)
+    void bindStorage() {
+        words_ = bits_.data();
+        costData_ = cost_.empty() ? nullptr : cost_.data();
+    }
+
     //dimensioni del grid
     int w_{};
     int h_{};
+    int wordsPerRow_{}; // word da 64 bit per riga paddata
+    int stride_{};      // wordsPerRow_ * 64
+    size_t wordCount_{};
+
+    // (h_ + 2) righe * wordsPerRow_ word; bit = 1 -> cella libera (vuoto se in prestito)
+    std::vector<std::uint64_t> bits_;
+
+    // costo di ingresso per cella (indice paddato), vuoto = tutte a costo 1
+    std::vector<std::uint8_t> cost_;
+
+    // dati letti dal pathfinding: i vector qui sopra o la memoria in prestito
+    const std::uint64_t* words_{nullptr};
+    const std::uint8_t* costData_{nullptr};
+
+    // identità del contenuto: valore nuovo (contatore globale) ad ogni costruzione e
+    // assegnazione, così un grid riassegnato non sembra mai "lo stesso" a una cache
+    struct Epoch {
+        Epoch() : value(next()) {}
+        Epoch(const Epoch&) : value(next()) {}
+        Epoch& operator=(const Epoch&) {
+            value = next();
+            return *this;
+        }
+        static std::uint64_t next();
+        std::uint64_t value;
+    };
+
+    // versione dell'ultima modifica per regione (y / kRegionSize * regionsX_ + x / kRegionSize)
+    int regionsX_{}, regionsY_{};
+    std::vector<std::uint64_t> regionVersion_, regionRelax_;
+    std::uint64_t version_{0}, relaxVersion_{0};
+    Epoch epoch_;
 
-    // Armazenamento 1D: blocked_[idx] diz se a célula é obstáculo.
-    std::vector<bool> blocked_; // true=obstacle, false=libero (blocked tem tamanho w_ * h_)
+    // registra una modifica nelle regioni del rettangolo di celle [x0, x1) x [y0, y1)
+    void touchRegions(int x0, int y0, int x1, int y1, bool relax);
+    // caso di una sola cella (setBlocked/toggleBlocked/setCost)
+    void touchCell(Cell c, bool relax) {
+        const auto r = static_cast<size_t>(regionOf(c));
+        regionVersion_[r] = ++version_;
+        if (relax) {
+            regionRelax_[r] = version_;
+            relaxVersion_ = version_;
+        }
+    }
 
-    //idx = y * width + x
-    // cada valor inteiro (1D) desse corresponde a uma dupla de células (x,y)
-    // ex. blocked_ [13] = (3,2) -> idx=2*5+3 com (w_=5)
-    //transforma coordinate 2d in indice 1d
-    int idx(Cell c) const { return c.y * w_ + c.x; }
+    // scrive "value" nei bit [bit, bit + n) della riga row, word-at-a-time
+    void fillBits(int row, int bit, int n, bool value);
 };
 
 #endif // GRIDMAP_H
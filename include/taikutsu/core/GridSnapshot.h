@@ -0,0 +1,155 @@
+#ifndef GRIDSNAPSHOT_H
+#define GRIDSNAPSHOT_H
+
+#include "ChunkedGridMap.h"
+#include "GridMap.h"
+#include "Types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Tile 64 x 64 di una versione del grid: una word per riga (bit x = 1 se libera), bit fuori
+// dalla mappa a 0. Una volta pubblicata non cambia più: le versioni successive che non la
+// toccano la condividono.
+struct GridTile {
+    std::uint64_t rows[ChunkedGridMap::kTileSize];
+};
+
+// Versione immutabile del grid (solo blocchi, costi unitari come ChunkedGridMap), a tile
+// condivise tra versioni. Si ottiene da VersionedGrid::snapshot() e si legge da qualsiasi
+// thread senza lock: niente in uno snapshot cambia dopo la pubblicazione.
+//
+// Stessa interfaccia di lettura di ChunkedGridMap (indici a 64 bit, mask dei vicini), quindi
+// ChunkedAStar::findPath cerca direttamente su uno snapshot.
+class GridSnapshot {
+public:
+    static constexpr int kTileShift = ChunkedGridMap::kTileShift;
+    static constexpr int kTileSize = ChunkedGridMap::kTileSize;
+    using TileState = ChunkedGridMap::TileState;
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    int tilesX() const { return tilesX_; }
+    int tilesY() const { return tilesY_; }
+    std::uint64_t version() const { return version_; } // 0 = stato iniziale, +1 per publish()
+
+    bool inBounds(Cell c) const { return c.x >= 0 && c.x < w_ && c.y >= 0 && c.y < h_; }
+    bool isBlocked(Cell c) const { return !isWalkable(c); } // fuori mappa = bloccata
+    bool isWalkable(Cell c) const { return inBounds(c) && walkableAt(c.x, c.y); }
+
+    TileState tileState(int tx, int ty) const;
+    // true se la tile (tx, ty) è la stessa in memoria nei due snapshot (uniformi comprese)
+    bool sharesTile(const GridSnapshot& other, int tx, int ty) const {
+        return tileAt(tx, ty) == other.tileAt(tx, ty);
+    }
+    size_t mixedTileCount() const;
+
+    // ---- indici a 64 bit e mask dei vicini, come ChunkedGridMap ----
+    std::int64_t index(Cell c) const { return static_cast<std::int64_t>(c.y) * w_ + c.x; }
+    Cell cellAt(std::int64_t idx) const { return Cell{static_cast<int>(idx % w_), static_cast<int>(idx / w_)}; }
+    std::int64_t cellCount() const { return static_cast<std::int64_t>(w_) * h_; }
+
+    unsigned walkableMask8(Cell c) const;
+    unsigned walkableMask(Cell c) const { return walkableMask8(c) & 0xFu; }
+    unsigned moveMask8(Cell c, bool cornerCutting = false) const {
+        const unsigned m = walkableMask8(c);
+        const unsigned r = m & 1u, l = (m >> kLeft) & 1u, d = (m >> kDown) & 1u, u = (m >> kUp) & 1u;
+        const unsigned allowed = cornerCutting
+            ? ((r | d) << kDownRight) | ((l | d) << kDownLeft) | ((r | u) << kUpRight) | ((l | u) << kUpLeft)
+            : ((r & d) << kDownRight) | ((l & d) << kDownLeft) | ((r & u) << kUpRight) | ((l & u) << kUpLeft);
+        return (m & 0xFu) | (m & allowed);
+    }
+
+private:
+    friend class VersionedGrid;
+
+    // Directory a due livelli: una riga di tile possiede le sue tile miste (uniformi =
+    // shared_ptr vuoto) e ne tiene la vista per la lettura. Condivisa tra le versioni finché
+    // nessuna sua tile cambia: publish() copia solo rows_ (un puntatore per riga di tile) e
+    // rifà le righe toccate, mai tutta la directory.
+    struct TileRow {
+        std::vector<std::shared_ptr<const GridTile>> owned;
+        // per tx: nullptr = tile libera, il blocco condiviso = bloccata, altrimenti owned[tx]
+        std::vector<const GridTile*> tiles;
+    };
+
+    const GridTile* tileAt(int tx, int ty) const { return rows_[static_cast<size_t>(ty)]->tiles[static_cast<size_t>(tx)]; }
+    // nessun bounds check (una tile uniforme libera risponde true anche oltre il bordo)
+    bool walkableAt(int x, int y) const {
+        const GridTile* t = tileAt(x >> kTileShift, y >> kTileShift);
+        return t == nullptr || ((t->rows[y & (kTileSize - 1)] >> (x & (kTileSize - 1))) & 1u);
+    }
+
+    int w_{}, h_{};
+    int tilesX_{}, tilesY_{};
+    std::uint64_t version_{0};
+    std::vector<std::shared_ptr<const TileRow>> rows_; // per ty
+};
+
+// Grid modificabile da un thread mentre altri cercano sulle versioni pubblicate.
+//
+//   - scrittore (un thread alla volta): setBlocked / toggleBlocked / fillRect lavorano su una
+//     bozza privata. La prima modifica di una tile dopo una publish() la copia (copy-on-write,
+//     512 byte); un fillRect che copre una tile intera cambia solo la voce della directory.
+//   - publish(): le tile toccate tornano canoniche (tutta libera / tutta bloccata -> niente
+//     payload), le righe di tile che le contengono vengono rifatte, tutto il resto è condiviso
+//     con la versione precedente: il costo è O(righe di tile + tile toccate), non O(tile).
+//     Poi uno store atomico rende visibile lo snapshot.
+//   - lettori (qualsiasi thread): snapshot() è un load atomico di uno shared_ptr; lo snapshot
+//     resta valido e identico finché lo si tiene, anche dopo altre publish(). La memoria delle
+//     tile sostituite se ne va con l'ultimo snapshot che le usa.
+//
+// Pensato per l'editor (il loop di pittura dell'app) con le ricerche in background: invece di
+// copiare tutto il GridMap o fermare chi disegna, si pubblica una versione per frame.
+class VersionedGrid {
+public:
+    VersionedGrid(int width, int height, bool blocked = false);
+    explicit VersionedGrid(const GridMap& grid); // stesse celle (costi ignorati), versione 0
+
+    VersionedGrid(const VersionedGrid&) = delete;
+    VersionedGrid& operator=(const VersionedGrid&) = delete;
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    // ---- lato scrittore ----
+    bool isWalkable(Cell c) const; // stato della bozza (modifiche non ancora pubblicate comprese)
+    void setBlocked(Cell c, bool blocked);
+    void toggleBlocked(Cell c);
+    void fillRect(Cell min, int w, int h, bool blocked); // clippato ai bordi
+    size_t pendingTiles() const { return dirty_.size(); }  // tile toccate dall'ultima publish()
+
+    // pubblica la bozza come nuova versione e la ritorna; senza modifiche ritorna la corrente
+    std::shared_ptr<const GridSnapshot> publish();
+
+    // ---- lato lettori, da qualsiasi thread ----
+    std::shared_ptr<const GridSnapshot> snapshot() const { return current_.load(std::memory_order_acquire); }
+    std::uint64_t version() const { return snapshot()->version(); }
+
+private:
+    size_t tileIndex(int tx, int ty) const {
+        return static_cast<size_t>(ty) * static_cast<size_t>(tilesX_) + static_cast<size_t>(tx);
+    }
+    void markDirty(size_t tile);
+    GridTile* writable(size_t tile); // tile della bozza, copiata alla prima modifica
+    void setUniform(size_t tile, bool blocked);
+    std::uint64_t rowMask(int tx) const;
+    int rowsIn(int ty) const;
+
+    int w_{}, h_{};
+    int tilesX_{}, tilesY_{};
+
+    // bozza, piatta (ty * tilesX + tx): come TileRow::tiles, ma le tile in owned_ sono della
+    // bozza e modificabili
+    std::vector<const GridTile*> tiles_;
+    std::vector<std::shared_ptr<GridTile>> owned_; // per tile, vuoto se non copiata dall'ultima publish()
+    std::vector<std::uint32_t> dirty_;             // tile toccate, in ordine di prima modifica
+    std::vector<std::uint8_t> isDirty_;
+
+    std::shared_ptr<const GridSnapshot> base_;      // ultima versione pubblicata (lato scrittore)
+    std::atomic<std::shared_ptr<const GridSnapshot>> current_;
+};
+
+#endif //GRIDSNAPSHOT_H
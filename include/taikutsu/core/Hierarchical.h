@@ -0,0 +1,120 @@
+#ifndef HIERARCHICAL_H
+#define HIERARCHICAL_H
+
+#include "AStarSearchContext.h" // AStarResult
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <cstdint>
+#include <vector>
+
+// HPA*: il grid è diviso in cluster quadrati; sui bordi tra due cluster adiacenti ogni
+// tratto libero genera 1-2 "entrate" (coppie di celle affiancate = nodi astratti).
+// Per ogni cluster si tengono in cache le distanze tra tutti i suoi nodi (ricerca locale
+// limitata al cluster). Una query cerca sul grafo astratto e poi raffina solo i segmenti
+// del percorso trovato, con ricerche locali dentro un cluster alla volta.
+// Il percorso è valido ma non sempre ottimo (le entrate sono un sottoinsieme del bordo).
+//
+// Il grid non notifica nulla: dopo setBlocked/toggleBlocked/setCost chiamare notifyChanged(c).
+// Vengono ricostruiti solo il cluster di c e i bordi che toccano c (con i cluster vicini),
+// in modo pigro alla prossima query o con update().
+class HierarchicalPathfinder {
+public:
+    explicit HierarchicalPathfinder(const GridMap& grid, int clusterSize = 32, const SearchOptions& opts = {});
+
+    void rebuild();              // ricostruisce tutto (es. grid sostituito)
+    void notifyChanged(Cell c);  // cella c cambiata (ostacolo o costo)
+    void update();               // ricostruisce i cluster sporchi
+
+    // percorso completo (raffinato); closed = celle dei nodi astratti espansi.
+    // Il risultato vive dentro l'oggetto fino alla prossima query.
+    const AStarResult& findPath(Cell start, Cell goal);
+
+    // solo il livello astratto: start, entrate attraversate, goal (vuoto se non c'è strada)
+    const std::vector<Cell>& findAbstractPath(Cell start, Cell goal);
+
+    // raffina il segmento a -> b di un percorso astratto: appende a out le celle dopo a fino a b
+    bool refineSegment(Cell a, Cell b, std::vector<Cell>& out);
+
+    int clusterSize() const { return size_; }
+    size_t clusterCount() const { return clusters_.size(); }
+    size_t nodeCount() const { return nodes_.size() - freeNodes_.size(); }
+    size_t lastRebuiltClusters() const { return lastRebuilt_; } // cluster ricalcolati dall'ultimo update()
+
+private:
+    static constexpr int kInf = 0x3fffffff;
+    static constexpr int kLongEntrance = 6; // tratti lunghi: un'entrata per estremo, altrimenti una al centro
+
+    struct Node {
+        Cell cell;
+        int cluster;     // -1 = slot libero
+        int local;       // posizione in Cluster::nodes (riga/colonna della matrice dist)
+        int partner;     // nodo dall'altra parte del bordo
+        int partnerCost; // costo per entrare nella cella del partner
+    };
+
+    struct Cluster {
+        int x0, y0, w, h;
+        std::vector<int> nodes; // id dei nodi che stanno in questo cluster
+        std::vector<int> dist;  // nodes.size()^2, dist[i * n + j] = costo i -> j dentro il cluster
+    };
+
+    // bordo tra due cluster: a sinistra/sopra (a) e a destra/sotto (b)
+    struct Border {
+        int a, b;
+        bool vertical; // true = bordo verticale (a e b affiancati in x)
+        std::vector<int> nodes;
+    };
+
+    int clusterOf(Cell c) const { return (c.y / size_) * ncx_ + c.x / size_; }
+    int verticalBorder(int cx, int cy) const { return cy * (ncx_ - 1) + cx; }
+    int horizontalBorder(int cx, int cy) const { return (ncx_ - 1) * ncy_ + cy * ncx_ + cx; }
+
+    void markCluster(int k);
+    void markBorder(int b);
+    void buildBorder(Border& border);
+    void buildCluster(int k);
+    int newNode(Cell c, int cluster);
+    int stepCost(int base, int fromIdx, int toIdx, bool reverse) const;
+
+    // ricerca (Dijkstra, A* se c'è target, BFS a costo unitario) limitata al cluster k.
+    // reverse = distanze verso source invece che da source
+    void localSearch(const Cluster& k, Cell source, Cell target, bool reverse);
+    int localIndex(const Cluster& k, Cell c) const { return (c.y - k.y0) * k.w + (c.x - k.x0); }
+    int localDist(int li) const { return stamp_[static_cast<size_t>(li)] == gen_ ? dist_[static_cast<size_t>(li)] : kInf; }
+
+    const GridMap* grid_;
+    SearchOptions opts_;
+    int size_;
+    int gridW_{0}, gridH_{0};
+    int ncx_{0}, ncy_{0};
+    bool eight_{false}, weighted_{false};
+
+    std::vector<Node> nodes_;
+    std::vector<int> freeNodes_;
+    std::vector<Cluster> clusters_;
+    std::vector<Border> borders_;
+    std::vector<std::uint8_t> clusterDirty_, borderDirty_;
+    std::vector<int> dirtyClusters_, dirtyBorders_;
+    size_t lastRebuilt_{0};
+
+    // scratch della ricerca locale (celle del cluster, stamp di generazione)
+    struct LocalEntry { int f, g, li; };
+    std::vector<int> dist_, parent_;
+    std::vector<std::uint32_t> stamp_;
+    std::uint32_t gen_{0};
+    std::vector<int> queue_;
+    std::vector<LocalEntry> heap_;
+
+    // scratch della ricerca astratta (nodi + start/goal temporanei)
+    struct AbsEntry { int f, g, id; };
+    std::vector<int> absG_, absParent_;
+    std::vector<std::uint32_t> absStamp_;
+    std::uint32_t absGen_{0};
+    std::vector<AbsEntry> absOpen_;
+    std::vector<int> startCost_, goalCost_; // per nodo locale del cluster di start/goal
+
+    std::vector<Cell> waypoints_;
+    AStarResult result_;
+};
+
+#endif //HIERARCHICAL_H
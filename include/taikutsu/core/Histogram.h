@@ -0,0 +1,48 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Istogramma log-lineare di valori interi: 2^kSubBits bucket per potenza di due (errore
+// relativo <= 12.5%), i valori < 2^kSubBits sono esatti. Dimensione fissa, nessuna allocazione.
+//
+// Counter sceglie chi scrive:
+//   std::uint64_t              - un thread (ValueHistogram, statistiche di SearchStatsCollector)
+//   std::atomic<std::uint64_t> - record() lock-free da più thread (fetch_add / CAS relaxed);
+//                                le letture sono un'istantanea approssimata (latenze di PathService)
+template <class Counter>
+class BasicHistogram {
+public:
+    static constexpr int kSubBits = 3;
+    static constexpr int kBuckets = (64 - kSubBits + 1) << kSubBits;
+
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t count() const { return load(count_); }
+    std::uint64_t sum() const { return load(sum_); }
+    std::uint64_t min() const { return count() ? load(min_) : 0; }
+    std::uint64_t max() const { return load(max_); }
+    double mean() const;
+    std::uint64_t percentile(double p) const; // p in [0, 1]: limite superiore del bucket (<= max), 0 se vuoto
+
+    // bucket: valori in [lowerBound(b), upperBound(b)]
+    std::uint64_t bucketCount(int b) const { return load(buckets_[static_cast<size_t>(b)]); }
+    static int bucketOf(std::uint64_t value);
+    static std::uint64_t lowerBound(int b);
+    static std::uint64_t upperBound(int b);
+
+private:
+    static std::uint64_t load(const std::uint64_t& c) { return c; }
+    static std::uint64_t load(const std::atomic<std::uint64_t>& c) { return c.load(std::memory_order_relaxed); }
+
+    std::array<Counter, kBuckets> buckets_{};
+    Counter count_{0}, sum_{0}, min_{UINT64_MAX}, max_{0};
+};
+
+using ValueHistogram = BasicHistogram<std::uint64_t>;
+using ConcurrentHistogram = BasicHistogram<std::atomic<std::uint64_t>>;
+
+#endif //HISTOGRAM_H
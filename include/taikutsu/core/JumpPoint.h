@@ -0,0 +1,35 @@
+#ifndef JUMPPOINT_H
+#define JUMPPOINT_H
+
+#include "GridMap.h"
+#include "AStarSearchContext.h"
+#include "SearchOptions.h"
+
+// Jump Point Search per grid a costo uniforme, 4 o 8 direzioni.
+//
+// 4 direzioni - ordine canonico: prima verticale, poi orizzontale. Un salto verticale a ogni
+// passo scandisce la riga a destra e a sinistra; un salto orizzontale si ferma solo sul goal
+// o su una cella con vicino "forzato" (sopra/sotto libero ma bloccato dietro).
+// 8 direzioni - JPS classico nella variante senza corner-cutting: i salti diagonali a ogni
+// passo provano i due salti rettilinei.
+// Le scansioni orizzontali leggono le righe del GridMap 64 celle alla volta.
+//
+// Il risultato ha la stessa forma di AStarPathfinder: path completo cella per cella
+// (ottimo), closed = jump point espansi.
+// JPS vale solo a costo uniforme: con layer di terreno attivo o cornerCutting=true
+// la query viene passata ad AStarPathfinder.
+class JumpPointPathfinder {
+public:
+    static AStarResult findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+
+    // versione con stato riutilizzabile (stesso AStarSearchContext di A*)
+    static const AStarResult& findPath(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                       const SearchOptions& opts = {});
+
+private:
+    template <bool Eight>
+    static const AStarResult& search(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                     const SearchOptions& opts);
+};
+
+#endif //JUMPPOINT_H
@@ -0,0 +1,129 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class ThreadPool;
+
+// Euristica ALT (A*, Landmarks, Triangle inequality): per K celle "landmark" L teniamo la
+// distanza vera d(v -> L) di ogni cella v. Per la disuguaglianza triangolare
+//   d(a -> goal) >= d(a -> L) - d(goal -> L)        (e, con costi simmetrici, anche il contrario)
+// quindi il massimo sui landmark è una stima ammissibile e consistente, molto più informata
+// di Manhattan/Octile su labirinti e stanze, dove la distanza in linea d'aria non dice nulla.
+//
+// Scelta dei landmark: farthest-point sulla componente più grande (il primo è la cella più
+// lontana da un seed, ogni successivo la più lontana da quelli già scelti), con le onde a
+// 4 direzioni di FlowField (bit-parallele, molto più rapide delle tabelle vere).
+// Tabelle: un Dijkstra all'indietro (FlowField) per landmark, con le regole di LandmarkOptions;
+// con un ThreadPool un task per landmark. Memoria: K distanze contigue per cella (la stima
+// legge una riga sola), uint16 se la distanza massima ci sta, altrimenti uint32. Con 4 direzioni
+// le distanze sono multipli di kCostStraight e vengono salvate in passi.
+//
+// Uso: SearchOptions::landmarks = &table (AStarPathfinder, ResumableSearch, PathBatch, ...):
+// l'euristica diventa max(ALT, Manhattan/Octile). Il dispatch la ignora se la tabella non vale
+// per la query (vedi usableFor): grid modificato dopo build(), oppure query con mosse che la
+// tabella non conosce / costi più bassi di quelli usati per le tabelle.
+struct LandmarkOptions {
+    int count{8}; // K, 1..LandmarkTable::kMaxLandmarks
+    // grafo delle tabelle: deve contenere quello delle query (8 direzioni con corner-cutting
+    // vale per tutte le query senza terreno, ma è meno informata per le query a 4 direzioni)
+    Connectivity connectivity{Connectivity::Eight};
+    bool cornerCutting{false};
+    bool useTerrainCost{true}; // tabelle con il layer di costo (valide solo per query con terreno)
+    ThreadPool* pool{nullptr}; // se presente: tabelle in parallelo, una per landmark
+};
+
+class LandmarkTable {
+public:
+    static constexpr int kMaxLandmarks = 32;
+
+    // sceglie i landmark (farthest-point) e costruisce le tabelle; riusa la memoria
+    void build(const GridMap& grid, const LandmarkOptions& opts = {});
+    // landmark scelti dal chiamante (celle bloccate/fuori dal grid scartate)
+    void build(const GridMap& grid, std::span<const Cell> landmarks, const LandmarkOptions& opts = {});
+
+    std::span<const Cell> landmarks() const { return landmarks_; }
+    int count() const { return k_; }
+    bool wide() const { return wide_; } // true = uint32 per distanza
+    size_t memoryBytes() const {
+        return d16_.capacity() * sizeof(std::uint16_t) + d32_.capacity() * sizeof(std::uint32_t) +
+               landmarks_.capacity() * sizeof(Cell);
+    }
+
+    // d(c -> landmark k) in fixed-point, kUnreachable se non c'è percorso o c è fuori dal grid
+    static constexpr std::uint32_t kUnreachable = 0xFFFFFFFFu;
+    std::uint32_t distance(int k, Cell c) const;
+
+    // la tabella dà stime ammissibili per questa query: stesso grid (epoch) non modificato
+    // (version) e grafo della query contenuto in quello delle tabelle
+    bool usableFor(const GridMap& grid, const SearchOptions& opts) const;
+
+    // riga della cella (per LandmarkHeuristic), SIZE_MAX se fuori dal grid
+    size_t row(Cell c) const {
+        if (c.x < 0 || c.y < 0 || c.x >= w_ || c.y >= h_) return SIZE_MAX;
+        return (static_cast<size_t>(c.y) * static_cast<size_t>(w_) + static_cast<size_t>(c.x)) *
+               static_cast<size_t>(k_);
+    }
+
+    // stima ALT di d(a -> goal) (goalRow = row(goal)); 0 se nessun landmark raggiunge entrambe
+    int estimate(Cell a, size_t goalRow) const {
+        const size_t ra = row(a);
+        return wide_ ? bound(d32_.data() + ra, d32_.data() + goalRow) : bound(d16_.data() + ra, d16_.data() + goalRow);
+    }
+
+private:
+    template <class T>
+    int bound(const T* a, const T* goal) const {
+        constexpr T kNone = static_cast<T>(~T{0});
+        long long best = 0;
+        for (int k = 0; k < k_; ++k) {
+            if (a[k] == kNone || goal[k] == kNone) continue; // landmark in un'altra componente
+            long long diff = static_cast<long long>(a[k]) - static_cast<long long>(goal[k]);
+            if (symmetric_ && diff < 0) diff = -diff;
+            best = std::max(best, diff);
+        }
+        return static_cast<int>(best * unit_);
+    }
+
+    void selectFarthest(const GridMap& grid, int count);
+    void buildTables(const GridMap& grid, const LandmarkOptions& opts);
+
+    int w_{0}, h_{0}, k_{0};
+    int unit_{1};          // fixed-point per unità salvata (kCostStraight con 4 direzioni)
+    bool wide_{false};
+    bool symmetric_{true}; // senza terreno d(a -> b) == d(b -> a)
+    bool eight_{true}, cornerCutting_{false}, weighted_{false};
+    std::uint64_t epoch_{0}, version_{0};
+    std::vector<Cell> landmarks_;
+    std::vector<std::uint16_t> d16_; // [cella * K + k], 0xFFFF = irraggiungibile
+    std::vector<std::uint32_t> d32_;
+};
+
+// Heuristic policy per BasicAStar (vedi AStarPolicies.h): max(ALT, Base). Ha stato, quindi
+// BasicAStar la riceve costruita per la query (vedi makeHeuristic in AStar.h); di default
+// (nessuna tabella) è Base. goal deve essere il goal della query.
+template <class Base>
+class LandmarkHeuristic {
+public:
+    LandmarkHeuristic() = default;
+    LandmarkHeuristic(const LandmarkTable& table, Cell goal) : goalRow_(table.row(goal)) {
+        if (goalRow_ != SIZE_MAX) table_ = &table;
+    }
+
+    int estimate(Cell a, Cell b) const {
+        const int h = Base::estimate(a, b);
+        return table_ == nullptr ? h : std::max(h, table_->estimate(a, goalRow_));
+    }
+
+private:
+    const LandmarkTable* table_{nullptr};
+    size_t goalRow_{SIZE_MAX};
+};
+
+#endif //LANDMARKS_H
@@ -0,0 +1,92 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include "ConnectivityIndex.h"
+#include "GridMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Formato binario delle mappe (.tkmap), pensato per essere mappato in memoria così com'è:
+// i bit sono nel layout di GridMap (righe paddate + cornice sentinella), quindi un
+// GridMapView li usa senza copiarli né convertirli. Little-endian, sezioni allineate a 64 byte.
+//
+//   header (64 byte)
+//     char     magic[8]          "TKGRIDMP"
+//     uint32   version           kMapFileVersion (versioni più nuove vengono rifiutate)
+//     uint32   headerBytes       64
+//     int32    width, height
+//     uint32   wordsPerRow       (width + 2 + 63) / 64
+//     uint32   flags             kMapFileCosts | kMapFileComponents
+//     uint64   bitsOffset        (height + 2) * wordsPerRow word da 64 bit, 1 = libera
+//     uint64   costOffset        0 se assente; altrimenti indexCount() byte (costo per indice paddato)
+//     uint64   componentsOffset  0 se assente; altrimenti uint32 K, uint32 0,
+//                                width * height uint32 (id 1..K per y * width + x, 0 = ostacolo),
+//                                K + 1 uint32 (celle per id, [0] = 0)
+//     uint64   fileBytes
+//
+// All'apertura header, dimensioni, offset e cornice sentinella vengono verificati: un file
+// troppo corto o con la cornice "aperta" farebbe uscire A* dal grid, quindi viene rifiutato.
+
+constexpr std::uint32_t kMapFileVersion = 1;
+constexpr std::uint32_t kMapFileCosts = 1u << 0;
+constexpr std::uint32_t kMapFileComponents = 1u << 1;
+
+struct MapFileOptions {
+    bool costs{true};       // salva il layer di costo (se il grid ce l'ha)
+    bool components{false}; // precalcola e salva le componenti connesse (4 byte per cella)
+};
+
+// In caso di errore nullptr / nullopt / false e, se error != nullptr, una descrizione.
+bool saveMapFile(std::ostream& out, const GridMap& grid, const MapFileOptions& opts = {});
+bool saveMapFile(const std::string& path, const GridMap& grid, const MapFileOptions& opts = {},
+                 std::string* error = nullptr);
+
+// copia in un GridMap normale (modificabile)
+std::optional<GridMap> loadMapFile(const std::string& path, std::string* error = nullptr);
+
+// Mappa in sola lettura sopra un file .tkmap mappato in memoria (mmap; dove non c'è,
+// il file viene letto in un buffer una volta): aprire costa la verifica dell'header e della
+// cornice, le pagine arrivano dal disco quando la ricerca le tocca.
+// grid() si usa ovunque serva un const GridMap& (A*, JPS, HPA*, PathBatch, ...).
+// Per PathService: std::shared_ptr<const GridMap>(view, &view->grid()) tiene vivo il file.
+class GridMapView {
+public:
+    static std::unique_ptr<GridMapView> open(const std::string& path, std::string* error = nullptr);
+    ~GridMapView();
+
+    GridMapView(const GridMapView&) = delete;
+    GridMapView& operator=(const GridMapView&) = delete;
+
+    const GridMap& grid() const { return grid_; }
+    operator const GridMap&() const { return grid_; }
+
+    std::uint32_t version() const { return version_; }
+    size_t fileBytes() const { return bytes_; }
+
+    // componenti precalcolate (copiate dal file), nullopt se il file non le ha o se non
+    // corrispondono ai bit: id oltre K, ostacolo con id, cella libera con id 0, celle per id
+    // diverse da quelle salvate (verifica O(celle), fatta qui e non in open())
+    bool hasComponents() const { return componentCount_ != kNoComponents; }
+    std::optional<ConnectivityIndex> components() const;
+
+private:
+    static constexpr std::uint32_t kNoComponents = UINT32_MAX;
+
+    GridMapView(const void* data, size_t bytes, bool mapped, std::unique_ptr<std::uint64_t[]> buffer,
+                int width, int height, const std::uint64_t* words, const std::uint8_t* costs);
+
+    const void* data_;
+    size_t bytes_;
+    bool mapped_; // munmap nel distruttore, altrimenti buffer_
+    std::unique_ptr<std::uint64_t[]> buffer_;
+    std::uint32_t version_{kMapFileVersion};
+    std::uint32_t componentCount_{kNoComponents};
+    const std::uint32_t* labels_{nullptr};
+    GridMap grid_; // in prestito sopra data_
+};
+
+#endif //MAPFILE_H
@@ -0,0 +1,25 @@
+#ifndef MAPGENERATORS_H
+#define MAPGENERATORS_H
+
+#include "GridMap.h"
+
+// Mappe sintetiche per benchmark e test (riproducibili: stesso seed -> stessa mappa).
+// Le famiglie ricalcano quelle dei benchmark MovingAI, così si possono confrontare
+// i numeri anche senza i file originali.
+
+// tutto libero
+GridMap makeOpenMap(int width, int height);
+
+// ogni cella bloccata con probabilità density (indipendenti; con density >= ~0.4
+// la mappa si spezza in molte componenti)
+GridMap makeRandomMap(int width, int height, double density, unsigned seed);
+
+// labirinto perfetto (un solo percorso tra due celle qualsiasi): corridoi larghi
+// corridor celle e muri spessi 1; depth-first randomizzato sulle celle del labirinto
+GridMap makeMazeMap(int width, int height, int corridor, unsigned seed);
+
+// stanze roomSize x roomSize separate da muri spessi 1 con porte: un albero di porte
+// garantisce la connessione, ogni altra parete ha una porta con probabilità extraDoors
+GridMap makeRoomsMap(int width, int height, int roomSize, unsigned seed, double extraDoors = 0.5);
+
+#endif //MAPGENERATORS_H
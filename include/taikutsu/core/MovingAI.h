@@ -0,0 +1,43 @@
+#ifndef MOVINGAI_H
+#define MOVINGAI_H
+
+#include "GridMap.h"
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Formati dei benchmark MovingAI (https://movingai.com/benchmarks/formats.html).
+//
+// .map:  "type octile" / "height H" / "width W" / "map" seguiti da H righe di W caratteri.
+//        Percorribili: '.', 'G', 'S' (palude). Bloccati: '@', 'O', 'T' (alberi), 'W' (acqua).
+// .scen: "version 1" poi una riga per query:
+//        bucket  mappa  larghezza  altezza  start.x start.y  goal.x goal.y  lunghezza_ottima
+//        (lunghezza ottima a 8 direzioni senza corner-cutting, diagonale = sqrt(2))
+//
+// In caso di errore le funzioni restituiscono nullopt / false e, se error != nullptr,
+// una descrizione con il numero di riga.
+
+struct MovingAIScenario {
+    int bucket{0};
+    std::string map;       // come scritto nel file .scen (di solito relativo)
+    int mapWidth{0}, mapHeight{0};
+    Cell start, goal;
+    double optimalLength{0.0};
+};
+
+std::optional<GridMap> loadMovingAIMap(std::istream& in, std::string* error = nullptr);
+std::optional<GridMap> loadMovingAIMap(const std::string& path, std::string* error = nullptr);
+void saveMovingAIMap(std::ostream& out, const GridMap& grid); // '.' e '@'
+
+// Testo semplice senza header (mappe scritte a mano): una riga per y, larghezza = riga più
+// lunga, le righe più corte sono completate con celle libere.
+//   libere: '.', ' ', 'G', 'S'   bloccate: '#', '@', 'O', 'T', 'W'   '1'..'9': libere con quel costo
+std::optional<GridMap> loadAsciiMap(std::istream& in, std::string* error = nullptr);
+std::optional<GridMap> loadAsciiMap(const std::string& path, std::string* error = nullptr);
+
+std::optional<std::vector<MovingAIScenario>> loadMovingAIScenarios(std::istream& in, std::string* error = nullptr);
+std::optional<std::vector<MovingAIScenario>> loadMovingAIScenarios(const std::string& path,
+                                                                   std::string* error = nullptr);
+
+#endif //MOVINGAI_H
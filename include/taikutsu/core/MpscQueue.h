@@ -0,0 +1,60 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+
+// nodo intrusivo: gli elementi della coda derivano da MpscNode
+struct MpscNode {
+    std::atomic<MpscNode*> next{nullptr};
+};
+
+// Coda intrusiva multi-producer / single-consumer (Vyukov).
+// push(): un exchange + uno store, wait-free, da qualsiasi thread.
+// pop():  un solo consumer alla volta (il chiamante serializza); nullptr se vuota o se un
+//         producer è a metà push (l'elemento diventa visibile appena il producer finisce).
+// La coda non possiede i nodi: restano vivi finché pop() non li restituisce.
+class MpscQueue {
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(MpscNode* n) {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* prev = head_.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release); // da qui n è raggiungibile dal consumer
+    }
+
+    MpscNode* pop() {
+        MpscNode* tail = tail_;
+        MpscNode* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) { // lo stub non è un elemento: si salta
+            if (next == nullptr) return nullptr;
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+        // tail è l'ultimo collegato: se head è più avanti un producer non ha ancora linkato
+        if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+        // rimettiamo lo stub in fondo per poter staccare tail
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    alignas(64) std::atomic<MpscNode*> head_; // lato producer
+    alignas(64) MpscNode* tail_;              // lato consumer
+    MpscNode stub_;
+};
+
+#endif //MPSCQUEUE_H
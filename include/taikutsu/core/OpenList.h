@@ -0,0 +1,190 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include "AStarSearchContext.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Implementazioni dell'open set per BasicAStar (parametro OpenList<TieBreak>).
+// Tutte lavorano sopra AStarSearchContext::OpenStorage, quindi a regime non allocano.
+//
+// Interfaccia comune:
+//   kDecreaseKey     - true se decrease() aggiorna in place (niente duplicati/stale)
+//   push(e)          - inserisce un nodo nuovo
+//   decrease(e)      - il nodo e.idx è già aperto e ha trovato un g migliore
+//   pop()            - estrae il prossimo nodo da espandere
+//   empty(), size()
+
+using OpenEntry = AStarSearchContext::OpenEntry;
+using OpenStorage = AStarSearchContext::OpenStorage;
+
+// Heap binario senza decrease-key (std::push_heap/pop_heap): un g migliore viene
+// inserito come duplicato e la copia vecchia scartata all'estrazione (stale pop).
+template <class TieBreak>
+class BinaryHeapOpen {
+public:
+    static constexpr bool kDecreaseKey = false;
+
+    BinaryHeapOpen(OpenStorage& s, size_t) : heap_(s.heap) { heap_.clear(); }
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+
+    void push(const OpenEntry& e) {
+        heap_.push_back(e);
+        std::push_heap(heap_.begin(), heap_.end(), Cmp{});
+    }
+    void decrease(const OpenEntry& e) { push(e); }
+
+    OpenEntry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), Cmp{});
+        const OpenEntry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+private:
+    // max-heap di std: "a < b" se a esce dopo b
+    struct Cmp {
+        bool operator()(const OpenEntry& a, const OpenEntry& b) const { return TieBreak::before(b, a); }
+    };
+
+    std::vector<OpenEntry>& heap_;
+};
+
+// Heap 4-ario indicizzato: heapPos[idx] = posizione del nodo nell'heap, così il
+// decrease-key avviene in place. Ogni cella compare al massimo una volta e l'heap
+// resta grande quanto la frontiera reale. 4 figli per nodo = albero più basso e
+// figli contigui in cache durante il sift-down.
+template <class TieBreak>
+class IndexedHeapOpen {
+public:
+    static constexpr bool kDecreaseKey = true;
+
+    IndexedHeapOpen(OpenStorage& s, size_t nodeCount) : heap_(s.heap), pos_(s.heapPos) {
+        heap_.clear();
+        // heapPos viene letto solo per nodi aperti nella query corrente: niente reset
+        if (pos_.size() < nodeCount) pos_.resize(nodeCount);
+    }
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+
+    void push(const OpenEntry& e) {
+        heap_.push_back(e);
+        siftUp(heap_.size() - 1);
+    }
+
+    void decrease(const OpenEntry& e) {
+        const auto i = static_cast<size_t>(pos_[static_cast<size_t>(e.idx)]);
+        heap_[i] = e;
+        siftUp(i);
+    }
+
+    OpenEntry pop() {
+        const OpenEntry top = heap_.front();
+        const OpenEntry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            heap_.front() = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void place(size_t i, const OpenEntry& e) {
+        heap_[i] = e;
+        pos_[static_cast<size_t>(e.idx)] = static_cast<int>(i);
+    }
+
+    void siftUp(size_t i) {
+        const OpenEntry e = heap_[i];
+        while (i > 0) {
+            const size_t parent = (i - 1) / 4;
+            if (!TieBreak::before(e, heap_[parent])) break;
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, e);
+    }
+
+    void siftDown(size_t i) {
+        const OpenEntry e = heap_[i];
+        const size_t n = heap_.size();
+        for (;;) {
+            const size_t first = 4 * i + 1;
+            if (first >= n) break;
+            size_t best = first;
+            const size_t end = std::min(first + 4, n);
+            for (size_t c = first + 1; c < end; ++c)
+                if (TieBreak::before(heap_[c], heap_[best])) best = c;
+            if (!TieBreak::before(heap_[best], e)) break;
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+    std::vector<OpenEntry>& heap_;
+    std::vector<int>& pos_;
+};
+
+// Radix queue monotona sugli f interi: 33 bucket, il bucket di una chiave è il bit
+// più alto in cui differisce dall'ultima chiave estratta. Push O(1), pop O(log C)
+// ammortizzato. Vale solo se le chiavi estratte non decrescono, cioè con euristica
+// consistente (Manhattan a 4 direzioni, Octile a 8): una chiave minore dell'ultima
+// estratta viene alzata a quella (con euristiche non consistenti l'ottimo era già perso).
+// Senza decrease-key (stale come l'heap binario). A parità di f i bucket sono LIFO,
+// che favorisce i nodi inseriti per ultimi (di solito g maggiore): TieBreak è ignorato.
+template <class TieBreak>
+class RadixOpen {
+public:
+    static constexpr bool kDecreaseKey = false;
+
+    RadixOpen(OpenStorage& s, size_t) : buckets_(s.radix) {
+        for (auto& b : buckets_) b.clear();
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    void push(OpenEntry e) {
+        const auto key = std::max(static_cast<std::uint32_t>(e.f), last_);
+        e.f = static_cast<int>(key);
+        buckets_[bucketOf(key)].push_back(e);
+        ++size_;
+    }
+    void decrease(const OpenEntry& e) { push(e); }
+
+    OpenEntry pop() {
+        if (buckets_[0].empty()) {
+            // primo bucket non vuoto: la sua chiave minima diventa last_, e i suoi
+            // elementi si ridistribuiscono tutti in bucket più bassi
+            size_t i = 1;
+            while (buckets_[i].empty()) ++i;
+            auto& from = buckets_[i];
+            std::uint32_t minKey = static_cast<std::uint32_t>(from.front().f);
+            for (const OpenEntry& e : from) minKey = std::min(minKey, static_cast<std::uint32_t>(e.f));
+            last_ = minKey;
+            for (const OpenEntry& e : from) buckets_[bucketOf(static_cast<std::uint32_t>(e.f))].push_back(e);
+            from.clear();
+        }
+        const OpenEntry top = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return top;
+    }
+
+private:
+    size_t bucketOf(std::uint32_t key) const {
+        return static_cast<size_t>(std::bit_width(key ^ last_));
+    }
+
+    std::array<std::vector<OpenEntry>, 33>& buckets_;
+    std::uint32_t last_{0};
+    size_t size_{0};
+};
+
+#endif //OPENLIST_H
@@ -0,0 +1,38 @@
+#ifndef PATHBATCH_H
+#define PATHBATCH_H
+
+#include "AStar.h"
+#include "ThreadPool.h"
+#include <span>
+#include <vector>
+
+// una query del batch
+struct PathRequest {
+    Cell start;
+    Cell goal;
+};
+
+// Esegue molte query A* in parallelo sullo stesso GridMap (sola lettura durante run()).
+// Un AStarSearchContext per worker del pool: nessuna allocazione per query a regime.
+// Le query sono divise in blocchi distribuiti sul pool (work-stealing bilancia i blocchi lenti).
+// Un PathBatch non va usato da più thread contemporaneamente; lo stesso ThreadPool sì.
+class PathBatch {
+public:
+    explicit PathBatch(ThreadPool& pool);
+
+    // results[i] = percorso di requests[i] (results.size() >= requests.size()).
+    // Il percorso viene scritto direttamente in results[i].path (PathOutput::buffer, riusando la
+    // sua capacità), poi success/cost/expanded/pathLength; closed resta vuoto (serve solo alla
+    // visualizzazione).
+    // opts.stats, opts.recordClosed e opts.output.buffer/span sono ignorati (opts.output.format no).
+    // Blocca fino alla fine del batch: non va chiamata da un task dello stesso pool (il worker
+    // fermo qui può essere proprio quello che deve eseguire i blocchi -> deadlock; assert in debug).
+    void run(const GridMap& grid, std::span<const PathRequest> requests, std::span<AStarResult> results,
+             const SearchOptions& opts = {});
+
+private:
+    ThreadPool& pool_;
+    std::vector<AStarSearchContext> contexts_; // uno per worker, indicizzati dall'id del worker
+};
+
+#endif //PATHBATCH_H
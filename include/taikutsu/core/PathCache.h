@@ -0,0 +1,89 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "AStarSearchContext.h"
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct PathCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};        // query eseguite con A* (anche dopo un'invalidazione)
+    std::uint64_t invalidations{0}; // percorsi scartati perché il grid è cambiato
+    std::uint64_t evictions{0};     // percorsi scartati per far posto (LRU)
+};
+
+// Cache LRU di percorsi davanti ad A*, chiave (start, goal), capacità fissa in percorsi.
+// I percorsi sono compatti: cella di partenza + una direzione (4 bit) per passo, più
+// l'elenco delle regioni di GridMap attraversate.
+//
+// Invalidazione precisa, controllata alla lettura con le versioni per regione del GridMap:
+//   - una regione attraversata è cambiata           -> scartato (potrebbe non essere più valido);
+//     con 8 direzioni contano anche le regioni delle celle d'angolo di ogni diagonale
+//   - uno sblocco / costo minore in un'altra regione -> scartato solo se lì può passare un
+//     percorso più corto: h(start, regione) + h(regione, goal) < costo in cache
+// Così un risultato dalla cache ha sempre il costo che A* troverebbe sul grid attuale.
+// Le query senza percorso non vengono memorizzate (per quelle c'è ConnectivityIndex).
+class PathCache {
+public:
+    // opts.output è ignorato: la cache memorizza e restituisce sempre tutte le celle in result.path
+    PathCache(const GridMap& grid, size_t capacity, const SearchOptions& opts = {});
+
+    // dalla cache (closed vuoto) o da A* (e memorizzato); valido fino alla prossima chiamata
+    const AStarResult& findPath(Cell start, Cell goal);
+
+    void clear();
+    size_t size() const { return index_.size(); }
+    size_t capacity() const { return capacity_; }
+    size_t memoryBytes() const; // stima: voci + percorsi compatti + indice
+    const PathCacheStats& stats() const { return stats_; }
+
+private:
+    static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+
+    struct Key {
+        Cell start, goal;
+        bool operator==(const Key& o) const { return start == o.start && goal == o.goal; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    struct Entry {
+        Key key;
+        int cost{0};
+        std::uint32_t steps{0};
+        std::uint64_t checked{0};           // version() del grid a cui è stato verificato valido
+        std::vector<std::uint8_t> moves;    // direzioni (Dir), due per byte
+        std::vector<std::uint32_t> regions; // regioni attraversate (+ angoli delle diagonali), ordinate
+        std::uint32_t prev{kNil}, next{kNil}; // lista LRU (head = più recente)
+    };
+
+    bool stillValid(Entry& e) const;
+    int lowerBound(Cell start, Cell goal, int region) const;
+    void store(const Key& key, const AStarResult& r);
+    void decode(const Entry& e);
+    void unlink(std::uint32_t i);
+    void pushFront(std::uint32_t i);
+    void erase(std::uint32_t i);
+    void syncWithGrid();
+
+    const GridMap* grid_;
+    SearchOptions opts_;
+    size_t capacity_;
+    std::uint64_t epoch_{0};
+    int w_{0}, h_{0};
+
+    std::vector<Entry> entries_;        // slot riusati (la capacità dei vettori resta)
+    std::vector<std::uint32_t> free_;
+    std::unordered_map<Key, std::uint32_t, KeyHash> index_;
+    std::uint32_t head_{kNil}, tail_{kNil};
+
+    AStarSearchContext ctx_;
+    AStarResult hit_; // risultato decodificato dalla cache
+    PathCacheStats stats_;
+};
+
+#endif //PATHCACHE_H
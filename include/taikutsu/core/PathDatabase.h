@@ -0,0 +1,111 @@
+#ifndef PATHDATABASE_H
+#define PATHDATABASE_H
+
+#include "AStarSearchContext.h"
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Database compresso delle prime mosse (CPD) per mappe statiche: per ogni cella sorgente s e
+// ogni target t, la prima mossa di un percorso ottimo s -> t. Una query è una sequenza di
+// lookup (una per passo) invece di una ricerca: niente open list, niente memoria per query.
+//
+// Costruzione: un Dijkstra in avanti per sorgente (BFS con 4 direzioni a costo unitario, bucket
+// di Dial altrimenti) che propaga l'insieme delle prime mosse ottime (bitmask: con i pareggi
+// ogni prima mossa ottima va bene). Con un ThreadPool le sorgenti vengono divise in blocchi.
+// Compressione: i target sono ordinati in profondità (DFS sul grid, celle vicine = rank vicini) e
+// la riga di s diventa una lista di run [rank iniziale, mossa]: un run si allunga finché
+// l'intersezione delle mosse ottime dei suoi target non è vuota.
+//
+// Dimensioni: build O(celle^2), pensato per arene da qualche decina di migliaia di celle;
+// la memoria è ~12 byte per cella + 4 byte per run.
+//
+// File (.tkcpd, little-endian, sezioni allineate a 64 byte):
+//   header (64 byte)
+//     char     magic[8]       "TKPATHDB"
+//     uint32   version        kPathDatabaseVersion
+//     uint32   headerBytes    64
+//     int32    width, height
+//     uint32   flags          kPathDatabaseEight | kPathDatabaseCornerCutting | kPathDatabaseTerrain
+//     uint32   0
+//     uint64   fingerprint    hash dei bit (e dei costi con il terreno) del grid di build
+//     uint64   runCount
+//     uint64   fileBytes      fine della sezione runs (load() la verifica contro layout e stream)
+//     uint64   0
+//   rank      width * height uint32 (posizione del target y * width + x nell'ordine dei run)
+//   offsets   width * height + 1 uint64 (run della sorgente c: [offsets[c], offsets[c + 1]))
+//   runs      runCount uint32 (rank iniziale << 4 | mossa: Dir, oppure 8 = irraggiungibile)
+constexpr std::uint32_t kPathDatabaseVersion = 1;
+constexpr std::uint32_t kPathDatabaseEight = 1u << 0;
+constexpr std::uint32_t kPathDatabaseCornerCutting = 1u << 1;
+constexpr std::uint32_t kPathDatabaseTerrain = 1u << 2;
+
+struct PathDatabaseOptions {
+    // regole delle mosse e dei costi, come SearchOptions (le query devono usare le stesse)
+    Connectivity connectivity{Connectivity::Eight};
+    bool cornerCutting{false};
+    bool useTerrainCost{true};
+    ThreadPool* pool{nullptr}; // se presente: sorgenti in parallelo
+};
+
+class PathDatabase {
+public:
+    static constexpr std::uint8_t kNoMove = 0xFF;   // s == t o t irraggiungibile da s
+    static constexpr int kMaxCells = 1 << 28;       // rank nei 28 bit alti di un run
+
+    // In caso di errore false / nullopt e, se error != nullptr, una descrizione.
+    bool build(const GridMap& grid, const PathDatabaseOptions& opts = {}, std::string* error = nullptr);
+
+    bool save(std::ostream& out) const;
+    bool save(const std::string& path, std::string* error = nullptr) const;
+    // in deve essere seekable: la lunghezza si controlla contro l'header prima di allocare
+    static std::optional<PathDatabase> load(std::istream& in, std::string* error = nullptr);
+    static std::optional<PathDatabase> load(const std::string& path, std::string* error = nullptr);
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    size_t runCount() const { return runs_.size(); }
+    size_t memoryBytes() const {
+        return rank_.capacity() * sizeof(std::uint32_t) + offsets_.capacity() * sizeof(std::uint64_t) +
+               runs_.capacity() * sizeof(std::uint32_t);
+    }
+
+    // stesso contenuto del grid di build (dimensioni + hash: O(celle / 64), da fare al caricamento)
+    bool matches(const GridMap& grid) const;
+    // stesse regole di movimento/costo della query (una mossa in più o in meno cambia i percorsi)
+    bool usableFor(const SearchOptions& opts) const;
+
+    // prima mossa (Dir) di un percorso ottimo start -> goal; kNoMove se start == goal,
+    // nessun percorso o celle fuori/bloccate. O(log run della riga di start)
+    std::uint8_t firstMove(Cell start, Cell goal) const;
+
+    // percorso completo a colpi di firstMove; grid = quello di build (per il costo con il terreno).
+    // Riusa la memoria di out; expanded = lookup fatti. Stesso costo di AStarPathfinder.
+    void findPath(const GridMap& grid, Cell start, Cell goal, AStarResult& out) const;
+    AStarResult findPath(const GridMap& grid, Cell start, Cell goal) const {
+        AStarResult r;
+        findPath(grid, start, goal, r);
+        return r;
+    }
+
+private:
+    size_t cellIndex(Cell c) const {
+        return static_cast<size_t>(c.y) * static_cast<size_t>(w_) + static_cast<size_t>(c.x);
+    }
+
+    int w_{0}, h_{0};
+    std::uint32_t flags_{0};
+    std::uint64_t fingerprint_{0};
+    std::vector<std::uint32_t> rank_;    // per cella (y * w + x)
+    std::vector<std::uint64_t> offsets_; // per cella + 1
+    std::vector<std::uint32_t> runs_;
+};
+
+#endif //PATHDATABASE_H
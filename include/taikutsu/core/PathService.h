@@ -0,0 +1,152 @@
+#ifndef PATHSERVICE_H
+#define PATHSERVICE_H
+
+#include "AStarSearchContext.h" // SearchStatus
+#include "GridMap.h"
+#include "Histogram.h"
+#include "MpscQueue.h"
+#include "SearchOptions.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ResumableSearch;
+
+// esito di una richiesta a PathService
+struct PathResponse {
+    SearchStatus status{SearchStatus::Idle}; // Found, NoPath o Cancelled
+    std::vector<Cell> path;                  // start -> goal (vuoto se non Found)
+    int cost{0};
+    std::uint64_t gridVersion{0};            // versione del grid su cui è stata calcolata
+};
+
+// contatori per dimensionare il pool (letture relaxed: un'istantanea approssimata)
+struct PathServiceStats {
+    size_t queueDepth{0};         // richieste in coda, non ancora prese da un worker
+    size_t inFlight{0};           // ricerche distinte in coda o in esecuzione (callback comprese)
+    std::uint64_t submitted{0};   // submit() totali
+    std::uint64_t coalesced{0};   // submit() agganciati a una ricerca già in corso
+    std::uint64_t completed{0};   // ricerche eseguite fino in fondo
+    std::uint64_t cancelled{0};   // ricerche abbandonate (tutti i richiedenti hanno cancellato)
+    // latenza submit -> risposta delle ricerche completate
+    double p50Us{0}, p90Us{0}, p99Us{0}, maxUs{0};
+};
+
+// Servizio asincrono di pathfinding: il gameplay non si blocca mai su A*.
+//
+//   submit(start, goal[, callback]) -> PathTicket (future condiviso + cancel)
+//   publish(grid)                   -> nuova versione del grid per le ricerche successive
+//
+// - Pool fisso di worker. La coda di invio è una MpscQueue (push lock-free dai producer);
+//   i worker fanno a turno da consumer (un pop alla volta) e dormono su un contatore atomico.
+// - Richieste identiche (start, goal, versione del grid) mentre la prima è in coda o in corso
+//   condividono la stessa ricerca e lo stesso risultato.
+// - cancel(): il richiedente non è più interessato (es. si è spostato). Quando nessuno lo è
+//   più la ricerca viene saltata o interrotta (controllo ogni qualche migliaio di nodi).
+// - I worker leggono il grid pubblicato più recente: la risposta riporta la versione usata.
+//
+// Il grid pubblicato è immutabile (shared_ptr<const GridMap>): chi lo modifica ne pubblica
+// una copia. opts.components viene ignorato (l'indice è legato a un grid mutabile), come opts.stats,
+// opts.recordClosed e opts.output.buffer/span (opts.output.format vale anche qui).
+class PathService {
+    struct Job;
+
+public:
+    using Callback = std::function<void(const PathResponse&)>;
+
+    // risposta di una submit(); move-only. Distruggerlo non cancella la richiesta.
+    class PathTicket {
+    public:
+        PathTicket() = default;
+        PathTicket(PathTicket&&) = default;
+        PathTicket& operator=(PathTicket&&) = default;
+        PathTicket(const PathTicket&) = delete;
+        PathTicket& operator=(const PathTicket&) = delete;
+
+        bool valid() const { return job_ != nullptr; }
+        bool ready() const { return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        const PathResponse& get() const { return future_.get(); } // attende
+        std::shared_future<PathResponse> future() const { return future_; }
+        bool coalesced() const { return coalesced_; } // agganciato a una ricerca già in corso
+
+        // questo richiedente non aspetta più: la sua callback non viene chiamata; la ricerca
+        // continua se altri richiedenti la condividono. get() resta valido (Cancelled o risultato)
+        void cancel();
+
+    private:
+        friend class PathService;
+        std::shared_ptr<Job> job_;
+        std::shared_future<PathResponse> future_;
+        size_t subscriber_{0};
+        bool coalesced_{false};
+        bool cancelled_{false};
+    };
+
+    explicit PathService(std::shared_ptr<const GridMap> grid, unsigned threads = 0, const SearchOptions& opts = {});
+    ~PathService(); // le richieste ancora in coda terminano Cancelled
+
+    PathService(const PathService&) = delete;
+    PathService& operator=(const PathService&) = delete;
+
+    // thread-safe; la callback (se presente) gira su un worker, dopo che il future è pronto
+    PathTicket submit(Cell start, Cell goal, Callback callback = {});
+
+    // nuova versione del grid (thread-safe); ritorna il numero di versione
+    std::uint64_t publish(std::shared_ptr<const GridMap> grid);
+    std::uint64_t gridVersion() const { return version_.load(std::memory_order_acquire); }
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers_.size()); }
+    PathServiceStats stats() const;
+
+private:
+    struct Key {
+        Cell start, goal;
+        std::uint64_t version;
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+
+    // tabella delle ricerche in corso, divisa in shard per non serializzare i producer
+    struct Shard {
+        std::mutex m;
+        std::unordered_map<Key, std::shared_ptr<Job>, KeyHash> jobs;
+    };
+    static constexpr size_t kShards = 16;
+
+    Shard& shardOf(const Key& k) { return shards_[KeyHash{}(k) % kShards]; }
+    std::shared_ptr<const GridMap> currentGrid(std::uint64_t& version) const;
+    void workerLoop();
+    void run(Job& job, ResumableSearch& search);
+    void finish(Job& job, PathResponse response);
+
+    SearchOptions opts_;
+
+    mutable std::mutex gridMutex_; // solo lo scambio del puntatore
+    std::shared_ptr<const GridMap> grid_;
+    std::atomic<std::uint64_t> version_{1}; // scritto con gridMutex_, letto anche senza
+
+    std::array<Shard, kShards> shards_;
+
+    MpscQueue queue_;
+    std::atomic<bool> consumer_{false};    // turno di consumer della coda
+    std::atomic<std::uint32_t> wake_{0};   // +1 ad ogni push: i worker dormono su questo valore
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> inFlight_{0};
+    std::atomic<std::uint64_t> submitted_{0}, coalesced_{0}, completed_{0}, cancelled_{0};
+    ConcurrentHistogram latency_; // ns, scritto dai worker
+};
+
+#endif //PATHSERVICE_H
@@ -0,0 +1,58 @@
+#ifndef RESUMABLESEARCH_H
+#define RESUMABLESEARCH_H
+
+#include "AStarSearchContext.h"
+#include "GridMap.h"
+#include "SearchOptions.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// A* a fette con le stesse SearchOptions di AStarPathfinder: start() prepara la query,
+// ogni step() espande al massimo N nodi e ritorna. Open set e punteggi restano nel contesto
+// interno tra una chiamata e l'altra, quindi un render loop può spendere un budget fisso
+// per frame (nodi o microsecondi) e disegnare result().closed man mano che cresce
+// (con opts.recordClosed = ClosedRecording::List).
+// Il risultato finale (path, costo, closed) è identico a quello di AStarPathfinder::findPath.
+//
+// Il grid deve restare vivo e invariato finché la ricerca è Running: se cambia, cancel()
+// (o start() di nuovo) e si riparte.
+class ResumableSearch {
+public:
+    ResumableSearch();
+    ~ResumableSearch();
+
+    ResumableSearch(const ResumableSearch&) = delete;
+    ResumableSearch& operator=(const ResumableSearch&) = delete;
+
+    // nuova query (quella in corso viene abbandonata); start/goal non validi o in componenti
+    // diverse (opts.components) -> NoPath subito, senza espansioni
+    void start(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts = {});
+
+    // espande al massimo maxExpansions nodi
+    SearchStatus step(size_t maxExpansions);
+
+    // espande finché non scade budget (controllato ogni qualche centinaio di nodi) o non
+    // raggiunge maxExpansions
+    SearchStatus stepFor(std::chrono::microseconds budget, size_t maxExpansions = SIZE_MAX);
+
+    // interrompe la query: status Cancelled, result() tiene le celle espanse finora
+    void cancel();
+
+    SearchStatus status() const { return status_; }
+    bool running() const { return status_ == SearchStatus::Running; }
+    size_t expanded() const; // nodi chiusi dall'inizio della query
+
+    // parziale finché Running (closed cresce), completo dopo Found/NoPath
+    const AStarResult& result() const { return ctx_.result(); }
+
+private:
+    struct Task; // istanza di BasicAStar::Search scelta a runtime (vedi .cpp)
+    template <class A> struct TaskFor;
+
+    AStarSearchContext ctx_;
+    std::unique_ptr<Task> task_;
+    SearchStatus status_{SearchStatus::Idle};
+};
+
+#endif //RESUMABLESEARCH_H
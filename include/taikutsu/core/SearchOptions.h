@@ -0,0 +1,90 @@
+#ifndef SEARCHOPTIONS_H
+#define SEARCHOPTIONS_H
+
+#include "Types.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+class ConnectivityIndex;
+class LandmarkTable;
+class SearchStatsCollector;
+
+// Costi in fixed-point intero: un passo ortogonale vale kCostStraight, uno diagonale
+// kCostDiagonal (~ 100 * sqrt(2), arrotondato per difetto così l'euristica octile resta
+// ammissibile). Con il layer di terreno il costo del passo è moltiplicato per cost(cella di arrivo).
+constexpr int kCostStraight = 100;
+constexpr int kCostDiagonal = 141;
+
+enum class Connectivity : std::uint8_t {
+    Four,  // solo mosse ortogonali
+    Eight  // anche diagonali (regole sugli angoli in SearchOptions::cornerCutting)
+};
+
+enum class HeuristicKind : std::uint8_t {
+    Auto,      // Manhattan con 4 direzioni, Octile con 8
+    Manhattan, // con 8 direzioni non è ammissibile (più veloce, path non garantito ottimo)
+    Octile
+};
+
+// implementazione dell'open set (vedi OpenList.h)
+enum class OpenListKind : std::uint8_t {
+    BinaryHeap,  // heap binario con duplicati e stale pop
+    IndexedHeap, // heap 4-ario con decrease-key in place
+    Radix        // radix queue monotona sugli f interi (euristica consistente)
+};
+
+// cosa resta in AStarResult delle celle espanse (debug/visualizzazione)
+enum class ClosedRecording : std::uint8_t {
+    None,  // niente: solo il conteggio result.expanded (query di produzione)
+    List,  // result.closed in ordine di espansione (una push_back per nodo)
+    Bitmap // result.closedBits, 1 bit per cella (memoria fissa, niente ordine)
+};
+
+enum class PathFormat : std::uint8_t {
+    Cells,    // ogni cella da start a goal
+    Waypoints // solo start, celle di svolta e goal (tra due waypoint il tratto è dritto o diagonale)
+};
+
+// dove e come scrivere il percorso trovato (default: tutte le celle in result.path)
+struct PathOutput {
+    PathFormat format{PathFormat::Cells};
+    // se presente, riceve il percorso al posto di result.path (vuoto se non c'è percorso)
+    std::vector<Cell>* buffer{nullptr};
+    // se non vuoto (precedenza su buffer): nessuna allocazione; se il percorso è più lungo di
+    // span.size() lo span non viene toccato e result.pathLength dice quanto spazio serve
+    std::span<Cell> span{};
+};
+
+// opzioni di una query (default = comportamento classico: 4 direzioni, Manhattan)
+struct SearchOptions {
+    Connectivity connectivity{Connectivity::Four};
+    HeuristicKind heuristic{HeuristicKind::Auto};
+    bool cornerCutting{false};  // 8 direzioni: permette la diagonale se almeno una ortogonale è libera
+    bool useTerrainCost{true};  // usa il layer di costo del GridMap (se presente)
+    OpenListKind openList{OpenListKind::BinaryHeap};
+    // se presente (e allineato al grid), start/goal in componenti diverse falliscono in O(1)
+    const ConnectivityIndex* components{nullptr};
+    // se presente (e valida per grid e opzioni, vedi LandmarkTable::usableFor) l'euristica
+    // diventa max(ALT, Manhattan/Octile): meno espansioni su labirinti e stanze
+    const LandmarkTable* landmarks{nullptr};
+    // se presente, ogni query conclusa viene misurata e registrata qui (vedi SearchStats.h)
+    SearchStatsCollector* stats{nullptr};
+    ClosedRecording recordClosed{ClosedRecording::None};
+    PathOutput output{};
+};
+
+// euristiche in fixed-point (costo minimo del terreno = 1)
+inline int manhattanCost(Cell a, Cell b) {
+    return kCostStraight * (std::abs(a.x - b.x) + std::abs(a.y - b.y));
+}
+
+inline int octileCost(Cell a, Cell b) {
+    const int dx = std::abs(a.x - b.x);
+    const int dy = std::abs(a.y - b.y);
+    return kCostStraight * std::max(dx, dy) + (kCostDiagonal - kCostStraight) * std::min(dx, dy);
+}
+
+#endif //SEARCHOPTIONS_H
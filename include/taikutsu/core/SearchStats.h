@@ -0,0 +1,129 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include "AStarPolicies.h"
+#include "Histogram.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Statistiche delle ricerche A*: un Recorder (StatsRecorder) che misura ogni query e un
+// collettore che le aggrega in istogrammi tra una query e l'altra.
+//
+// Uso a compile-time: BasicAStar<..., StatsRecorder<>, ...>::findPath(ctx, grid, s, g, recorder).
+// Uso a runtime: SearchOptions::stats = &collector con AStarPathfinder / ResumableSearch
+// (il dispatch sceglie istanze separate: senza collettore il loop resta quello di sempre).
+// Il collettore non è thread-safe: uno per thread (PathBatch e PathService lo ignorano).
+
+// misure di una query
+struct SearchStats {
+    std::uint64_t expanded{0};
+    std::uint64_t pushes{0};
+    std::uint64_t stalePops{0};      // copie vecchie estratte e scartate (open list senza decrease-key)
+    std::uint64_t peakOpen{0};       // massima dimensione dell'open set
+    std::uint64_t bytesAllocated{0}; // crescita dei buffer del contesto (0 a regime)
+    std::uint64_t setupNs{0};
+    std::uint64_t expandNs{0};
+    std::uint64_t pathNs{0};
+    bool found{false};
+
+    std::uint64_t totalNs() const { return setupNs + expandNs + pathNs; }
+};
+
+// riassunto di un istogramma (struct piatta, per il monitoring)
+struct StatSummary {
+    std::uint64_t count{0}, sum{0}, min{0}, max{0};
+    double mean{0.0};
+    std::uint64_t p50{0}, p90{0}, p99{0};
+};
+
+struct SearchStatsSummary {
+    std::uint64_t queries{0};
+    std::uint64_t found{0};
+    StatSummary expanded, pushes, stalePops, peakOpen, bytesAllocated;
+    StatSummary setupNs, expandNs, pathNs, totalNs;
+};
+
+// aggrega le SearchStats delle query concluse (Found / NoPath)
+class SearchStatsCollector {
+public:
+    struct Histograms {
+        ValueHistogram expanded, pushes, stalePops, peakOpen, bytesAllocated;
+        ValueHistogram setupNs, expandNs, pathNs, totalNs;
+    };
+
+    void record(const SearchStats& s);
+    void reset();
+
+    const SearchStats& last() const { return last_; } // ultima query registrata
+    const Histograms& histograms() const { return h_; }
+    SearchStatsSummary summary() const;
+
+    // dump: testo leggibile (una riga per metrica) e JSON (riassunti + bucket non vuoti)
+    std::string toText() const;
+    std::string toJson() const;
+
+private:
+    SearchStats last_;
+    std::uint64_t queries_{0}, found_{0};
+    Histograms h_;
+};
+
+// Recorder che misura la query e la consegna al collettore alla fine (Inner: cosa registrare
+// oltre alle statistiche, di default il closed set come le istanze di AStar.h).
+// Una query abbandonata prima della fine (ResumableSearch::cancel) non viene registrata.
+template <class Inner = RecordClosed>
+class StatsRecorder : public Inner {
+public:
+    static constexpr bool kProfile = true;
+
+    StatsRecorder() = default;
+    explicit StatsRecorder(SearchStatsCollector* sink) : sink_(sink) {}
+
+    const SearchStats& current() const { return current_; } // query in corso (o l'ultima)
+
+    void onExpand(AStarResult& result, Cell c, int idx) {
+        Inner::onExpand(result, c, idx);
+        ++current_.expanded;
+    }
+    void onPush() {
+        Inner::onPush();
+        ++current_.pushes;
+    }
+    void onOpenSize(size_t n) {
+        Inner::onOpenSize(n);
+        if (n > current_.peakOpen) current_.peakOpen = n;
+    }
+    void onStalePop() {
+        Inner::onStalePop();
+        ++current_.stalePops;
+    }
+    void onQueryBegin(const AStarSearchContext& ctx) {
+        Inner::onQueryBegin(ctx);
+        current_ = SearchStats{};
+        bytesBefore_ = ctx.memoryBytes();
+    }
+    void onQueryEnd(SearchStatus status, const AStarSearchContext& ctx) {
+        Inner::onQueryEnd(status, ctx);
+        const size_t after = ctx.memoryBytes();
+        current_.bytesAllocated = after > bytesBefore_ ? after - bytesBefore_ : 0;
+        current_.found = status == SearchStatus::Found;
+        if (sink_ != nullptr) sink_->record(current_);
+    }
+    void onPhase(SearchPhase phase, std::chrono::nanoseconds d) {
+        Inner::onPhase(phase, d);
+        const auto ns = static_cast<std::uint64_t>(d.count());
+        switch (phase) {
+            case SearchPhase::Setup: current_.setupNs += ns; break;
+            case SearchPhase::Expand: current_.expandNs += ns; break;
+            case SearchPhase::Path: current_.pathNs += ns; break;
+        }
+    }
+
+private:
+    SearchStatsCollector* sink_{nullptr};
+    SearchStats current_;
+    size_t bytesBefore_{0};
+};
+
+#endif //SEARCHSTATS_H
@@ -0,0 +1,61 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool di thread fisso con work-stealing.
+// Ogni worker ha la sua coda: prende i task dal fondo della propria (LIFO, cache calda)
+// e, se è vuota, ruba dalla testa di quelle degli altri. I task ricevono l'id del worker
+// (0..size()-1), utile per usare stato per-worker senza lock (es. un AStarSearchContext).
+// I task non devono lanciare eccezioni.
+class ThreadPool {
+public:
+    using Task = std::function<void(unsigned worker)>;
+
+    explicit ThreadPool(unsigned threads = 0); // 0 = std::thread::hardware_concurrency()
+    ~ThreadPool();                             // completa i task in coda, poi chiude
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); } // queues_ è completo prima dei thread
+
+    // da un worker del pool il task va nella sua coda, da fuori round-robin
+    void submit(Task task);
+
+    // attende che tutti i task inviati finora siano terminati. Non da un task del pool stesso:
+    // il worker che aspetta conta fra i pending e non finirebbe mai (deadlock)
+    void wait();
+
+    // true se chiamato da un task in esecuzione su un worker di questo pool
+    bool onWorkerThread() const;
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned id);
+    bool tryPop(unsigned id, Task& out); // prima la propria coda, poi furto
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex m_;                   // protegge stop_ e le attese
+    std::condition_variable work_;   // c'è lavoro (queued_ > 0) o stop
+    std::condition_variable idle_;   // pending_ è arrivato a 0
+    std::atomic<size_t> queued_{0};  // task in coda, non ancora presi
+    std::atomic<size_t> pending_{0}; // task inviati e non ancora terminati
+    std::atomic<unsigned> next_{0};  // round-robin per submit dall'esterno
+    bool stop_{false};
+};
+
+#endif //THREADPOOL_H
@@ -12,4 +12,15 @@ inline bool operator==(const Cell& a, const Cell& b) {
     return a.x == b.x && a.y == b.y;
 }
 
+// direzioni dei vicini; l'ordine corrisponde ai bit delle mask di GridMap
+// (bit 0..3 = 4 direzioni cardinali, bit 4..7 = diagonali)
+enum Dir : int {
+    kRight = 0, kLeft, kDown, kUp,
+    kDownRight, kDownLeft, kUpRight, kUpLeft
+};
+
+// spostamento (dx,dy) per ogni Dir
+constexpr int kDirDx[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+constexpr int kDirDy[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+
 #endif //TYPES_H
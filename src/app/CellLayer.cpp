@@ -0,0 +1,89 @@
+#include "CellLayer.h"
+#include <algorithm>
+#include <cmath>
+
+void CellLayer::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    chunksX_ = (width + kChunk - 1) / kChunk;
+    chunksY_ = (height + kChunk - 1) / kChunk;
+    chunks_.clear();
+    chunks_.resize(static_cast<size_t>(chunksX_) * static_cast<size_t>(chunksY_));
+}
+
+CellLayer::Chunk& CellLayer::chunkAt(int cx, int cy) {
+    auto& slot = chunks_[static_cast<size_t>(cy) * static_cast<size_t>(chunksX_) + static_cast<size_t>(cx)];
+    if (!slot) {
+        slot = std::make_unique<Chunk>();
+        slot->w = std::min(kChunk, width_ - cx * kChunk);
+        slot->h = std::min(kChunk, height_ - cy * kChunk);
+        slot->pixels.assign(static_cast<size_t>(slot->w) * static_cast<size_t>(slot->h) * 4, 0);
+        slot->dirtyEnd = slot->h; // la texture nuova va caricata tutta
+    }
+    return *slot;
+}
+
+void CellLayer::setCell(Cell c, sf::Color color) {
+    if (c.x < 0 || c.y < 0 || c.x >= width_ || c.y >= height_) return;
+    const int cx = c.x / kChunk, cy = c.y / kChunk;
+    Chunk& chunk = chunkAt(cx, cy);
+    const int lx = c.x - cx * kChunk, ly = c.y - cy * kChunk;
+    sf::Uint8* p = &chunk.pixels[(static_cast<size_t>(ly) * static_cast<size_t>(chunk.w) + static_cast<size_t>(lx)) * 4];
+    p[0] = color.r;
+    p[1] = color.g;
+    p[2] = color.b;
+    p[3] = color.a;
+    if (chunk.dirtyBegin == chunk.dirtyEnd) {
+        chunk.dirtyBegin = ly;
+        chunk.dirtyEnd = ly + 1;
+    } else {
+        chunk.dirtyBegin = std::min(chunk.dirtyBegin, ly);
+        chunk.dirtyEnd = std::max(chunk.dirtyEnd, ly + 1);
+    }
+    chunk.used = true;
+}
+
+void CellLayer::clear() {
+    for (const auto& chunk : chunks_) {
+        if (!chunk || !chunk->used) continue;
+        std::fill(chunk->pixels.begin(), chunk->pixels.end(), sf::Uint8{0});
+        chunk->dirtyBegin = 0;
+        chunk->dirtyEnd = chunk->h;
+        chunk->used = false;
+    }
+}
+
+void CellLayer::flush() {
+    for (const auto& chunk : chunks_) {
+        if (!chunk || chunk->dirtyBegin == chunk->dirtyEnd) continue;
+        if (!chunk->created) {
+            chunk->created = chunk->texture.create(static_cast<unsigned>(chunk->w), static_cast<unsigned>(chunk->h));
+            if (!chunk->created) continue;
+        }
+        // righe intere: la banda sporca è già contigua nei pixel, niente copie
+        const size_t offset = static_cast<size_t>(chunk->dirtyBegin) * static_cast<size_t>(chunk->w) * 4;
+        chunk->texture.update(chunk->pixels.data() + offset, static_cast<unsigned>(chunk->w),
+                              static_cast<unsigned>(chunk->dirtyEnd - chunk->dirtyBegin), 0,
+                              static_cast<unsigned>(chunk->dirtyBegin));
+        chunk->dirtyBegin = chunk->dirtyEnd = 0;
+    }
+}
+
+int CellLayer::draw(sf::RenderTarget& target, const sf::FloatRect& visible) const {
+    const int x0 = std::max(0, static_cast<int>(std::floor(visible.left / kChunk)));
+    const int y0 = std::max(0, static_cast<int>(std::floor(visible.top / kChunk)));
+    const int x1 = std::min(chunksX_ - 1, static_cast<int>(std::floor((visible.left + visible.width) / kChunk)));
+    const int y1 = std::min(chunksY_ - 1, static_cast<int>(std::floor((visible.top + visible.height) / kChunk)));
+    int draws = 0;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const auto& chunk = chunks_[static_cast<size_t>(cy) * static_cast<size_t>(chunksX_) + static_cast<size_t>(cx)];
+            if (!chunk || !chunk->used || !chunk->created) continue;
+            sf::Sprite sprite(chunk->texture);
+            sprite.setPosition(static_cast<float>(cx * kChunk), static_cast<float>(cy * kChunk));
+            target.draw(sprite);
+            ++draws;
+        }
+    }
+    return draws;
+}
@@ -0,0 +1,47 @@
+#ifndef CELLLAYER_H
+#define CELLLAYER_H
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+
+#include "taikutsu/core/GridMap.h"
+
+// Un colore per cella, disegnato come texture (un texel = una cella, coordinate del mondo in
+// celle) divisa in chunk di kChunk x kChunk: una draw per chunk visibile invece di una per
+// cella, e le texture restano sotto il limite di dimensione della GPU anche su mappe enormi.
+// setCell() scrive solo nella copia in RAM del chunk e ne allarga la banda di righe sporche;
+// flush() carica sulla GPU solo quelle righe. Un chunk mai scritto non ha né pixel né texture
+// (gli overlay sparsi, es. closed, costano solo dove c'è qualcosa); texel non scritti = trasparenti.
+class CellLayer {
+public:
+    static constexpr int kChunk = 512;
+
+    CellLayer(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height); // tutto trasparente, chunk liberati
+    void setCell(Cell c, sf::Color color);
+    void clear();                       // tutto trasparente, tiene la memoria dei chunk
+    void flush();                       // carica le righe sporche (prima di draw)
+
+    // solo i chunk che intersecano visible (coordinate del mondo); ritorna le draw fatte
+    int draw(sf::RenderTarget& target, const sf::FloatRect& visible) const;
+
+private:
+    struct Chunk {
+        int w{0}, h{0};
+        std::vector<sf::Uint8> pixels; // RGBA, w*h*4
+        sf::Texture texture;
+        bool created{false};           // texture allocata sulla GPU
+        bool used{false};              // qualche texel scritto dall'ultima clear()
+        int dirtyBegin{0}, dirtyEnd{0}; // righe da caricare [begin, end)
+    };
+
+    Chunk& chunkAt(int cx, int cy);
+
+    int width_{0}, height_{0};
+    int chunksX_{0}, chunksY_{0};
+    std::vector<std::unique_ptr<Chunk>> chunks_; // nullptr = mai scritto
+};
+
+#endif //CELLLAYER_H
@@ -1,61 +1,250 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "CellLayer.h"
 #include "taikutsu/core/GridMap.h"
 #include "taikutsu/core/AStar.h"
+#include "taikutsu/core/Hierarchical.h"
+#include "taikutsu/core/DStarLite.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapFile.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/MovingAI.h"
+#include "taikutsu/core/ResumableSearch.h"
+
+// uso: taikutsu_app [mappa .map/.txt/.tkmap | --maze <lato> | --rooms <lato> | --random <lato>]
+// (senza argomenti la griglia vuota 30x20)
+
+constexpr int kCellSize = 25;          // pixel per cella all'avvio (se la mappa ci sta)
+constexpr unsigned kMaxWindowW = 1280; // finestra iniziale al massimo così, poi zoom/pan
+constexpr unsigned kMaxWindowH = 800;
+constexpr float kGridLinesMinZoom = 8.f; // linee tra le celle solo da 8 pixel per cella in su
+
+// A* a fette: tetto di tempo per frame (60 FPS = 16.6 ms) e, con l'animazione attiva,
+// pochi nodi per frame così l'esplorazione si vede crescere
+constexpr std::chrono::microseconds kSearchFrameBudget{4000};
+constexpr size_t kAnimatedExpansionsPerFrame = 4;
+
+// algoritmo usato da Space (H alterna)
+enum class Mode { AStar, Hpa, DStarLite };
+
+const sf::Color kFreeColor(120, 120, 120);
+const sf::Color kBlockedColor(60, 60, 60);
+const sf::Color kClosedColor(40, 80, 160);
+const sf::Color kPathColor(220, 200, 0);
+
+static std::optional<GridMap> loadGrid(int argc, char** argv) {
+    if (argc < 2) return GridMap(30, 20);
+    const std::string arg = argv[1];
+    if (argc >= 3 && (arg == "--maze" || arg == "--rooms" || arg == "--random")) {
+        const int side = std::max(8, std::atoi(argv[2]));
+        if (arg == "--maze") return makeMazeMap(side, side, 2, 1);
+        if (arg == "--rooms") return makeRoomsMap(side, side, 32, 1);
+        return makeRandomMap(side, side, 0.3, 1);
+    }
+    std::string error;
+    std::optional<GridMap> grid;
+    if (arg.size() > 6 && arg.compare(arg.size() - 6, 6, ".tkmap") == 0) {
+        grid = loadMapFile(arg, &error);
+    } else {
+        // MovingAI se la prima parola è una chiave dell'header, altrimenti ASCII semplice
+        std::ifstream in(arg);
+        std::string first;
+        in >> first;
+        grid = first == "type" || first == "height" || first == "width" ? loadMovingAIMap(arg, &error)
+                                                                         : loadAsciiMap(arg, &error);
+    }
+    if (!grid) std::fprintf(stderr, "%s: %s\n", arg.c_str(), error.c_str());
+    return grid;
+}
 
-constexpr int kCellSize = 25;
+// rettangolo del mondo (in celle) visto dalla view: per il culling
+static sf::FloatRect visibleArea(const sf::View& view) {
+    const sf::Vector2f size = view.getSize();
+    const sf::Vector2f center = view.getCenter();
+    return {center.x - size.x / 2.f, center.y - size.y / 2.f, size.x, size.y};
+}
+
+// pixel per cella con questa view nella finestra
+static float zoomOf(const sf::RenderWindow& window, const sf::View& view) {
+    return static_cast<float>(window.getSize().x) / view.getSize().x;
+}
 
-static std::optional<Cell> mouseToCell(const sf::RenderWindow& window,
+// tutta la mappa nella finestra, al massimo kCellSize pixel per cella
+static void fitView(sf::View& view, const sf::RenderWindow& window, const GridMap& grid) {
+    const sf::Vector2u size = window.getSize();
+    const float zoom = std::min({static_cast<float>(kCellSize), static_cast<float>(size.x) / static_cast<float>(grid.width()),
+                                 static_cast<float>(size.y) / static_cast<float>(grid.height())});
+    view.setSize(static_cast<float>(size.x) / zoom, static_cast<float>(size.y) / zoom);
+    view.setCenter(static_cast<float>(grid.width()) / 2.f, static_cast<float>(grid.height()) / 2.f);
+}
+
+static std::optional<Cell> mouseToCell(const sf::RenderWindow& window, const sf::View& view,
                                        const GridMap& grid) {
     const auto m = sf::Mouse::getPosition(window);
-    if (m.x < 0 || m.y < 0) return std::nullopt;
+    const sf::Vector2u size = window.getSize();
+    if (m.x < 0 || m.y < 0 || m.x >= static_cast<int>(size.x) || m.y >= static_cast<int>(size.y)) return std::nullopt;
 
-    Cell c{ m.x / kCellSize, m.y / kCellSize };
+    const sf::Vector2f p = window.mapPixelToCoords(m, view);
+    Cell c{ static_cast<int>(std::floor(p.x)), static_cast<int>(std::floor(p.y)) };
     if (!grid.inBounds(c)) return std::nullopt;
     return c;
 }
 
-static void setTitle(sf::RenderWindow& window, const std::string& status) {
-    window.setTitle("Taikutsu - A* | " + status);
+// linee tra le celle (il "bordo" nero delle celle da 24 px di una volta), solo nell'area visibile
+static void buildGridLines(sf::VertexArray& lines, const sf::FloatRect& area, const GridMap& grid) {
+    lines.clear();
+    const int x0 = std::max(0, static_cast<int>(std::floor(area.left)));
+    const int y0 = std::max(0, static_cast<int>(std::floor(area.top)));
+    const int x1 = std::min(grid.width(), static_cast<int>(std::ceil(area.left + area.width)));
+    const int y1 = std::min(grid.height(), static_cast<int>(std::ceil(area.top + area.height)));
+    for (int x = x0; x <= x1; ++x) {
+        lines.append(sf::Vertex(sf::Vector2f(static_cast<float>(x), static_cast<float>(y0)), sf::Color::Black));
+        lines.append(sf::Vertex(sf::Vector2f(static_cast<float>(x), static_cast<float>(y1)), sf::Color::Black));
+    }
+    for (int y = y0; y <= y1; ++y) {
+        lines.append(sf::Vertex(sf::Vector2f(static_cast<float>(x0), static_cast<float>(y)), sf::Color::Black));
+        lines.append(sf::Vertex(sf::Vector2f(static_cast<float>(x1), static_cast<float>(y)), sf::Color::Black));
+    }
+}
+
+static void appendQuad(sf::VertexArray& quads, Cell c, sf::Color color) {
+    const auto x = static_cast<float>(c.x), y = static_cast<float>(c.y);
+    quads.append(sf::Vertex(sf::Vector2f(x, y), color));
+    quads.append(sf::Vertex(sf::Vector2f(x + 1.f, y), color));
+    quads.append(sf::Vertex(sf::Vector2f(x + 1.f, y + 1.f), color));
+    quads.append(sf::Vertex(sf::Vector2f(x, y + 1.f), color));
 }
 
-int main() {
-    constexpr int gridW = 30;
-    constexpr int gridH = 20;
+int main(int argc, char** argv) {
+    std::optional<GridMap> loaded = loadGrid(argc, argv);
+    if (!loaded) return 1;
+    GridMap grid = std::move(*loaded);
+    const int gridW = grid.width();
+    const int gridH = grid.height();
 
     sf::RenderWindow window(
-        sf::VideoMode(gridW * kCellSize, gridH * kCellSize),
+        sf::VideoMode(std::min(kMaxWindowW, static_cast<unsigned>(gridW) * kCellSize),
+                      std::min(kMaxWindowH, static_cast<unsigned>(gridH) * kCellSize)),
         "Taikutsu - A*"
     );
     window.setFramerateLimit(60);
-
-    GridMap grid(gridW, gridH);
+    sf::View view = window.getDefaultView(); // coordinate del mondo = celle
+    fitView(view, window, grid);
+
+    // cluster HPA* più grandi sulle mappe grandi (astrazione e costruzione restano piccole)
+    const bool large = static_cast<long long>(gridW) * gridH > (1 << 20);
+    HierarchicalPathfinder hpa(grid, large ? 32 : 8); // astrazione HPA*, aggiornata solo nei cluster toccati dal pennello
+    DStarLitePathfinder dstar(grid);     // D* Lite: ripara il percorso precedente invece di ripartire
+    ConnectivityIndex components(grid);  // componenti connesse: "NO PATH" senza ricerca
+    SearchOptions opts;
+    opts.components = &components;
+    opts.recordClosed = ClosedRecording::List; // l'app disegna le celle esplorate, in ordine
+    std::vector<Cell> edits;             // celle dipinte dall'ultimo D* Lite
+    std::optional<Cell> plannedStart, plannedGoal;
+    Mode mode = Mode::AStar;
     std::optional<Cell> start;
     std::optional<Cell> goal;
 
     std::optional<AStarResult> last;
+    ResumableSearch search;                // A* di Space: avanza un po' ad ogni frame;
+                                           // ogni modifica (grid, start/goal, modo) la cancella
+    bool animate = true;                   // A: esplorazione animata / solo tetto di tempo
     bool painting = false;                 // LMB pressed
     bool erasing  = false;                 // RMB pressed (opcional)
+    bool panning  = false;                 // MMB pressed: arrasta a view
+    sf::Vector2i panFrom;
     std::optional<Cell> lastPainted;       // evita repetir na mesma célula
 
+    // layer disegnati in blocco: grid (ridisegnato solo nelle celle cambiate), closed (cresce
+    // con la ricerca a fette: si aggiungono solo le celle nuove), path
+    CellLayer base(gridW, gridH);
+    CellLayer closedLayer(gridW, gridH);
+    size_t closedDrawn = 0;                // celle di shown->closed già nel layer
+    sf::VertexArray pathQuads(sf::Quads);
+    size_t pathDrawn = 0;
+    sf::VertexArray gridLines(sf::Lines);
+    sf::RectangleShape marker(sf::Vector2f(1.f, 1.f)); // hover, start, goal
+
+    auto paintBase = [&] {
+        for (int y = 0; y < gridH; ++y)
+            for (int x = 0; x < gridW; ++x) base.setCell(Cell{x, y}, grid.isBlocked(Cell{x, y}) ? kBlockedColor : kFreeColor);
+    };
+    paintBase();
+
+    // il titolo: stato + tempo per frame (aggiornato due volte al secondo, setTitle non è gratis)
+    std::string status;
+    sf::Clock frameClock, titleClock;
+    double frameMs = 0.0, workMs = 0.0;
+    int draws = 0;
+    auto setTitle = [&](const std::string& s) {
+        status = s;
+        char timing[96];
+        std::snprintf(timing, sizeof(timing), " | %.1f fps, %.2f ms/frame, %d draws", frameMs > 0.0 ? 1000.0 / frameMs : 0.0,
+                      workMs, draws);
+        window.setTitle("Taikutsu - A* | " + status + timing);
+        titleClock.restart();
+    };
+
+    // resultado descartado: ricerca cancellata e overlay vuoti
+    auto clearResult = [&] {
+        search.cancel();
+        last.reset();
+        closedLayer.clear();
+        closedDrawn = 0;
+        pathQuads.clear();
+        pathDrawn = 0;
+    };
+
+    // esito di una ricerca nel titolo
+    auto report = [&](const std::string& name, const AStarResult& r) {
+        if (r.success) {
+            setTitle(name + "PATH FOUND | len=" + std::to_string(r.path.size()) +
+                     " | expanded=" + std::to_string(r.closed.size()));
+        } else if (start && goal && !components.connected(*start, *goal)) {
+            setTitle("NO PATH (start/goal in different regions)");
+        } else {
+            setTitle("NO PATH (see explored nodes)");
+        }
+    };
 
-    sf::RectangleShape cellShape(
-        sf::Vector2f(static_cast<float>(kCellSize - 1),
-                     static_cast<float>(kCellSize - 1))
-    );
-
-    setTitle(window, "LMB paint obstacle | S start | G goal | Space run | R clear result | C clear grid");
+    setTitle("LMB paint | MMB/arrows pan | wheel zoom | F fit | S start | G goal | Space run | H A*/HPA*/D* Lite | A animate | R clear result | C clear grid");
 
     while (window.isOpen()) {
         // célula sob o mouse (hover + comandos S/G)
-        const auto hovered = mouseToCell(window, grid);
+        const auto hovered = mouseToCell(window, view, grid);
 
         sf::Event event{};
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) window.close();
 
+            // finestra ridimensionata: stessa scala, più o meno mondo visibile
+            if (event.type == sf::Event::Resized) {
+                const float zoom = zoomOf(window, view);
+                view.setSize(static_cast<float>(event.size.width) / zoom, static_cast<float>(event.size.height) / zoom);
+            }
+
+            // rotella: zoom attorno al cursore (la cella sotto il mouse resta ferma)
+            if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+                const sf::Vector2i pixel(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                const sf::Vector2f before = window.mapPixelToCoords(pixel, view);
+                const float factor = event.mouseWheelScroll.delta > 0 ? 0.8f : 1.25f;
+                const float zoom = zoomOf(window, view) / factor;
+                if (zoom >= 0.05f && zoom <= 64.f) {
+                    view.zoom(factor);
+                    const sf::Vector2f after = window.mapPixelToCoords(pixel, view);
+                    view.move(before.x - after.x, before.y - after.y);
+                }
+            }
+
             // mouse press/release: ativa/desativa pincel (paint)
             if (event.type == sf::Event::MouseButtonPressed) {
                 if (event.mouseButton.button == sf::Mouse::Left) {
@@ -66,6 +255,10 @@ int main() {
                     erasing = true;
                     lastPainted.reset();
                 }
+                if (event.mouseButton.button == sf::Mouse::Middle) {
+                    panning = true;
+                    panFrom = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+                }
             }
 
             if (event.type == sf::Event::MouseButtonReleased) {
@@ -77,6 +270,14 @@ int main() {
                     erasing = false;
                     lastPainted.reset();
                 }
+                if (event.mouseButton.button == sf::Mouse::Middle) panning = false;
+            }
+
+            if (event.type == sf::Event::MouseMoved && panning) {
+                const sf::Vector2i to(event.mouseMove.x, event.mouseMove.y);
+                const float zoom = zoomOf(window, view);
+                view.move(static_cast<float>(panFrom.x - to.x) / zoom, static_cast<float>(panFrom.y - to.y) / zoom);
+                panFrom = to;
             }
 
 
@@ -86,41 +287,77 @@ int main() {
                 if (event.key.code == sf::Keyboard::S && hovered) {
                     if (grid.isWalkable(*hovered)) {
                         start = *hovered;
-                        last.reset();
+                        clearResult();
                     }
                 }
                 if (event.key.code == sf::Keyboard::G && hovered) {
                     if (grid.isWalkable(*hovered)) {
                         goal = *hovered;
-                        last.reset();
+                        clearResult();
                     }
                 }
 
-                // space: roda A*
+                // space: roda A* (a fette, vedi sotto) / HPA* / D* Lite
                 if (event.key.code == sf::Keyboard::Space) {
                     if (start && goal) {
-                        last = AStarPathfinder::findPath(grid, *start, *goal);
-                        if (last->success) {
-                            setTitle(window, "PATH FOUND | len=" + std::to_string(last->path.size()));
+                        clearResult();
+                        std::string name;
+                        if (mode == Mode::Hpa) {
+                            last = hpa.findPath(*start, *goal);
+                            name = "HPA* ";
+                        } else if (mode == Mode::DStarLite) {
+                            // stessi start/goal: solo riparazione (closed = nós re-expandidos)
+                            const bool same = plannedStart && plannedGoal && *plannedStart == *start && *plannedGoal == *goal;
+                            last = same ? dstar.replan(edits) : dstar.plan(*start, *goal);
+                            plannedStart = start;
+                            plannedGoal = goal;
+                            edits.clear();
+                            name = same ? "D* Lite replan " : "D* Lite ";
                         } else {
-                            setTitle(window, "NO PATH (see explored nodes)");
+                            search.start(grid, *start, *goal, opts);
+                            if (!search.running()) last = search.result(); // start == goal, regioni diverse, ...
+                            name = "A* ";
                         }
+                        if (last) report(name, *last);
                     } else {
-                        setTitle(window, "set START (S) and GOAL (G) first");
+                        setTitle("set START (S) and GOAL (G) first");
                     }
                 }
 
+                // H: alterna A* / HPA* (closed = nós abstratos expandidos) / D* Lite
+                if (event.key.code == sf::Keyboard::H) {
+                    if (mode == Mode::AStar) mode = Mode::Hpa;
+                    else if (mode == Mode::Hpa) mode = Mode::DStarLite;
+                    else mode = Mode::AStar;
+                    clearResult();
+                    setTitle(mode == Mode::AStar ? "mode: A*" : mode == Mode::Hpa ? "mode: HPA*" : "mode: D* Lite");
+                }
+
+                // A: A* animato (pochi nodi per frame) o solo col tetto di tempo per frame
+                if (event.key.code == sf::Keyboard::A) {
+                    animate = !animate;
+                    setTitle(animate ? "A* animation on" : "A* animation off");
+                }
+
+                // F: tutta la mappa nella finestra
+                if (event.key.code == sf::Keyboard::F) fitView(view, window, grid);
+
                 // R: limpa só resultado (path + closed)
                 if (event.key.code == sf::Keyboard::R) {
-                    last.reset();
-                    setTitle(window, "result cleared");
+                    clearResult();
+                    setTitle("result cleared");
                 }
 
                 // C: limpa o grid todo (obstáculos) + resultado
                 if (event.key.code == sf::Keyboard::C) {
+                    clearResult(); // la ricerca tiene un riferimento al grid
                     grid = GridMap(gridW, gridH);
-                    last.reset();
-                    setTitle(window, "grid cleared");
+                    hpa.rebuild();
+                    components.rebuild();
+                    plannedStart.reset(); // D* Lite riparte da zero
+                    edits.clear();
+                    paintBase();
+                    setTitle("grid cleared");
                 }
 
                 // Esc: fecha
@@ -130,6 +367,15 @@ int main() {
             }
         }
 
+        // frecce: pan continuo (mezzo schermo al secondo, a qualunque zoom)
+        if (window.hasFocus()) {
+            const sf::Vector2f step(view.getSize().x / 120.f, view.getSize().y / 120.f);
+            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) view.move(-step.x, 0.f);
+            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) view.move(step.x, 0.f);
+            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) view.move(0.f, -step.y);
+            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) view.move(0.f, step.y);
+        }
+
         // pincel (drag): pinta/apaga enquanto o botão estiver pressionado
         if (hovered) {
             const bool isStart = (start && (*hovered == *start));
@@ -140,12 +386,20 @@ int main() {
 
                     if (painting && !grid.isBlocked(*hovered)) {
                         grid.setBlocked(*hovered, true);
-                        last.reset();
+                        hpa.notifyChanged(*hovered);
+                        components.notifyChanged(*hovered);
+                        edits.push_back(*hovered);
+                        base.setCell(*hovered, kBlockedColor);
+                        clearResult();
                     }
 
                     if (erasing && grid.isBlocked(*hovered)) { // opcional
                         grid.setBlocked(*hovered, false);
-                        last.reset();
+                        hpa.notifyChanged(*hovered);
+                        components.notifyChanged(*hovered);
+                        edits.push_back(*hovered);
+                        base.setCell(*hovered, kFreeColor);
+                        clearResult();
                     }
 
                     lastPainted = *hovered;
@@ -153,62 +407,69 @@ int main() {
             }
         }
 
-        window.clear(sf::Color::Black);
-
-        // 1) desenha o grid base (livre/obstáculo + hover)
-        for (int y = 0; y < grid.height(); ++y) {
-            for (int x = 0; x < grid.width(); ++x) {
-                Cell c{x, y};
-
-                if (grid.isBlocked(c)) cellShape.setFillColor(sf::Color(60, 60, 60));
-                else                   cellShape.setFillColor(sf::Color(120, 120, 120));
-
-                if (hovered && c == *hovered &&
-                    (!start || !(c == *start)) &&
-                    (!goal  || !(c == *goal))) {
-                    cellShape.setFillColor(sf::Color(180, 180, 180));
-                }
-
-                cellShape.setPosition(static_cast<float>(x * kCellSize),
-                                      static_cast<float>(y * kCellSize));
-                window.draw(cellShape);
+        // A* in corso: una fetta per frame, il frame non si blocca anche su mappe grandi
+        if (search.running()) {
+            search.stepFor(kSearchFrameBudget, animate ? kAnimatedExpansionsPerFrame : SIZE_MAX);
+            if (search.running()) {
+                status = "A* searching... expanded=" + std::to_string(search.expanded());
+            } else {
+                last = search.result();
+                report("A* ", *last);
             }
         }
-
-        // 2) overlay: explorados (closed) e path (se houver)
-        if (last) {
-            // explorados (closed) - azul
-            cellShape.setFillColor(sf::Color(40, 80, 160));
-            for (const auto& c : last->closed) {
-                cellShape.setPosition(static_cast<float>(c.x * kCellSize),
-                                      static_cast<float>(c.y * kCellSize));
-                window.draw(cellShape);
-            }
-
-            // caminho final (path) - amarelo
-            cellShape.setFillColor(sf::Color(220, 200, 0));
-            for (const auto& c : last->path) {
-                cellShape.setPosition(static_cast<float>(c.x * kCellSize),
-                                      static_cast<float>(c.y * kCellSize));
-                window.draw(cellShape);
+        // durante la ricerca si disegna il risultato parziale (closed finora)
+        const AStarResult* shown = search.running() ? &search.result() : last ? &*last : nullptr;
+
+        // overlay: solo le celle nuove (closed cresce, il path arriva tutto alla fine)
+        if (shown) {
+            for (; closedDrawn < shown->closed.size(); ++closedDrawn) closedLayer.setCell(shown->closed[closedDrawn], kClosedColor);
+            if (pathDrawn != shown->path.size()) {
+                pathQuads.clear();
+                for (const Cell& c : shown->path) appendQuad(pathQuads, c, kPathColor);
+                pathDrawn = shown->path.size();
             }
         }
+        base.flush();
+        closedLayer.flush();
 
-        // 3) start/goal por cima de tudo
-        if (start) {
-            cellShape.setFillColor(sf::Color(0, 180, 0));
-            cellShape.setPosition(static_cast<float>(start->x * kCellSize),
-                                  static_cast<float>(start->y * kCellSize));
-            window.draw(cellShape);
+        window.clear(sf::Color::Black);
+        window.setView(view);
+        const sf::FloatRect area = visibleArea(view);
+        const float zoom = zoomOf(window, view);
+
+        // 1) grid base, 2) explorados (closed) - azul, 3) caminho (path) - amarelo
+        draws = base.draw(window, area);
+        draws += closedLayer.draw(window, area);
+        if (pathQuads.getVertexCount() > 0) {
+            window.draw(pathQuads);
+            ++draws;
         }
-        if (goal) {
-            cellShape.setFillColor(sf::Color(180, 0, 0));
-            cellShape.setPosition(static_cast<float>(goal->x * kCellSize),
-                                  static_cast<float>(goal->y * kCellSize));
-            window.draw(cellShape);
+        if (zoom >= kGridLinesMinZoom) {
+            buildGridLines(gridLines, area, grid);
+            window.draw(gridLines);
+            ++draws;
+        }
+
+        // 4) hover, start/goal por cima de tudo (almeno 6 pixel anche da lontano)
+        const float side = std::max(1.f, 6.f / zoom);
+        marker.setSize(sf::Vector2f(side, side));
+        auto drawMarker = [&](Cell c, sf::Color color) {
+            marker.setFillColor(color);
+            marker.setPosition(static_cast<float>(c.x) + 0.5f - side / 2.f, static_cast<float>(c.y) + 0.5f - side / 2.f);
+            window.draw(marker);
+            ++draws;
+        };
+        if (hovered && (!start || !(*hovered == *start)) && (!goal || !(*hovered == *goal))) {
+            drawMarker(*hovered, sf::Color(180, 180, 180));
         }
+        if (start) drawMarker(*start, sf::Color(0, 180, 0));
+        if (goal) drawMarker(*goal, sf::Color(180, 0, 0));
 
+        // tempo per frame: lavoro della CPU (senza l'attesa di setFramerateLimit) e frame intero
+        workMs = 0.9 * workMs + 0.1 * static_cast<double>(frameClock.getElapsedTime().asMicroseconds()) / 1000.0;
         window.display();
+        frameMs = 0.9 * frameMs + 0.1 * static_cast<double>(frameClock.restart().asMicroseconds()) / 1000.0;
+        if (titleClock.getElapsedTime().asMilliseconds() >= 500) setTitle(status);
     }
 
     return 0;
@@ -1,147 +1,26 @@
 #include "taikutsu/core/AStar.h"
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
-#include <algorithm>
+#include "taikutsu/core/ConnectivityIndex.h"
 
-namespace { //namespace anonimo, tutto è di uso interno di questo .cpp, evita conflitto di nomi e evita accesso esterno
-
-    // Transforma la coppia (x,y) in un valore numerico (hash)
-    // usato per trovare velocemente i dati nelle strutture unordered_map e unordered_set (permettere ricerca veloce)
-    struct CellHash {
-        size_t operator()(const Cell& c) const noexcept {
-            // hash simples e suficiente pra grid pequeno/médio (combina dois inteiros c.x, c.y)
-            return (static_cast<size_t>(c.x) << 32) ^ static_cast<size_t>(c.y);
-        }
-    };
-
-    //heuristics
-    int manhattan(Cell a, Cell b) {
-        return std::abs(a.x - b.x) + std::abs(a.y - b.y);
-    }
-
-    // ricostruisce la strada finale usando cameFrom (da goal a start)
-    std::vector<Cell> reconstructPath(
-        const std::unordered_map<Cell, Cell, CellHash>& cameFrom,
-        Cell start, Cell goal
-    ) {
-        std::vector<Cell> path;
-        Cell cur = goal;
-        path.push_back(cur);
-
-        while (!(cur == start)) {
-            auto it = cameFrom.find(cur);
-            if (it == cameFrom.end()) {
-                // não deveria acontecer se success=true, mas evita loop infinito
-                return {};
-            }
-            cur = it->second;
-            path.push_back(cur);
-        }
-
-        std::reverse(path.begin(), path.end()); //inverte ordem dos elementos em um intervalo
-        return path;
-    }
-
-    // Nodo nella coda di priorità
-    struct PQNode {
-        Cell c; // qualle cella del grid
-        int f;  // priorità (f = g + h)
-        int g;  // costo reale dallo start fino a questa cella
-    };
-
-    // comparatore usato dalla coda di priorità, decide chi ha "piu priorità"
-    // return del nodo con valore di f minore
-    struct PQCmp {
-        bool operator()(const PQNode& a, const PQNode& b) const {
-            // priority_queue é max-heap por padrão(elemento maior no topo); invertendo comparação vira min-heap por f
-            return a.f > b.f; //return di f minore
-        }
-    };
+AStarResult AStarPathfinder::findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    AStarSearchContext ctx;
+    findPath(ctx, grid, start, goal, opts);
+    return ctx.result();
 }
 
-
-AStarResult AStarPathfinder::findPath(const GridMap& grid, Cell start, Cell goal) {
-    AStarResult result;
-
-    //controllare se start/goal sono all'interno della mappa
-    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return result;
-
-    if (start == goal) {
-        result.success = true;
-        result.path = {start};
-        return result;
-    }
-
-    //open set: nodi candidati scoperti a essere espansi/esplorati (priority queue di PQNode)
-    std::priority_queue<PQNode, std::vector<PQNode>, PQCmp> open; //PQCmo fa il prossimo candidato essere quello di minore f
-
-    //closed set: insieme di nodi già espansi (per evitare di espandere di nuovo)
-    std::unordered_set<Cell, CellHash> closedSet;
-
-    //gScore[c] = miglior costo conosciuto da start fino a c (current cell)
-    std::unordered_map<Cell, int, CellHash> gScore;
-
-    // cameFrom[child] = parent, per ricostruire la strada alla fine
-    std::unordered_map<Cell, Cell, CellHash> cameFrom;
-
-
-
-    gScore[start] = 0; //il costo per arrivare da start partendo da start é 0
-    open.push(PQNode{start, manhattan(start, goal), 0}); //mette start su open set
-
-    while (!open.empty()) { //continua mentre ci sono candidati sulla 'frontiera' open set
-        PQNode current = open.top(); //seleciona nó com menor f
-        open.pop(); //remove nó da fila pois ele vai ser processado.
-
-        // “skip” entradas desatualizadas:
-        // Como std::priority_queue não tem decrease-key,
-        // quando encontramos um caminho melhor para uma célula,
-        // empilhamos um novo nó e deixamos o antigo na fila.
-        //Aqui verificamos se este é o melhor nó para essa célula
-        auto itG = gScore.find(current.c);
-        if (itG == gScore.end() || current.g != itG->second) continue;
-
-        //se a célula está no closed set, sem sentido explorar de novo
-        if (closedSet.contains(current.c)) continue;
-
-        // marca current cell como explorada
-        closedSet.insert(current.c);
-        result.closed.push_back(current.c); //pra debug/visualização
-
-        //se chegamos no objetivo
-        if (current.c == goal) {
-            result.success = true;
-            //reconstrói o caminho de goal até start
-            result.path = reconstructPath(cameFrom, start, goal);
-            return result;
-        }
-
-        //explora os vizinhos em 4 direções
-        for (Cell nb : grid.neighbors4(current.c)) {
-            if (closedSet.contains(nb)) continue; //ignora os já explorados
-
-            const int tentativeG = current.g + 1; // custo unitário de 1 por movimento aos 4 vizinhos
-
-            //verifica se:
-            //1. vizinho já não foi visitado, ou
-            //2. encontramos um caminho mais barato até ele
-            auto it = gScore.find(nb);
-            const bool better = (it == gScore.end()) || tentativeG < it->second;
-
-            if (better) {
-                //atualiza melhor caminho conhecido até vizinho
-                cameFrom[nb] = current.c;
-                gScore[nb] = tentativeG;
-                // f = (custo real) g + heuristics (h)
-                const int f = tentativeG + manhattan(nb, goal);
-
-                // insere vizinho no open set como novo candidato a exploração
-                open.push(PQNode{nb, f, tentativeG});
-            }
-        }
+const AStarResult& AStarPathfinder::findPath(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                             const SearchOptions& opts) {
+    // componenti diverse: nessuna ricerca (niente flood di tutta la componente di start)
+    if (opts.components && !opts.components->connected(start, goal)) {
+        ctx.resize(grid);
+        ctx.beginQuery();
+        if (opts.output.buffer != nullptr) opts.output.buffer->clear();
+        return ctx.result_;
     }
 
-    // sem caminho
-    return result;
+    // dispatch una volta per query verso l'istanza specializzata
+    return dispatchAStar(grid, opts, [&]<class A>() -> const AStarResult& {
+        auto recorder = makeRecorder<typename A::RecorderType>(opts);
+        return A::findPath(ctx, grid, start, goal, recorder, opts.output,
+                           makeHeuristic<typename A::HeuristicType>(opts, goal));
+    });
 }
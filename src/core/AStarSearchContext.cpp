@@ -0,0 +1,33 @@
+#include "taikutsu/core/AStarSearchContext.h"
+#include <cstddef>
+
+void AStarSearchContext::resize(const GridMap& grid) {
+    if (grid.stride() == stride_ && grid.height() == h_ && !nodes_.empty()) return;
+
+    stride_ = grid.stride();
+    h_ = grid.height();
+    nodes_.assign(grid.indexCount(), NodeRecord{});
+    generation_ = 0;
+}
+
+void AStarSearchContext::beginQuery() {
+    ++generation_;
+    // overflow del contatore (dopo 2^32 query): i vecchi stamp tornerebbero "validi",
+    // quindi azzeriamo tutto una volta e ripartiamo da 1
+    if (generation_ == 0) {
+        for (NodeRecord& n : nodes_) n.stamp = 0;
+        generation_ = 1;
+    }
+    open_.heap.clear();
+    result_.clear();
+}
+
+size_t AStarSearchContext::memoryBytes() const {
+    size_t bytes = nodes_.capacity() * sizeof(NodeRecord) + open_.heap.capacity() * sizeof(OpenEntry) +
+                   open_.heapPos.capacity() * sizeof(int);
+    for (const auto& bucket : open_.radix) bytes += bucket.capacity() * sizeof(OpenEntry);
+    bytes += (result_.path.capacity() + result_.closed.capacity()) * sizeof(Cell);
+    bytes += result_.closedBits.capacity() * sizeof(std::uint64_t);
+    bytes += result_.closedWords.capacity() * sizeof(std::uint32_t);
+    return bytes;
+}
@@ -0,0 +1,215 @@
+#include "taikutsu/core/BidirectionalAStar.h"
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/OpenList.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr std::uint64_t kNoPath = ~std::uint64_t{0};
+
+    std::uint64_t pack(std::uint32_t generation, int g) {
+        return static_cast<std::uint64_t>(generation) << 32 | static_cast<std::uint32_t>(g);
+    }
+
+    int signOf(int v) { return (v > 0) - (v < 0); }
+}
+
+void BidirectionalSearchContext::resize(const GridMap& grid) {
+    const size_t n = grid.indexCount();
+    if (forward_.g.size() == n) return;
+    for (Side* side : {&forward_, &backward_}) {
+        side->g.assign(n, 0);
+        side->parent.assign(n, -1);
+    }
+    generation_ = 0;
+}
+
+size_t BidirectionalSearchContext::memoryBytes() const {
+    size_t bytes = 0;
+    for (const Side* side : {&forward_, &backward_}) {
+        bytes += side->g.capacity() * sizeof(std::uint64_t) + side->parent.capacity() * sizeof(int) +
+                 side->open.heap.capacity() * sizeof(AStarSearchContext::OpenEntry) +
+                 side->closed.capacity() * sizeof(int);
+    }
+    bytes += cells_.capacity() * sizeof(Cell) + result_.path.capacity() * sizeof(Cell) +
+             result_.closed.capacity() * sizeof(Cell) + result_.closedBits.capacity() * sizeof(std::uint64_t) +
+             result_.closedWords.capacity() * sizeof(std::uint32_t);
+    return bytes + single_.memoryBytes();
+}
+
+bool BidirectionalAStar::twoSided(Cell start, Cell goal, const SearchOptions& opts, int minParallelEstimate) {
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool octile = opts.heuristic == HeuristicKind::Octile || (opts.heuristic == HeuristicKind::Auto && eight);
+    const int estimate = octile ? octileCost(start, goal) : manhattanCost(start, goal);
+    const bool admissible = !eight || octile;
+    return estimate >= minParallelEstimate && start != goal && admissible;
+}
+
+AStarResult BidirectionalAStar::findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    // query corta: un thread solo, niente array a due lati da allocare e buttare
+    if (!twoSided(start, goal, opts, BidirectionalSearchContext::kDefaultMinParallelEstimate))
+        return AStarPathfinder::findPath(grid, start, goal, opts);
+    BidirectionalSearchContext ctx;
+    return findPath(ctx, grid, start, goal, opts);
+}
+
+const AStarResult& BidirectionalAStar::findPath(BidirectionalSearchContext& ctx, const GridMap& grid, Cell start,
+                                                Cell goal, const SearchOptions& opts) {
+    if (!twoSided(start, goal, opts, ctx.minParallelEstimate_))
+        return AStarPathfinder::findPath(ctx.single_, grid, start, goal, opts);
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool octile = opts.heuristic == HeuristicKind::Octile || (opts.heuristic == HeuristicKind::Auto && eight);
+
+    AStarResult& result = ctx.result_;
+    result.clear();
+    if (opts.output.buffer != nullptr) opts.output.buffer->clear();
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return result;
+    if (opts.components && !opts.components->connected(start, goal)) return result;
+
+    ctx.resize(grid);
+    if (++ctx.generation_ == 0) { // overflow: i record vecchi potrebbero sembrare nuovi
+        for (Side* side : {&ctx.forward_, &ctx.backward_}) std::fill(side->g.begin(), side->g.end(), 0);
+        ctx.generation_ = 1;
+    }
+    const std::uint32_t generation = ctx.generation_;
+    const int s = grid.index(start), t = grid.index(goal);
+    for (Side* side : {&ctx.forward_, &ctx.backward_}) {
+        side->closed.clear();
+        side->expanded = 0;
+    }
+    ctx.forward_.g[static_cast<size_t>(s)] = pack(generation, 0);
+    ctx.forward_.parent[static_cast<size_t>(s)] = -1;
+    ctx.backward_.g[static_cast<size_t>(t)] = pack(generation, 0);
+    ctx.backward_.parent[static_cast<size_t>(t)] = -1;
+    ctx.forward_.top.store(0, std::memory_order_relaxed);
+    ctx.backward_.top.store(0, std::memory_order_relaxed);
+    ctx.best_.store(kNoPath, std::memory_order_relaxed);
+    ctx.stop_.store(false, std::memory_order_relaxed);
+
+    const bool weighted = opts.useTerrainCost && grid.hasCosts();
+    const bool cornerCutting = eight && opts.cornerCutting;
+    const bool record = opts.recordClosed != ClosedRecording::None;
+    auto run = [&](Side& self, const Side& other, int from, Cell target, bool forward) {
+        if (eight) {
+            if (weighted) searchSide<true, true>(ctx, grid, self, other, from, target, forward, cornerCutting, octile, record);
+            else searchSide<true, false>(ctx, grid, self, other, from, target, forward, cornerCutting, octile, record);
+        } else {
+            if (weighted) searchSide<false, true>(ctx, grid, self, other, from, target, forward, false, octile, record);
+            else searchSide<false, false>(ctx, grid, self, other, from, target, forward, false, octile, record);
+        }
+    };
+    // il lato all'indietro sul thread di aiuto, quello in avanti qui; wait() = happens-before
+    // per tutto quello che il lato all'indietro ha scritto
+    if (!ctx.helper_) ctx.helper_ = std::make_unique<ThreadPool>(1);
+    ctx.helper_->submit([&](unsigned) { run(ctx.backward_, ctx.forward_, t, start, false); });
+    run(ctx.forward_, ctx.backward_, s, goal, true);
+    ctx.helper_->wait();
+
+    result.expanded = ctx.forward_.expanded + ctx.backward_.expanded;
+    if (opts.recordClosed == ClosedRecording::List) {
+        for (const Side* side : {&ctx.forward_, &ctx.backward_})
+            for (const int idx : side->closed) result.closed.push_back(grid.cellAt(idx));
+    } else if (opts.recordClosed == ClosedRecording::Bitmap) {
+        for (const Side* side : {&ctx.forward_, &ctx.backward_})
+            for (const int idx : side->closed) result.markClosed(idx);
+    }
+
+    const std::uint64_t best = ctx.best_.load(std::memory_order_relaxed);
+    if (best == kNoPath) return result;
+    const int meet = static_cast<int>(best & 0xFFFFFFFFu);
+    // g attuali: la somma può essere scesa dopo l'incontro registrato, mai salita
+    result.cost = static_cast<int>(ctx.forward_.g[static_cast<size_t>(meet)] & 0xFFFFFFFFu) +
+                  static_cast<int>(ctx.backward_.g[static_cast<size_t>(meet)] & 0xFFFFFFFFu);
+    result.success = true;
+    writePath(ctx, grid, meet, opts.output);
+    return result;
+}
+
+template <bool kEight, bool kWeighted>
+void BidirectionalAStar::searchSide(BidirectionalSearchContext& ctx, const GridMap& grid, Side& self,
+                                    const Side& other, int from, Cell target, bool forward, bool cornerCutting,
+                                    bool octile, bool record) {
+    const std::uint32_t generation = ctx.generation_;
+    const std::uint8_t* terrain = kWeighted ? grid.costs() : nullptr;
+    const Cell source = grid.cellAt(from);
+    // potenziale medio (raddoppiato per restare in interi): chiave = 2g + h(idx)
+    auto h = [&](int idx) {
+        const Cell c = grid.cellAt(idx);
+        return octile ? octileCost(c, target) - octileCost(c, source)
+                      : manhattanCost(c, target) - manhattanCost(c, source);
+    };
+    auto offer = [&](std::uint64_t cost, int idx) {
+        const std::uint64_t candidate = cost << 32 | static_cast<std::uint32_t>(idx);
+        std::uint64_t current = ctx.best_.load(std::memory_order_relaxed);
+        while (candidate < current && !ctx.best_.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+        }
+    };
+
+    BinaryHeapOpen<TieBreakLargerG> open(self.open, 0);
+    open.push({from, h(from), 0});
+    while (!open.empty() && !ctx.stop_.load(std::memory_order_relaxed)) {
+        const AStarSearchContext::OpenEntry cur = open.pop();
+        // stale: g della cella migliorato dopo il push (le scritture su self.g sono solo nostre)
+        if (static_cast<int>(self.g[static_cast<size_t>(cur.idx)] & 0xFFFFFFFFu) != cur.g) continue;
+        // release: gli incontri offerti espandendo le chiavi < cur.f si vedono con top
+        self.top.store(cur.f, std::memory_order_release);
+        const auto bound = static_cast<std::uint64_t>(cur.f) + static_cast<std::uint64_t>(other.top.load(std::memory_order_acquire));
+        if (bound >= 2 * (ctx.best_.load(std::memory_order_relaxed) >> 32)) break; // best è ottimo
+        ++self.expanded;
+        if (record) self.closed.push_back(cur.idx);
+
+        const unsigned mask = kEight ? grid.moveMask8(cur.idx, cornerCutting) : grid.walkableMask(cur.idx);
+        for (unsigned m = mask; m != 0; m &= m - 1) {
+            const int d = std::countr_zero(m);
+            const int q = cur.idx + grid.offset(d);
+            int step = (kEight && d >= kDownRight) ? kCostDiagonal : kCostStraight;
+            // si paga l'ingresso nella cella d'arrivo: in avanti q, all'indietro (q -> cur) cur
+            if constexpr (kWeighted) step *= terrain[forward ? q : cur.idx];
+            const int ng = cur.g + step;
+            const std::uint64_t mine = self.g[static_cast<size_t>(q)];
+            if (static_cast<std::uint32_t>(mine >> 32) == generation && static_cast<int>(mine & 0xFFFFFFFFu) <= ng) continue;
+
+            self.parent[static_cast<size_t>(q)] = cur.idx;
+            std::atomic_ref<std::uint64_t>(self.g[static_cast<size_t>(q)]).store(pack(generation, ng));
+            const std::uint64_t theirs = std::atomic_ref<const std::uint64_t>(other.g[static_cast<size_t>(q)]).load();
+            if (static_cast<std::uint32_t>(theirs >> 32) == generation)
+                offer(static_cast<std::uint64_t>(ng) + (theirs & 0xFFFFFFFFu), q);
+            open.push({q, 2 * ng + h(q), ng});
+        }
+    }
+    // finito da questo lato (open vuota o limite raggiunto): vale anche per l'altro
+    ctx.stop_.store(true, std::memory_order_relaxed);
+}
+
+void BidirectionalAStar::writePath(BidirectionalSearchContext& ctx, const GridMap& grid, int meet,
+                                   const PathOutput& out) {
+    // start -> meet dai parent in avanti (al contrario), meet -> goal dai parent all'indietro
+    std::vector<Cell>& cells = ctx.cells_;
+    cells.clear();
+    for (int i = meet; i != -1; i = ctx.forward_.parent[static_cast<size_t>(i)]) cells.push_back(grid.cellAt(i));
+    std::reverse(cells.begin(), cells.end());
+    for (int i = ctx.backward_.parent[static_cast<size_t>(meet)]; i != -1; i = ctx.backward_.parent[static_cast<size_t>(i)])
+        cells.push_back(grid.cellAt(i));
+
+    // Waypoints: start, svolte, goal (come AStarSearchContext::writePath)
+    if (out.format == PathFormat::Waypoints && cells.size() > 2) {
+        size_t n = 1;
+        for (size_t i = 1; i + 1 < cells.size(); ++i) {
+            const bool turn = signOf(cells[i].x - cells[i - 1].x) != signOf(cells[i + 1].x - cells[i].x) ||
+                              signOf(cells[i].y - cells[i - 1].y) != signOf(cells[i + 1].y - cells[i].y);
+            if (turn) cells[n++] = cells[i];
+        }
+        cells[n++] = cells.back();
+        cells.resize(n);
+    }
+
+    AStarResult& result = ctx.result_;
+    result.pathLength = cells.size();
+    if (!out.span.empty()) {
+        if (cells.size() <= out.span.size()) std::copy(cells.begin(), cells.end(), out.span.begin());
+        return; // non ci sta: il chiamante rilegge pathLength
+    }
+    std::vector<Cell>& dst = out.buffer ? *out.buffer : result.path;
+    dst.assign(cells.begin(), cells.end());
+}
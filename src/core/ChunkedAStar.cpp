@@ -0,0 +1,114 @@
+#include "taikutsu/core/ChunkedAStar.h"
+#include "taikutsu/core/AStarPolicies.h"
+#include "taikutsu/core/GridSnapshot.h"
+#include "taikutsu/core/OpenList.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr size_t kInitialSlots = 1024;
+
+    size_t slotOf(std::int64_t key, size_t mask) {
+        // Fibonacci hashing: celle vicine finiscono in slot lontani
+        return static_cast<size_t>((static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+}
+
+// ---------------- ChunkedSearchContext ----------------
+
+void ChunkedSearchContext::beginQuery() {
+    if (table_.empty()) table_.resize(kInitialSlots);
+    ++generation_;
+    if (generation_ == 0) { // overflow: vedi AStarSearchContext::beginQuery
+        for (Slot& s : table_) s.stamp = 0;
+        generation_ = 1;
+    }
+    nodes_.clear();
+    open_.heap.clear();
+    result_.clear();
+}
+
+void ChunkedSearchContext::grow() {
+    std::vector<Slot> bigger(table_.size() * 2);
+    const size_t mask = bigger.size() - 1;
+    for (std::uint32_t n = 0; n < nodes_.size(); ++n) {
+        size_t i = slotOf(nodes_[n].idx, mask);
+        while (bigger[i].stamp == generation_) i = (i + 1) & mask;
+        bigger[i] = Slot{nodes_[n].idx, generation_, n};
+    }
+    table_.swap(bigger);
+}
+
+std::uint32_t ChunkedSearchContext::touch(std::int64_t idx) {
+    const size_t mask = table_.size() - 1;
+    size_t i = slotOf(idx, mask);
+    for (; table_[i].stamp == generation_; i = (i + 1) & mask)
+        if (table_[i].key == idx) return table_[i].node;
+
+    const auto n = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.push_back(Node{idx, 0, -1, kNew});
+    table_[i] = Slot{idx, generation_, n};
+    if (nodes_.size() * 2 > table_.size()) grow();
+    return n;
+}
+
+size_t ChunkedSearchContext::memoryBytes() const {
+    return table_.capacity() * sizeof(Slot) + nodes_.capacity() * sizeof(Node) +
+           open_.heap.capacity() * sizeof(AStarSearchContext::OpenEntry) +
+           (result_.path.capacity() + result_.closed.capacity()) * sizeof(Cell);
+}
+
+// ---------------- ChunkedAStar ----------------
+
+AStarResult ChunkedAStar::findPath(const ChunkedGridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    ChunkedSearchContext ctx;
+    findPath(ctx, grid, start, goal, opts);
+    return ctx.result_;
+}
+
+const AStarResult& ChunkedAStar::findPath(ChunkedSearchContext& ctx, const ChunkedGridMap& grid, Cell start,
+                                          Cell goal, const SearchOptions& opts) {
+    return dispatch(ctx, grid, start, goal, opts);
+}
+
+AStarResult ChunkedAStar::findPath(const GridSnapshot& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    ChunkedSearchContext ctx;
+    findPath(ctx, grid, start, goal, opts);
+    return ctx.result_;
+}
+
+const AStarResult& ChunkedAStar::findPath(ChunkedSearchContext& ctx, const GridSnapshot& grid, Cell start,
+                                          Cell goal, const SearchOptions& opts) {
+    return dispatch(ctx, grid, start, goal, opts);
+}
+
+template <class Grid>
+const AStarResult& ChunkedAStar::dispatch(ChunkedSearchContext& ctx, const Grid& grid, Cell start, Cell goal,
+                                          const SearchOptions& opts) {
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool octile = opts.heuristic == HeuristicKind::Octile || (opts.heuristic == HeuristicKind::Auto && eight);
+    if (!eight) {
+        if (octile) return search<Neighbors4, OctileHeuristic>(ctx, grid, start, goal, opts);
+        return search<Neighbors4, ManhattanHeuristic>(ctx, grid, start, goal, opts);
+    }
+    if (opts.cornerCutting) {
+        if (octile) return search<Neighbors8CornerCut, OctileHeuristic>(ctx, grid, start, goal, opts);
+        return search<Neighbors8CornerCut, ManhattanHeuristic>(ctx, grid, start, goal, opts);
+    }
+    if (octile) return search<Neighbors8, OctileHeuristic>(ctx, grid, start, goal, opts);
+    return search<Neighbors8, ManhattanHeuristic>(ctx, grid, start, goal, opts);
+}
+
+// lo stesso BasicAStar di AStarPathfinder (heap binario, a parità di f g maggiore), sui nodi della tabella hash
+template <class Neighborhood, class Heuristic, class Grid>
+const AStarResult& ChunkedAStar::search(ChunkedSearchContext& ctx, const Grid& grid, Cell start, Cell goal,
+                                        const SearchOptions& opts) {
+    if (opts.recordClosed == ClosedRecording::List) {
+        RecordClosed recorder;
+        return BasicAStar<Neighborhood, Heuristic, UnitCost, TieBreakLargerG, RecordClosed, BinaryHeapOpen, Grid>::findPath(
+            ctx, grid, start, goal, recorder, opts.output);
+    }
+    NoRecorder recorder;
+    return BasicAStar<Neighborhood, Heuristic, UnitCost, TieBreakLargerG, NoRecorder, BinaryHeapOpen, Grid>::findPath(
+        ctx, grid, start, goal, recorder, opts.output);
+}
@@ -0,0 +1,236 @@
+#include "taikutsu/core/ChunkedGridMap.h"
+#include "taikutsu/core/BitOps.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr int kMask = ChunkedGridMap::kTileSize - 1;
+
+    int tilesFor(int cells) {
+        return static_cast<int>((static_cast<std::int64_t>(cells) + ChunkedGridMap::kTileSize - 1) >>
+                                ChunkedGridMap::kTileShift);
+    }
+}
+
+ChunkedGridMap::ChunkedGridMap(int width, int height, bool blocked)
+    : w_(std::max(width, 0)), h_(std::max(height, 0)),
+      tilesX_(tilesFor(w_)), tilesY_(tilesFor(h_)),
+      dir_(static_cast<size_t>(tilesX_) * static_cast<size_t>(tilesY_), blocked ? kBlockedTile : kFreeTile) {}
+
+ChunkedGridMap::ChunkedGridMap(const GridMap& grid) : ChunkedGridMap(grid.width(), grid.height(), true) {
+    const auto wpr = static_cast<size_t>(grid.wordsPerRow());
+    for (int ty = 0; ty < tilesY_; ++ty) {
+        const int rows = rowsIn(ty);
+        for (int tx = 0; tx < tilesX_; ++tx) {
+            const std::uint64_t valid = rowMask(tx);
+            const int n = std::popcount(valid);
+            // prima classifichiamo, poi allochiamo solo le tile miste
+            bool anyFree = false, anyBlocked = false;
+            std::uint64_t rowBits[kTileSize];
+            for (int ly = 0; ly < rows; ++ly) {
+                const std::uint64_t* row = grid.words() + static_cast<size_t>((ty << kTileShift) + ly + 1) * wpr;
+                rowBits[ly] = loadBits(row, (tx << kTileShift) + 1, n);
+                anyFree |= rowBits[ly] != 0;
+                anyBlocked |= rowBits[ly] != valid;
+            }
+            const size_t t = tileIndex(tx, ty);
+            if (!anyBlocked) dir_[t] = kFreeTile;
+            if (!anyFree || !anyBlocked) continue;
+            std::uint64_t* words = materialize(t);
+            std::copy(rowBits, rowBits + rows, words);
+        }
+    }
+}
+
+std::uint64_t ChunkedGridMap::rowMask(int tx) const {
+    return lowMask(std::min(kTileSize, w_ - (tx << kTileShift)));
+}
+
+int ChunkedGridMap::rowsIn(int ty) const {
+    return std::min(kTileSize, h_ - (ty << kTileShift));
+}
+
+size_t ChunkedGridMap::memoryBytes() const {
+    return dir_.capacity() * sizeof(std::uint32_t) + pool_.capacity() * sizeof(std::uint64_t) +
+           freeSlots_.capacity() * sizeof(std::uint32_t);
+}
+
+ChunkedGridMap::TileState ChunkedGridMap::tileState(int tx, int ty) const {
+    const std::uint32_t t = dir_[tileIndex(tx, ty)];
+    if (t == kFreeTile) return TileState::Free;
+    if (t == kBlockedTile) return TileState::Blocked;
+    return TileState::Mixed;
+}
+
+// slot nuovo (o riciclato) riempito con lo stato uniforme della tile
+std::uint64_t* ChunkedGridMap::materialize(size_t tile) {
+    const std::uint32_t state = dir_[tile];
+    std::uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(pool_.size() / kTileSize);
+        pool_.resize(pool_.size() + kTileSize);
+    }
+    const int tx = static_cast<int>(tile % static_cast<size_t>(tilesX_));
+    const int ty = static_cast<int>(tile / static_cast<size_t>(tilesX_));
+    std::uint64_t* words = pool_.data() + static_cast<size_t>(slot) * kTileSize;
+    const std::uint64_t fill = state == kFreeTile ? rowMask(tx) : 0;
+    const int rows = rowsIn(ty);
+    for (int ly = 0; ly < kTileSize; ++ly) words[ly] = ly < rows ? fill : 0;
+    dir_[tile] = slot;
+    return words;
+}
+
+void ChunkedGridMap::release(size_t tile, std::uint32_t state) {
+    const std::uint32_t slot = dir_[tile];
+    if (slot < kBlockedTile) freeSlots_.push_back(slot);
+    dir_[tile] = state;
+}
+
+void ChunkedGridMap::collapseIfUniform(int tx, int ty) {
+    const size_t t = tileIndex(tx, ty);
+    const std::uint32_t slot = dir_[t];
+    if (slot >= kBlockedTile) return;
+    const std::uint64_t* words = pool_.data() + static_cast<size_t>(slot) * kTileSize;
+    const std::uint64_t valid = rowMask(tx);
+    const int rows = rowsIn(ty);
+    bool allFree = true, allBlocked = true;
+    for (int ly = 0; ly < rows && (allFree || allBlocked); ++ly) {
+        allFree &= words[ly] == valid;
+        allBlocked &= words[ly] == 0;
+    }
+    if (allFree) release(t, kFreeTile);
+    else if (allBlocked) release(t, kBlockedTile);
+}
+
+void ChunkedGridMap::setBlocked(Cell c, bool blocked) {
+    if (!inBounds(c) || walkableAt(c.x, c.y) != blocked) return; // fuori mappa o già così
+    toggleBlocked(c);
+}
+
+void ChunkedGridMap::toggleBlocked(Cell c) {
+    if (!inBounds(c)) return;
+    const int tx = c.x >> kTileShift, ty = c.y >> kTileShift;
+    const size_t t = tileIndex(tx, ty);
+    std::uint64_t* words = dir_[t] >= kBlockedTile ? materialize(t)
+                                                   : pool_.data() + static_cast<size_t>(dir_[t]) * kTileSize;
+    std::uint64_t& row = words[c.y & kMask];
+    row ^= std::uint64_t{1} << (c.x & kMask);
+    // la tile può essere diventata uniforme solo se la riga lo è
+    if (row == 0 || row == rowMask(tx)) collapseIfUniform(tx, ty);
+}
+
+void ChunkedGridMap::fillRect(Cell min, int w, int h, bool blocked) {
+    const int x0 = std::max(min.x, 0);
+    const int y0 = std::max(min.y, 0);
+    const int x1 = static_cast<int>(std::min<std::int64_t>(static_cast<std::int64_t>(min.x) + w, w_));
+    const int y1 = static_cast<int>(std::min<std::int64_t>(static_cast<std::int64_t>(min.y) + h, h_));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const std::uint32_t uniform = blocked ? kBlockedTile : kFreeTile;
+    for (int ty = y0 >> kTileShift; ty <= (y1 - 1) >> kTileShift; ++ty) {
+        const int ty0 = std::max(y0, ty << kTileShift), ty1 = std::min(y1, (ty << kTileShift) + rowsIn(ty));
+        for (int tx = x0 >> kTileShift; tx <= (x1 - 1) >> kTileShift; ++tx) {
+            const size_t t = tileIndex(tx, ty);
+            if (dir_[t] == uniform) continue;
+            const int tx0 = std::max(x0, tx << kTileShift);
+            const int tx1 = std::min(x1, (tx << kTileShift) + std::popcount(rowMask(tx)));
+            // tutta la tile (dentro la mappa) coperta: basta la directory
+            if (tx1 - tx0 == std::popcount(rowMask(tx)) && ty1 - ty0 == rowsIn(ty)) {
+                release(t, uniform);
+                continue;
+            }
+            std::uint64_t* words = dir_[t] >= kBlockedTile ? materialize(t)
+                                                           : pool_.data() + static_cast<size_t>(dir_[t]) * kTileSize;
+            const std::uint64_t bits = lowMask(tx1 - tx0) << (tx0 & kMask);
+            for (int y = ty0; y < ty1; ++y) {
+                if (blocked) words[y & kMask] &= ~bits;
+                else         words[y & kMask] |= bits;
+            }
+            collapseIfUniform(tx, ty);
+        }
+    }
+}
+
+void ChunkedGridMap::clear(bool blocked) {
+    std::fill(dir_.begin(), dir_.end(), blocked ? kBlockedTile : kFreeTile);
+    pool_.clear();
+    freeSlots_.clear();
+}
+
+unsigned ChunkedGridMap::walkableMask8(Cell c) const {
+    const int lx = c.x & kMask, ly = c.y & kMask;
+    // vicini tutti nella stessa tile e nella mappa
+    if (lx > 0 && lx < kMask && ly > 0 && ly < kMask && c.x + 1 < w_ && c.y + 1 < h_) {
+        const std::uint32_t t = dir_[tileIndex(c.x >> kTileShift, c.y >> kTileShift)];
+        if (t == kFreeTile) return 0xFFu;
+        if (t == kBlockedTile) return 0u;
+        const std::uint64_t* row = pool_.data() + static_cast<size_t>(t) * kTileSize + ly;
+        // bit 0 = x - 1, bit 1 = x, bit 2 = x + 1
+        const unsigned up = static_cast<unsigned>(row[-1] >> (lx - 1)) & 7u;
+        const unsigned mid = static_cast<unsigned>(row[0] >> (lx - 1)) & 7u;
+        const unsigned down = static_cast<unsigned>(row[1] >> (lx - 1)) & 7u;
+        return  ((mid >> 2) & 1u)
+             | ((mid & 1u) << kLeft)
+             | (((down >> 1) & 1u) << kDown)
+             | (((up >> 1) & 1u) << kUp)
+             | (((down >> 2) & 1u) << kDownRight)
+             | ((down & 1u) << kDownLeft)
+             | (((up >> 2) & 1u) << kUpRight)
+             | ((up & 1u) << kUpLeft);
+    }
+    unsigned m = 0;
+    for (int d = 0; d < 8; ++d)
+        m |= static_cast<unsigned>(isWalkable(Cell{c.x + kDirDx[d], c.y + kDirDy[d]})) << d;
+    return m;
+}
+
+std::vector<Cell> ChunkedGridMap::neighbors4(Cell c) const {
+    std::vector<Cell> out;
+    if (!inBounds(c)) return out;
+    out.reserve(4);
+    for (unsigned m = walkableMask(c); m != 0; m &= m - 1) {
+        const int d = std::countr_zero(m);
+        out.push_back(Cell{c.x + kDirDx[d], c.y + kDirDy[d]});
+    }
+    return out;
+}
+
+GridMap ChunkedGridMap::window(Cell min, int w, int h) const {
+    GridMap out(w, h);
+    out.fillRect(Cell{0, 0}, w, h, true);
+    // per run di tile: le uniformi libere con fillRect, le miste riga per riga
+    for (int y = 0; y < h; ++y) {
+        const int sy = min.y + y;
+        if (sy < 0 || sy >= h_) continue;
+        for (int x = 0; x < w;) {
+            const int sx = min.x + x;
+            if (sx < 0 || sx >= w_) {
+                ++x;
+                continue;
+            }
+            const int n = std::min({w - x, kTileSize - (sx & kMask), w_ - sx}); // fino al bordo della tile
+            const std::uint32_t t = dir_[tileIndex(sx >> kTileShift, sy >> kTileShift)];
+            if (t == kFreeTile) {
+                out.fillRect(Cell{x, y}, n, 1, false);
+            } else if (t != kBlockedTile) {
+                std::uint64_t bits = pool_[static_cast<size_t>(t) * kTileSize + static_cast<size_t>(sy & kMask)];
+                bits = (bits >> (sx & kMask)) & lowMask(n);
+                // un fillRect per run di celle libere
+                for (int i = 0; bits != 0;) {
+                    const int skip = std::countr_zero(bits);
+                    bits >>= skip;
+                    i += skip;
+                    const int run = std::countr_one(bits);
+                    out.fillRect(Cell{x + i, y}, run, 1, false);
+                    bits = run >= 64 ? 0 : bits >> run;
+                    i += run;
+                }
+            }
+            x += n;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,303 @@
+#include "taikutsu/core/ConnectivityIndex.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace {
+    // prima posizione >= p (fino a end) in cui il bit della riga vale "ones"
+    int scanBits(const std::uint64_t* row, int p, int end, bool ones) {
+        while (p < end) {
+            std::uint64_t word = row[p >> 6];
+            if (!ones) word = ~word;
+            word >>= (p & 63);
+            if (word != 0) return std::min(end, p + std::countr_zero(word));
+            p = (p | 63) + 1;
+        }
+        return end;
+    }
+
+    struct Run {
+        int x0, x1; // [x0, x1)
+        std::uint32_t id;
+    };
+
+    // anello degli 8 vicini in ordine circolare (N, NE, E, SE, S, SW, W, NW):
+    // celle consecutive sono adiacenti a 4 direzioni, le ortogonali stanno nelle posizioni pari
+    constexpr int kRingDx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    constexpr int kRingDy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+}
+
+ConnectivityIndex::ConnectivityIndex(const GridMap& grid) : grid_(&grid) {
+    rebuild();
+}
+
+ConnectivityIndex::ConnectivityIndex(const GridMap& grid, std::span<const std::uint32_t> labels,
+                                     std::span<const std::uint32_t> sizes)
+    : grid_(&grid), w_(grid.width()), h_(grid.height()), label_(labels.begin(), labels.end()),
+      parent_(sizes.size()), size_(sizes.begin(), sizes.end()), components_(sizes.empty() ? 0 : sizes.size() - 1) {
+    for (size_t i = 0; i < parent_.size(); ++i) parent_[i] = static_cast<std::uint32_t>(i);
+    if (parent_.empty()) { // nessuna componente: resta valido parent_[0] = 0
+        parent_.assign(1, 0);
+        size_.assign(1, 0);
+    }
+}
+
+void ConnectivityIndex::exportCompact(std::vector<std::uint32_t>& labels, std::vector<std::uint32_t>& sizes) const {
+    // dopo notifyChanged gli id non sono più compatti né radici: stessa rinumerazione di rebuild()
+    std::vector<std::uint32_t> compact(parent_.size(), 0);
+    labels.resize(label_.size());
+    sizes.assign(1, 0);
+    for (size_t i = 0; i < label_.size(); ++i) {
+        if (label_[i] == 0) {
+            labels[i] = 0;
+            continue;
+        }
+        const std::uint32_t r = find(label_[i]);
+        if (compact[r] == 0) {
+            compact[r] = static_cast<std::uint32_t>(sizes.size());
+            sizes.push_back(size_[r]);
+        }
+        labels[i] = compact[r];
+    }
+}
+
+std::uint32_t ConnectivityIndex::newId(std::uint32_t size) {
+    const auto id = static_cast<std::uint32_t>(parent_.size());
+    parent_.push_back(id);
+    size_.push_back(size);
+    ++components_;
+    return id;
+}
+
+std::uint32_t ConnectivityIndex::find(std::uint32_t id) const {
+    while (parent_[id] != id) id = parent_[id];
+    return id;
+}
+
+std::uint32_t ConnectivityIndex::findCompress(std::uint32_t id) {
+    while (parent_[id] != id) {
+        parent_[id] = parent_[parent_[id]]; // path halving
+        id = parent_[id];
+    }
+    return id;
+}
+
+std::uint32_t ConnectivityIndex::unite(std::uint32_t a, std::uint32_t b) {
+    a = findCompress(a);
+    b = findCompress(b);
+    if (a == b) return a;
+    if (size_[a] < size_[b]) std::swap(a, b);
+    parent_[b] = a;
+    size_[a] += size_[b];
+    --components_;
+    return a;
+}
+
+void ConnectivityIndex::rebuild() {
+    w_ = grid_->width();
+    h_ = grid_->height();
+    label_.assign(static_cast<size_t>(w_) * static_cast<size_t>(h_), 0);
+    parent_.assign(1, 0);
+    size_.assign(1, 0);
+    components_ = 0;
+
+    // 1) run di celle libere riga per riga; un run che si sovrappone a run della riga
+    //    precedente ne eredita l'id (e li unisce tra loro), altrimenti id nuovo
+    std::vector<Run> prev, cur;
+    for (int y = 0; y < h_; ++y) {
+        const std::uint64_t* row = grid_->words() + static_cast<size_t>(y + 1) * static_cast<size_t>(grid_->wordsPerRow());
+        cur.clear();
+        size_t j = 0;
+        for (int p = 1; p <= w_;) {
+            const int s = scanBits(row, p, w_ + 1, true);
+            if (s > w_) break;
+            const int e = scanBits(row, s, w_ + 1, false);
+            Run run{s - 1, e - 1, 0};
+
+            while (j < prev.size() && prev[j].x1 <= run.x0) ++j;
+            for (size_t k = j; k < prev.size() && prev[k].x0 < run.x1; ++k)
+                run.id = run.id == 0 ? findCompress(prev[k].id) : unite(run.id, prev[k].id);
+
+            const auto len = static_cast<std::uint32_t>(run.x1 - run.x0);
+            if (run.id == 0) run.id = newId(len);
+            else size_[findCompress(run.id)] += len;
+
+            std::fill_n(label_.begin() + static_cast<std::ptrdiff_t>(cellIndex(Cell{run.x0, y})), len, run.id);
+            cur.push_back(run);
+            p = e;
+        }
+        std::swap(prev, cur);
+    }
+
+    // 2) id compatti 1..K: ogni radice diventa un id, tutti gli alberi hanno profondità 0
+    std::vector<std::uint32_t> compact(parent_.size(), 0);
+    std::vector<std::uint32_t> sizes(1, 0);
+    for (std::uint32_t& l : label_) {
+        if (l == 0) continue;
+        const std::uint32_t r = findCompress(l);
+        if (compact[r] == 0) {
+            compact[r] = static_cast<std::uint32_t>(sizes.size());
+            sizes.push_back(size_[r]);
+        }
+        l = compact[r];
+    }
+    size_ = std::move(sizes);
+    parent_.resize(size_.size());
+    for (size_t i = 0; i < parent_.size(); ++i) parent_[i] = static_cast<std::uint32_t>(i);
+    components_ = size_.size() - 1;
+}
+
+std::uint32_t ConnectivityIndex::component(Cell c) const {
+    if (c.x < 0 || c.y < 0 || c.x >= w_ || c.y >= h_) return 0;
+    const std::uint32_t l = label_[cellIndex(c)];
+    return l == 0 ? 0 : find(l);
+}
+
+void ConnectivityIndex::notifyChanged(Cell c) {
+    if (grid_->width() != w_ || grid_->height() != h_) {
+        rebuild();
+        return;
+    }
+    if (!grid_->inBounds(c)) return;
+    const bool walkable = grid_->isWalkable(c);
+    const bool labeled = label_[cellIndex(c)] != 0;
+    if (walkable && !labeled) onUnblocked(c);
+    else if (!walkable && labeled) onBlocked(c);
+}
+
+void ConnectivityIndex::onUnblocked(Cell c) {
+    std::uint32_t id = 0;
+    for (int d = 0; d < 4; ++d) {
+        const Cell nb{c.x + kDirDx[d], c.y + kDirDy[d]};
+        if (!grid_->inBounds(nb)) continue;
+        const std::uint32_t l = label_[cellIndex(nb)];
+        if (l != 0) id = id == 0 ? findCompress(l) : unite(id, l);
+    }
+    if (id == 0) {
+        id = newId(1);
+    } else {
+        id = findCompress(id);
+        ++size_[id];
+    }
+    label_[cellIndex(c)] = id;
+}
+
+void ConnectivityIndex::onBlocked(Cell c) {
+    const std::uint32_t root = findCompress(label_[cellIndex(c)]);
+    label_[cellIndex(c)] = 0;
+    if (--size_[root] == 0) {
+        --components_;
+        return;
+    }
+
+    // caso comune: i vicini ortogonali liberi stanno nello stesso tratto libero dell'anello
+    // attorno a c, quindi restano collegati senza passare da c
+    auto freeAt = [&](int i) {
+        const Cell nb{c.x + kRingDx[i], c.y + kRingDy[i]};
+        return grid_->inBounds(nb) && label_[cellIndex(nb)] != 0;
+    };
+    bool ring[8];
+    for (int i = 0; i < 8; ++i) ring[i] = freeAt(i);
+    int group[8];
+    int start = 0;
+    while (start < 8 && ring[start]) ++start;
+    if (start == 8) return; // anello tutto libero
+    int groups = 0;
+    for (int k = 1; k <= 8; ++k) { // parte dopo una cella bloccata: i tratti non si spezzano
+        const int i = (start + k) % 8;
+        if (!ring[i]) continue;
+        if (!ring[(i + 7) % 8]) ++groups;
+        group[i] = groups;
+    }
+
+    std::array<size_t, 4> seeds{};
+    int k = 0;
+    int seedGroup[4];
+    for (int i = 0; i < 8; i += 2) {
+        if (!ring[i]) continue;
+        bool dup = false;
+        for (int s = 0; s < k; ++s) dup = dup || seedGroup[s] == group[i];
+        if (dup) continue;
+        seedGroup[k] = group[i];
+        seeds[static_cast<size_t>(k++)] = cellIndex(Cell{c.x + kRingDx[i], c.y + kRingDy[i]});
+    }
+    if (k <= 1) return;
+
+    // flood alternato dai k semi: quando due si incontrano si uniscono; un insieme che si
+    // esaurisce senza incontrare gli altri è una componente staccata e prende un id nuovo
+    if (seen_.size() != label_.size()) {
+        seen_.assign(label_.size(), 0);
+        owner_.assign(label_.size(), 0);
+        stamp_ = 0;
+    }
+    if (++stamp_ == 0) {
+        std::fill(seen_.begin(), seen_.end(), 0u);
+        stamp_ = 1;
+    }
+
+    std::array<std::vector<size_t>, 4> queue;
+    std::array<size_t, 4> head{};
+    std::array<int, 4> set{};  // insieme di appartenenza di ogni seme
+    std::array<bool, 4> alive{};
+    for (int i = 0; i < k; ++i) {
+        const auto s = static_cast<size_t>(i);
+        queue[s].push_back(seeds[s]);
+        seen_[seeds[s]] = stamp_;
+        owner_[seeds[s]] = static_cast<std::uint8_t>(i);
+        set[s] = i;
+        alive[s] = true;
+    }
+    auto setOf = [&](int i) {
+        while (set[static_cast<size_t>(i)] != i) i = set[static_cast<size_t>(i)];
+        return i;
+    };
+    int sets = k;
+
+    while (sets > 1) {
+        for (int i = 0; i < k && sets > 1; ++i) {
+            const auto s = static_cast<size_t>(i);
+            if (!alive[s] || head[s] >= queue[s].size()) continue;
+            const size_t cell = queue[s][head[s]++];
+            const Cell cc{static_cast<int>(cell % static_cast<size_t>(w_)), static_cast<int>(cell / static_cast<size_t>(w_))};
+            for (int d = 0; d < 4; ++d) {
+                const Cell nb{cc.x + kDirDx[d], cc.y + kDirDy[d]};
+                if (!grid_->inBounds(nb)) continue;
+                const size_t ni = cellIndex(nb);
+                if (label_[ni] == 0) continue;
+                if (seen_[ni] == stamp_) {
+                    const int a = setOf(i), b = setOf(owner_[ni]);
+                    if (a != b) {
+                        set[static_cast<size_t>(b)] = a;
+                        --sets;
+                    }
+                    continue;
+                }
+                seen_[ni] = stamp_;
+                owner_[ni] = static_cast<std::uint8_t>(i);
+                queue[s].push_back(ni);
+            }
+        }
+
+        // insiemi esauriti: tutti i loro semi hanno finito la coda
+        for (int r = 0; r < k && sets > 1; ++r) {
+            if (!alive[static_cast<size_t>(r)] || setOf(r) != r) continue;
+            bool done = true;
+            for (int i = 0; i < k; ++i)
+                if (alive[static_cast<size_t>(i)] && setOf(i) == r && head[static_cast<size_t>(i)] < queue[static_cast<size_t>(i)].size()) done = false;
+            if (!done) continue;
+
+            std::uint32_t count = 0;
+            for (int i = 0; i < k; ++i)
+                if (alive[static_cast<size_t>(i)] && setOf(i) == r) count += static_cast<std::uint32_t>(queue[static_cast<size_t>(i)].size());
+            const std::uint32_t id = newId(count);
+            size_[root] -= count;
+            for (int i = 0; i < k; ++i) {
+                const auto s = static_cast<size_t>(i);
+                if (!alive[s] || setOf(i) != r) continue;
+                for (const size_t cell : queue[s]) label_[cell] = id;
+                alive[s] = false;
+            }
+            --sets;
+        }
+    }
+}
@@ -0,0 +1,311 @@
+#include "taikutsu/core/CooperativePlanner.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace {
+    constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+    // min-heap su f, a parità di f il g più grande (più vicino alla fine)
+    struct Worse {
+        bool operator()(const AStarSearchContext::OpenEntry& a, const AStarSearchContext::OpenEntry& b) const {
+            return a.f > b.f || (a.f == b.f && a.g < b.g);
+        }
+    };
+
+    void pushOpen(std::vector<AStarSearchContext::OpenEntry>& heap, AStarSearchContext::OpenEntry e) {
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end(), Worse{});
+    }
+
+    AStarSearchContext::OpenEntry popOpen(std::vector<AStarSearchContext::OpenEntry>& heap) {
+        std::pop_heap(heap.begin(), heap.end(), Worse{});
+        const AStarSearchContext::OpenEntry e = heap.back();
+        heap.pop_back();
+        return e;
+    }
+}
+
+CooperativePlanner::CooperativePlanner(const GridMap& grid, const CooperativeOptions& opts)
+    : grid_(&grid), opts_(opts), epoch_(grid.epoch()), version_(grid.version()) {
+    opts_.window = std::max(opts_.window, 1);
+    opts_.heuristicGoals = std::max<size_t>(opts_.heuristicGoals, 1);
+}
+
+int CooperativePlanner::addAgent(Cell position, Cell goal) {
+    if (!grid_->isWalkable(position)) return kNoAgent;
+    const int pos = grid_->index(position);
+    const auto id = static_cast<std::uint32_t>(agents_.size());
+    if (reservedByOther(tick_, pos, id)) return kNoAgent; // c'è già un agente
+    agents_.push_back(Agent{pos, pos, tick_, {pos}, true});
+    parked_.insert(static_cast<std::uint32_t>(pos), id); // piano vuoto: in sosta dove sta
+    setGoal(static_cast<int>(id), goal);
+    return static_cast<int>(id);
+}
+
+void CooperativePlanner::setGoal(int agent, Cell goal) {
+    Agent& a = agents_[static_cast<size_t>(agent)];
+    a.goal = grid_->isWalkable(goal) ? grid_->index(goal) : a.pos; // goal non valido: resta fermo
+    a.dirty = true;
+}
+
+std::vector<Cell> CooperativePlanner::plannedPath(int agent) const {
+    const Agent& a = agents_[static_cast<size_t>(agent)];
+    std::vector<Cell> out;
+    for (size_t k = tick_ - a.planStart; k < a.plan.size(); ++k) out.push_back(grid_->cellAt(a.plan[k]));
+    if (out.empty()) out.push_back(grid_->cellAt(a.pos)); // piano finito: fermo
+    return out;
+}
+
+bool CooperativePlanner::needsPlan(const Agent& a) const {
+    const std::uint32_t end = planEnd(a);
+    return a.dirty || end <= tick_ || static_cast<int>(end - tick_) <= opts_.window / 2;
+}
+
+CooperativeTickStats CooperativePlanner::plan(std::chrono::microseconds budget) {
+    syncWithGrid();
+    CooperativeTickStats stats;
+    const auto n = static_cast<std::uint32_t>(agents_.size());
+    if (n == 0) return stats;
+    const auto t0 = std::chrono::steady_clock::now();
+    cursor_ %= n;
+    for (std::uint32_t k = 0; k < n; ++k) {
+        const std::uint32_t id = (cursor_ + k) % n;
+        if (!needsPlan(agents_[id])) continue;
+        if (stats.planned > 0 &&
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0) >= budget) {
+            for (std::uint32_t j = k; j < n; ++j) stats.deferred += needsPlan(agents_[(cursor_ + j) % n]);
+            cursor_ = id; // i rimasti per primi la prossima volta
+            return stats;
+        }
+        planAgent(id, stats);
+    }
+    cursor_ = (cursor_ + 1) % n; // priorità a rotazione
+    return stats;
+}
+
+void CooperativePlanner::planAgent(std::uint32_t id, CooperativeTickStats& stats) {
+    releaseFuture(id);
+    const int window = opts_.window;
+    const int pos = agents_[id].pos, goal = agents_[id].goal;
+    GoalDistances& gd = distancesFor(goal, pos);
+    size_t hExpanded = 0;
+
+    nodes_.clear();
+    open_.clear();
+    visited_.clear();
+    int found = -1;
+    const int h0 = distance(gd, pos, hExpanded);
+    if (h0 < kUnreachable) {
+        nodes_.push_back({pos, 0, 0, -1});
+        visited_.insert(key(0, pos), 0);
+        pushOpen(open_, {0, h0, 0});
+    }
+    size_t expanded = 0;
+    while (!open_.empty()) {
+        const AStarSearchContext::OpenEntry e = popOpen(open_);
+        const Node n = nodes_[static_cast<size_t>(e.idx)];
+        if (n.g != e.g) continue; // stale
+        // fine finestra: f = g + distanza vera dal goal, esatta oltre la finestra
+        if (n.t == window) {
+            found = e.idx;
+            break;
+        }
+        if (++expanded > opts_.maxExpansions) break;
+        const std::uint32_t now = tick_ + static_cast<std::uint32_t>(n.t);
+        auto relax = [&](int q, int cost) {
+            if (reservedByOther(now + 1, q, id)) return;
+            if (q != n.idx) { // scambio: chi sta in q adesso e va in n.idx al tick dopo
+                const std::uint32_t* here = reservations_.find(key(now, q));
+                const std::uint32_t* there = reservations_.find(key(now + 1, n.idx));
+                if (here && there && *here == *there) return;
+            }
+            const int hq = distance(gd, q, hExpanded);
+            if (hq >= kUnreachable) return;
+            const int ng = n.g + cost;
+            std::uint32_t& slot = visited_.findOrInsert(key(static_cast<std::uint32_t>(n.t + 1), q), kNone);
+            if (slot == kNone) {
+                slot = static_cast<std::uint32_t>(nodes_.size());
+                nodes_.push_back({q, n.t + 1, ng, e.idx});
+            } else if (nodes_[slot].g > ng) {
+                nodes_[slot].g = ng;
+                nodes_[slot].parent = e.idx;
+            } else {
+                return;
+            }
+            pushOpen(open_, {static_cast<int>(slot), ng + hq, ng});
+        };
+        relax(n.idx, n.idx == goal ? 0 : kCostStraight); // attesa: gratis solo sul goal
+        for (unsigned m = moves(n.idx); m != 0; m &= m - 1) {
+            const int d = std::countr_zero(m);
+            const int q = n.idx + grid_->offset(d);
+            relax(q, stepCost(d, q));
+        }
+    }
+
+    Agent& a = agents_[id];
+    a.planStart = tick_;
+    a.plan.clear();
+    if (found >= 0) {
+        a.plan.resize(static_cast<size_t>(window) + 1);
+        for (int i = found; i != -1; i = nodes_[static_cast<size_t>(i)].parent)
+            a.plan[static_cast<size_t>(nodes_[static_cast<size_t>(i)].t)] = nodes_[static_cast<size_t>(i)].idx;
+    } else {
+        // nessun piano nella finestra (goal irraggiungibile, chiuso dagli altri o troppi nodi):
+        // fermo finché la cella non è prenotata da qualcun altro
+        a.plan.push_back(a.pos);
+        for (int k = 1; k <= window && !reservedByOther(tick_ + static_cast<std::uint32_t>(k), a.pos, id); ++k)
+            a.plan.push_back(a.pos);
+        ++stats.failed;
+    }
+    a.dirty = false;
+    reservePlan(id);
+    ++stats.planned;
+    stats.expanded += expanded;
+    stats.heuristicExpanded += hExpanded;
+}
+
+void CooperativePlanner::releaseFuture(std::uint32_t id) {
+    const Agent& a = agents_[id];
+    for (size_t k = tick_ - a.planStart + 1; k < a.plan.size(); ++k) {
+        const std::uint64_t kk = key(a.planStart + static_cast<std::uint32_t>(k), a.plan[k]);
+        const std::uint32_t* v = reservations_.find(kk);
+        if (v && *v == id) reservations_.erase(kk);
+    }
+    const auto last = static_cast<std::uint32_t>(a.plan.back());
+    if (const std::uint32_t* v = parked_.find(last); v && *v == id) parked_.erase(last);
+}
+
+void CooperativePlanner::reservePlan(std::uint32_t id) {
+    const Agent& a = agents_[id];
+    for (size_t k = 1; k < a.plan.size(); ++k)
+        reservations_.insert(key(a.planStart + static_cast<std::uint32_t>(k), a.plan[k]), id);
+    parked_.insert(static_cast<std::uint32_t>(a.plan.back()), id);
+}
+
+bool CooperativePlanner::reservedByOther(std::uint32_t tick, int idx, std::uint32_t id) const {
+    if (const std::uint32_t* v = reservations_.find(key(tick, idx))) return *v != id;
+    // in sosta: la cella è di chi ci finisce il piano, da lì in poi (senza holdPlanEnd solo se
+    // il piano è già finito: appena aggiunto o rimasto fuori budget)
+    const std::uint32_t* p = parked_.find(static_cast<std::uint32_t>(idx));
+    if (p == nullptr || *p == id) return false;
+    const std::uint32_t end = planEnd(agents_[*p]);
+    return tick >= end && (opts_.holdPlanEnd || end <= tick_);
+}
+
+size_t CooperativePlanner::advance() {
+    std::vector<Cell> from(agents_.size()), to(agents_.size());
+    for (std::uint32_t id = 0; id < agents_.size(); ++id) {
+        Agent& a = agents_[id];
+        const size_t k = tick_ + 1 - a.planStart;
+        const int next = k < a.plan.size() ? a.plan[k] : a.pos;
+        const std::uint64_t here = key(tick_, a.pos);
+        if (const std::uint32_t* v = reservations_.find(here); v && *v == id) reservations_.erase(here);
+        from[id] = grid_->cellAt(a.pos);
+        to[id] = grid_->cellAt(next);
+        a.pos = next; // piano finito: resta fermo, in sosta sull'ultima cella
+    }
+    ++tick_;
+    return countConflicts(*grid_, from, to);
+}
+
+int CooperativePlanner::trueDistance(Cell c, Cell goal) {
+    syncWithGrid();
+    if (!grid_->isWalkable(c) || !grid_->isWalkable(goal)) return kUnreachable;
+    size_t expanded = 0;
+    return distance(distancesFor(grid_->index(goal), grid_->index(c)), grid_->index(c), expanded);
+}
+
+unsigned CooperativePlanner::moves(int idx) const {
+    return opts_.connectivity == Connectivity::Eight ? grid_->moveMask8(idx, opts_.cornerCutting)
+                                                     : grid_->walkableMask(idx);
+}
+
+int CooperativePlanner::stepCost(int d, int to) const {
+    const int base = d >= kDownRight ? kCostDiagonal : kCostStraight;
+    return opts_.useTerrainCost && grid_->hasCosts() ? base * grid_->costs()[to] : base;
+}
+
+int CooperativePlanner::estimate(int from, Cell b) const {
+    const Cell a = grid_->cellAt(from);
+    return opts_.connectivity == Connectivity::Eight ? octileCost(a, b) : manhattanCost(a, b);
+}
+
+CooperativePlanner::GoalDistances& CooperativePlanner::distancesFor(int goal, int origin) {
+    if (const auto it = goalIndex_.find(goal); it != goalIndex_.end()) {
+        GoalDistances& gd = goals_[it->second];
+        gd.lastUse = ++useCounter_;
+        return gd;
+    }
+    std::uint32_t slot;
+    if (goals_.size() < opts_.heuristicGoals) {
+        slot = static_cast<std::uint32_t>(goals_.size());
+        goals_.emplace_back();
+    } else { // LRU: si butta il goal usato meno di recente (la memoria resta)
+        slot = 0;
+        for (std::uint32_t i = 1; i < goals_.size(); ++i)
+            if (goals_[i].lastUse < goals_[slot].lastUse) slot = i;
+        goalIndex_.erase(goals_[slot].goal);
+    }
+    GoalDistances& gd = goals_[slot];
+    goalIndex_.emplace(goal, slot);
+    gd.goal = goal;
+    gd.origin = grid_->cellAt(origin);
+    gd.g.clear();
+    gd.open.clear();
+    gd.lastUse = ++useCounter_;
+    gd.g.insert(static_cast<std::uint32_t>(goal), 0);
+    pushOpen(gd.open, {goal, estimate(goal, gd.origin), 0});
+    return gd;
+}
+
+int CooperativePlanner::distance(GoalDistances& gd, int idx, size_t& expanded) {
+    // RRA*: all'indietro dal goal con h verso origin (consistente), quindi una cella chiusa ha
+    // la sua distanza esatta anche se la chiesta adesso non è origin
+    if (const std::uint32_t* v = gd.g.find(static_cast<std::uint32_t>(idx)); v && (*v & 1u)) return static_cast<int>(*v >> 1);
+    while (!gd.open.empty()) {
+        const AStarSearchContext::OpenEntry e = popOpen(gd.open);
+        std::uint32_t& v = *gd.g.find(static_cast<std::uint32_t>(e.idx));
+        if ((v & 1u) || static_cast<int>(v >> 1) != e.g) continue; // chiusa o stale
+        v |= 1u;
+        ++expanded;
+        // arco q -> e.idx: si paga l'ingresso in e.idx (mosse simmetriche sul grid)
+        for (unsigned m = moves(e.idx); m != 0; m &= m - 1) {
+            const int d = std::countr_zero(m);
+            const int q = e.idx + grid_->offset(d);
+            const int ng = e.g + stepCost(d, e.idx);
+            std::uint32_t& w = gd.g.findOrInsert(static_cast<std::uint32_t>(q), static_cast<std::uint32_t>(kUnreachable) << 1);
+            if ((w & 1u) || static_cast<int>(w >> 1) <= ng) continue;
+            w = static_cast<std::uint32_t>(ng) << 1;
+            pushOpen(gd.open, {q, ng + estimate(q, gd.origin), ng});
+        }
+        if (e.idx == idx) return e.g;
+    }
+    return kUnreachable; // open esaurita: idx non raggiunge il goal
+}
+
+void CooperativePlanner::syncWithGrid() {
+    if (grid_->epoch() == epoch_ && grid_->version() == version_) return;
+    epoch_ = grid_->epoch();
+    version_ = grid_->version();
+    goals_.clear();
+    goalIndex_.clear();
+    for (Agent& a : agents_) a.dirty = true;
+}
+
+size_t countConflicts(const GridMap& grid, std::span<const Cell> from, std::span<const Cell> to) {
+    FlatHashMap64 arrivals(2 * to.size()), departures(2 * from.size());
+    size_t conflicts = 0;
+    for (size_t i = 0; i < to.size(); ++i) {
+        std::uint32_t& count = arrivals.findOrInsert(static_cast<std::uint32_t>(grid.index(to[i])), 0);
+        conflicts += count++ > 0;
+    }
+    for (size_t i = 0; i < from.size(); ++i)
+        departures.insert(static_cast<std::uint32_t>(grid.index(from[i])), static_cast<std::uint32_t>(i));
+    for (size_t i = 0; i < from.size() && i < to.size(); ++i) {
+        if (from[i] == to[i]) continue;
+        const std::uint32_t* j = departures.find(static_cast<std::uint32_t>(grid.index(to[i])));
+        if (j && *j > i && *j < to.size() && to[*j] == from[i]) ++conflicts;
+    }
+    return conflicts;
+}
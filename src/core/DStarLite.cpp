@@ -0,0 +1,221 @@
+#include "taikutsu/core/DStarLite.h"
+#include <algorithm>
+#include <bit>
+
+DStarLitePathfinder::DStarLitePathfinder(const GridMap& grid, const SearchOptions& opts)
+    : grid_(&grid), opts_(opts), eight_(opts.connectivity == Connectivity::Eight) {}
+
+void DStarLitePathfinder::ensureSize() {
+    if (grid_->stride() == stride_ && grid_->height() == h_ && !g_.empty()) return;
+    stride_ = grid_->stride();
+    h_ = grid_->height();
+    g_.assign(grid_->indexCount(), kInf);
+    rhs_.assign(grid_->indexCount(), kInf);
+    stamp_.assign(grid_->indexCount(), 0);
+    gen_ = 0;
+}
+
+void DStarLitePathfinder::set(int idx, int g, int rhs) {
+    const auto i = static_cast<size_t>(idx);
+    stamp_[i] = gen_;
+    g_[i] = g;
+    rhs_[i] = rhs;
+}
+
+unsigned DStarLitePathfinder::moves(int idx) const {
+    // le mosse sono simmetriche: la stessa mask dà successori e predecessori
+    return eight_ ? grid_->moveMask8(idx, opts_.cornerCutting) : grid_->walkableMask(idx);
+}
+
+int DStarLitePathfinder::stepCost(int d, int toIdx) const {
+    const int base = d >= kDownRight ? kCostDiagonal : kCostStraight;
+    return weighted_ ? base * grid_->costs()[toIdx] : base;
+}
+
+int DStarLitePathfinder::heuristic(int idx) const {
+    const Cell a = grid_->cellAt(start_), b = grid_->cellAt(idx);
+    return eight_ ? octileCost(a, b) : manhattanCost(a, b);
+}
+
+DStarLitePathfinder::Entry DStarLitePathfinder::key(int idx) const {
+    const int m = std::min(g(idx), rhs(idx));
+    return {m == kInf ? kInf : m + heuristic(idx) + km_, m, idx};
+}
+
+void DStarLitePathfinder::updateVertex(int idx) {
+    int r = rhs(idx);
+    if (idx != goal_) {
+        // rhs = min sui successori di (costo del passo + g)
+        r = kInf;
+        if (grid_->walkable(idx)) {
+            for (unsigned mask = moves(idx); mask != 0; mask &= mask - 1) {
+                const int d = std::countr_zero(mask);
+                const int nb = idx + grid_->offset(d);
+                const int gn = g(nb);
+                if (gn != kInf) r = std::min(r, gn + stepCost(d, nb));
+            }
+        }
+    }
+    const int gv = g(idx);
+    if (r != rhs(idx)) set(idx, gv, r);
+    if (gv != r) { // inconsistente: (ri)entra in open con la chiave attuale
+        open_.push_back(key(idx));
+        std::push_heap(open_.begin(), open_.end(), Cmp{});
+    }
+}
+
+void DStarLitePathfinder::computeShortestPath() {
+    result_.closed.clear();
+    result_.expanded = 0;
+    const Cmp greater{};
+
+    while (!open_.empty()) {
+        const Entry top = open_.front();
+        const int u = top.idx;
+        const int gu = g(u), ru = rhs(u);
+
+        // voce vecchia: nodo ormai consistente, oppure chiave cambiata
+        if (gu == ru) {
+            std::pop_heap(open_.begin(), open_.end(), Cmp{});
+            open_.pop_back();
+            continue;
+        }
+        const Entry now = key(u);
+        if (top.k1 != now.k1 || top.k2 != now.k2) {
+            std::pop_heap(open_.begin(), open_.end(), Cmp{});
+            open_.pop_back();
+            // chiave cresciuta (km): si reinserisce; se è calata esiste già una voce più recente
+            if (greater(now, top)) {
+                open_.push_back(now);
+                std::push_heap(open_.begin(), open_.end(), Cmp{});
+            }
+            continue;
+        }
+
+        // fine: top >= key(start) e start consistente
+        if (!greater(key(start_), top) && rhs(start_) == g(start_)) break;
+
+        std::pop_heap(open_.begin(), open_.end(), Cmp{});
+        open_.pop_back();
+        result_.closed.push_back(grid_->cellAt(u));
+        ++result_.expanded;
+
+        if (gu > ru) {
+            set(u, ru, ru); // sovraconsistente: g scende a rhs
+        } else {
+            set(u, kInf, ru); // sottoconsistente: g = inf e si ricalcola anche u
+            updateVertex(u);
+        }
+        for (unsigned mask = moves(u); mask != 0; mask &= mask - 1) {
+            const int p = u + grid_->offset(std::countr_zero(mask));
+            if (grid_->walkable(p)) updateVertex(p);
+        }
+    }
+}
+
+void DStarLitePathfinder::extractPath() {
+    result_.path.clear();
+    result_.success = false;
+    result_.cost = 0;
+    result_.pathLength = 0;
+    if (!grid_->walkable(start_) || !grid_->walkable(goal_) || rhs(start_) == kInf) return;
+
+    // discesa: dal nodo corrente al successore con costo + g minimo
+    int cur = start_;
+    int cost = 0;
+    result_.path.push_back(grid_->cellAt(cur));
+    while (cur != goal_) {
+        int best = -1, bestCost = kInf, bestStep = 0;
+        for (unsigned mask = moves(cur); mask != 0; mask &= mask - 1) {
+            const int d = std::countr_zero(mask);
+            const int nb = cur + grid_->offset(d);
+            const int gn = g(nb);
+            if (gn == kInf) continue;
+            const int step = stepCost(d, nb);
+            if (gn + step < bestCost) {
+                bestCost = gn + step;
+                best = nb;
+                bestStep = step;
+            }
+        }
+        if (best == -1 || result_.path.size() > grid_->indexCount()) { // non dovrebbe succedere
+            result_.path.clear();
+            return;
+        }
+        cost += bestStep;
+        cur = best;
+        result_.path.push_back(grid_->cellAt(cur));
+    }
+    result_.success = true;
+    result_.cost = cost;
+    result_.pathLength = result_.path.size();
+}
+
+const AStarResult& DStarLitePathfinder::plan(Cell start, Cell goal) {
+    ensureSize();
+    weighted_ = opts_.useTerrainCost && grid_->hasCosts();
+    if (++gen_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0u);
+        gen_ = 1;
+    }
+    open_.clear();
+    km_ = 0;
+    result_.clear();
+    startCell_ = start;
+    goalCell_ = goal;
+    hasQuery_ = true;
+    planned_ = grid_->isWalkable(start) && grid_->isWalkable(goal);
+    if (!planned_) return result_;
+
+    start_ = grid_->index(start);
+    goal_ = grid_->index(goal);
+    set(goal_, kInf, 0);
+    open_.push_back(key(goal_));
+
+    computeShortestPath();
+    extractPath();
+    return result_;
+}
+
+const AStarResult& DStarLitePathfinder::moveStart(Cell start) {
+    if (!planned_ || grid_->stride() != stride_ || grid_->height() != h_) {
+        if (!hasQuery_) return result_;
+        return plan(start, goalCell_);
+    }
+    result_.clear();
+    if (!grid_->isWalkable(start)) return result_;
+    startCell_ = start;
+
+    // le chiavi in open restano valide a meno di km: h(vecchio start, nuovo start)
+    const int last = start_;
+    start_ = grid_->index(start);
+    km_ += heuristic(last);
+
+    computeShortestPath();
+    extractPath();
+    return result_;
+}
+
+const AStarResult& DStarLitePathfinder::replan(std::span<const Cell> changed) {
+    if (!planned_ || grid_->stride() != stride_ || grid_->height() != h_) {
+        if (!hasQuery_) return result_;
+        return plan(startCell_, goalCell_);
+    }
+    weighted_ = opts_.useTerrainCost && grid_->hasCosts();
+
+    // una cella cambiata altera i suoi archi e, a 8 direzioni, le diagonali che le passano accanto:
+    // basta ricalcolare rhs della cella e degli 8 vicini
+    for (const Cell c : changed) {
+        if (!grid_->inBounds(c)) continue;
+        const int idx = grid_->index(c);
+        updateVertex(idx);
+        for (int d = 0; d < 8; ++d) {
+            const int nb = idx + grid_->offset(d);
+            if (grid_->walkable(nb)) updateVertex(nb);
+        }
+    }
+
+    computeShortestPath();
+    extractPath();
+    return result_;
+}
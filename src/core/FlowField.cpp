@@ -0,0 +1,183 @@
+#include "taikutsu/core/FlowField.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+namespace {
+    // direzione opposta (vedi Dir): R<->L, D<->U, DR<->UL, DL<->UR
+    std::uint8_t opposite(int d) { return static_cast<std::uint8_t>(d < 4 ? d ^ 1 : 11 - d); }
+}
+
+void FlowField::build(const GridMap& grid, std::span<const Cell> goals, const SearchOptions& opts) {
+    w_ = grid.width();
+    h_ = grid.height();
+    const size_t cells = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    dist_.assign(cells, kUnreachable);
+    dir_.assign(cells, kNoDir);
+
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool weighted = opts.useTerrainCost && grid.hasCosts();
+    if (!eight && !weighted) buildWavefront(grid, goals);
+    else buildDial(grid, goals, eight, opts.cornerCutting, weighted);
+}
+
+void FlowField::buildWavefront(const GridMap& grid, std::span<const Cell> goals) {
+    const int wpr = grid.wordsPerRow();
+    const size_t words = static_cast<size_t>(h_ + 2) * static_cast<size_t>(wpr);
+    visited_.assign(words, 0);
+    frontier_.assign(words, 0);
+    next_.assign(words, 0);
+    const std::uint64_t* walk = grid.words();
+
+    // onda 0 = goal; rmin/rmax = righe paddate con frontiera non vuota
+    int rmin = INT_MAX, rmax = -1;
+    for (const Cell& g : goals) {
+        if (!grid.isWalkable(g)) continue;
+        const auto idx = static_cast<size_t>(grid.index(g));
+        visited_[idx >> 6] |= std::uint64_t{1} << (idx & 63);
+        frontier_[idx >> 6] |= std::uint64_t{1} << (idx & 63);
+        dist_[cellIndex(g)] = 0;
+        rmin = std::min(rmin, g.y + 1);
+        rmax = std::max(rmax, g.y + 1);
+    }
+
+    // ogni onda: dilatazione a 4 direzioni della frontiera (shift nella riga, righe sopra/sotto),
+    // filtrata con le celle libere non ancora visitate. La cornice a 0 del grid ferma i bordi.
+    std::uint32_t dist = 0;
+    while (rmin <= rmax) {
+        dist += kCostStraight;
+        const int r0 = std::max(1, rmin - 1), r1 = std::min(h_, rmax + 1);
+        int nmin = INT_MAX, nmax = -1;
+        for (int r = r0; r <= r1; ++r) {
+            const size_t base = static_cast<size_t>(r) * static_cast<size_t>(wpr);
+            const std::uint64_t* F = frontier_.data() + base;
+            const std::uint64_t* up = F - wpr;
+            const std::uint64_t* down = F + wpr;
+            for (int i = 0; i < wpr; ++i) {
+                // frontiera vista da ogni cella: a destra, a sinistra, sotto, sopra
+                const std::uint64_t f = F[i];
+                const std::uint64_t right = (f >> 1) | (i + 1 < wpr ? F[i + 1] << 63 : 0);
+                const std::uint64_t left = (f << 1) | (i > 0 ? F[i - 1] >> 63 : 0);
+                const size_t w = base + static_cast<size_t>(i);
+                const std::uint64_t n = (right | left | up[i] | down[i]) & walk[w] & ~visited_[w];
+                next_[w] = n;
+                if (n == 0) continue;
+                visited_[w] |= n;
+                nmin = std::min(nmin, r);
+                nmax = std::max(nmax, r);
+                for (std::uint64_t m = n; m != 0; m &= m - 1) {
+                    const int b = std::countr_zero(m);
+                    const size_t c = cellIndex(Cell{i * 64 + b - 1, r - 1});
+                    dist_[c] = dist;
+                    // il passo verso il goal va verso la frontiera (stesso ordine di priorità di Dir)
+                    dir_[c] = ((right >> b) & 1u) ? kRight : ((left >> b) & 1u) ? kLeft : ((down[i] >> b) & 1u) ? kDown : kUp;
+                }
+            }
+        }
+        // la vecchia frontiera diventa il buffer (azzerato) per l'onda successiva
+        for (int r = rmin; r <= rmax; ++r)
+            std::fill_n(frontier_.begin() + static_cast<std::ptrdiff_t>(r) * wpr, wpr, std::uint64_t{0});
+        std::swap(frontier_, next_);
+        rmin = nmin;
+        rmax = nmax;
+    }
+}
+
+void FlowField::buildDial(const GridMap& grid, std::span<const Cell> goals, bool eight, bool cornerCutting,
+                          bool weighted) {
+    // costo massimo di un passo = numero di bucket circolari - 1
+    const int maxStep = (eight ? kCostDiagonal : kCostStraight) * (weighted ? 255 : 1);
+    const auto bucketCount = static_cast<size_t>(maxStep) + 1;
+    buckets_.resize(bucketCount);
+    for (auto& b : buckets_) b.clear();
+
+    const std::uint8_t* terrain = weighted ? grid.costs() : nullptr;
+    const int stride = grid.stride();
+    auto cellOf = [&](int idx) {
+        return static_cast<size_t>(idx / stride - 1) * static_cast<size_t>(w_) + static_cast<size_t>(idx % stride - 1);
+    };
+
+    size_t pending = 0;
+    for (const Cell& g : goals) {
+        if (!grid.isWalkable(g) || dist_[cellIndex(g)] == 0) continue;
+        dist_[cellIndex(g)] = 0;
+        buckets_[0].push_back(grid.index(g));
+        ++pending;
+    }
+
+    for (std::uint32_t cur = 0; pending > 0; ++cur) {
+        auto& bucket = buckets_[cur % bucketCount];
+        // i costi sono > 0: nessun inserimento nel bucket corrente durante il giro
+        for (const int idx : bucket) {
+            --pending;
+            if (dist_[cellOf(idx)] != cur) continue; // stale
+
+            // all'indietro: il predecessore p paga l'ingresso in idx
+            const int enter = terrain ? terrain[idx] : 1;
+            const unsigned mask = eight ? grid.moveMask8(idx, cornerCutting) : grid.walkableMask(idx);
+            for (unsigned m = mask; m != 0; m &= m - 1) {
+                const int d = std::countr_zero(m);
+                const int p = idx + grid.offset(d);
+                const std::uint32_t nd = cur + static_cast<std::uint32_t>((d >= kDownRight ? kCostDiagonal : kCostStraight) * enter);
+                const size_t pc = cellOf(p);
+                if (nd >= dist_[pc]) continue;
+                dist_[pc] = nd;
+                dir_[pc] = opposite(d);
+                buckets_[nd % bucketCount].push_back(p);
+                ++pending;
+            }
+        }
+        bucket.clear();
+    }
+}
+
+std::unique_ptr<FlowField> SharedFlowField::acquireBuffer() {
+    // il campo rilasciato dall'ultimo che lo teneva, se c'è. Il rilascio passa dal mutex di
+    // Spare, quindi le letture di quel lettore vengono prima della nostra build (un controllo
+    // use_count() == 1 non basterebbe: è un load relaxed, non ordina niente).
+    std::lock_guard<std::mutex> lk(spare_->m);
+    if (spare_->field) return std::move(spare_->field);
+    return std::make_unique<FlowField>();
+}
+
+void SharedFlowField::rebuild(const GridMap& grid, std::span<const Cell> goals, const SearchOptions& opts) {
+    build(++requested_, grid, goals, opts);
+}
+
+void SharedFlowField::build(std::uint64_t seq, const GridMap& grid, std::span<const Cell> goals,
+                            const SearchOptions& opts) {
+    std::lock_guard<std::mutex> lk(buildMutex_);
+    if (seq < requested_.load()) return; // c'è già una richiesta più recente
+    std::unique_ptr<FlowField> field = acquireBuffer();
+    field->build(grid, goals, opts);
+    // l'ultimo shared_ptr rilasciato (in qualsiasi thread) rimette il campo in spare_
+    std::shared_ptr<const FlowField> published(field.release(), [spare = spare_](const FlowField* f) {
+        std::lock_guard<std::mutex> lk(spare->m);
+        spare->field.reset(const_cast<FlowField*>(f)); // uno solo in riserva, un eventuale altro si libera
+    });
+    {
+        std::lock_guard<std::mutex> cur(currentMutex_);
+        std::swap(published, current_);
+    }
+    version_.fetch_add(1, std::memory_order_release);
+    // published (il campo vecchio) si rilascia qui: torna in spare_ subito se nessun lettore lo tiene
+}
+
+void SharedFlowField::rebuildAsync(ThreadPool& pool, const GridMap& grid, std::vector<Cell> goals,
+                                   const SearchOptions& opts) {
+    {
+        std::lock_guard<std::mutex> lk(pendingMutex_);
+        ++pending_;
+    }
+    const std::uint64_t seq = ++requested_;
+    pool.submit([this, seq, grid, goals = std::move(goals), opts](unsigned) {
+        build(seq, grid, goals, opts);
+        std::lock_guard<std::mutex> lk(pendingMutex_);
+        if (--pending_ == 0) pendingDone_.notify_all();
+    });
+}
+
+void SharedFlowField::wait() {
+    std::unique_lock<std::mutex> lk(pendingMutex_);
+    pendingDone_.wait(lk, [this] { return pending_ == 0; });
+}
@@ -1,8 +1,77 @@
 #include "taikutsu/core/GridMap.h"
+#include "taikutsu/core/BitOps.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cstddef>
 
-// costruisce grid WxH e inizializza tutte le celle come libere (false)
+std::uint64_t GridMap::Epoch::next() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+bool GridMap::fits(int width, int height) {
+    if (width < 0 || height < 0) return false;
+    const std::int64_t wordsPerRow = (static_cast<std::int64_t>(width) + 2 + 63) / 64;
+    return (static_cast<std::int64_t>(height) + 2) * wordsPerRow * 64 <= INT_MAX;
+}
+
+// costruisce grid WxH e inizializza tutte le celle come libere
+// (+2 per la cornice sentinella: colonna 0 e bit di padding a destra restano 0 = bloccati)
 GridMap::GridMap(int width, int height)
-    : w_(width), h_(height), blocked_(static_cast<size_t>(width * height), false) {}
+    : w_(width), h_(height),
+      wordsPerRow_((width + 2 + 63) / 64),
+      stride_(wordsPerRow_ * 64),
+      wordCount_(static_cast<size_t>(height + 2) * static_cast<size_t>(wordsPerRow_)),
+      bits_(wordCount_, 0),
+      regionsX_((width + kRegionSize - 1) >> kRegionShift),
+      regionsY_((height + kRegionSize - 1) >> kRegionShift),
+      regionVersion_(static_cast<size_t>(regionsX_) * static_cast<size_t>(regionsY_), 0),
+      regionRelax_(regionVersion_.size(), 0) {
+    bindStorage();
+    clear();
+}
+
+// in prestito: nessuna copia, versioni a 0 (il grid non cambierà mai)
+GridMap::GridMap(int width, int height, const std::uint64_t* words, const std::uint8_t* costs)
+    : w_(width), h_(height),
+      wordsPerRow_((width + 2 + 63) / 64),
+      stride_(wordsPerRow_ * 64),
+      wordCount_(static_cast<size_t>(height + 2) * static_cast<size_t>(wordsPerRow_)),
+      words_(words), costData_(costs),
+      regionsX_((width + kRegionSize - 1) >> kRegionShift),
+      regionsY_((height + kRegionSize - 1) >> kRegionShift),
+      regionVersion_(static_cast<size_t>(regionsX_) * static_cast<size_t>(regionsY_), 0),
+      regionRelax_(regionVersion_.size(), 0) {}
+
+GridMap::GridMap(const GridMap& other)
+    : w_(other.w_), h_(other.h_), wordsPerRow_(other.wordsPerRow_), stride_(other.stride_),
+      wordCount_(other.wordCount_),
+      bits_(other.words_, other.words_ + other.wordCount_),
+      regionsX_(other.regionsX_), regionsY_(other.regionsY_),
+      regionVersion_(other.regionVersion_), regionRelax_(other.regionRelax_),
+      version_(other.version_), relaxVersion_(other.relaxVersion_) {
+    if (other.costData_ != nullptr) cost_.assign(other.costData_, other.costData_ + other.indexCount());
+    bindStorage();
+}
+
+GridMap& GridMap::operator=(const GridMap& other) {
+    if (this != &other) *this = GridMap(other);
+    return *this;
+}
+
+void GridMap::touchRegions(int x0, int y0, int x1, int y1, bool relax) {
+    const std::uint64_t tick = ++version_;
+    if (relax) relaxVersion_ = tick;
+    for (int ry = y0 >> kRegionShift; ry <= (y1 - 1) >> kRegionShift; ++ry) {
+        for (int rx = x0 >> kRegionShift; rx <= (x1 - 1) >> kRegionShift; ++rx) {
+            const auto r = static_cast<size_t>(ry * regionsX_ + rx);
+            regionVersion_[r] = tick;
+            if (relax) regionRelax_[r] = tick;
+        }
+    }
+}
 
 // controlla se una coordinata (x,y) è all'interno dei limiti del grid
 bool GridMap::inBounds(Cell c) const {
@@ -14,39 +83,130 @@ bool GridMap::inBounds(Cell c) const {
 // ciò semplifica A*, può usare is Walkable senza preocuparsi con boundaries
 bool GridMap::isBlocked(Cell c) const {
     if (!inBounds(c)) return true;
-    return blocked_[static_cast<size_t>(idx(c))];
+    return !walkable(index(c));
 }
 
 // determina se una cella è bloccata oppure no
 // se è fuori mappa, la ignora
 void GridMap::setBlocked(Cell c, bool blocked) {
     if (!inBounds(c)) return;
-    blocked_[static_cast<size_t>(idx(c))] = blocked;
+    const auto i = static_cast<size_t>(index(c));
+    const std::uint64_t bit = std::uint64_t{1} << (i & 63);
+    if (((bits_[i >> 6] & bit) == 0) == blocked) return; // già così: nessuna nuova versione
+    if (blocked) bits_[i >> 6] &= ~bit;
+    else         bits_[i >> 6] |= bit;
+    touchCell(c, !blocked);
 }
 
 //alterna lo stato: Libero diventa obstacle, e Obstacle diventa libero
 // utile per modifica del gridmap tramite click del mouse
 void GridMap::toggleBlocked(Cell c) {
     if (!inBounds(c)) return;
-    const auto i = static_cast<size_t>(idx(c));
-    blocked_[i] = !blocked_[i];
+    const auto i = static_cast<size_t>(index(c));
+    bits_[i >> 6] ^= std::uint64_t{1} << (i & 63);
+    touchCell(c, walkable(static_cast<int>(i)));
+}
+
+void GridMap::fillBits(int row, int bit, int n, bool value) {
+    std::uint64_t* r = bits_.data() + static_cast<size_t>(row) * static_cast<size_t>(wordsPerRow_);
+    const std::uint64_t v = value ? ~std::uint64_t{0} : 0;
+    while (n > 0) {
+        // primo pezzo fino al bordo della word, poi word intere
+        const int chunk = std::min(n, 64 - (bit & 63));
+        storeBits(r, bit, chunk, v);
+        bit += chunk;
+        n -= chunk;
+    }
+}
+
+void GridMap::fillRect(Cell min, int w, int h, bool blocked) {
+    const int x0 = std::max(min.x, 0);
+    const int y0 = std::max(min.y, 0);
+    const int x1 = std::min(min.x + w, w_);
+    const int y1 = std::min(min.y + h, h_);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int y = y0; y < y1; ++y) fillBits(y + 1, x0 + 1, x1 - x0, !blocked);
+    touchRegions(x0, y0, x1, y1, !blocked);
+}
+
+void GridMap::clear() {
+    fillRect(Cell{0, 0}, w_, h_, false);
+    clearCosts();
+}
+
+std::uint8_t GridMap::cost(Cell c) const {
+    if (!inBounds(c) || costData_ == nullptr) return 1;
+    return costData_[static_cast<size_t>(index(c))];
+}
+
+void GridMap::setCost(Cell c, std::uint8_t cost) {
+    if (!inBounds(c)) return;
+    cost = std::max<std::uint8_t>(cost, 1);
+    if (cost_.empty()) {
+        if (cost == 1) return; // niente da fare, il layer resta non allocato
+        cost_.assign(indexCount(), 1);
+        bindStorage();
+    }
+    std::uint8_t& slot = cost_[static_cast<size_t>(index(c))];
+    if (slot == cost) return;
+    const bool relax = cost < slot;
+    slot = cost;
+    touchCell(c, relax);
+}
+
+void GridMap::clearCosts() {
+    if (cost_.empty()) return;
+    std::vector<std::uint8_t>().swap(cost_);
+    bindStorage();
+    touchRegions(0, 0, w_, h_, true);
+}
+
+void GridMap::copyRegion(const GridMap& src, Cell srcMin, int w, int h, Cell dstMin) {
+    if (&src == this) {
+        // sorgente e destinazione possono sovrapporsi: copiamo da una fotografia
+        const GridMap snapshot = src;
+        copyRegion(snapshot, srcMin, w, h, dstMin);
+        return;
+    }
+
+    // clip: il rettangolo deve stare dentro entrambi i grid
+    int sx = srcMin.x, sy = srcMin.y, dx = dstMin.x, dy = dstMin.y;
+    if (sx < 0) { w += sx; dx -= sx; sx = 0; }
+    if (sy < 0) { h += sy; dy -= sy; sy = 0; }
+    if (dx < 0) { w += dx; sx -= dx; dx = 0; }
+    if (dy < 0) { h += dy; sy -= dy; dy = 0; }
+    w = std::min({w, src.w_ - sx, w_ - dx});
+    h = std::min({h, src.h_ - sy, h_ - dy});
+    if (w <= 0 || h <= 0) return;
+
+    touchRegions(dx, dy, dx + w, dy + h, true);
+    for (int y = 0; y < h; ++y) {
+        const std::uint64_t* s = src.words_ + static_cast<size_t>(sy + y + 1) * static_cast<size_t>(src.wordsPerRow_);
+        std::uint64_t* d = bits_.data() + static_cast<size_t>(dy + y + 1) * static_cast<size_t>(wordsPerRow_);
+        for (int off = 0; off < w; off += 64) {
+            const int n = std::min(64, w - off);
+            storeBits(d, dx + 1 + off, n, loadBits(s, sx + 1 + off, n));
+        }
+    }
+
+    // costi: cella per cella (solo se almeno uno dei due grid ha il layer)
+    if (!src.hasCosts() && !hasCosts()) return;
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            setCost(Cell{dx + x, dy + y}, src.cost(Cell{sx + x, sy + y}));
 }
 
 // return dei vicini in 4 direzioni (no diagonali)
 std::vector<Cell> GridMap::neighbors4(Cell c) const {
     std::vector<Cell> out;
+    if (!inBounds(c)) return out;
     out.reserve(4);
 
-    const Cell cand[4] = {
-        {c.x + 1, c.y},  // candidati in 4 direzioni (right, left, up, down)
-        {c.x - 1, c.y},
-        {c.x, c.y + 1},
-        {c.x, c.y - 1}
-    };
-
-    //filtra solo i candidati che sono walkable (non bloccati)
-    for (Cell n : cand) {
-        if (isWalkable(n)) out.push_back(n);
+    //filtra solo i candidati che sono walkable (non bloccati), ordine: right, left, down, up
+    for (unsigned m = neighborMask(c); m != 0; m &= m - 1) {
+        const int d = std::countr_zero(m);
+        out.push_back(Cell{c.x + kDirDx[d], c.y + kDirDy[d]});
     }
 
     return out;
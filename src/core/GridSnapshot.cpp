@@ -0,0 +1,232 @@
+#include "taikutsu/core/GridSnapshot.h"
+#include "taikutsu/core/BitOps.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr int kTileShift = GridSnapshot::kTileShift;
+    constexpr int kMask = GridSnapshot::kTileSize - 1;
+
+    // unica tile tutta bloccata, condivisa da tutte le versioni di tutti i grid (bit a 0)
+    const GridTile kBlockedTile{};
+
+    int tilesFor(int cells) {
+        return static_cast<int>((static_cast<std::int64_t>(cells) + GridSnapshot::kTileSize - 1) >>
+                                GridSnapshot::kTileShift);
+    }
+}
+
+// ---------------- GridSnapshot ----------------
+
+GridSnapshot::TileState GridSnapshot::tileState(int tx, int ty) const {
+    const GridTile* t = tileAt(tx, ty);
+    if (t == nullptr) return TileState::Free;
+    if (t == &kBlockedTile) return TileState::Blocked;
+    return TileState::Mixed;
+}
+
+size_t GridSnapshot::mixedTileCount() const {
+    size_t n = 0;
+    for (const auto& row : rows_)
+        n += static_cast<size_t>(std::count_if(row->tiles.begin(), row->tiles.end(), [](const GridTile* t) {
+            return t != nullptr && t != &kBlockedTile;
+        }));
+    return n;
+}
+
+// come ChunkedGridMap::walkableMask8, con la tile presa dal puntatore
+unsigned GridSnapshot::walkableMask8(Cell c) const {
+    const int lx = c.x & kMask, ly = c.y & kMask;
+    if (lx > 0 && lx < kMask && ly > 0 && ly < kMask && c.x + 1 < w_ && c.y + 1 < h_) {
+        const GridTile* t = tileAt(c.x >> kTileShift, c.y >> kTileShift);
+        if (t == nullptr) return 0xFFu;
+        if (t == &kBlockedTile) return 0u;
+        const std::uint64_t* row = t->rows + ly;
+        // bit 0 = x - 1, bit 1 = x, bit 2 = x + 1
+        const unsigned up = static_cast<unsigned>(row[-1] >> (lx - 1)) & 7u;
+        const unsigned mid = static_cast<unsigned>(row[0] >> (lx - 1)) & 7u;
+        const unsigned down = static_cast<unsigned>(row[1] >> (lx - 1)) & 7u;
+        return  ((mid >> 2) & 1u)
+             | ((mid & 1u) << kLeft)
+             | (((down >> 1) & 1u) << kDown)
+             | (((up >> 1) & 1u) << kUp)
+             | (((down >> 2) & 1u) << kDownRight)
+             | ((down & 1u) << kDownLeft)
+             | (((up >> 2) & 1u) << kUpRight)
+             | ((up & 1u) << kUpLeft);
+    }
+    unsigned m = 0;
+    for (int d = 0; d < 8; ++d)
+        m |= static_cast<unsigned>(isWalkable(Cell{c.x + kDirDx[d], c.y + kDirDy[d]})) << d;
+    return m;
+}
+
+// ---------------- VersionedGrid ----------------
+
+VersionedGrid::VersionedGrid(int width, int height, bool blocked)
+    : w_(std::max(width, 0)), h_(std::max(height, 0)),
+      tilesX_(tilesFor(w_)), tilesY_(tilesFor(h_)),
+      tiles_(static_cast<size_t>(tilesX_) * static_cast<size_t>(tilesY_), blocked ? &kBlockedTile : nullptr),
+      owned_(tiles_.size()), isDirty_(tiles_.size(), 0) {
+    publish();
+}
+
+VersionedGrid::VersionedGrid(const GridMap& grid)
+    : w_(grid.width()), h_(grid.height()),
+      tilesX_(tilesFor(w_)), tilesY_(tilesFor(h_)),
+      tiles_(static_cast<size_t>(tilesX_) * static_cast<size_t>(tilesY_), &kBlockedTile),
+      owned_(tiles_.size()), isDirty_(tiles_.size(), 0) {
+    const auto wpr = static_cast<size_t>(grid.wordsPerRow());
+    for (int ty = 0; ty < tilesY_; ++ty) {
+        for (int tx = 0; tx < tilesX_; ++tx) {
+            const int n = std::popcount(rowMask(tx));
+            GridTile* tile = writable(tileIndex(tx, ty));
+            for (int ly = 0; ly < rowsIn(ty); ++ly) {
+                const std::uint64_t* row = grid.words() + static_cast<size_t>((ty << kTileShift) + ly + 1) * wpr;
+                tile->rows[ly] = loadBits(row, (tx << kTileShift) + 1, n);
+            }
+        }
+    }
+    publish(); // le tile uniformi perdono il payload qui
+}
+
+std::uint64_t VersionedGrid::rowMask(int tx) const {
+    return lowMask(std::min(GridSnapshot::kTileSize, w_ - (tx << kTileShift)));
+}
+
+int VersionedGrid::rowsIn(int ty) const {
+    return std::min(GridSnapshot::kTileSize, h_ - (ty << kTileShift));
+}
+
+void VersionedGrid::markDirty(size_t tile) {
+    if (isDirty_[tile]) return;
+    isDirty_[tile] = 1;
+    dirty_.push_back(static_cast<std::uint32_t>(tile));
+}
+
+GridTile* VersionedGrid::writable(size_t tile) {
+    if (owned_[tile]) return owned_[tile].get();
+    auto copy = std::make_shared<GridTile>();
+    if (const GridTile* src = tiles_[tile]; src != nullptr) {
+        *copy = *src;
+    } else { // tile libera: solo le celle dentro la mappa
+        const int tx = static_cast<int>(tile % static_cast<size_t>(tilesX_));
+        const int ty = static_cast<int>(tile / static_cast<size_t>(tilesX_));
+        const int rows = rowsIn(ty);
+        for (int ly = 0; ly < GridSnapshot::kTileSize; ++ly) copy->rows[ly] = ly < rows ? rowMask(tx) : 0;
+    }
+    tiles_[tile] = copy.get();
+    owned_[tile] = std::move(copy);
+    markDirty(tile);
+    return owned_[tile].get();
+}
+
+void VersionedGrid::setUniform(size_t tile, bool blocked) {
+    owned_[tile].reset();
+    tiles_[tile] = blocked ? &kBlockedTile : nullptr;
+    markDirty(tile);
+}
+
+bool VersionedGrid::isWalkable(Cell c) const {
+    if (c.x < 0 || c.x >= w_ || c.y < 0 || c.y >= h_) return false;
+    const GridTile* t = tiles_[tileIndex(c.x >> kTileShift, c.y >> kTileShift)];
+    return t == nullptr || ((t->rows[c.y & kMask] >> (c.x & kMask)) & 1u);
+}
+
+void VersionedGrid::setBlocked(Cell c, bool blocked) {
+    if (c.x < 0 || c.x >= w_ || c.y < 0 || c.y >= h_ || isWalkable(c) != blocked) return;
+    toggleBlocked(c);
+}
+
+void VersionedGrid::toggleBlocked(Cell c) {
+    if (c.x < 0 || c.x >= w_ || c.y < 0 || c.y >= h_) return;
+    GridTile* tile = writable(tileIndex(c.x >> kTileShift, c.y >> kTileShift));
+    tile->rows[c.y & kMask] ^= std::uint64_t{1} << (c.x & kMask);
+}
+
+void VersionedGrid::fillRect(Cell min, int w, int h, bool blocked) {
+    const int x0 = std::max(min.x, 0);
+    const int y0 = std::max(min.y, 0);
+    const int x1 = static_cast<int>(std::min<std::int64_t>(static_cast<std::int64_t>(min.x) + w, w_));
+    const int y1 = static_cast<int>(std::min<std::int64_t>(static_cast<std::int64_t>(min.y) + h, h_));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const GridTile* uniform = blocked ? &kBlockedTile : nullptr;
+    for (int ty = y0 >> kTileShift; ty <= (y1 - 1) >> kTileShift; ++ty) {
+        const int ty0 = std::max(y0, ty << kTileShift), ty1 = std::min(y1, (ty << kTileShift) + rowsIn(ty));
+        for (int tx = x0 >> kTileShift; tx <= (x1 - 1) >> kTileShift; ++tx) {
+            const size_t t = tileIndex(tx, ty);
+            if (tiles_[t] == uniform) continue;
+            const int cols = std::popcount(rowMask(tx));
+            const int tx0 = std::max(x0, tx << kTileShift), tx1 = std::min(x1, (tx << kTileShift) + cols);
+            // tutta la tile coperta: basta la voce della directory, nessuna copia
+            if (tx1 - tx0 == cols && ty1 - ty0 == rowsIn(ty)) {
+                setUniform(t, blocked);
+                continue;
+            }
+            GridTile* tile = writable(t);
+            const std::uint64_t bits = lowMask(tx1 - tx0) << (tx0 & kMask);
+            for (int y = ty0; y < ty1; ++y) {
+                if (blocked) tile->rows[y & kMask] &= ~bits;
+                else         tile->rows[y & kMask] |= bits;
+            }
+        }
+    }
+}
+
+std::shared_ptr<const GridSnapshot> VersionedGrid::publish() {
+    if (base_ && dirty_.empty()) return base_;
+
+    // tile toccate di nuovo canoniche: una tile copiata e poi riportata uniforme perde il payload
+    for (const std::uint32_t t : dirty_) {
+        if (!owned_[t]) continue;
+        const int tx = static_cast<int>(t % static_cast<std::uint32_t>(tilesX_));
+        const int ty = static_cast<int>(t / static_cast<std::uint32_t>(tilesX_));
+        const std::uint64_t valid = rowMask(tx);
+        bool allFree = true, allBlocked = true;
+        for (int ly = 0; ly < rowsIn(ty) && (allFree || allBlocked); ++ly) {
+            allFree &= owned_[t]->rows[ly] == valid;
+            allBlocked &= owned_[t]->rows[ly] == 0;
+        }
+        if (allFree || allBlocked) setUniform(t, allBlocked);
+    }
+    std::sort(dirty_.begin(), dirty_.end()); // raggruppate per riga di tile
+
+    auto snap = std::make_shared<GridSnapshot>();
+    snap->w_ = w_;
+    snap->h_ = h_;
+    snap->tilesX_ = tilesX_;
+    snap->tilesY_ = tilesY_;
+    snap->version_ = base_ ? base_->version_ + 1 : 0;
+    if (base_) {
+        snap->rows_ = base_->rows_; // solo il primo livello: un puntatore per riga di tile
+    } else { // prima versione: tutte le righe sono nuove
+        snap->rows_.resize(static_cast<size_t>(tilesY_));
+        for (int ty = 0; ty < tilesY_; ++ty) {
+            auto row = std::make_shared<GridSnapshot::TileRow>();
+            row->owned.resize(static_cast<size_t>(tilesX_));
+            row->tiles.assign(tiles_.begin() + static_cast<std::ptrdiff_t>(tileIndex(0, ty)),
+                              tiles_.begin() + static_cast<std::ptrdiff_t>(tileIndex(0, ty + 1)));
+            snap->rows_[static_cast<size_t>(ty)] = std::move(row);
+        }
+    }
+
+    // una riga nuova per ogni riga di tile con modifiche, le altre restano condivise
+    for (size_t i = 0; i < dirty_.size();) {
+        const auto ty = dirty_[i] / static_cast<std::uint32_t>(tilesX_);
+        auto row = std::make_shared<GridSnapshot::TileRow>(*snap->rows_[ty]);
+        for (; i < dirty_.size() && dirty_[i] / static_cast<std::uint32_t>(tilesX_) == ty; ++i) {
+            const std::uint32_t t = dirty_[i];
+            const std::uint32_t tx = t % static_cast<std::uint32_t>(tilesX_);
+            row->owned[tx] = std::move(owned_[t]); // vuoto se uniforme
+            row->tiles[tx] = tiles_[t];
+            isDirty_[t] = 0;
+        }
+        snap->rows_[ty] = std::move(row);
+    }
+    dirty_.clear();
+
+    base_ = snap;
+    current_.store(snap, std::memory_order_release);
+    return snap;
+}
@@ -0,0 +1,401 @@
+#include "taikutsu/core/Hierarchical.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // min-heap per f (a parità di f, g maggiore prima)
+    struct MinF {
+        template <class Entry>
+        bool operator()(const Entry& a, const Entry& b) const { return a.f > b.f || (a.f == b.f && a.g < b.g); }
+    };
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const GridMap& grid, int clusterSize, const SearchOptions& opts)
+    : grid_(&grid), opts_(opts), size_(std::max(2, clusterSize)) {
+    rebuild();
+}
+
+void HierarchicalPathfinder::rebuild() {
+    gridW_ = grid_->width();
+    gridH_ = grid_->height();
+    ncx_ = (gridW_ + size_ - 1) / size_;
+    ncy_ = (gridH_ + size_ - 1) / size_;
+    eight_ = opts_.connectivity == Connectivity::Eight;
+
+    nodes_.clear();
+    freeNodes_.clear();
+    clusters_.clear();
+    borders_.clear();
+
+    for (int cy = 0; cy < ncy_; ++cy) {
+        for (int cx = 0; cx < ncx_; ++cx) {
+            const int x0 = cx * size_, y0 = cy * size_;
+            clusters_.push_back(Cluster{x0, y0, std::min(size_, gridW_ - x0), std::min(size_, gridH_ - y0), {}, {}});
+        }
+    }
+    // stesso ordine di verticalBorder()/horizontalBorder()
+    for (int cy = 0; cy < ncy_; ++cy)
+        for (int cx = 0; cx + 1 < ncx_; ++cx) borders_.push_back(Border{cy * ncx_ + cx, cy * ncx_ + cx + 1, true, {}});
+    for (int cy = 0; cy + 1 < ncy_; ++cy)
+        for (int cx = 0; cx < ncx_; ++cx) borders_.push_back(Border{cy * ncx_ + cx, (cy + 1) * ncx_ + cx, false, {}});
+
+    const auto cells = static_cast<size_t>(size_) * static_cast<size_t>(size_);
+    dist_.assign(cells, kInf);
+    parent_.assign(cells, -1);
+    stamp_.assign(cells, 0);
+    gen_ = 0;
+
+    clusterDirty_.assign(clusters_.size(), 0);
+    borderDirty_.assign(borders_.size(), 0);
+    dirtyClusters_.clear();
+    dirtyBorders_.clear();
+    for (size_t b = 0; b < borders_.size(); ++b) markBorder(static_cast<int>(b));
+    for (size_t k = 0; k < clusters_.size(); ++k) markCluster(static_cast<int>(k));
+    update();
+}
+
+void HierarchicalPathfinder::markCluster(int k) {
+    if (clusterDirty_[static_cast<size_t>(k)]) return;
+    clusterDirty_[static_cast<size_t>(k)] = 1;
+    dirtyClusters_.push_back(k);
+}
+
+void HierarchicalPathfinder::markBorder(int b) {
+    if (borderDirty_[static_cast<size_t>(b)]) return;
+    borderDirty_[static_cast<size_t>(b)] = 1;
+    dirtyBorders_.push_back(b);
+}
+
+void HierarchicalPathfinder::notifyChanged(Cell c) {
+    if (c.x < 0 || c.y < 0 || c.x >= gridW_ || c.y >= gridH_) return;
+    const int cx = c.x / size_, cy = c.y / size_;
+    const Cluster& k = clusters_[static_cast<size_t>(clusterOf(c))];
+    markCluster(clusterOf(c));
+
+    // le entrate dipendono solo dalle due file di celle affacciate sul bordo
+    if (c.x == k.x0 && cx > 0) markBorder(verticalBorder(cx - 1, cy));
+    if (c.x == k.x0 + k.w - 1 && cx + 1 < ncx_) markBorder(verticalBorder(cx, cy));
+    if (c.y == k.y0 && cy > 0) markBorder(horizontalBorder(cx, cy - 1));
+    if (c.y == k.y0 + k.h - 1 && cy + 1 < ncy_) markBorder(horizontalBorder(cx, cy));
+}
+
+void HierarchicalPathfinder::update() {
+    if (grid_->width() != gridW_ || grid_->height() != gridH_) {
+        rebuild();
+        return;
+    }
+    weighted_ = opts_.useTerrainCost && grid_->hasCosts();
+
+    // bordi prima: cambiano i nodi di entrambi i cluster affacciati
+    for (const int b : dirtyBorders_) {
+        Border& border = borders_[static_cast<size_t>(b)];
+        buildBorder(border);
+        markCluster(border.a);
+        markCluster(border.b);
+        borderDirty_[static_cast<size_t>(b)] = 0;
+    }
+    dirtyBorders_.clear();
+
+    lastRebuilt_ = dirtyClusters_.size();
+    for (const int k : dirtyClusters_) {
+        buildCluster(k);
+        clusterDirty_[static_cast<size_t>(k)] = 0;
+    }
+    dirtyClusters_.clear();
+}
+
+int HierarchicalPathfinder::newNode(Cell c, int cluster) {
+    int id;
+    if (!freeNodes_.empty()) {
+        id = freeNodes_.back();
+        freeNodes_.pop_back();
+    } else {
+        id = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[static_cast<size_t>(id)] = Node{c, cluster, -1, -1, kInf};
+    return id;
+}
+
+int HierarchicalPathfinder::stepCost(int base, int fromIdx, int toIdx, bool reverse) const {
+    if (!weighted_) return base;
+    // il costo è quello della cella in cui si entra: all'indietro è la cella di partenza
+    return base * grid_->costs()[reverse ? fromIdx : toIdx];
+}
+
+void HierarchicalPathfinder::buildBorder(Border& border) {
+    for (const int id : border.nodes) {
+        nodes_[static_cast<size_t>(id)].cluster = -1;
+        freeNodes_.push_back(id);
+    }
+    border.nodes.clear();
+
+    const Cluster& a = clusters_[static_cast<size_t>(border.a)];
+    // cella lungo il bordo dalla parte di a (i = offset lungo il bordo) e la sua gemella in b
+    const int len = border.vertical ? a.h : a.w;
+    auto sideA = [&](int i) { return border.vertical ? Cell{a.x0 + a.w - 1, a.y0 + i} : Cell{a.x0 + i, a.y0 + a.h - 1}; };
+    auto sideB = [&](int i) { return border.vertical ? Cell{a.x0 + a.w, a.y0 + i} : Cell{a.x0 + i, a.y0 + a.h}; };
+
+    auto addTransition = [&](int i) {
+        const Cell ca = sideA(i), cb = sideB(i);
+        const int na = newNode(ca, border.a);
+        const int nb = newNode(cb, border.b);
+        Node& A = nodes_[static_cast<size_t>(na)];
+        Node& B = nodes_[static_cast<size_t>(nb)];
+        A.partner = nb;
+        B.partner = na;
+        A.partnerCost = stepCost(kCostStraight, grid_->index(ca), grid_->index(cb), false);
+        B.partnerCost = stepCost(kCostStraight, grid_->index(cb), grid_->index(ca), false);
+        border.nodes.push_back(na);
+        border.nodes.push_back(nb);
+    };
+
+    // tratti massimali in cui entrambe le celle affacciate sono libere
+    for (int i = 0; i < len;) {
+        if (!grid_->isWalkable(sideA(i)) || !grid_->isWalkable(sideB(i))) {
+            ++i;
+            continue;
+        }
+        const int s = i;
+        while (i < len && grid_->isWalkable(sideA(i)) && grid_->isWalkable(sideB(i))) ++i;
+        if (i - s >= kLongEntrance) {
+            addTransition(s);
+            addTransition(i - 1);
+        } else {
+            addTransition(s + (i - s) / 2);
+        }
+    }
+}
+
+void HierarchicalPathfinder::buildCluster(int k) {
+    Cluster& cl = clusters_[static_cast<size_t>(k)];
+    cl.nodes.clear();
+
+    // nodi del cluster = nodi dei suoi (fino a) 4 bordi che stanno dalla sua parte
+    const int cx = k % ncx_, cy = k / ncx_;
+    auto collect = [&](int b) {
+        for (const int id : borders_[static_cast<size_t>(b)].nodes)
+            if (nodes_[static_cast<size_t>(id)].cluster == k) cl.nodes.push_back(id);
+    };
+    if (cx > 0) collect(verticalBorder(cx - 1, cy));
+    if (cx + 1 < ncx_) collect(verticalBorder(cx, cy));
+    if (cy > 0) collect(horizontalBorder(cx, cy - 1));
+    if (cy + 1 < ncy_) collect(horizontalBorder(cx, cy));
+
+    const size_t n = cl.nodes.size();
+    for (size_t i = 0; i < n; ++i) nodes_[static_cast<size_t>(cl.nodes[i])].local = static_cast<int>(i);
+
+    // matrice delle distanze: una ricerca completa del cluster per nodo
+    cl.dist.assign(n * n, kInf);
+    for (size_t i = 0; i < n; ++i) {
+        localSearch(cl, nodes_[static_cast<size_t>(cl.nodes[i])].cell, Cell{-1, -1}, false);
+        for (size_t j = 0; j < n; ++j)
+            cl.dist[i * n + j] = localDist(localIndex(cl, nodes_[static_cast<size_t>(cl.nodes[j])].cell));
+    }
+}
+
+void HierarchicalPathfinder::localSearch(const Cluster& k, Cell source, Cell target, bool reverse) {
+    if (++gen_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0u);
+        gen_ = 1;
+    }
+    if (!grid_->isWalkable(source)) return;
+
+    const bool hasTarget = target.x >= 0;
+    const int targetLi = hasTarget ? localIndex(k, target) : -1;
+    auto inside = [&](Cell c) { return c.x >= k.x0 && c.y >= k.y0 && c.x < k.x0 + k.w && c.y < k.y0 + k.h; };
+    auto cellOf = [&](int li) { return Cell{k.x0 + li % k.w, k.y0 + li / k.w}; };
+    auto h = [&](Cell c) { return hasTarget ? (eight_ ? octileCost(c, target) : manhattanCost(c, target)) : 0; };
+    auto moves = [&](int idx) { return eight_ ? grid_->moveMask8(idx, opts_.cornerCutting) : grid_->walkableMask(idx); };
+
+    const int srcLi = localIndex(k, source);
+    stamp_[static_cast<size_t>(srcLi)] = gen_;
+    dist_[static_cast<size_t>(srcLi)] = 0;
+    parent_[static_cast<size_t>(srcLi)] = -1;
+
+    // 4 direzioni a costo unitario: BFS, niente heap
+    if (!eight_ && !weighted_) {
+        queue_.clear();
+        queue_.push_back(srcLi);
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            const int li = queue_[head];
+            if (li == targetLi) return;
+            const Cell cur = cellOf(li);
+            const int idx = grid_->index(cur);
+            for (unsigned mask = moves(idx); mask != 0; mask &= mask - 1) {
+                const int d = std::countr_zero(mask);
+                const Cell nb{cur.x + kDirDx[d], cur.y + kDirDy[d]};
+                if (!inside(nb)) continue;
+                const auto nli = static_cast<size_t>(localIndex(k, nb));
+                if (stamp_[nli] == gen_) continue;
+                stamp_[nli] = gen_;
+                dist_[nli] = dist_[static_cast<size_t>(li)] + kCostStraight;
+                parent_[nli] = li;
+                queue_.push_back(static_cast<int>(nli));
+            }
+        }
+        return;
+    }
+
+    heap_.clear();
+    heap_.push_back({h(source), 0, srcLi});
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), MinF{});
+        const LocalEntry e = heap_.back();
+        heap_.pop_back();
+        if (e.g != dist_[static_cast<size_t>(e.li)]) continue; // stale
+        if (e.li == targetLi) return;
+
+        const Cell cur = cellOf(e.li);
+        const int idx = grid_->index(cur);
+        for (unsigned mask = moves(idx); mask != 0; mask &= mask - 1) {
+            const int d = std::countr_zero(mask);
+            const Cell nb{cur.x + kDirDx[d], cur.y + kDirDy[d]};
+            if (!inside(nb)) continue;
+            const int base = d >= kDownRight ? kCostDiagonal : kCostStraight;
+            const int g = e.g + stepCost(base, idx, idx + grid_->offset(d), reverse);
+            const auto nli = static_cast<size_t>(localIndex(k, nb));
+            if (stamp_[nli] == gen_ && dist_[nli] <= g) continue;
+            stamp_[nli] = gen_;
+            dist_[nli] = g;
+            parent_[nli] = e.li;
+            heap_.push_back({g + h(nb), g, static_cast<int>(nli)});
+            std::push_heap(heap_.begin(), heap_.end(), MinF{});
+        }
+    }
+}
+
+const std::vector<Cell>& HierarchicalPathfinder::findAbstractPath(Cell start, Cell goal) {
+    update();
+    waypoints_.clear();
+    result_.clear();
+    if (!grid_->isWalkable(start) || !grid_->isWalkable(goal)) return waypoints_;
+
+    if (start == goal) {
+        waypoints_.push_back(start);
+        result_.success = true;
+        return waypoints_;
+    }
+
+    const int sk = clusterOf(start), gk = clusterOf(goal);
+    const Cluster& sc = clusters_[static_cast<size_t>(sk)];
+    const Cluster& gc = clusters_[static_cast<size_t>(gk)];
+
+    // start/goal collegati ai nodi del proprio cluster (verso il goal: ricerca all'indietro)
+    localSearch(sc, start, Cell{-1, -1}, false);
+    startCost_.resize(sc.nodes.size());
+    for (size_t i = 0; i < sc.nodes.size(); ++i)
+        startCost_[i] = localDist(localIndex(sc, nodes_[static_cast<size_t>(sc.nodes[i])].cell));
+    const int direct = sk == gk ? localDist(localIndex(sc, goal)) : kInf;
+
+    localSearch(gc, goal, Cell{-1, -1}, true);
+    goalCost_.resize(gc.nodes.size());
+    for (size_t i = 0; i < gc.nodes.size(); ++i)
+        goalCost_[i] = localDist(localIndex(gc, nodes_[static_cast<size_t>(gc.nodes[i])].cell));
+
+    // A* sul grafo astratto; id S e T = start/goal temporanei
+    const int S = static_cast<int>(nodes_.size()), T = S + 1;
+    const auto total = nodes_.size() + 2;
+    if (absStamp_.size() < total) {
+        absStamp_.resize(total, 0);
+        absG_.resize(total);
+        absParent_.resize(total);
+    }
+    if (++absGen_ == 0) {
+        std::fill(absStamp_.begin(), absStamp_.end(), 0u);
+        absGen_ = 1;
+    }
+
+    auto cellOfNode = [&](int id) { return id == S ? start : id == T ? goal : nodes_[static_cast<size_t>(id)].cell; };
+    auto h = [&](int id) { return eight_ ? octileCost(cellOfNode(id), goal) : manhattanCost(cellOfNode(id), goal); };
+
+    absOpen_.clear();
+    auto relax = [&](int from, int to, int g) {
+        const auto t = static_cast<size_t>(to);
+        if (absStamp_[t] == absGen_ && absG_[t] <= g) return;
+        absStamp_[t] = absGen_;
+        absG_[t] = g;
+        absParent_[t] = from;
+        absOpen_.push_back({g + h(to), g, to});
+        std::push_heap(absOpen_.begin(), absOpen_.end(), MinF{});
+    };
+
+    absStamp_[static_cast<size_t>(S)] = absGen_;
+    absG_[static_cast<size_t>(S)] = 0;
+    absParent_[static_cast<size_t>(S)] = -1;
+    absOpen_.push_back({h(S), 0, S});
+
+    while (!absOpen_.empty()) {
+        std::pop_heap(absOpen_.begin(), absOpen_.end(), MinF{});
+        const AbsEntry e = absOpen_.back();
+        absOpen_.pop_back();
+        if (e.g != absG_[static_cast<size_t>(e.id)]) continue; // stale
+
+        if (e.id == T) {
+            for (int id = T; id != -1; id = absParent_[static_cast<size_t>(id)]) waypoints_.push_back(cellOfNode(id));
+            std::reverse(waypoints_.begin(), waypoints_.end());
+            result_.success = true;
+            result_.cost = e.g;
+            return waypoints_;
+        }
+        result_.closed.push_back(cellOfNode(e.id));
+        ++result_.expanded;
+
+        if (e.id == S) {
+            for (size_t i = 0; i < sc.nodes.size(); ++i)
+                if (startCost_[i] < kInf) relax(S, sc.nodes[i], startCost_[i]);
+            if (direct < kInf) relax(S, T, direct);
+            continue;
+        }
+
+        const Node& n = nodes_[static_cast<size_t>(e.id)];
+        const Cluster& cl = clusters_[static_cast<size_t>(n.cluster)];
+        const size_t count = cl.nodes.size();
+        const int* row = cl.dist.data() + static_cast<size_t>(n.local) * count;
+        for (size_t j = 0; j < count; ++j)
+            if (row[j] < kInf && cl.nodes[j] != e.id) relax(e.id, cl.nodes[j], e.g + row[j]);
+        relax(e.id, n.partner, e.g + n.partnerCost);
+        if (n.cluster == gk && goalCost_[static_cast<size_t>(n.local)] < kInf)
+            relax(e.id, T, e.g + goalCost_[static_cast<size_t>(n.local)]);
+    }
+
+    return waypoints_; // nessun percorso
+}
+
+bool HierarchicalPathfinder::refineSegment(Cell a, Cell b, std::vector<Cell>& out) {
+    if (a == b) return true;
+    const int k = clusterOf(a);
+    if (k != clusterOf(b)) {
+        // arco tra due entrate affacciate: celle adiacenti
+        out.push_back(b);
+        return true;
+    }
+
+    const Cluster& cl = clusters_[static_cast<size_t>(k)];
+    localSearch(cl, a, b, false);
+    const int target = localIndex(cl, b);
+    if (localDist(target) == kInf) return false;
+
+    const size_t first = out.size();
+    for (int li = target; li != localIndex(cl, a); li = parent_[static_cast<size_t>(li)])
+        out.push_back(Cell{cl.x0 + li % cl.w, cl.y0 + li / cl.w});
+    std::reverse(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+    return true;
+}
+
+const AStarResult& HierarchicalPathfinder::findPath(Cell start, Cell goal) {
+    findAbstractPath(start, goal);
+    if (waypoints_.empty()) return result_;
+
+    result_.path.push_back(waypoints_.front());
+    for (size_t i = 0; i + 1 < waypoints_.size(); ++i) {
+        if (!refineSegment(waypoints_[i], waypoints_[i + 1], result_.path)) {
+            // non dovrebbe succedere: la cache del cluster era aggiornata
+            result_.path.clear();
+            result_.success = false;
+            break;
+        }
+    }
+    result_.pathLength = result_.path.size();
+    return result_;
+}
@@ -0,0 +1,86 @@
+#include "taikutsu/core/Histogram.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    void add(std::uint64_t& c, std::uint64_t v) { c += v; }
+    void add(std::atomic<std::uint64_t>& c, std::uint64_t v) { c.fetch_add(v, std::memory_order_relaxed); }
+
+    void lower(std::uint64_t& c, std::uint64_t v) { c = std::min(c, v); }
+    void lower(std::atomic<std::uint64_t>& c, std::uint64_t v) {
+        std::uint64_t prev = c.load(std::memory_order_relaxed);
+        while (v < prev && !c.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {}
+    }
+
+    void raise(std::uint64_t& c, std::uint64_t v) { c = std::max(c, v); }
+    void raise(std::atomic<std::uint64_t>& c, std::uint64_t v) {
+        std::uint64_t prev = c.load(std::memory_order_relaxed);
+        while (prev < v && !c.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {}
+    }
+
+    void store(std::uint64_t& c, std::uint64_t v) { c = v; }
+    void store(std::atomic<std::uint64_t>& c, std::uint64_t v) { c.store(v, std::memory_order_relaxed); }
+}
+
+template <class Counter>
+int BasicHistogram<Counter>::bucketOf(std::uint64_t value) {
+    if (value < (1u << kSubBits)) return static_cast<int>(value); // primi bucket esatti
+    const int e = std::bit_width(value) - 1;                       // e >= kSubBits
+    const auto sub = static_cast<int>((value >> (e - kSubBits)) & ((1u << kSubBits) - 1));
+    return ((e - kSubBits + 1) << kSubBits) + sub;
+}
+
+template <class Counter>
+std::uint64_t BasicHistogram<Counter>::lowerBound(int b) {
+    if (b < (1 << kSubBits)) return static_cast<std::uint64_t>(b);
+    const int e = (b >> kSubBits) + kSubBits - 1;
+    const auto sub = static_cast<std::uint64_t>(b & ((1 << kSubBits) - 1));
+    return ((std::uint64_t{1} << kSubBits) + sub) << (e - kSubBits);
+}
+
+template <class Counter>
+std::uint64_t BasicHistogram<Counter>::upperBound(int b) {
+    if (b < (1 << kSubBits)) return static_cast<std::uint64_t>(b);
+    const int e = (b >> kSubBits) + kSubBits - 1;
+    return lowerBound(b) + ((std::uint64_t{1} << (e - kSubBits)) - 1);
+}
+
+template <class Counter>
+void BasicHistogram<Counter>::record(std::uint64_t value) {
+    add(buckets_[static_cast<size_t>(bucketOf(value))], 1);
+    add(count_, 1);
+    add(sum_, value);
+    lower(min_, value);
+    raise(max_, value);
+}
+
+template <class Counter>
+void BasicHistogram<Counter>::reset() {
+    for (Counter& b : buckets_) store(b, 0);
+    store(count_, 0);
+    store(sum_, 0);
+    store(min_, UINT64_MAX);
+    store(max_, 0);
+}
+
+template <class Counter>
+double BasicHistogram<Counter>::mean() const {
+    const std::uint64_t n = count();
+    return n ? static_cast<double>(sum()) / static_cast<double>(n) : 0.0;
+}
+
+template <class Counter>
+std::uint64_t BasicHistogram<Counter>::percentile(double p) const {
+    const std::uint64_t total = count();
+    if (total == 0) return 0;
+    const auto rank = static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += bucketCount(b);
+        if (seen >= rank) return std::min(upperBound(b), max());
+    }
+    return max();
+}
+
+template class BasicHistogram<std::uint64_t>;
+template class BasicHistogram<std::atomic<std::uint64_t>>;
@@ -0,0 +1,277 @@
+#include "taikutsu/core/JumpPoint.h"
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/BitOps.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace {
+
+    int sign(int v) { return (v > 0) - (v < 0); }
+
+    // min-heap per f (come in AStar.cpp)
+    struct PQCmp {
+        template <class Entry>
+        bool operator()(const Entry& a, const Entry& b) const { return a.f > b.f; }
+    };
+
+    // riga paddata r del grid (r = y + 1)
+    const std::uint64_t* row(const GridMap& g, int r) {
+        return g.words() + static_cast<size_t>(r) * static_cast<size_t>(g.wordsPerRow());
+    }
+
+    // Salto orizzontale da (x,y) in direzione dx (+1/-1).
+    // Ritorna la x del jump point (goal o cella con vicino forzato), -1 se si arriva su un ostacolo.
+    // Vicino forzato sopra la cella x' (verso destra): sopra(x') libero && sopra(x'-1) bloccato; idem sotto.
+    // Ogni iterazione controlla fino a 64 celle: stop = ostacoli | forzati | goal, poi ctz/clz.
+    int jumpHorizontal(const GridMap& g, int x, int y, int dx, Cell goal) {
+        const std::uint64_t* R = row(g, y + 1);
+        const std::uint64_t* U = row(g, y);
+        const std::uint64_t* D = row(g, y + 2);
+        const int rowBits = g.stride();
+        const int goalBit = (goal.y == y) ? goal.x + 1 : -1;
+
+        if (dx > 0) {
+            // finestra [q, q + n) in posizioni paddate
+            for (int q = x + 2; q < rowBits;) {
+                const int n = std::min(64, rowBits - q);
+                const std::uint64_t r = loadBits(R, q, n);
+                const std::uint64_t u = loadBits(U, q, n) & ~loadBits(U, q - 1, n);
+                const std::uint64_t d = loadBits(D, q, n) & ~loadBits(D, q - 1, n);
+                std::uint64_t stop = (~r & lowMask(n)) | u | d;
+                if (goalBit >= q && goalBit < q + n) stop |= std::uint64_t{1} << (goalBit - q);
+
+                if (stop != 0) {
+                    const int i = std::countr_zero(stop);
+                    return ((r >> i) & 1u) ? q + i - 1 : -1;
+                }
+                q += n;
+            }
+            return -1;
+        }
+
+        // verso sinistra: finestra [s, q], cerchiamo il bit più alto
+        // (la colonna sentinella in posizione 0 è sempre bloccata, quindi il loop termina)
+        for (int q = x; q >= 0;) {
+            const int n = std::min(64, q + 1);
+            const int s = q - n + 1;
+            const std::uint64_t r = loadBits(R, s, n);
+            const std::uint64_t u = loadBits(U, s, n) & ~loadBits(U, s + 1, n);
+            const std::uint64_t d = loadBits(D, s, n) & ~loadBits(D, s + 1, n);
+            std::uint64_t stop = (~r & lowMask(n)) | u | d;
+            if (goalBit >= s && goalBit <= q) stop |= std::uint64_t{1} << (goalBit - s);
+
+            if (stop != 0) {
+                const int i = 63 - std::countl_zero(stop);
+                return ((r >> i) & 1u) ? s + i - 1 : -1;
+            }
+            q = s - 1;
+        }
+        return -1;
+    }
+
+    bool walk(const GridMap& g, int x, int y) { return g.walkable(g.index(Cell{x, y})); }
+
+    // Salto verticale (4 direzioni) da (x,y) in direzione dy: si ferma sul goal o sulla prima riga
+    // dalla quale una scansione orizzontale trova un jump point. false se incontra un ostacolo.
+    bool jumpVertical4(const GridMap& g, int x, int y, int dy, Cell goal, int& outY) {
+        for (;;) {
+            y += dy;
+            if (!walk(g, x, y)) return false; // righe sentinella fermano il salto
+            if (x == goal.x && y == goal.y) break;
+            if (jumpHorizontal(g, x, y, +1, goal) >= 0 || jumpHorizontal(g, x, y, -1, goal) >= 0) break;
+        }
+        outY = y;
+        return true;
+    }
+
+    // Salto verticale (8 direzioni): vicino forzato a sinistra/destra se libero ma bloccato dietro.
+    bool jumpVertical8(const GridMap& g, int x, int y, int dy, Cell goal, int& outY) {
+        for (;;) {
+            y += dy;
+            if (!walk(g, x, y)) return false;
+            if (x == goal.x && y == goal.y) break;
+            if ((walk(g, x - 1, y) && !walk(g, x - 1, y - dy)) || (walk(g, x + 1, y) && !walk(g, x + 1, y - dy))) break;
+        }
+        outY = y;
+        return true;
+    }
+
+    // Salto diagonale (senza corner-cutting: entrambe le ortogonali devono essere libere a ogni passo).
+    // Si ferma sul goal o dove uno dei due salti rettilinei trova un jump point.
+    bool jumpDiagonal(const GridMap& g, int x, int y, int dx, int dy, Cell goal, Cell& out) {
+        for (;;) {
+            if (!walk(g, x + dx, y) || !walk(g, x, y + dy) || !walk(g, x + dx, y + dy)) return false;
+            x += dx;
+            y += dy;
+            if (x == goal.x && y == goal.y) break;
+            int unused = 0;
+            if (jumpHorizontal(g, x, y, dx, goal) >= 0 || jumpVertical8(g, x, y, dy, goal, unused)) break;
+        }
+        out = Cell{x, y};
+        return true;
+    }
+}
+
+
+AStarResult JumpPointPathfinder::findPath(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    AStarSearchContext ctx;
+    return findPath(ctx, grid, start, goal, opts);
+}
+
+const AStarResult& JumpPointPathfinder::findPath(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                                 const SearchOptions& opts) {
+    // JPS richiede costo uniforme e le regole senza corner-cutting: altrimenti A* classico
+    if ((opts.useTerrainCost && grid.hasCosts()) || (opts.connectivity == Connectivity::Eight && opts.cornerCutting)) {
+        return AStarPathfinder::findPath(ctx, grid, start, goal, opts);
+    }
+    if (opts.components && !opts.components->connected(start, goal)) {
+        ctx.resize(grid);
+        ctx.beginQuery();
+        if (opts.output.buffer != nullptr) opts.output.buffer->clear();
+        return ctx.result_;
+    }
+    if (opts.connectivity == Connectivity::Eight) return search<true>(ctx, grid, start, goal, opts);
+    return search<false>(ctx, grid, start, goal, opts);
+}
+
+template <bool Eight>
+const AStarResult& JumpPointPathfinder::search(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal,
+                                               const SearchOptions& opts) {
+    ctx.resize(grid);
+    ctx.beginQuery();
+    AStarResult& result = ctx.result_;
+    if (opts.output.buffer != nullptr) opts.output.buffer->clear();
+
+    // costo di un salto in linea retta/diagonale = euristica esatta tra i due estremi
+    auto dist = [](Cell a, Cell b) { return Eight ? octileCost(a, b) : manhattanCost(a, b); };
+
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return result;
+
+    if (start == goal) {
+        result.success = true;
+        ctx.touch(grid.index(start));
+        ctx.writePath(grid, grid.index(start), opts.output);
+        return result;
+    }
+
+    auto& open = ctx.open_.heap;
+    const int startIdx = grid.index(start);
+    const int goalIdx = grid.index(goal);
+
+    ctx.touch(startIdx).state = AStarSearchContext::kOpen;
+    open.push_back({startIdx, dist(start, goal), 0});
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), PQCmp{});
+        const AStarSearchContext::OpenEntry current = open.back();
+        open.pop_back();
+
+        auto& node = ctx.nodes_[static_cast<size_t>(current.idx)];
+        if (node.state == AStarSearchContext::kClosed || current.g != node.g) continue; // stale
+
+        node.state = AStarSearchContext::kClosed;
+        const Cell cur = grid.cellAt(current.idx);
+        ++result.expanded;
+        // pochi jump point per query: un branch per espansione invece di un'istanza per recorder
+        if (opts.recordClosed == ClosedRecording::List) RecordClosed{}.onExpand(result, cur, current.idx);
+        else if (opts.recordClosed == ClosedRecording::Bitmap) RecordClosedBitmap{}.onExpand(result, cur, current.idx);
+
+        if (current.idx == goalIdx) {
+            result.success = true;
+            result.cost = current.g;
+            // jump point consecutivi sono allineati: writePath riempie le celle intermedie
+            ctx.writePath(grid, goalIdx, opts.output);
+            return result;
+        }
+
+        // rilassa il successore (jump point) sulla stessa riga/colonna/diagonale
+        auto relax = [&](Cell nb) {
+            const int nbIdx = grid.index(nb);
+            auto& rec = ctx.touch(nbIdx);
+            if (rec.state == AStarSearchContext::kClosed) return;
+
+            const int tentativeG = current.g + dist(cur, nb);
+            if (rec.state == AStarSearchContext::kNew || tentativeG < rec.g) {
+                rec.parent = current.idx;
+                rec.g = tentativeG;
+                rec.state = AStarSearchContext::kOpen;
+                open.push_back({nbIdx, tentativeG + dist(nb, goal), tentativeG});
+                std::push_heap(open.begin(), open.end(), PQCmp{});
+            }
+        };
+        // salta da cur in direzione (dx,dy) e rilassa il jump point trovato
+        auto jump = [&](int dx, int dy) {
+            if (dy == 0) {
+                const int jx = jumpHorizontal(grid, cur.x, cur.y, dx, goal);
+                if (jx >= 0) relax(Cell{jx, cur.y});
+            } else if (dx == 0) {
+                int jy = 0;
+                const bool found = Eight ? jumpVertical8(grid, cur.x, cur.y, dy, goal, jy)
+                                         : jumpVertical4(grid, cur.x, cur.y, dy, goal, jy);
+                if (found) relax(Cell{cur.x, jy});
+            } else {
+                Cell j{};
+                if (jumpDiagonal(grid, cur.x, cur.y, dx, dy, goal, j)) relax(j);
+            }
+        };
+
+        // vicini "potati": dipendono dalla direzione con cui siamo arrivati
+        if (node.parent == -1) {
+            for (int d = 0; d < (Eight ? 8 : 4); ++d) jump(kDirDx[d], kDirDy[d]);
+            continue;
+        }
+
+        const Cell p = grid.cellAt(node.parent);
+        const int dx = sign(cur.x - p.x);
+        const int dy = sign(cur.y - p.y);
+
+        if constexpr (!Eight) {
+            if (dx != 0) {
+                // arrivati in orizzontale: si prosegue, più i vicini forzati sopra/sotto
+                jump(dx, 0);
+                if (walk(grid, cur.x, cur.y - 1) && !walk(grid, cur.x - dx, cur.y - 1)) jump(0, -1);
+                if (walk(grid, cur.x, cur.y + 1) && !walk(grid, cur.x - dx, cur.y + 1)) jump(0, +1);
+            } else {
+                // arrivati in verticale: si prosegue e si aprono le due direzioni orizzontali
+                jump(0, dy);
+                jump(+1, 0);
+                jump(-1, 0);
+            }
+        } else if (dx != 0 && dy != 0) {
+            // diagonale: le due componenti rettilinee e la diagonale stessa
+            const bool walkX = walk(grid, cur.x + dx, cur.y);
+            const bool walkY = walk(grid, cur.x, cur.y + dy);
+            if (walkY) jump(0, dy);
+            if (walkX) jump(dx, 0);
+            if (walkX && walkY) jump(dx, dy);
+        } else if (dx != 0) {
+            // orizzontale: avanti, diagonali in avanti e le due verticali (eventualmente forzate)
+            const bool next = walk(grid, cur.x + dx, cur.y);
+            const bool down = walk(grid, cur.x, cur.y + 1);
+            const bool up = walk(grid, cur.x, cur.y - 1);
+            if (next) {
+                jump(dx, 0);
+                if (down) jump(dx, +1);
+                if (up) jump(dx, -1);
+            }
+            if (down) jump(0, +1);
+            if (up) jump(0, -1);
+        } else {
+            // verticale: simmetrico
+            const bool next = walk(grid, cur.x, cur.y + dy);
+            const bool right = walk(grid, cur.x + 1, cur.y);
+            const bool left = walk(grid, cur.x - 1, cur.y);
+            if (next) {
+                jump(0, dy);
+                if (right) jump(+1, dy);
+                if (left) jump(-1, dy);
+            }
+            if (right) jump(+1, 0);
+            if (left) jump(-1, 0);
+        }
+    }
+
+    return result;
+}
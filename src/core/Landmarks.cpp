@@ -0,0 +1,141 @@
+#include "taikutsu/core/Landmarks.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/FlowField.h"
+#include "taikutsu/core/ThreadPool.h"
+
+namespace {
+    SearchOptions fieldOptions(Connectivity connectivity, bool cornerCutting, bool useTerrainCost) {
+        SearchOptions opts;
+        opts.connectivity = connectivity;
+        opts.cornerCutting = cornerCutting;
+        opts.useTerrainCost = useTerrainCost;
+        return opts;
+    }
+}
+
+void LandmarkTable::build(const GridMap& grid, const LandmarkOptions& opts) {
+    w_ = grid.width();
+    h_ = grid.height();
+    selectFarthest(grid, std::clamp(opts.count, 1, kMaxLandmarks));
+    buildTables(grid, opts);
+}
+
+void LandmarkTable::build(const GridMap& grid, std::span<const Cell> landmarks, const LandmarkOptions& opts) {
+    w_ = grid.width();
+    h_ = grid.height();
+    landmarks_.clear();
+    for (const Cell& c : landmarks) {
+        if (static_cast<int>(landmarks_.size()) == kMaxLandmarks) break;
+        if (grid.isWalkable(c)) landmarks_.push_back(c);
+    }
+    buildTables(grid, opts);
+}
+
+// farthest-point con le distanze a 4 direzioni (onde bit-parallele di FlowField)
+void LandmarkTable::selectFarthest(const GridMap& grid, int count) {
+    landmarks_.clear();
+
+    // seed: prima cella della componente più grande
+    std::vector<std::uint32_t> labels, sizes;
+    ConnectivityIndex(grid).exportCompact(labels, sizes);
+    if (sizes.size() < 2) return; // nessuna cella libera
+    const auto largest = static_cast<std::uint32_t>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+    const auto first = static_cast<size_t>(std::find(labels.begin(), labels.end(), largest) - labels.begin());
+    Cell from{static_cast<int>(first % static_cast<size_t>(w_)), static_cast<int>(first / static_cast<size_t>(w_))};
+
+    // minDist[c] = distanza dal landmark più vicino (all'inizio: dal seed, che non è un landmark)
+    FlowField field;
+    const SearchOptions bfs = fieldOptions(Connectivity::Four, false, false);
+    field.build(grid, std::span<const Cell>(&from, 1), bfs);
+    std::vector<std::uint32_t> minDist(field.distances().begin(), field.distances().end());
+
+    for (int k = 0; k < count; ++k) {
+        // irraggiungibile (altre componenti) = kUnreachable: escluso dal massimo
+        size_t best = SIZE_MAX;
+        std::uint32_t bestDist = 0;
+        for (size_t i = 0; i < minDist.size(); ++i) {
+            if (minDist[i] != FlowField::kUnreachable && (best == SIZE_MAX || minDist[i] > bestDist)) {
+                best = i;
+                bestDist = minDist[i];
+            }
+        }
+        if (best == SIZE_MAX || (k > 0 && bestDist == 0)) break; // componente tutta coperta
+        from = Cell{static_cast<int>(best % static_cast<size_t>(w_)), static_cast<int>(best / static_cast<size_t>(w_))};
+        landmarks_.push_back(from);
+        if (k + 1 == count) break;
+        field.build(grid, std::span<const Cell>(&from, 1), bfs);
+        const std::span<const std::uint32_t> d = field.distances();
+        if (k == 0) minDist.assign(d.begin(), d.end()); // il seed non conta più
+        else for (size_t i = 0; i < minDist.size(); ++i) minDist[i] = std::min(minDist[i], d[i]);
+    }
+}
+
+void LandmarkTable::buildTables(const GridMap& grid, const LandmarkOptions& opts) {
+    k_ = static_cast<int>(landmarks_.size());
+    eight_ = opts.connectivity == Connectivity::Eight;
+    cornerCutting_ = eight_ && opts.cornerCutting;
+    weighted_ = opts.useTerrainCost && grid.hasCosts();
+    symmetric_ = !weighted_;
+    unit_ = eight_ ? 1 : kCostStraight; // 4 direzioni: ogni passo costa un multiplo di kCostStraight
+    epoch_ = grid.epoch();
+    version_ = grid.version();
+
+    // una colonna per landmark (ognuna scritta da un solo task), poi la trasposizione per cella
+    const size_t cells = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    std::vector<std::vector<std::uint32_t>> columns(landmarks_.size());
+    const SearchOptions rules = fieldOptions(opts.connectivity, cornerCutting_, opts.useTerrainCost);
+    auto fill = [&](size_t k) {
+        FlowField field;
+        field.build(grid, std::span<const Cell>(&landmarks_[k], 1), rules);
+        columns[k].assign(field.distances().begin(), field.distances().end());
+    };
+    if (opts.pool != nullptr && landmarks_.size() > 1) {
+        for (size_t k = 0; k < landmarks_.size(); ++k) opts.pool->submit([&fill, k](unsigned) { fill(k); });
+        opts.pool->wait();
+    } else {
+        for (size_t k = 0; k < landmarks_.size(); ++k) fill(k);
+    }
+
+    std::uint32_t maxStored = 0;
+    for (const auto& col : columns)
+        for (const std::uint32_t d : col)
+            if (d != FlowField::kUnreachable) maxStored = std::max(maxStored, d / static_cast<std::uint32_t>(unit_));
+    wide_ = maxStored >= 0xFFFFu;
+
+    const auto K = static_cast<size_t>(k_);
+    auto transpose = [&](auto& table, auto none) {
+        table.assign(cells * K, none);
+        for (size_t k = 0; k < K; ++k) {
+            const std::vector<std::uint32_t>& col = columns[k];
+            for (size_t c = 0; c < cells; ++c)
+                if (col[c] != FlowField::kUnreachable)
+                    table[c * K + k] = static_cast<decltype(none)>(col[c] / static_cast<std::uint32_t>(unit_));
+        }
+    };
+    if (wide_) {
+        std::vector<std::uint16_t>().swap(d16_);
+        transpose(d32_, kUnreachable);
+    } else {
+        std::vector<std::uint32_t>().swap(d32_);
+        transpose(d16_, std::uint16_t{0xFFFF});
+    }
+}
+
+std::uint32_t LandmarkTable::distance(int k, Cell c) const {
+    const size_t r = row(c);
+    if (r == SIZE_MAX || k < 0 || k >= k_) return kUnreachable;
+    const size_t i = r + static_cast<size_t>(k);
+    if (wide_) return d32_[i] == kUnreachable ? kUnreachable : d32_[i] * static_cast<std::uint32_t>(unit_);
+    return d16_[i] == 0xFFFFu ? kUnreachable : d16_[i] * static_cast<std::uint32_t>(unit_);
+}
+
+bool LandmarkTable::usableFor(const GridMap& grid, const SearchOptions& opts) const {
+    if (k_ == 0 || grid.epoch() != epoch_ || grid.version() != version_) return false;
+    if (grid.width() != w_ || grid.height() != h_) return false;
+    // mosse della query contenute in quelle delle tabelle (una mossa in più = distanze più corte)
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    if (eight && (!eight_ || (opts.cornerCutting && !cornerCutting_))) return false;
+    // tabelle con il terreno: la query deve pagarlo anche lei
+    const bool weighted = opts.useTerrainCost && grid.hasCosts();
+    return !weighted_ || weighted;
+}
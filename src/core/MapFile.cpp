@@ -0,0 +1,290 @@
+#include "taikutsu/core/MapFile.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TAIKUTSU_HAVE_MMAP 1
+#endif
+
+namespace {
+    constexpr char kMagic[8] = {'T', 'K', 'G', 'R', 'I', 'D', 'M', 'P'};
+
+    // header su disco (vedi MapFile.h), scritto/letto byte per byte così com'è in memoria
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerBytes;
+        std::int32_t width, height;
+        std::uint32_t wordsPerRow;
+        std::uint32_t flags;
+        std::uint64_t bitsOffset;
+        std::uint64_t costOffset;
+        std::uint64_t componentsOffset;
+        std::uint64_t fileBytes;
+    };
+    static_assert(sizeof(Header) == 64);
+
+    std::uint64_t align64(std::uint64_t v) { return (v + 63) & ~std::uint64_t{63}; }
+
+    void fail(std::string* error, const std::string& what) {
+        if (error != nullptr) *error = what;
+    }
+
+    void pad(std::ostream& out, std::uint64_t& at, std::uint64_t to) {
+        static const char zeros[64] = {};
+        out.write(zeros, static_cast<std::streamsize>(to - at));
+        at = to;
+    }
+
+    // cornice sentinella chiusa: righe 0 e h+1 a zero, colonna 0 e bit oltre width a zero
+    bool sentinelsClosed(const std::uint64_t* words, int w, int h, int wordsPerRow) {
+        const auto wpr = static_cast<size_t>(wordsPerRow);
+        for (size_t i = 0; i < wpr; ++i)
+            if (words[i] != 0 || words[static_cast<size_t>(h + 1) * wpr + i] != 0) return false;
+        const int first = w + 1; // primo bit di padding a destra
+        for (int r = 1; r <= h; ++r) {
+            const std::uint64_t* row = words + static_cast<size_t>(r) * wpr;
+            if (row[0] & 1u) return false;
+            if (row[first >> 6] >> (first & 63)) return false;
+            for (size_t i = static_cast<size_t>(first >> 6) + 1; i < wpr; ++i)
+                if (row[i] != 0) return false;
+        }
+        return true;
+    }
+}
+
+// ---------------- scrittura ----------------
+
+bool saveMapFile(std::ostream& out, const GridMap& grid, const MapFileOptions& opts) {
+    if constexpr (std::endian::native != std::endian::little) return false;
+
+    std::vector<std::uint32_t> labels, sizes;
+    if (opts.components) ConnectivityIndex(grid).exportCompact(labels, sizes);
+    const bool costs = opts.costs && grid.hasCosts();
+
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kMapFileVersion;
+    h.headerBytes = sizeof(Header);
+    h.width = grid.width();
+    h.height = grid.height();
+    h.wordsPerRow = static_cast<std::uint32_t>(grid.wordsPerRow());
+    h.bitsOffset = align64(sizeof(Header));
+    std::uint64_t end = h.bitsOffset + grid.wordCount() * sizeof(std::uint64_t);
+    if (costs) {
+        h.flags |= kMapFileCosts;
+        h.costOffset = align64(end);
+        end = h.costOffset + grid.indexCount();
+    }
+    if (opts.components) {
+        h.flags |= kMapFileComponents;
+        h.componentsOffset = align64(end);
+        end = h.componentsOffset + 2 * sizeof(std::uint32_t) + (labels.size() + sizes.size()) * sizeof(std::uint32_t);
+    }
+    h.fileBytes = end;
+
+    std::uint64_t at = 0;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    at += sizeof(h);
+    pad(out, at, h.bitsOffset);
+    out.write(reinterpret_cast<const char*>(grid.words()),
+              static_cast<std::streamsize>(grid.wordCount() * sizeof(std::uint64_t)));
+    at += grid.wordCount() * sizeof(std::uint64_t);
+    if (costs) {
+        pad(out, at, h.costOffset);
+        out.write(reinterpret_cast<const char*>(grid.costs()), static_cast<std::streamsize>(grid.indexCount()));
+        at += grid.indexCount();
+    }
+    if (opts.components) {
+        pad(out, at, h.componentsOffset);
+        const std::uint32_t count[2] = {static_cast<std::uint32_t>(sizes.size() - 1), 0};
+        out.write(reinterpret_cast<const char*>(count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(labels.data()),
+                  static_cast<std::streamsize>(labels.size() * sizeof(std::uint32_t)));
+        out.write(reinterpret_cast<const char*>(sizes.data()),
+                  static_cast<std::streamsize>(sizes.size() * sizeof(std::uint32_t)));
+    }
+    return static_cast<bool>(out);
+}
+
+bool saveMapFile(const std::string& path, const GridMap& grid, const MapFileOptions& opts, std::string* error) {
+    if constexpr (std::endian::native != std::endian::little) {
+        fail(error, "big-endian hosts are not supported");
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        fail(error, "cannot create " + path);
+        return false;
+    }
+    if (!saveMapFile(out, grid, opts)) {
+        fail(error, "write error on " + path);
+        return false;
+    }
+    return true;
+}
+
+std::optional<GridMap> loadMapFile(const std::string& path, std::string* error) {
+    const auto view = GridMapView::open(path, error);
+    if (!view) return std::nullopt;
+    return GridMap(view->grid());
+}
+
+// ---------------- GridMapView ----------------
+
+GridMapView::GridMapView(const void* data, size_t bytes, bool mapped, std::unique_ptr<std::uint64_t[]> buffer,
+                         int width, int height, const std::uint64_t* words, const std::uint8_t* costs)
+    : data_(data), bytes_(bytes), mapped_(mapped), buffer_(std::move(buffer)), grid_(width, height, words, costs) {}
+
+GridMapView::~GridMapView() {
+#ifdef TAIKUTSU_HAVE_MMAP
+    if (mapped_) munmap(const_cast<void*>(data_), bytes_);
+#endif
+}
+
+std::unique_ptr<GridMapView> GridMapView::open(const std::string& path, std::string* error) {
+    if constexpr (std::endian::native != std::endian::little) {
+        fail(error, "big-endian hosts are not supported");
+        return nullptr;
+    }
+
+    // 1) il file in memoria: mmap in sola lettura, oppure una lettura unica
+    const void* data = nullptr;
+    size_t bytes = 0;
+    bool mapped = false;
+    std::unique_ptr<std::uint64_t[]> buffer;
+#ifdef TAIKUTSU_HAVE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail(error, "cannot open " + path);
+        return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        fail(error, path + ": too short for a map header");
+        return nullptr;
+    }
+    bytes = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // la mappatura resta valida
+    if (p == MAP_FAILED) {
+        fail(error, "cannot map " + path);
+        return nullptr;
+    }
+    data = p;
+    mapped = true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        fail(error, "cannot open " + path);
+        return nullptr;
+    }
+    bytes = static_cast<size_t>(in.tellg());
+    if (bytes < sizeof(Header)) {
+        fail(error, path + ": too short for a map header");
+        return nullptr;
+    }
+    buffer.reset(new std::uint64_t[(bytes + 7) / 8]);
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(bytes));
+    if (!in) {
+        fail(error, "read error on " + path);
+        return nullptr;
+    }
+    data = buffer.get();
+#endif
+    // da qui in poi ogni errore rilascia la mappatura
+    const auto* base = static_cast<const unsigned char*>(data);
+    auto reject = [&](const std::string& what) -> std::unique_ptr<GridMapView> {
+#ifdef TAIKUTSU_HAVE_MMAP
+        munmap(const_cast<void*>(data), bytes);
+#endif
+        fail(error, path + ": " + what);
+        return nullptr;
+    };
+
+    // 2) header
+    Header h{};
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) return reject("not a taikutsu map file");
+    if (h.version == 0 || h.version > kMapFileVersion)
+        return reject("unsupported format version " + std::to_string(h.version));
+    if (h.headerBytes < sizeof(Header)) return reject("bad header size");
+    if (h.fileBytes != bytes) return reject("truncated or padded file");
+    if (h.width <= 0 || h.height <= 0) return reject("bad dimensions");
+    if (!GridMap::fits(h.width, h.height)) return reject("map too large for 32-bit indices");
+    if (h.wordsPerRow != static_cast<std::uint32_t>((h.width + 2 + 63) / 64)) return reject("bad row stride");
+
+    const std::uint64_t wordCount = static_cast<std::uint64_t>(h.height + 2) * h.wordsPerRow;
+    const std::uint64_t indexCount = wordCount * 64;
+
+    auto fits = [&](std::uint64_t offset, std::uint64_t size, std::uint64_t align) {
+        return offset >= h.headerBytes && offset % align == 0 && offset <= bytes && size <= bytes - offset;
+    };
+    if (!fits(h.bitsOffset, wordCount * 8, 8)) return reject("obstacle bits out of range");
+    const auto* words = reinterpret_cast<const std::uint64_t*>(base + h.bitsOffset);
+    if (!sentinelsClosed(words, h.width, h.height, static_cast<int>(h.wordsPerRow)))
+        return reject("sentinel border is not blocked");
+
+    const std::uint8_t* costs = nullptr;
+    if (h.flags & kMapFileCosts) {
+        if (!fits(h.costOffset, indexCount, 1)) return reject("cost layer out of range");
+        costs = base + h.costOffset;
+        // GridMap::setCost non scrive mai 0: le euristiche (ammissibili) e i bucket di Dial
+        // (FlowField, PathDatabase) contano su costo >= 1 per ogni cella della mappa
+        const size_t stride = static_cast<size_t>(h.wordsPerRow) * 64;
+        for (int y = 1; y <= h.height; ++y) {
+            const std::uint8_t* row = costs + static_cast<size_t>(y) * stride + 1;
+            if (std::find(row, row + h.width, std::uint8_t{0}) != row + h.width) return reject("zero cost in cost layer");
+        }
+    }
+
+    std::uint32_t componentCount = kNoComponents;
+    const std::uint32_t* labels = nullptr;
+    if (h.flags & kMapFileComponents) {
+        const std::uint64_t cells = static_cast<std::uint64_t>(h.width) * static_cast<std::uint64_t>(h.height);
+        if (!fits(h.componentsOffset, 8, 4)) return reject("components out of range");
+        std::memcpy(&componentCount, base + h.componentsOffset, sizeof(componentCount));
+        if (componentCount == kNoComponents ||
+            !fits(h.componentsOffset, 8 + (cells + componentCount + 1) * 4, 4))
+            return reject("components out of range");
+        labels = reinterpret_cast<const std::uint32_t*>(base + h.componentsOffset + 8);
+    }
+
+    std::unique_ptr<GridMapView> view(
+        new GridMapView(data, bytes, mapped, std::move(buffer), h.width, h.height, words, costs));
+    view->version_ = h.version;
+    view->componentCount_ = componentCount;
+    view->labels_ = labels;
+    return view;
+}
+
+std::optional<ConnectivityIndex> GridMapView::components() const {
+    if (!hasComponents()) return std::nullopt;
+    const size_t cells = static_cast<size_t>(grid_.width()) * static_cast<size_t>(grid_.height());
+    const std::span<const std::uint32_t> labels(labels_, cells);
+    const std::span<const std::uint32_t> sizes(labels_ + cells, componentCount_ + size_t{1});
+    // le componenti devono descrivere proprio questi bit: un id fuori range farebbe leggere
+    // union-find fuori dagli array, un ostacolo con id o una cella libera senza id darebbero
+    // risposte sbagliate a connected(), e sizes guida l'union by size di notifyChanged
+    std::vector<std::uint32_t> counted(componentCount_ + size_t{1}, 0);
+    size_t i = 0;
+    for (int y = 0; y < grid_.height(); ++y) {
+        for (int x = 0; x < grid_.width(); ++x, ++i) {
+            const std::uint32_t l = labels[i];
+            if (l > componentCount_ || (l != 0) != grid_.isWalkable(Cell{x, y})) return std::nullopt;
+            ++counted[l];
+        }
+    }
+    counted[0] = 0;
+    if (!std::equal(counted.begin(), counted.end(), sizes.begin())) return std::nullopt;
+    return ConnectivityIndex(grid_, labels, sizes);
+}
@@ -0,0 +1,106 @@
+#include "taikutsu/core/MapGenerators.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Depth-first randomizzato su un reticolo nx x ny di "stanze": chiama link(i, j, dir)
+    // per ogni lato dell'albero ricoprente (dir 0 = verso i+1, 1 = verso j+1, dal nodo (i, j)).
+    template <class Link>
+    void spanningTree(int nx, int ny, std::mt19937& rng, Link link) {
+        std::vector<std::uint8_t> seen(static_cast<size_t>(nx) * static_cast<size_t>(ny), 0);
+        std::vector<std::pair<int, int>> stack;
+        stack.emplace_back(0, 0);
+        seen[0] = 1;
+        while (!stack.empty()) {
+            const auto [i, j] = stack.back();
+            int options[4];
+            int n = 0;
+            constexpr int dx[4] = {1, -1, 0, 0};
+            constexpr int dy[4] = {0, 0, 1, -1};
+            for (int d = 0; d < 4; ++d) {
+                const int ni = i + dx[d], nj = j + dy[d];
+                if (ni >= 0 && nj >= 0 && ni < nx && nj < ny && !seen[static_cast<size_t>(nj * nx + ni)]) options[n++] = d;
+            }
+            if (n == 0) {
+                stack.pop_back();
+                continue;
+            }
+            const int d = options[std::uniform_int_distribution<int>(0, n - 1)(rng)];
+            const int ni = i + dx[d], nj = j + dy[d];
+            // lato espresso sempre dal nodo con coordinata minore
+            if (d == 0) link(i, j, 0);
+            else if (d == 1) link(ni, nj, 0);
+            else if (d == 2) link(i, j, 1);
+            else link(ni, nj, 1);
+            seen[static_cast<size_t>(nj * nx + ni)] = 1;
+            stack.emplace_back(ni, nj);
+        }
+    }
+}
+
+GridMap makeOpenMap(int width, int height) {
+    return GridMap(width, height);
+}
+
+GridMap makeRandomMap(int width, int height, double density, unsigned seed) {
+    GridMap g(width, height);
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution blocked(density);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            if (blocked(rng)) g.setBlocked(Cell{x, y}, true);
+    return g;
+}
+
+GridMap makeMazeMap(int width, int height, int corridor, unsigned seed) {
+    GridMap g(width, height);
+    corridor = std::max(1, corridor);
+    const int pitch = corridor + 1;
+    const int nx = width >= corridor ? (width - corridor) / pitch + 1 : 0;
+    const int ny = height >= corridor ? (height - corridor) / pitch + 1 : 0;
+    g.fillRect(Cell{0, 0}, width, height, true);
+    if (nx == 0 || ny == 0) return g;
+
+    for (int j = 0; j < ny; ++j)
+        for (int i = 0; i < nx; ++i) g.fillRect(Cell{i * pitch, j * pitch}, corridor, corridor, false);
+
+    std::mt19937 rng(seed);
+    spanningTree(nx, ny, rng, [&](int i, int j, int dir) {
+        if (dir == 0) g.fillRect(Cell{i * pitch + corridor, j * pitch}, 1, corridor, false);
+        else g.fillRect(Cell{i * pitch, j * pitch + corridor}, corridor, 1, false);
+    });
+    return g;
+}
+
+GridMap makeRoomsMap(int width, int height, int roomSize, unsigned seed, double extraDoors) {
+    GridMap g(width, height);
+    roomSize = std::max(1, roomSize);
+    const int pitch = roomSize + 1;
+    const int nx = (width + pitch - 1) / pitch, ny = (height + pitch - 1) / pitch;
+    for (int i = 1; i < nx; ++i) g.fillRect(Cell{i * pitch - 1, 0}, 1, height, true);
+    for (int j = 1; j < ny; ++j) g.fillRect(Cell{0, j * pitch - 1}, width, 1, true);
+
+    std::mt19937 rng(seed);
+    const int doorWidth = std::max(1, roomSize / 8);
+    // porta in un punto a caso della parete tra (i, j) e il vicino a destra (dir 0) o sotto (dir 1)
+    auto door = [&](int i, int j, int dir) {
+        const int along = dir == 0 ? std::min(roomSize, height - j * pitch) : std::min(roomSize, width - i * pitch);
+        const int w = std::min(doorWidth, along);
+        const int at = std::uniform_int_distribution<int>(0, along - w)(rng);
+        if (dir == 0) g.fillRect(Cell{(i + 1) * pitch - 1, j * pitch + at}, 1, w, false);
+        else g.fillRect(Cell{i * pitch + at, (j + 1) * pitch - 1}, w, 1, false);
+    };
+    spanningTree(nx, ny, rng, door);
+
+    std::bernoulli_distribution extra(extraDoors);
+    for (int j = 0; j < ny; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            if (i + 1 < nx && extra(rng)) door(i, j, 0);
+            if (j + 1 < ny && extra(rng)) door(i, j, 1);
+        }
+    }
+    return g;
+}
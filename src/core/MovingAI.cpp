@@ -0,0 +1,204 @@
+#include "taikutsu/core/MovingAI.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    void fail(std::string* error, int line, const std::string& what) {
+        if (error != nullptr) *error = "line " + std::to_string(line) + ": " + what;
+    }
+
+    bool passable(char c) {
+        return c == '.' || c == 'G' || c == 'S';
+    }
+
+    bool knownTerrain(char c) {
+        return passable(c) || c == '@' || c == 'O' || c == 'T' || c == 'W';
+    }
+}
+
+std::optional<GridMap> loadMovingAIMap(std::istream& in, std::string* error) {
+    // header: coppie chiave/valore fino a "map" (l'ordine di height/width varia tra i file)
+    int w = -1, h = -1, lineNo = 0;
+    std::string line;
+    for (;;) {
+        if (!std::getline(in, line)) {
+            fail(error, lineNo, "missing 'map' line");
+            return std::nullopt;
+        }
+        ++lineNo;
+        std::istringstream ss(line);
+        std::string key;
+        if (!(ss >> key)) continue;
+        if (key == "map") break;
+        if (key == "type") continue; // sempre "octile" nei file in circolazione
+        int value = 0;
+        if (!(ss >> value) || value <= 0) {
+            fail(error, lineNo, "bad header line '" + line + "'");
+            return std::nullopt;
+        }
+        if (key == "height") h = value;
+        else if (key == "width") w = value;
+        else {
+            fail(error, lineNo, "unknown header key '" + key + "'");
+            return std::nullopt;
+        }
+    }
+    if (w <= 0 || h <= 0) {
+        fail(error, lineNo, "missing width/height");
+        return std::nullopt;
+    }
+    if (!GridMap::fits(w, h)) {
+        fail(error, lineNo, "map too large for GridMap (" + std::to_string(w) + "x" + std::to_string(h) + ")");
+        return std::nullopt;
+    }
+
+    GridMap grid(w, h);
+    for (int y = 0; y < h; ++y) {
+        if (!std::getline(in, line)) {
+            fail(error, lineNo, "expected " + std::to_string(h) + " rows, got " + std::to_string(y));
+            return std::nullopt;
+        }
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back(); // file salvati su Windows
+        if (static_cast<int>(line.size()) < w) {
+            fail(error, lineNo, "row shorter than width");
+            return std::nullopt;
+        }
+        // i run di celle bloccate vanno a fillRect (64 celle per word)
+        int x = 0;
+        while (x < w) {
+            const char c = line[static_cast<size_t>(x)];
+            if (!knownTerrain(c)) {
+                fail(error, lineNo, std::string("unknown terrain '") + c + "'");
+                return std::nullopt;
+            }
+            const bool free = passable(c);
+            int end = x + 1;
+            while (end < w && knownTerrain(line[static_cast<size_t>(end)]) &&
+                   passable(line[static_cast<size_t>(end)]) == free)
+                ++end;
+            if (!free) grid.fillRect(Cell{x, y}, end - x, 1, true);
+            x = end;
+        }
+    }
+    return grid;
+}
+
+std::optional<GridMap> loadMovingAIMap(const std::string& path, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error != nullptr) *error = "cannot open " + path;
+        return std::nullopt;
+    }
+    return loadMovingAIMap(in, error);
+}
+
+void saveMovingAIMap(std::ostream& out, const GridMap& grid) {
+    out << "type octile\nheight " << grid.height() << "\nwidth " << grid.width() << "\nmap\n";
+    std::string row(static_cast<size_t>(grid.width()), '.');
+    for (int y = 0; y < grid.height(); ++y) {
+        for (int x = 0; x < grid.width(); ++x) row[static_cast<size_t>(x)] = grid.isBlocked(Cell{x, y}) ? '@' : '.';
+        out << row << '\n';
+    }
+}
+
+std::optional<GridMap> loadAsciiMap(std::istream& in, std::string* error) {
+    std::vector<std::string> rows;
+    std::string line;
+    size_t width = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        width = std::max(width, line.size());
+        rows.push_back(std::move(line));
+    }
+    while (!rows.empty() && rows.back().empty()) rows.pop_back();
+    if (rows.empty() || width == 0) {
+        fail(error, 0, "empty map");
+        return std::nullopt;
+    }
+    if (width > static_cast<size_t>(INT_MAX) || rows.size() > static_cast<size_t>(INT_MAX) ||
+        !GridMap::fits(static_cast<int>(width), static_cast<int>(rows.size()))) {
+        fail(error, 0, "map too large for GridMap");
+        return std::nullopt;
+    }
+
+    GridMap grid(static_cast<int>(width), static_cast<int>(rows.size()));
+    for (size_t y = 0; y < rows.size(); ++y) {
+        const std::string& row = rows[y];
+        int x = 0;
+        while (x < static_cast<int>(row.size())) {
+            const char c = row[static_cast<size_t>(x)];
+            if (c >= '1' && c <= '9') {
+                grid.setCost(Cell{x, static_cast<int>(y)}, static_cast<std::uint8_t>(c - '0'));
+                ++x;
+                continue;
+            }
+            if (c != '#' && c != ' ' && !knownTerrain(c)) {
+                fail(error, static_cast<int>(y) + 1, std::string("unknown terrain '") + c + "'");
+                return std::nullopt;
+            }
+            if (c != '#' && (c == ' ' || passable(c))) {
+                ++x;
+                continue;
+            }
+            // run di celle bloccate a fillRect
+            int end = x + 1;
+            while (end < static_cast<int>(row.size())) {
+                const char e = row[static_cast<size_t>(end)];
+                if (e != '#' && e != '@' && e != 'O' && e != 'T' && e != 'W') break;
+                ++end;
+            }
+            grid.fillRect(Cell{x, static_cast<int>(y)}, end - x, 1, true);
+            x = end;
+        }
+    }
+    return grid;
+}
+
+std::optional<GridMap> loadAsciiMap(const std::string& path, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error != nullptr) *error = "cannot open " + path;
+        return std::nullopt;
+    }
+    return loadAsciiMap(in, error);
+}
+
+std::optional<std::vector<MovingAIScenario>> loadMovingAIScenarios(std::istream& in, std::string* error) {
+    std::vector<MovingAIScenario> out;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::istringstream ss(line);
+        std::string first;
+        if (!(ss >> first)) continue;
+        if (first == "version") continue; // "version 1" / "version 1.0"
+
+        MovingAIScenario s;
+        const auto [end, ec] = std::from_chars(first.data(), first.data() + first.size(), s.bucket);
+        if (ec != std::errc() || end != first.data() + first.size()) {
+            fail(error, lineNo, "bad bucket '" + first + "'");
+            return std::nullopt;
+        }
+        if (!(ss >> s.map >> s.mapWidth >> s.mapHeight >> s.start.x >> s.start.y >> s.goal.x >> s.goal.y >>
+              s.optimalLength)) {
+            fail(error, lineNo, "expected 9 fields");
+            return std::nullopt;
+        }
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+std::optional<std::vector<MovingAIScenario>> loadMovingAIScenarios(const std::string& path, std::string* error) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error != nullptr) *error = "cannot open " + path;
+        return std::nullopt;
+    }
+    return loadMovingAIScenarios(in, error);
+}
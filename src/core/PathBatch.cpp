@@ -0,0 +1,44 @@
+#include "taikutsu/core/PathBatch.h"
+#include <algorithm>
+#include <cassert>
+#include <latch>
+
+PathBatch::PathBatch(ThreadPool& pool) : pool_(pool), contexts_(pool.size()) {}
+
+void PathBatch::run(const GridMap& grid, std::span<const PathRequest> requests, std::span<AStarResult> results,
+                    const SearchOptions& batchOpts) {
+    assert(results.size() >= requests.size());
+    assert(!pool_.onWorkerThread()); // attenderebbe i propri blocchi: vedi PathBatch.h
+    SearchOptions opts = batchOpts;
+    opts.stats = nullptr; // il collettore non è thread-safe
+    opts.recordClosed = ClosedRecording::None;
+    opts.output.span = {}; // ogni query scrive direttamente in results[i].path (vedi sotto)
+    const size_t n = requests.size();
+    if (n == 0) return;
+
+    // ~8 blocchi per worker: abbastanza per rubare lavoro, pochi task da schedulare
+    const size_t chunk = std::max<size_t>(1, n / (static_cast<size_t>(pool_.size()) * 8));
+    const auto chunks = static_cast<std::ptrdiff_t>((n + chunk - 1) / chunk);
+
+    // contatore del solo batch: il pool può eseguire altro lavoro nel frattempo
+    std::latch done(chunks);
+    for (size_t begin = 0; begin < n; begin += chunk) {
+        const size_t end = std::min(n, begin + chunk);
+        pool_.submit([&, begin, end](unsigned worker) {
+            AStarSearchContext& ctx = contexts_[worker];
+            SearchOptions local = opts; // output.buffer cambia per query
+            for (size_t i = begin; i < end; ++i) {
+                AStarResult& out = results[i];
+                local.output.buffer = &out.path; // nessuna copia del percorso, capacità del chiamante
+                const AStarResult& r = AStarPathfinder::findPath(ctx, grid, requests[i].start, requests[i].goal, local);
+                out.closed.clear();
+                out.success = r.success;
+                out.cost = r.cost;
+                out.expanded = r.expanded;
+                out.pathLength = r.pathLength;
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+}
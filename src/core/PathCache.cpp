@@ -0,0 +1,192 @@
+#include "taikutsu/core/PathCache.h"
+#include "taikutsu/core/AStar.h"
+#include <algorithm>
+
+size_t PathCache::KeyHash::operator()(const Key& k) const {
+    auto mix = [](std::uint64_t h, int v) {
+        h ^= static_cast<std::uint32_t>(v) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        return h;
+    };
+    const std::uint64_t h = mix(mix(mix(mix(0, k.start.x), k.start.y), k.goal.x), k.goal.y);
+    return static_cast<size_t>(h * 0xFF51AFD7ED558CCDull >> 17);
+}
+
+PathCache::PathCache(const GridMap& grid, size_t capacity, const SearchOptions& opts)
+    : grid_(&grid), opts_(opts), capacity_(std::max<size_t>(capacity, 1)) {
+    opts_.output = {}; // i passi compatti si ricavano da celle adiacenti
+    entries_.reserve(capacity_);
+    index_.reserve(capacity_);
+    syncWithGrid();
+}
+
+void PathCache::syncWithGrid() {
+    epoch_ = grid_->epoch();
+    w_ = grid_->width();
+    h_ = grid_->height();
+}
+
+void PathCache::clear() {
+    entries_.clear();
+    free_.clear();
+    index_.clear();
+    head_ = tail_ = kNil;
+}
+
+size_t PathCache::memoryBytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry) + index_.size() * (sizeof(Key) + 2 * sizeof(void*) + 8);
+    for (const Entry& e : entries_) bytes += e.moves.capacity() + e.regions.capacity() * sizeof(std::uint32_t);
+    return bytes;
+}
+
+// ---------------- lista LRU ----------------
+
+void PathCache::unlink(std::uint32_t i) {
+    Entry& e = entries_[i];
+    if (e.prev != kNil) entries_[e.prev].next = e.next;
+    else head_ = e.next;
+    if (e.next != kNil) entries_[e.next].prev = e.prev;
+    else tail_ = e.prev;
+    e.prev = e.next = kNil;
+}
+
+void PathCache::pushFront(std::uint32_t i) {
+    Entry& e = entries_[i];
+    e.prev = kNil;
+    e.next = head_;
+    if (head_ != kNil) entries_[head_].prev = i;
+    head_ = i;
+    if (tail_ == kNil) tail_ = i;
+}
+
+void PathCache::erase(std::uint32_t i) {
+    unlink(i);
+    index_.erase(entries_[i].key);
+    free_.push_back(i);
+}
+
+// ---------------- validità ----------------
+
+// limite inferiore del costo di un percorso start -> goal che passa per la regione
+int PathCache::lowerBound(Cell start, Cell goal, int region) const {
+    const int rx = region % grid_->regionsX(), ry = region / grid_->regionsX();
+    int x0 = rx * GridMap::kRegionSize, y0 = ry * GridMap::kRegionSize;
+    int x1 = std::min(x0 + GridMap::kRegionSize, w_) - 1, y1 = std::min(y0 + GridMap::kRegionSize, h_) - 1;
+    if (opts_.connectivity == Connectivity::Eight) {
+        // una cella sbloccata qui può rendere legale una diagonale tra due celle fuori dalla
+        // regione (sono i suoi angoli): allarghiamo di una cella, così quelle due ci stanno
+        --x0;
+        --y0;
+        ++x1;
+        ++y1;
+    }
+    // cella della regione più vicina a ciascun estremo (il minimo della somma è >= somma dei minimi)
+    const Cell a{std::clamp(start.x, x0, x1), std::clamp(start.y, y0, y1)};
+    const Cell b{std::clamp(goal.x, x0, x1), std::clamp(goal.y, y0, y1)};
+    if (opts_.connectivity == Connectivity::Eight) return octileCost(start, a) + octileCost(b, goal);
+    return manhattanCost(start, a) + manhattanCost(b, goal);
+}
+
+bool PathCache::stillValid(Entry& e) const {
+    const GridMap& g = *grid_;
+    if (g.version() == e.checked) return true; // nessuna modifica da allora
+
+    for (const std::uint32_t r : e.regions)
+        if (g.regionVersion(static_cast<int>(r)) > e.checked) return false;
+
+    if (g.relaxVersion() > e.checked) {
+        const int regions = g.regionsX() * g.regionsY();
+        for (int r = 0; r < regions; ++r)
+            if (g.regionRelaxVersion(r) > e.checked && lowerBound(e.key.start, e.key.goal, r) < e.cost) return false;
+    }
+    e.checked = g.version(); // valido ad oggi: il prossimo controllo riparte da qui
+    return true;
+}
+
+// ---------------- query ----------------
+
+void PathCache::decode(const Entry& e) {
+    hit_.clear();
+    hit_.success = true;
+    hit_.cost = e.cost;
+    hit_.path.reserve(e.steps + 1);
+    Cell c = e.key.start;
+    hit_.path.push_back(c);
+    for (std::uint32_t i = 0; i < e.steps; ++i) {
+        const int d = (e.moves[i >> 1] >> ((i & 1) * 4)) & 0xF;
+        c = Cell{c.x + kDirDx[d], c.y + kDirDy[d]};
+        hit_.path.push_back(c);
+    }
+    hit_.pathLength = hit_.path.size();
+}
+
+void PathCache::store(const Key& key, const AStarResult& r) {
+    std::uint32_t i;
+    if (index_.size() >= capacity_) { // piena: fuori il meno recente
+        i = tail_;
+        erase(i);
+        ++stats_.evictions;
+    }
+    if (!free_.empty()) {
+        i = free_.back();
+        free_.pop_back();
+    } else {
+        i = static_cast<std::uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+
+    Entry& e = entries_[i];
+    e.key = key;
+    e.cost = r.cost;
+    e.steps = static_cast<std::uint32_t>(r.path.size() - 1);
+    e.checked = grid_->version();
+    e.moves.assign((e.steps + 1) / 2, 0);
+    e.regions.clear();
+    e.regions.push_back(static_cast<std::uint32_t>(grid_->regionOf(r.path[0])));
+    for (std::uint32_t s = 0; s < e.steps; ++s) {
+        const Cell a = r.path[s], b = r.path[s + 1];
+        int d = 0;
+        while (kDirDx[d] != b.x - a.x || kDirDy[d] != b.y - a.y) ++d;
+        e.moves[s >> 1] |= static_cast<std::uint8_t>(d << ((s & 1) * 4));
+        const auto reg = static_cast<std::uint32_t>(grid_->regionOf(b));
+        if (reg != e.regions.back()) e.regions.push_back(reg);
+        if (d >= kDownRight) {
+            // la diagonale dipende anche dalle due celle ortogonali (regola degli angoli),
+            // che possono stare in una regione dove il percorso non entra
+            e.regions.push_back(static_cast<std::uint32_t>(grid_->regionOf(Cell{b.x, a.y})));
+            e.regions.push_back(static_cast<std::uint32_t>(grid_->regionOf(Cell{a.x, b.y})));
+        }
+    }
+    std::sort(e.regions.begin(), e.regions.end());
+    e.regions.erase(std::unique(e.regions.begin(), e.regions.end()), e.regions.end());
+
+    index_.emplace(key, i);
+    pushFront(i);
+}
+
+const AStarResult& PathCache::findPath(Cell start, Cell goal) {
+    // grid riassegnato o ridimensionato: nessuna versione è più confrontabile
+    if (grid_->epoch() != epoch_ || grid_->width() != w_ || grid_->height() != h_) {
+        stats_.invalidations += index_.size();
+        clear();
+        syncWithGrid();
+    }
+
+    const Key key{start, goal};
+    if (auto it = index_.find(key); it != index_.end()) {
+        const std::uint32_t i = it->second;
+        if (stillValid(entries_[i])) {
+            ++stats_.hits;
+            unlink(i);
+            pushFront(i);
+            decode(entries_[i]);
+            return hit_;
+        }
+        ++stats_.invalidations;
+        erase(i);
+    }
+
+    ++stats_.misses;
+    const AStarResult& r = AStarPathfinder::findPath(ctx_, *grid_, start, goal, opts_);
+    if (r.success) store(key, r);
+    return r;
+}
@@ -0,0 +1,496 @@
+#include "taikutsu/core/PathDatabase.h"
+#include "taikutsu/core/ThreadPool.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace {
+    constexpr char kMagic[8] = {'T', 'K', 'P', 'A', 'T', 'H', 'D', 'B'};
+    constexpr std::uint32_t kNoRank = 0xFFFFFFFFu; // cella bloccata: mai un target
+
+    // maschere delle prime mosse durante la build: bit 0..7 = Dir, bit 8 = irraggiungibile
+    constexpr std::uint16_t kUnreachableBit = 1u << 8;
+    constexpr std::uint16_t kAnyMove = 0x1FF; // target == sorgente: qualunque run va bene
+    constexpr std::uint32_t kNoneMove = 8;     // mossa di un run senza percorso
+
+    constexpr int kSourcesPerTask = 64;
+
+    // header su disco (vedi PathDatabase.h)
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerBytes;
+        std::int32_t width, height;
+        std::uint32_t flags;
+        std::uint32_t reserved0;
+        std::uint64_t fingerprint;
+        std::uint64_t runCount;
+        std::uint64_t fileBytes;
+        std::uint64_t reserved1;
+    };
+    static_assert(sizeof(Header) == 64);
+
+    std::uint64_t align64(std::uint64_t v) { return (v + 63) & ~std::uint64_t{63}; }
+
+    void fail(std::string* error, const std::string& what) {
+        if (error != nullptr) *error = what;
+    }
+
+    std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+        h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        return h * 0xBF58476D1CE4E5B9ull;
+    }
+
+    // hash del contenuto: bit (con la cornice, stesso layout ovunque) e costi se contano
+    std::uint64_t fingerprint(const GridMap& grid, bool terrain) {
+        std::uint64_t h = mix(static_cast<std::uint64_t>(grid.width()), static_cast<std::uint64_t>(grid.height()));
+        for (size_t i = 0; i < grid.wordCount(); ++i) h = mix(h, grid.words()[i]);
+        if (terrain && grid.hasCosts()) {
+            const std::uint8_t* costs = grid.costs();
+            const size_t n = grid.indexCount();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                std::uint64_t v;
+                std::memcpy(&v, costs + i, sizeof(v));
+                h = mix(h, v);
+            }
+            for (; i < n; ++i) h = mix(h, costs[i]);
+        }
+        return h;
+    }
+
+    // ordine dei target: visita in profondità (preordine), così una regione compatta del grid ha
+    // rank contigui e tende a condividere la prima mossa dalle sorgenti lontane
+    std::vector<std::uint32_t> depthFirstRanks(const GridMap& grid, bool eight, bool cornerCutting) {
+        const int w = grid.width(), h = grid.height(), stride = grid.stride();
+        std::vector<std::uint32_t> rank(static_cast<size_t>(w) * static_cast<size_t>(h), kNoRank);
+        std::vector<int> stack;
+        std::uint32_t next = 0;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                if (!grid.isWalkable(Cell{x, y}) || rank[static_cast<size_t>(y) * w + x] != kNoRank) continue;
+                stack.push_back(grid.index(Cell{x, y}));
+                while (!stack.empty()) {
+                    const int idx = stack.back();
+                    stack.pop_back();
+                    const size_t c = static_cast<size_t>(idx / stride - 1) * static_cast<size_t>(w) +
+                                     static_cast<size_t>(idx % stride - 1);
+                    if (rank[c] != kNoRank) continue;
+                    rank[c] = next++;
+                    const unsigned mask = eight ? grid.moveMask8(idx, cornerCutting) : grid.walkableMask(idx);
+                    // al contrario: la prima direzione (Right) viene visitata per prima
+                    for (int d = 7; d >= 0; --d)
+                        if ((mask >> d) & 1u) stack.push_back(idx + grid.offset(d));
+                }
+            }
+        }
+        return rank;
+    }
+
+    // Dijkstra da una sorgente con le maschere delle prime mosse ottime; scratch di un worker
+    class FirstMoveSweep {
+    public:
+        FirstMoveSweep(const GridMap& grid, bool eight, bool cornerCutting, bool weighted)
+            : grid_(grid), eight_(eight), cornerCutting_(cornerCutting),
+              terrain_(weighted && grid.hasCosts() ? grid.costs() : nullptr),
+              dist_(grid.indexCount()), stamp_(grid.indexCount(), 0), moves_(grid.indexCount()) {
+            if (eight_ || terrain_ != nullptr) {
+                const int maxStep = (eight_ ? kCostDiagonal : kCostStraight) * (terrain_ != nullptr ? 255 : 1);
+                buckets_.resize(static_cast<size_t>(maxStep) + 1);
+            }
+        }
+
+        // prime mosse da source verso ogni cella (moves(idx), valido se reached(idx))
+        void run(int source) {
+            if (++generation_ == 0) { // overflow: azzera gli stamp una volta ogni 2^32 sorgenti
+                std::fill(stamp_.begin(), stamp_.end(), 0);
+                generation_ = 1;
+            }
+            source_ = source;
+            settle(source, 0, 0);
+            if (buckets_.empty()) breadthFirst();
+            else dial();
+        }
+
+        bool reached(int idx) const { return stamp_[static_cast<size_t>(idx)] == generation_; }
+        std::uint16_t moves(int idx) const { return moves_[static_cast<size_t>(idx)]; }
+
+    private:
+        void settle(int idx, std::uint32_t dist, std::uint16_t moves) {
+            stamp_[static_cast<size_t>(idx)] = generation_;
+            dist_[static_cast<size_t>(idx)] = dist;
+            moves_[static_cast<size_t>(idx)] = moves;
+        }
+
+        // relax di idx -> q con la mossa d; true se q va (ri)messo in coda
+        bool relax(int idx, int d, int q, std::uint32_t nd) {
+            const auto via = static_cast<std::uint16_t>(idx == source_ ? 1u << d : moves_[static_cast<size_t>(idx)]);
+            if (!reached(q) || nd < dist_[static_cast<size_t>(q)]) {
+                settle(q, nd, via);
+                return true;
+            }
+            // pareggio: anche le prime mosse di questo predecessore sono ottime
+            if (nd == dist_[static_cast<size_t>(q)]) moves_[static_cast<size_t>(q)] |= via;
+            return false;
+        }
+
+        // 4 direzioni a costo unitario: livelli in ordine, ogni cella entra in coda una volta
+        void breadthFirst() {
+            queue_.clear();
+            queue_.push_back(source_);
+            for (size_t head = 0; head < queue_.size(); ++head) {
+                const int idx = queue_[head];
+                const std::uint32_t nd = dist_[static_cast<size_t>(idx)] + 1;
+                for (unsigned m = grid_.walkableMask(idx); m != 0; m &= m - 1) {
+                    const int d = std::countr_zero(m);
+                    const int q = idx + grid_.offset(d);
+                    if (relax(idx, d, q, nd)) queue_.push_back(q);
+                }
+            }
+        }
+
+        // costi interi limitati: bucket circolari di Dial (come FlowField, ma in avanti)
+        void dial() {
+            const size_t bucketCount = buckets_.size();
+            for (auto& b : buckets_) b.clear();
+            buckets_[0].push_back(source_);
+            size_t pending = 1;
+            for (std::uint32_t cur = 0; pending > 0; ++cur) {
+                auto& bucket = buckets_[cur % bucketCount];
+                for (size_t i = 0; i < bucket.size(); ++i) {
+                    const int idx = bucket[i];
+                    --pending;
+                    if (dist_[static_cast<size_t>(idx)] != cur) continue; // stale
+                    const unsigned mask = eight_ ? grid_.moveMask8(idx, cornerCutting_) : grid_.walkableMask(idx);
+                    for (unsigned m = mask; m != 0; m &= m - 1) {
+                        const int d = std::countr_zero(m);
+                        const int q = idx + grid_.offset(d);
+                        const int enter = terrain_ != nullptr ? terrain_[q] : 1;
+                        const std::uint32_t nd =
+                            cur + static_cast<std::uint32_t>((d >= kDownRight ? kCostDiagonal : kCostStraight) * enter);
+                        if (relax(idx, d, q, nd)) {
+                            buckets_[nd % bucketCount].push_back(q);
+                            ++pending;
+                        }
+                    }
+                }
+                bucket.clear();
+            }
+        }
+
+        const GridMap& grid_;
+        bool eight_, cornerCutting_;
+        const std::uint8_t* terrain_;
+        int source_{0};
+        std::uint32_t generation_{0};
+        std::vector<std::uint32_t> dist_, stamp_; // per indice paddato
+        std::vector<std::uint16_t> moves_;
+        std::vector<int> queue_;
+        std::vector<std::vector<int>> buckets_;
+    };
+
+    // run della riga di una sorgente: target in ordine di rank, un run finché le maschere si intersecano
+    void appendRuns(const std::vector<std::uint16_t>& byRank, std::vector<std::uint32_t>& out) {
+        std::uint32_t begin = 0;
+        std::uint16_t common = byRank[0];
+        auto emit = [&] {
+            out.push_back(begin << 4 | static_cast<std::uint32_t>(std::countr_zero(static_cast<unsigned>(common))));
+        };
+        for (std::uint32_t r = 1; r < byRank.size(); ++r) {
+            if ((common & byRank[r]) != 0) {
+                common &= byRank[r];
+                continue;
+            }
+            emit();
+            begin = r;
+            common = byRank[r];
+        }
+        emit();
+    }
+}
+
+bool PathDatabase::build(const GridMap& grid, const PathDatabaseOptions& opts, std::string* error) {
+    const size_t cells = static_cast<size_t>(grid.width()) * static_cast<size_t>(grid.height());
+    if (cells > static_cast<size_t>(kMaxCells)) {
+        fail(error, "grid too large for a path database (" + std::to_string(cells) + " cells)");
+        return false;
+    }
+    w_ = grid.width();
+    h_ = grid.height();
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool cornerCutting = eight && opts.cornerCutting;
+    const bool weighted = opts.useTerrainCost && grid.hasCosts();
+    flags_ = (eight ? kPathDatabaseEight : 0u) | (cornerCutting ? kPathDatabaseCornerCutting : 0u) |
+             (weighted ? kPathDatabaseTerrain : 0u);
+    fingerprint_ = fingerprint(grid, weighted);
+    rank_ = depthFirstRanks(grid, eight, cornerCutting);
+
+    // target in ordine di rank (indice paddato)
+    std::vector<int> targets;
+    for (int y = 0; y < h_; ++y)
+        for (int x = 0; x < w_; ++x)
+            if (rank_[cellIndex(Cell{x, y})] != kNoRank) targets.push_back(grid.index(Cell{x, y}));
+    std::vector<int> byRankIdx(targets.size());
+    for (const int idx : targets) {
+        const Cell c{idx % grid.stride() - 1, idx / grid.stride() - 1};
+        byRankIdx[rank_[cellIndex(c)]] = idx;
+    }
+
+    // blocchi di sorgenti consecutive (y * w + x); ogni blocco scrive solo i suoi run
+    const size_t blocks = (cells + kSourcesPerTask - 1) / kSourcesPerTask;
+    std::vector<std::vector<std::uint32_t>> blockRuns(blocks), blockCounts(blocks);
+    const unsigned workers = opts.pool != nullptr ? opts.pool->size() : 1;
+    std::vector<std::unique_ptr<FirstMoveSweep>> sweeps(workers);
+    std::vector<std::vector<std::uint16_t>> masks(workers, std::vector<std::uint16_t>(byRankIdx.size()));
+    auto buildBlock = [&](size_t b, unsigned worker) {
+        if (!sweeps[worker]) sweeps[worker] = std::make_unique<FirstMoveSweep>(grid, eight, cornerCutting, weighted);
+        FirstMoveSweep& sweep = *sweeps[worker];
+        std::vector<std::uint16_t>& byRank = masks[worker];
+        const size_t end = std::min(cells, (b + 1) * kSourcesPerTask);
+        for (size_t c = b * kSourcesPerTask; c < end; ++c) {
+            const Cell source{static_cast<int>(c % static_cast<size_t>(w_)), static_cast<int>(c / static_cast<size_t>(w_))};
+            const size_t before = blockRuns[b].size();
+            if (rank_[c] != kNoRank) {
+                sweep.run(grid.index(source));
+                for (size_t r = 0; r < byRankIdx.size(); ++r)
+                    byRank[r] = sweep.reached(byRankIdx[r]) ? sweep.moves(byRankIdx[r]) : kUnreachableBit;
+                byRank[rank_[c]] = kAnyMove;
+                appendRuns(byRank, blockRuns[b]);
+            }
+            blockCounts[b].push_back(static_cast<std::uint32_t>(blockRuns[b].size() - before));
+        }
+    };
+    if (opts.pool != nullptr && blocks > 1) {
+        for (size_t b = 0; b < blocks; ++b) opts.pool->submit([&buildBlock, b](unsigned worker) { buildBlock(b, worker); });
+        opts.pool->wait();
+    } else {
+        for (size_t b = 0; b < blocks; ++b) buildBlock(b, 0);
+    }
+
+    offsets_.assign(cells + 1, 0);
+    size_t total = 0;
+    for (const auto& r : blockRuns) total += r.size();
+    runs_.clear();
+    runs_.reserve(total);
+    size_t c = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        for (const std::uint32_t n : blockCounts[b]) {
+            offsets_[c + 1] = offsets_[c] + n;
+            ++c;
+        }
+        runs_.insert(runs_.end(), blockRuns[b].begin(), blockRuns[b].end());
+        std::vector<std::uint32_t>().swap(blockRuns[b]); // picco di memoria: un blocco alla volta
+    }
+    return true;
+}
+
+bool PathDatabase::matches(const GridMap& grid) const {
+    return grid.width() == w_ && grid.height() == h_ &&
+           fingerprint(grid, (flags_ & kPathDatabaseTerrain) != 0) == fingerprint_;
+}
+
+bool PathDatabase::usableFor(const SearchOptions& opts) const {
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    if (eight != ((flags_ & kPathDatabaseEight) != 0)) return false;
+    if (eight && opts.cornerCutting != ((flags_ & kPathDatabaseCornerCutting) != 0)) return false;
+    // terreno: senza costi nel grid le due scelte coincidono (il flag resta spento)
+    return (flags_ & kPathDatabaseTerrain) == 0 || opts.useTerrainCost;
+}
+
+std::uint8_t PathDatabase::firstMove(Cell start, Cell goal) const {
+    if (start.x < 0 || start.y < 0 || start.x >= w_ || start.y >= h_) return kNoMove;
+    if (goal.x < 0 || goal.y < 0 || goal.x >= w_ || goal.y >= h_ || start == goal) return kNoMove;
+    const std::uint32_t target = rank_[cellIndex(goal)];
+    const size_t s = cellIndex(start);
+    const auto begin = runs_.begin() + static_cast<std::ptrdiff_t>(offsets_[s]);
+    const auto end = runs_.begin() + static_cast<std::ptrdiff_t>(offsets_[s + 1]);
+    if (target == kNoRank || begin == end) return kNoMove; // goal o start bloccati
+    // ultimo run che inizia a rank <= target (il primo inizia sempre a 0)
+    const std::uint32_t move = *(std::upper_bound(begin, end, target << 4 | 0xFu) - 1) & 0xFu;
+    return move == kNoneMove ? kNoMove : static_cast<std::uint8_t>(move);
+}
+
+void PathDatabase::findPath(const GridMap& grid, Cell start, Cell goal, AStarResult& out) const {
+    out.clear();
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal) || w_ != grid.width() || h_ != grid.height()) return;
+    const std::uint8_t* terrain = (flags_ & kPathDatabaseTerrain) != 0 ? grid.costs() : nullptr;
+    const size_t maxSteps = static_cast<size_t>(w_) * static_cast<size_t>(h_);
+    out.path.push_back(start);
+    for (Cell cur = start; !(cur == goal);) {
+        const std::uint8_t d = firstMove(cur, goal);
+        ++out.expanded;
+        if (d == kNoMove || out.path.size() > maxSteps) { // nessun percorso (o grid diverso da quello di build)
+            out.path.clear();
+            out.cost = 0;
+            return;
+        }
+        cur = Cell{cur.x + kDirDx[d], cur.y + kDirDy[d]};
+        if (!grid.isWalkable(cur)) { // database di un altro grid
+            out.path.clear();
+            out.cost = 0;
+            return;
+        }
+        const int enter = terrain != nullptr ? terrain[grid.index(cur)] : 1;
+        out.cost += (d >= kDownRight ? kCostDiagonal : kCostStraight) * enter;
+        out.path.push_back(cur);
+    }
+    out.success = true;
+    out.pathLength = out.path.size();
+}
+
+// ---------------- file ----------------
+
+bool PathDatabase::save(std::ostream& out) const {
+    if constexpr (std::endian::native != std::endian::little) return false;
+    const std::uint64_t cells = rank_.size();
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kPathDatabaseVersion;
+    h.headerBytes = sizeof(Header);
+    h.width = w_;
+    h.height = h_;
+    h.flags = flags_;
+    h.fingerprint = fingerprint_;
+    h.runCount = runs_.size();
+    const std::uint64_t rankAt = align64(sizeof(Header));
+    const std::uint64_t offsetsAt = align64(rankAt + cells * sizeof(std::uint32_t));
+    const std::uint64_t runsAt = align64(offsetsAt + (cells + 1) * sizeof(std::uint64_t));
+    h.fileBytes = runsAt + runs_.size() * sizeof(std::uint32_t);
+
+    static const char zeros[64] = {};
+    std::uint64_t at = 0;
+    auto section = [&](std::uint64_t offset, const void* data, std::uint64_t bytes) {
+        out.write(zeros, static_cast<std::streamsize>(offset - at));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        at = offset + bytes;
+    };
+    section(0, &h, sizeof(h));
+    section(rankAt, rank_.data(), cells * sizeof(std::uint32_t));
+    section(offsetsAt, offsets_.data(), (cells + 1) * sizeof(std::uint64_t));
+    section(runsAt, runs_.data(), runs_.size() * sizeof(std::uint32_t));
+    return static_cast<bool>(out);
+}
+
+bool PathDatabase::save(const std::string& path, std::string* error) const {
+    if constexpr (std::endian::native != std::endian::little) {
+        fail(error, "big-endian hosts are not supported");
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        fail(error, "cannot create " + path);
+        return false;
+    }
+    if (!save(out)) {
+        fail(error, "write error on " + path);
+        return false;
+    }
+    return true;
+}
+
+std::optional<PathDatabase> PathDatabase::load(std::istream& in, std::string* error) {
+    if constexpr (std::endian::native != std::endian::little) {
+        fail(error, "big-endian hosts are not supported");
+        return std::nullopt;
+    }
+    const std::istream::pos_type start = in.tellg();
+    Header h{};
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        fail(error, "not a path database file");
+        return std::nullopt;
+    }
+    if (h.version > kPathDatabaseVersion || h.headerBytes != sizeof(Header)) {
+        fail(error, "unsupported path database version " + std::to_string(h.version));
+        return std::nullopt;
+    }
+    if (h.width <= 0 || h.height <= 0 ||
+        static_cast<std::uint64_t>(h.width) * static_cast<std::uint64_t>(h.height) > static_cast<std::uint64_t>(kMaxCells) ||
+        h.runCount > (std::uint64_t{1} << 40)) {
+        fail(error, "invalid path database header");
+        return std::nullopt;
+    }
+    // layout come in save(): fileBytes deve tornare e stare nello stream prima di allocare
+    // (runCount arriva fino a 2^40, cells a 2^28)
+    const auto cellCount = static_cast<std::uint64_t>(h.width) * static_cast<std::uint64_t>(h.height);
+    const std::uint64_t rankAt = align64(sizeof(Header));
+    const std::uint64_t offsetsAt = align64(rankAt + cellCount * sizeof(std::uint32_t));
+    const std::uint64_t runsAt = align64(offsetsAt + (cellCount + 1) * sizeof(std::uint64_t));
+    if (h.fileBytes != runsAt + h.runCount * sizeof(std::uint32_t)) {
+        fail(error, "invalid path database header");
+        return std::nullopt;
+    }
+    const std::istream::pos_type here = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(here);
+    if (start < 0 || here < 0 || end < 0 || !in) {
+        fail(error, "path database stream is not seekable");
+        return std::nullopt;
+    }
+    if (h.fileBytes > static_cast<std::uint64_t>(end - start)) {
+        fail(error, "truncated path database file");
+        return std::nullopt;
+    }
+
+    PathDatabase db;
+    db.w_ = h.width;
+    db.h_ = h.height;
+    db.flags_ = h.flags;
+    db.fingerprint_ = h.fingerprint;
+    const size_t cells = static_cast<size_t>(h.width) * static_cast<size_t>(h.height);
+    db.rank_.resize(cells);
+    db.offsets_.resize(cells + 1);
+    db.runs_.resize(h.runCount);
+
+    std::uint64_t at = sizeof(Header);
+    auto section = [&](void* data, std::uint64_t bytes) {
+        in.ignore(static_cast<std::streamsize>(align64(at) - at));
+        in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        at = align64(at) + bytes;
+        return static_cast<bool>(in);
+    };
+    if (!section(db.rank_.data(), cells * sizeof(std::uint32_t)) ||
+        !section(db.offsets_.data(), (cells + 1) * sizeof(std::uint64_t)) ||
+        !section(db.runs_.data(), db.runs_.size() * sizeof(std::uint32_t))) {
+        fail(error, "truncated path database file");
+        return std::nullopt;
+    }
+
+    // una riga deve iniziare dal rank 0 e i rank devono stare fra le celle: firstMove non controlla
+    if (db.offsets_[0] != 0 || db.offsets_[cells] != db.runs_.size()) {
+        fail(error, "corrupt path database offsets");
+        return std::nullopt;
+    }
+    for (size_t c = 0; c < cells; ++c) {
+        if (db.rank_[c] != kNoRank && db.rank_[c] >= cells) {
+            fail(error, "corrupt path database ranks");
+            return std::nullopt;
+        }
+        // crescenti e dentro runs_ prima di leggere il primo run della riga
+        if (db.offsets_[c] > db.offsets_[c + 1] || db.offsets_[c + 1] > db.runs_.size() ||
+            (db.offsets_[c] != db.offsets_[c + 1] && (db.runs_[db.offsets_[c]] >> 4) != 0)) {
+            fail(error, "corrupt path database offsets");
+            return std::nullopt;
+        }
+    }
+    for (const std::uint32_t run : db.runs_) {
+        if ((run & 0xFu) > kNoneMove) {
+            fail(error, "corrupt path database runs");
+            return std::nullopt;
+        }
+    }
+    return db;
+}
+
+std::optional<PathDatabase> PathDatabase::load(const std::string& path, std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        fail(error, "cannot open " + path);
+        return std::nullopt;
+    }
+    auto db = load(in, error);
+    if (!db && error != nullptr) *error = path + ": " + *error;
+    return db;
+}
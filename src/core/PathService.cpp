@@ -0,0 +1,213 @@
+#include "taikutsu/core/PathService.h"
+#include "taikutsu/core/ResumableSearch.h"
+#include <algorithm>
+
+// ---------------- PathService ----------------
+
+// una ricerca (condivisa dai richiedenti coalescenti); in coda tramite il nodo intrusivo
+struct PathService::Job : MpscNode {
+    struct Subscriber {
+        Callback callback;
+        bool cancelled{false};
+    };
+
+    Key key;
+    std::chrono::steady_clock::time_point submitted;
+    std::promise<PathResponse> promise;
+    std::shared_future<PathResponse> future{promise.get_future().share()};
+    std::atomic<int> interested{0}; // richiedenti che non hanno cancellato (scritto con m)
+    std::shared_ptr<Job> self;      // riferimento tenuto dalla coda fino al pop
+
+    std::mutex m; // protegge subscribers e done
+    std::vector<Subscriber> subscribers;
+    bool done{false};
+};
+
+size_t PathService::KeyHash::operator()(const Key& k) const {
+    std::uint64_t h = k.version * 0x9E3779B97F4A7C15ull;
+    h ^= (static_cast<std::uint64_t>(static_cast<std::uint32_t>(k.start.x)) << 32 | static_cast<std::uint32_t>(k.start.y)) + 0x7F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= (static_cast<std::uint64_t>(static_cast<std::uint32_t>(k.goal.x)) << 32 | static_cast<std::uint32_t>(k.goal.y)) + 0x7F4A7C15ull + (h << 6) + (h >> 2);
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+void PathService::PathTicket::cancel() {
+    if (!job_ || cancelled_) return;
+    cancelled_ = true;
+    std::lock_guard<std::mutex> lk(job_->m);
+    if (job_->done) return;
+    job_->subscribers[subscriber_].cancelled = true;
+    job_->interested.fetch_sub(1, std::memory_order_acq_rel); // a 0 il worker la salta / interrompe
+}
+
+PathService::PathService(std::shared_ptr<const GridMap> grid, unsigned threads, const SearchOptions& opts)
+    : opts_(opts), grid_(std::move(grid)) {
+    opts_.components = nullptr;
+    opts_.stats = nullptr; // i worker sono più thread: il collettore non è thread-safe
+    opts_.recordClosed = ClosedRecording::None;
+    opts_.output.buffer = nullptr; // il percorso va in PathResponse::path
+    opts_.output.span = {};
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this] { workerLoop(); });
+}
+
+PathService::~PathService() {
+    stop_.store(true, std::memory_order_release);
+    wake_.fetch_add(1, std::memory_order_acq_rel);
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+std::shared_ptr<const GridMap> PathService::currentGrid(std::uint64_t& version) const {
+    std::lock_guard<std::mutex> lk(gridMutex_);
+    version = version_.load(std::memory_order_relaxed);
+    return grid_;
+}
+
+std::uint64_t PathService::publish(std::shared_ptr<const GridMap> grid) {
+    std::lock_guard<std::mutex> lk(gridMutex_);
+    grid_ = std::move(grid);
+    // le nuove submit non si agganciano più alle ricerche della versione precedente
+    return version_.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+PathService::PathTicket PathService::submit(Cell start, Cell goal, Callback callback) {
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    const Key key{start, goal, gridVersion()};
+    PathTicket ticket;
+
+    Shard& shard = shardOf(key);
+    {
+        std::lock_guard<std::mutex> lk(shard.m);
+        auto it = shard.jobs.find(key);
+        if (it != shard.jobs.end()) {
+            // stessa ricerca già in coda o in corso: ci si aggancia (il worker la toglie dalla
+            // tabella prima di chiudere, quindi qui non è ancora done). Se tutti hanno cancellato
+            // il worker può averla già interrotta: serve una ricerca nuova.
+            Job& job = *it->second;
+            std::lock_guard<std::mutex> jl(job.m);
+            if (job.interested.load(std::memory_order_relaxed) > 0) {
+                ticket.subscriber_ = job.subscribers.size();
+                job.subscribers.push_back({std::move(callback), false});
+                job.interested.fetch_add(1, std::memory_order_acq_rel);
+                ticket.job_ = it->second;
+                ticket.future_ = job.future;
+                ticket.coalesced_ = true;
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return ticket;
+            }
+        }
+
+        auto job = std::make_shared<Job>();
+        job->key = key;
+        job->submitted = std::chrono::steady_clock::now();
+        job->interested.store(1, std::memory_order_relaxed);
+        job->subscribers.push_back({std::move(callback), false});
+        job->self = job;
+        shard.jobs.insert_or_assign(key, job);
+        ticket.job_ = job;
+        ticket.future_ = job->future;
+    }
+
+    inFlight_.fetch_add(1, std::memory_order_relaxed);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+    queue_.push(ticket.job_.get());
+    wake_.fetch_add(1, std::memory_order_acq_rel);
+    wake_.notify_one();
+    return ticket;
+}
+
+void PathService::workerLoop() {
+    ResumableSearch search; // contesto del worker, riusato tra le query
+    for (;;) {
+        const std::uint32_t ticket = wake_.load(std::memory_order_acquire);
+
+        // un consumer alla volta sulla coda (sezione di poche istruzioni)
+        while (consumer_.exchange(true, std::memory_order_acquire)) {}
+        MpscNode* node = queue_.pop();
+        consumer_.store(false, std::memory_order_release);
+
+        if (node != nullptr) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            Job& job = static_cast<Job&>(*node);
+            const std::shared_ptr<Job> hold = std::move(job.self);
+            run(job, search);
+            continue;
+        }
+        if (stop_.load(std::memory_order_acquire)) return; // coda vuota e chiusura
+        wake_.wait(ticket, std::memory_order_acquire);      // dorme finché arriva una push
+    }
+}
+
+void PathService::run(Job& job, ResumableSearch& search) {
+    // chi non interessa più a nessuno (o arriva durante la chiusura) non viene cercato
+    PathResponse response;
+    response.status = SearchStatus::Cancelled;
+    if (stop_.load(std::memory_order_acquire) || job.interested.load(std::memory_order_acquire) == 0) {
+        finish(job, std::move(response));
+        return;
+    }
+
+    const std::shared_ptr<const GridMap> grid = currentGrid(response.gridVersion);
+
+    // a fette: tra una e l'altra si guarda se qualcuno aspetta ancora
+    constexpr size_t kSlice = 4096;
+    search.start(*grid, job.key.start, job.key.goal, opts_);
+    while (search.running()) {
+        search.step(kSlice);
+        if (job.interested.load(std::memory_order_acquire) == 0) search.cancel();
+    }
+
+    response.status = search.status();
+    if (response.status == SearchStatus::Found) {
+        response.path = search.result().path;
+        response.cost = search.result().cost;
+    }
+    finish(job, std::move(response));
+}
+
+void PathService::finish(Job& job, PathResponse response) {
+    // fuori dalla tabella prima di chiudere: da qui nessuno si aggancia più
+    {
+        Shard& shard = shardOf(job.key);
+        std::lock_guard<std::mutex> lk(shard.m);
+        auto it = shard.jobs.find(job.key);
+        if (it != shard.jobs.end() && it->second.get() == &job) shard.jobs.erase(it);
+    }
+
+    const bool cancelled = response.status == SearchStatus::Cancelled;
+    if (cancelled) cancelled_.fetch_add(1, std::memory_order_relaxed);
+    else {
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - job.submitted);
+        latency_.record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, latency.count())));
+    }
+
+    std::vector<Job::Subscriber> subscribers;
+    {
+        std::lock_guard<std::mutex> lk(job.m);
+        job.done = true;
+        subscribers = std::move(job.subscribers);
+    }
+    job.promise.set_value(std::move(response));
+
+    const PathResponse& result = job.future.get();
+    for (const auto& s : subscribers)
+        if (!s.cancelled && s.callback) s.callback(result);
+    inFlight_.fetch_sub(1, std::memory_order_release); // dopo le callback: a 0 il servizio è fermo
+}
+
+PathServiceStats PathService::stats() const {
+    PathServiceStats s;
+    s.queueDepth = queued_.load(std::memory_order_relaxed);
+    s.inFlight = inFlight_.load(std::memory_order_relaxed);
+    s.submitted = submitted_.load(std::memory_order_relaxed);
+    s.coalesced = coalesced_.load(std::memory_order_relaxed);
+    s.completed = completed_.load(std::memory_order_relaxed);
+    s.cancelled = cancelled_.load(std::memory_order_relaxed);
+    s.p50Us = static_cast<double>(latency_.percentile(0.50)) / 1000.0;
+    s.p90Us = static_cast<double>(latency_.percentile(0.90)) / 1000.0;
+    s.p99Us = static_cast<double>(latency_.percentile(0.99)) / 1000.0;
+    s.maxUs = static_cast<double>(latency_.max()) / 1000.0;
+    return s;
+}
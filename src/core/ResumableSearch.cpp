@@ -0,0 +1,73 @@
+#include "taikutsu/core/ResumableSearch.h"
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include <algorithm>
+
+// una chiamata virtuale per step(), non per nodo: il loop resta quello dell'istanza specializzata
+struct ResumableSearch::Task {
+    virtual ~Task() = default;
+    virtual SearchStatus step(size_t maxExpansions) = 0;
+    virtual size_t expanded() const = 0;
+};
+
+template <class A>
+struct ResumableSearch::TaskFor final : ResumableSearch::Task {
+    TaskFor(AStarSearchContext& ctx, const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts)
+        : recorder(makeRecorder<typename A::RecorderType>(opts)),
+          search(ctx, grid, start, goal, recorder, opts.output, makeHeuristic<typename A::HeuristicType>(opts, goal)) {}
+
+    SearchStatus step(size_t maxExpansions) override { return search.step(maxExpansions); }
+    size_t expanded() const override { return search.expanded(); }
+
+    typename A::RecorderType recorder; // prima di search, che ne tiene un riferimento
+    typename A::Search search;
+};
+
+ResumableSearch::ResumableSearch() = default;
+ResumableSearch::~ResumableSearch() = default;
+
+void ResumableSearch::start(const GridMap& grid, Cell start, Cell goal, const SearchOptions& opts) {
+    task_.reset();
+
+    // componenti diverse: nessuna ricerca (come AStarPathfinder::findPath)
+    if (opts.components && !opts.components->connected(start, goal)) {
+        ctx_.resize(grid);
+        ctx_.beginQuery();
+        if (opts.output.buffer != nullptr) opts.output.buffer->clear();
+        status_ = SearchStatus::NoPath;
+        return;
+    }
+
+    task_ = dispatchAStar(grid, opts, [&]<class A>() -> std::unique_ptr<Task> {
+        return std::make_unique<TaskFor<A>>(ctx_, grid, start, goal, opts);
+    });
+    status_ = task_->step(0); // start/goal non validi o coincidenti: già concluso
+}
+
+SearchStatus ResumableSearch::step(size_t maxExpansions) {
+    if (status_ != SearchStatus::Running) return status_;
+    status_ = task_->step(maxExpansions);
+    return status_;
+}
+
+SearchStatus ResumableSearch::stepFor(std::chrono::microseconds budget, size_t maxExpansions) {
+    // il clock costa qualche decina di ns: lo leggiamo solo ogni kSlice nodi
+    constexpr size_t kSlice = 256;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    while (status_ == SearchStatus::Running && maxExpansions > 0) {
+        const size_t before = task_->expanded();
+        step(std::min(kSlice, maxExpansions));
+        maxExpansions -= std::min(maxExpansions, task_->expanded() - before);
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+    return status_;
+}
+
+void ResumableSearch::cancel() {
+    if (status_ != SearchStatus::Running) return;
+    status_ = SearchStatus::Cancelled;
+}
+
+size_t ResumableSearch::expanded() const {
+    return task_ ? task_->expanded() : 0;
+}
@@ -0,0 +1,110 @@
+#include "taikutsu/core/SearchStats.h"
+#include <algorithm>
+#include <cstdio>
+
+// ---------------- SearchStatsCollector ----------------
+
+void SearchStatsCollector::record(const SearchStats& s) {
+    last_ = s;
+    ++queries_;
+    found_ += s.found;
+    h_.expanded.record(s.expanded);
+    h_.pushes.record(s.pushes);
+    h_.stalePops.record(s.stalePops);
+    h_.peakOpen.record(s.peakOpen);
+    h_.bytesAllocated.record(s.bytesAllocated);
+    h_.setupNs.record(s.setupNs);
+    h_.expandNs.record(s.expandNs);
+    h_.pathNs.record(s.pathNs);
+    h_.totalNs.record(s.totalNs());
+}
+
+void SearchStatsCollector::reset() {
+    *this = SearchStatsCollector{};
+}
+
+namespace {
+    StatSummary summarize(const ValueHistogram& h) {
+        StatSummary s;
+        s.count = h.count();
+        s.sum = h.sum();
+        s.min = h.min();
+        s.max = h.max();
+        s.mean = h.mean();
+        s.p50 = h.percentile(0.50);
+        s.p90 = h.percentile(0.90);
+        s.p99 = h.percentile(0.99);
+        return s;
+    }
+
+    // (nome, istogramma) nell'ordine dei dump
+    template <class Fn>
+    void forEachMetric(const SearchStatsCollector::Histograms& h, Fn fn) {
+        fn("expanded", h.expanded);
+        fn("pushes", h.pushes);
+        fn("stale_pops", h.stalePops);
+        fn("peak_open", h.peakOpen);
+        fn("bytes_allocated", h.bytesAllocated);
+        fn("setup_ns", h.setupNs);
+        fn("expand_ns", h.expandNs);
+        fn("path_ns", h.pathNs);
+        fn("total_ns", h.totalNs);
+    }
+
+    void append(std::string& out, const char* fmt, auto... args) {
+        char buf[256];
+        const int n = std::snprintf(buf, sizeof(buf), fmt, args...);
+        out.append(buf, static_cast<size_t>(std::clamp(n, 0, static_cast<int>(sizeof(buf)) - 1)));
+    }
+
+    unsigned long long ull(std::uint64_t v) { return static_cast<unsigned long long>(v); }
+}
+
+SearchStatsSummary SearchStatsCollector::summary() const {
+    SearchStatsSummary s;
+    s.queries = queries_;
+    s.found = found_;
+    s.expanded = summarize(h_.expanded);
+    s.pushes = summarize(h_.pushes);
+    s.stalePops = summarize(h_.stalePops);
+    s.peakOpen = summarize(h_.peakOpen);
+    s.bytesAllocated = summarize(h_.bytesAllocated);
+    s.setupNs = summarize(h_.setupNs);
+    s.expandNs = summarize(h_.expandNs);
+    s.pathNs = summarize(h_.pathNs);
+    s.totalNs = summarize(h_.totalNs);
+    return s;
+}
+
+std::string SearchStatsCollector::toText() const {
+    std::string out;
+    append(out, "queries %llu (found %llu)\n", ull(queries_), ull(found_));
+    append(out, "%-16s %14s %14s %14s %14s %14s %14s\n", "metric", "mean", "min", "p50", "p90", "p99", "max");
+    forEachMetric(h_, [&](const char* name, const ValueHistogram& h) {
+        const StatSummary s = summarize(h);
+        append(out, "%-16s %14.1f %14llu %14llu %14llu %14llu %14llu\n", name, s.mean, ull(s.min), ull(s.p50),
+               ull(s.p90), ull(s.p99), ull(s.max));
+    });
+    return out;
+}
+
+std::string SearchStatsCollector::toJson() const {
+    std::string out;
+    append(out, "{\"queries\":%llu,\"found\":%llu", ull(queries_), ull(found_));
+    forEachMetric(h_, [&](const char* name, const ValueHistogram& h) {
+        const StatSummary s = summarize(h);
+        append(out, ",\"%s\":{\"count\":%llu,\"sum\":%llu,\"min\":%llu,\"max\":%llu,\"mean\":%.3f,", name,
+               ull(s.count), ull(s.sum), ull(s.min), ull(s.max), s.mean);
+        append(out, "\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"buckets\":[", ull(s.p50), ull(s.p90), ull(s.p99));
+        // solo i bucket non vuoti: [limite superiore incluso, conteggio]
+        bool first = true;
+        for (int b = 0; b < ValueHistogram::kBuckets; ++b) {
+            if (h.bucketCount(b) == 0) continue;
+            append(out, "%s[%llu,%llu]", first ? "" : ",", ull(ValueHistogram::upperBound(b)), ull(h.bucketCount(b)));
+            first = false;
+        }
+        out += "]}";
+    });
+    out += "}";
+    return out;
+}
@@ -0,0 +1,98 @@
+#include "taikutsu/core/ThreadPool.h"
+#include <algorithm>
+
+namespace {
+    // worker corrente (per submit dall'interno di un task)
+    thread_local const ThreadPool* tlsPool = nullptr;
+    thread_local unsigned tlsWorker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    queues_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    work_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+void ThreadPool::submit(Task task) {
+    const unsigned target = (tlsPool == this) ? tlsWorker : next_.fetch_add(1, std::memory_order_relaxed) % size();
+
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lk(queues_[target]->m);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    {
+        // incremento sotto m_: un worker che sta per addormentarsi non perde la notifica
+        std::lock_guard<std::mutex> lk(m_);
+        queued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    work_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lk(m_);
+    idle_.wait(lk, [this] { return pending_.load() == 0; });
+}
+
+bool ThreadPool::onWorkerThread() const {
+    return tlsPool == this;
+}
+
+bool ThreadPool::tryPop(unsigned id, Task& out) {
+    {
+        Queue& own = *queues_[id];
+        std::lock_guard<std::mutex> lk(own.m);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // furto: dalla testa delle code degli altri worker, partendo dal vicino
+    for (unsigned k = 1; k < size(); ++k) {
+        Queue& victim = *queues_[(id + k) % size()];
+        std::lock_guard<std::mutex> lk(victim.m);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned id) {
+    tlsPool = this;
+    tlsWorker = id;
+
+    for (;;) {
+        Task task;
+        if (tryPop(id, task)) {
+            task(id);
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lk(m_);
+                idle_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(m_);
+        work_.wait(lk, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "taikutsu/core/MapFile.h"
+#include "taikutsu/core/MovingAI.h"
+
+// Converte una mappa testuale (MovingAI .map o ASCII semplice, vedi MovingAI.h) o un .tkmap
+// nel formato binario di MapFile.h.
+// uso: taikutsu_mapconv <input> <output.tkmap> [--components] [--no-costs]
+
+namespace {
+    bool endsWith(const std::string& s, const char* suffix) {
+        const size_t n = std::strlen(suffix);
+        return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+    }
+
+    // MovingAI se la prima parola è una chiave dell'header, altrimenti ASCII semplice
+    bool looksLikeMovingAI(const std::string& path) {
+        std::ifstream in(path);
+        std::string first;
+        in >> first;
+        return first == "type" || first == "height" || first == "width";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string input, output;
+    MapFileOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--components") == 0) opts.components = true;
+        else if (std::strcmp(argv[i], "--no-costs") == 0) opts.costs = false;
+        else if (input.empty()) input = argv[i];
+        else if (output.empty()) output = argv[i];
+        else input.clear(), output.clear(), i = argc; // troppi argomenti
+    }
+    if (input.empty() || output.empty()) {
+        std::fprintf(stderr, "usage: %s <input.map|input.txt|input.tkmap> <output.tkmap> [--components] [--no-costs]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string error;
+    std::optional<GridMap> grid;
+    if (endsWith(input, ".tkmap")) grid = loadMapFile(input, &error);
+    else if (looksLikeMovingAI(input)) grid = loadMovingAIMap(input, &error);
+    else grid = loadAsciiMap(input, &error);
+    if (!grid) {
+        std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+        return 1;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    if (!saveMapFile(output, *grid, opts, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const auto view = GridMapView::open(output, &error); // rilettura: il file è valido
+    if (!view) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+    std::printf("%s: %dx%d%s%s, %zu bytes (load %.1f ms, write %.1f ms)\n", output.c_str(), grid->width(),
+                grid->height(), grid->hasCosts() && opts.costs ? ", costs" : "",
+                view->hasComponents() ? ", components" : "", view->fileBytes(), ms(t1 - t0), ms(t2 - t1));
+    return 0;
+}
@@ -0,0 +1,94 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/GridMap.h"
+#include "taikutsu/core/SearchOptions.h"
+
+// Helper condivisi dai test: griglie casuali (stessa sequenza di estrazioni per lo stesso seed)
+// e controlli sui percorsi.
+
+// ogni cella bloccata con probabilità density; con terrain anche un costo casuale 1..6
+inline void randomize(GridMap& g, unsigned seed, double density, bool terrain = false) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution blocked(density);
+    std::uniform_int_distribution<int> cost(1, 6);
+    for (int y = 0; y < g.height(); ++y) {
+        for (int x = 0; x < g.width(); ++x) {
+            g.setBlocked(Cell{x, y}, blocked(rng));
+            if (terrain) g.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+        }
+    }
+}
+
+inline GridMap randomGrid(int w, int h, double density, unsigned seed, bool terrain = false) {
+    GridMap g(w, h);
+    randomize(g, seed, density, terrain);
+    return g;
+}
+
+// count celle libere casuali (anche ripetute)
+inline std::vector<Cell> freeCells(const GridMap& g, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    std::vector<Cell> out;
+    while (static_cast<int>(out.size()) < count) {
+        const Cell c{rx(rng), ry(rng)};
+        if (g.isWalkable(c)) out.push_back(c);
+    }
+    return out;
+}
+
+// controlla se il path non è vuoto, va da start a goal,
+// tutte le celle sono all'interno del grid e walkable, passi da 1 cella in 4 direzioni
+inline void assertValidPath(const GridMap& g, const std::vector<Cell>& path, Cell start, Cell goal) {
+    ASSERT_FALSE(path.empty());
+    EXPECT_TRUE(path.front() == start);
+    EXPECT_TRUE(path.back() == goal);
+    for (size_t i = 0; i < path.size(); ++i) {
+        const Cell c = path[i];
+        EXPECT_TRUE(g.inBounds(c)) << "Cell out of bounds: (" << c.x << "," << c.y << ")";
+        EXPECT_TRUE(g.isWalkable(c)) << "Cell not walkable: (" << c.x << "," << c.y << ")";
+        if (i > 0) {
+            const Cell prev = path[i - 1];
+            EXPECT_EQ(std::abs(prev.x - c.x) + std::abs(prev.y - c.y), 1)
+                << "Non-4-neighbor step from (" << prev.x << "," << prev.y << ") to (" << c.x << "," << c.y << ")";
+        }
+    }
+}
+
+// percorso di celle adiacenti, libere, mosse permesse da opts; ritorna il suo costo (-1 se un
+// passo non è fra celle vicine)
+inline int pathCost(const GridMap& g, const std::vector<Cell>& path, const SearchOptions& opts) {
+    const bool eight = opts.connectivity == Connectivity::Eight;
+    const bool weighted = opts.useTerrainCost && g.hasCosts();
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        const Cell a = path[i - 1], b = path[i];
+        EXPECT_TRUE(g.isWalkable(b));
+        int d = 0;
+        while (d < 8 && !(a.x + kDirDx[d] == b.x && a.y + kDirDy[d] == b.y)) ++d;
+        EXPECT_LT(d, eight ? 8 : 4) << "step (" << a.x << "," << a.y << ") -> (" << b.x << "," << b.y << ")";
+        if (d >= 8) return -1;
+        const unsigned moves = eight ? g.moveMask8(g.index(a), opts.cornerCutting) : g.walkableMask(g.index(a));
+        EXPECT_TRUE((moves >> d) & 1u);
+        cost += (d >= kDownRight ? kCostDiagonal : kCostStraight) * (weighted ? g.cost(b) : 1);
+    }
+    return cost;
+}
+
+// come sopra, e il percorso deve andare da start a goal
+inline int pathCost(const GridMap& g, const std::vector<Cell>& path, Cell start, Cell goal, const SearchOptions& opts) {
+    EXPECT_FALSE(path.empty());
+    if (path.empty()) return -1;
+    EXPECT_TRUE(path.front() == start);
+    EXPECT_TRUE(path.back() == goal);
+    return pathCost(g, path, opts);
+}
+
+#endif //TESTHELPERS_H
@@ -1,10 +1,14 @@
 // tests/test_astar.cpp
 #include <gtest/gtest.h>
+#include <climits>
+#include <bit>
 #include <cmath>
+#include <random>
 
 #include "taikutsu/core/AStar.h"
 #include "taikutsu/core/GridMap.h"
 #include "taikutsu/core/Types.h"
+#include "TestHelpers.h"
 
 // ===================== helpers =====================
 
@@ -12,38 +16,34 @@ static int manhattan(Cell a, Cell b) { //manhattan 4 direzioni
     return std::abs(a.x - b.x) + std::abs(a.y - b.y);
 }
 
-// controlla se il path non è vuoto, va da start a goal,
-//tutte le celle sono all'interno del grid e walkable e uso corretto di manhattan
-static void assertValidPath(const GridMap& g,
-                            const std::vector<Cell>& path,
-                            Cell start,
-                            Cell goal) {
-    ASSERT_FALSE(path.empty());
-    EXPECT_TRUE(path.front() == start);
-    EXPECT_TRUE(path.back() == goal);
-
-    for (size_t i = 0; i < path.size(); ++i) {
-        const Cell c = path[i];
-        EXPECT_TRUE(g.inBounds(c)) << "Cell out of bounds: (" << c.x << "," << c.y << ")";
-        EXPECT_TRUE(g.isWalkable(c)) << "Cell not walkable: (" << c.x << "," << c.y << ")";
-
-        if (i > 0) {
-            const Cell prev = path[i - 1];
-            EXPECT_EQ(manhattan(prev, c), 1)
-                << "Non-4-neighbor step from (" << prev.x << "," << prev.y << ") to ("
-                << c.x << "," << c.y << ")";
-        }
+// le stesse prove girano contro entrambe le API:
+// - Static: AStarPathfinder::findPath(grid, s, t) (wrapper stateless)
+// - Context: findPath(ctx, grid, s, t) con un AStarSearchContext riusato tra le query
+enum class Api { Static, Context };
+
+class AStar : public ::testing::TestWithParam<Api> {
+protected:
+    AStarResult find(const GridMap& g, Cell s, Cell t) {
+        if (GetParam() == Api::Static) return AStarPathfinder::findPath(g, s, t);
+        return AStarPathfinder::findPath(ctx_, g, s, t); // copia del risultato interno al ctx
     }
-}
+
+    AStarResult find(const GridMap& g, Cell s, Cell t, const SearchOptions& opts) {
+        if (GetParam() == Api::Static) return AStarPathfinder::findPath(g, s, t, opts);
+        return AStarPathfinder::findPath(ctx_, g, s, t, opts);
+    }
+
+    AStarSearchContext ctx_; // condiviso tra le query dello stesso test
+};
 
 // ===================== tests =====================
 
 //1.Test start=goal
-TEST(AStar, StartEqualsGoal_ReturnsSingleCellPath) {
+TEST_P(AStar, StartEqualsGoal_ReturnsSingleCellPath) {
     GridMap g(5, 5);
     Cell s{2, 2};
 
-    AStarResult res = AStarPathfinder::findPath(g, s, s);
+    AStarResult res = find(g, s, s);
 
     EXPECT_TRUE(res.success);
     ASSERT_EQ(res.path.size(), 1u);
@@ -52,12 +52,12 @@ TEST(AStar, StartEqualsGoal_ReturnsSingleCellPath) {
 }
 
 //2.Test grid vuoto
-TEST(AStar, EmptyGrid_ShortestPathLengthIsManhattanPlusOne) {
+TEST_P(AStar, EmptyGrid_ShortestPathLengthIsManhattanPlusOne) {
     GridMap g(6, 6);
     Cell s{0, 0};
     Cell t{5, 3};
 
-    AStarResult res = AStarPathfinder::findPath(g, s, t);
+    AStarResult res = find(g, s, t);
 
     EXPECT_TRUE(res.success);
     assertValidPath(g, res.path, s, t);
@@ -67,7 +67,7 @@ TEST(AStar, EmptyGrid_ShortestPathLengthIsManhattanPlusOne) {
 }
 
 //test ostacolo semplice
-TEST(AStar, BlockedCells_ForceDetourPathIsLongerThanManhattan) {
+TEST_P(AStar, BlockedCells_ForceDetourPathIsLongerThanManhattan) {
     GridMap g(6, 3);
     Cell s{0, 1};
     Cell t{5, 1};
@@ -76,7 +76,7 @@ TEST(AStar, BlockedCells_ForceDetourPathIsLongerThanManhattan) {
     g.setBlocked(Cell{2, 1}, true);
     g.setBlocked(Cell{3, 1}, true);
 
-    AStarResult res = AStarPathfinder::findPath(g, s, t);
+    AStarResult res = find(g, s, t);
 
     EXPECT_TRUE(res.success);
     assertValidPath(g, res.path, s, t);
@@ -85,7 +85,7 @@ TEST(AStar, BlockedCells_ForceDetourPathIsLongerThanManhattan) {
     EXPECT_GT(static_cast<int>(res.path.size()), minCells);
 }
 //4.Test parete verticale
-TEST(AStar, NoPath_WhenVerticalWallSplitsGrid) {
+TEST_P(AStar, NoPath_WhenVerticalWallSplitsGrid) {
     GridMap g(6, 3);
     Cell s{1, 1};
     Cell t{5, 1};
@@ -95,14 +95,14 @@ TEST(AStar, NoPath_WhenVerticalWallSplitsGrid) {
         g.setBlocked(Cell{3, y}, true);
     }
 
-    AStarResult res = AStarPathfinder::findPath(g, s, t);
+    AStarResult res = find(g, s, t);
 
     EXPECT_FALSE(res.success);
     EXPECT_TRUE(res.path.empty());
 }
 
 //5.Test start o goal bloccati
-TEST(AStar, StartOrGoalBlocked_ReturnsFailure) {
+TEST_P(AStar, StartOrGoalBlocked_ReturnsFailure) {
     GridMap g(5, 5);
     Cell s{0, 0};
     Cell t{4, 4};
@@ -110,7 +110,7 @@ TEST(AStar, StartOrGoalBlocked_ReturnsFailure) {
     // start bloccato
     g.setBlocked(s, true);
     {
-        AStarResult res = AStarPathfinder::findPath(g, s, t);
+        AStarResult res = find(g, s, t);
         EXPECT_FALSE(res.success);
         EXPECT_TRUE(res.path.empty());
     }
@@ -119,33 +119,33 @@ TEST(AStar, StartOrGoalBlocked_ReturnsFailure) {
     g.setBlocked(s, false);
     g.setBlocked(t, true);
     {
-        AStarResult res = AStarPathfinder::findPath(g, s, t);
+        AStarResult res = find(g, s, t);
         EXPECT_FALSE(res.success);
         EXPECT_TRUE(res.path.empty());
     }
 }
 
 //6.Test coordinate invalide (offbounds) di start o goal
-TEST(AStar, StartOrGoalOutOfBounds_ReturnsFailure) {
+TEST_P(AStar, StartOrGoalOutOfBounds_ReturnsFailure) {
     GridMap g(5, 5);
 
     // start fuori bound
     {
-        AStarResult res = AStarPathfinder::findPath(g, Cell{-1, 0}, Cell{2, 2});
+        AStarResult res = find(g, Cell{-1, 0}, Cell{2, 2});
         EXPECT_FALSE(res.success);
         EXPECT_TRUE(res.path.empty());
     }
 
     // goal fuori bound
     {
-        AStarResult res = AStarPathfinder::findPath(g, Cell{0, 0}, Cell{99, 2});
+        AStarResult res = find(g, Cell{0, 0}, Cell{99, 2});
         EXPECT_FALSE(res.success);
         EXPECT_TRUE(res.path.empty());
     }
 }
 
 //7. ostacoli vari sul grid con possibilità di costruzione path
-TEST(AStar, PathNeverStepsOnObstacles) {
+TEST_P(AStar, PathNeverStepsOnObstacles) {
     GridMap g(8, 8);
     Cell s{0, 0};
     Cell t{7, 7};
@@ -158,8 +158,294 @@ TEST(AStar, PathNeverStepsOnObstacles) {
     g.setBlocked(Cell{4, 3}, true);
     g.setBlocked(Cell{4, 4}, true);
 
-    AStarResult res = AStarPathfinder::findPath(g, s, t);
+    AStarResult res = find(g, s, t);
 
     EXPECT_TRUE(res.success);
     assertValidPath(g, res.path, s, t);
 }
+
+//8. lo stesso contesto riusato su grid diversi e query ripetute deve dare gli stessi risultati
+TEST_P(AStar, ReusedContext_MatchesFreshSearchAcrossQueries) {
+    GridMap small(4, 4);
+    GridMap big(12, 9);
+    for (int y = 1; y < 8; ++y) big.setBlocked(Cell{6, y}, true);
+
+    for (int round = 0; round < 3; ++round) {
+        AStarResult a = find(big, Cell{0, 4}, Cell{11, 4});
+        EXPECT_TRUE(a.success);
+        assertValidPath(big, a.path, Cell{0, 4}, Cell{11, 4});
+        EXPECT_EQ(a.path.size(), AStarPathfinder::findPath(big, Cell{0, 4}, Cell{11, 4}).path.size());
+
+        AStarResult b = find(small, Cell{0, 0}, Cell{3, 3});
+        EXPECT_TRUE(b.success);
+        EXPECT_EQ(static_cast<int>(b.path.size()), manhattan(Cell{0, 0}, Cell{3, 3}) + 1);
+    }
+}
+
+
+// ===================== terreno pesato e 8 direzioni =====================
+
+// Dijkstra di riferimento (lento ma ovvio) con le stesse regole di movimento/costo di A*
+static int referenceCost(const GridMap& g, Cell s, Cell t, bool eight) {
+    const int n = g.width() * g.height();
+    std::vector<int> dist(static_cast<size_t>(n), INT_MAX);
+    std::vector<bool> done(static_cast<size_t>(n), false);
+    auto id = [&](Cell c) { return static_cast<size_t>(c.y * g.width() + c.x); };
+    dist[id(s)] = 0;
+
+    for (;;) {
+        int best = -1;
+        for (int i = 0; i < n; ++i)
+            if (!done[static_cast<size_t>(i)] && dist[static_cast<size_t>(i)] != INT_MAX &&
+                (best < 0 || dist[static_cast<size_t>(i)] < dist[static_cast<size_t>(best)])) best = i;
+        if (best < 0) return -1;
+        const Cell c{best % g.width(), best / g.width()};
+        if (c == t) return dist[id(c)];
+        done[id(c)] = true;
+
+        for (int d = 0; d < (eight ? 8 : 4); ++d) {
+            const Cell nb{c.x + kDirDx[d], c.y + kDirDy[d]};
+            if (!g.isWalkable(nb)) continue;
+            // diagonale: niente corner-cutting
+            if (d >= 4 && (!g.isWalkable(Cell{nb.x, c.y}) || !g.isWalkable(Cell{c.x, nb.y}))) continue;
+            const int step = (d >= 4 ? kCostDiagonal : kCostStraight) * g.cost(nb);
+            dist[id(nb)] = std::min(dist[id(nb)], dist[id(c)] + step);
+        }
+    }
+}
+
+//9. il terreno costoso viene aggirato: path più lungo ma costo minore
+TEST_P(AStar, WeightedTerrain_AvoidsExpensiveCells) {
+    GridMap g(7, 5);
+    for (int y = 0; y < 4; ++y) g.setCost(Cell{3, y}, 20); // "fango" su quasi tutta la colonna 3
+    ASSERT_TRUE(g.hasCosts());
+
+    const Cell s{0, 0};
+    const Cell t{6, 0};
+    AStarResult res = find(g, s, t);
+
+    ASSERT_TRUE(res.success);
+    assertValidPath(g, res.path, s, t);
+    EXPECT_EQ(res.cost, referenceCost(g, s, t, false));
+    EXPECT_GT(static_cast<int>(res.path.size()), manhattan(s, t) + 1); // passa dalla riga 4
+
+    SearchOptions unit;
+    unit.useTerrainCost = false;
+    EXPECT_EQ(AStarPathfinder::findPath(g, s, t, unit).cost, manhattan(s, t) * kCostStraight);
+}
+
+//10. 8 direzioni: diagonali con costo octile e senza tagliare gli angoli
+TEST_P(AStar, EightConnected_UsesDiagonalsWithoutCornerCutting) {
+    GridMap g(5, 5);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+
+    AStarResult open = AStarPathfinder::findPath(g, Cell{0, 0}, Cell{4, 4}, opts);
+    ASSERT_TRUE(open.success);
+    EXPECT_EQ(open.path.size(), 5u);
+    EXPECT_EQ(open.cost, 4 * kCostDiagonal);
+
+    // due ostacoli in diagonale: senza corner-cutting non si passa "in mezzo"
+    GridMap corner(2, 2);
+    corner.setBlocked(Cell{1, 0}, true);
+    corner.setBlocked(Cell{0, 1}, true);
+    EXPECT_FALSE(AStarPathfinder::findPath(corner, Cell{0, 0}, Cell{1, 1}, opts).success);
+
+    // un solo ostacolo: con cornerCutting=true la diagonale è permessa
+    corner.setBlocked(Cell{0, 1}, false);
+    EXPECT_EQ(AStarPathfinder::findPath(corner, Cell{0, 0}, Cell{1, 1}, opts).path.size(), 3u);
+    opts.cornerCutting = true;
+    EXPECT_EQ(AStarPathfinder::findPath(corner, Cell{0, 0}, Cell{1, 1}, opts).path.size(), 2u);
+}
+
+//11. mappe casuali pesate: costo ottimo (== Dijkstra) in 4 e 8 direzioni
+TEST_P(AStar, RandomWeightedMaps_CostMatchesDijkstra) {
+    std::mt19937 rng(11);
+    for (int map = 0; map < 20; ++map) {
+        GridMap g(16, 12);
+        std::bernoulli_distribution blocked(0.2);
+        std::uniform_int_distribution<int> cost(1, 9);
+        for (int y = 0; y < g.height(); ++y) {
+            for (int x = 0; x < g.width(); ++x) {
+                g.setBlocked(Cell{x, y}, blocked(rng));
+                g.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+            }
+        }
+
+        for (bool eight : {false, true}) {
+            SearchOptions opts;
+            opts.connectivity = eight ? Connectivity::Eight : Connectivity::Four;
+            const Cell s{0, 0};
+            const Cell t{15, 11};
+            g.setBlocked(s, false);
+            g.setBlocked(t, false);
+
+            const AStarResult& res = (GetParam() == Api::Static) ? AStarPathfinder::findPath(g, s, t, opts)
+                                                                 : AStarPathfinder::findPath(ctx_, g, s, t, opts);
+            const int expected = referenceCost(g, s, t, eight);
+            EXPECT_EQ(res.success, expected >= 0);
+            if (res.success) {
+                EXPECT_EQ(res.cost, expected) << "map " << map << " eight " << eight;
+            }
+        }
+    }
+}
+
+//12. heap binario, heap 4-ario indicizzato e radix queue: stesso costo ottimo
+TEST_P(AStar, RandomMaps_AllOpenListsFindSameCost) {
+    std::mt19937 rng(12);
+    for (int map = 0; map < 15; ++map) {
+        GridMap g(40, 30);
+        std::bernoulli_distribution blocked(0.25);
+        std::uniform_int_distribution<int> cost(1, 6);
+        for (int y = 0; y < g.height(); ++y) {
+            for (int x = 0; x < g.width(); ++x) {
+                g.setBlocked(Cell{x, y}, blocked(rng));
+                if (map % 2 == 1) g.setCost(Cell{x, y}, static_cast<std::uint8_t>(cost(rng)));
+            }
+        }
+
+        std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+        for (int q = 0; q < 10; ++q) {
+            const Cell s{rx(rng), ry(rng)};
+            const Cell t{rx(rng), ry(rng)};
+            for (bool eight : {false, true}) {
+                SearchOptions opts;
+                opts.connectivity = eight ? Connectivity::Eight : Connectivity::Four;
+                const AStarResult binary = AStarPathfinder::findPath(g, s, t, opts);
+
+                for (OpenListKind kind : {OpenListKind::IndexedHeap, OpenListKind::Radix}) {
+                    opts.openList = kind;
+                    const AStarResult& res = (GetParam() == Api::Static) ? AStarPathfinder::findPath(g, s, t, opts)
+                                                                         : AStarPathfinder::findPath(ctx_, g, s, t, opts);
+                    ASSERT_EQ(res.success, binary.success);
+                    EXPECT_EQ(res.cost, binary.cost) << "map " << map << " kind " << static_cast<int>(kind);
+                }
+            }
+        }
+    }
+}
+
+//13. closed set: spento di default (solo il conteggio), lista o bitmap su richiesta; path identico
+TEST_P(AStar, ClosedRecording_NoneListBitmapAgree) {
+    GridMap g(40, 30);
+    g.fillRect(Cell{20, 0}, 1, 25, true);
+    const Cell s{2, 3}, t{37, 4};
+
+    const AStarResult none = find(g, s, t);
+    ASSERT_TRUE(none.success);
+    EXPECT_TRUE(none.closed.empty());
+    EXPECT_TRUE(none.closedBits.empty());
+    EXPECT_GT(none.expanded, 0u);
+    EXPECT_EQ(none.pathLength, none.path.size());
+
+    SearchOptions opts;
+    opts.recordClosed = ClosedRecording::List;
+    const AStarResult list = find(g, s, t, opts);
+    EXPECT_EQ(list.path, none.path);
+    EXPECT_EQ(list.closed.size(), none.expanded);
+
+    opts.recordClosed = ClosedRecording::Bitmap;
+    const AStarResult bits = find(g, s, t, opts);
+    EXPECT_EQ(bits.path, none.path);
+    EXPECT_TRUE(bits.closed.empty());
+    size_t set = 0;
+    for (const std::uint64_t w : bits.closedBits) set += static_cast<size_t>(std::popcount(w));
+    EXPECT_EQ(set, none.expanded);
+    for (const Cell c : list.closed) EXPECT_TRUE(bits.closedAt(g, c));
+    EXPECT_FALSE(bits.closedAt(g, Cell{20, 0})); // ostacolo: mai espanso
+
+    // query successiva più corta: nessun bit rimasto dalla precedente
+    const AStarResult again = find(g, Cell{30, 20}, Cell{33, 20}, opts);
+    set = 0;
+    for (const std::uint64_t w : again.closedBits) set += static_cast<size_t>(std::popcount(w));
+    EXPECT_EQ(set, again.expanded);
+    EXPECT_FALSE(again.closedAt(g, s));
+}
+
+//14. percorso nel buffer o nello span del chiamante: result.path resta vuoto, pathLength dice quanto serve
+TEST_P(AStar, PathOutput_CallerBufferAndSpan) {
+    GridMap g(30, 20);
+    g.fillRect(Cell{10, 2}, 1, 18, true);
+    const Cell s{1, 10}, t{28, 15};
+    const AStarResult ref = find(g, s, t);
+    ASSERT_TRUE(ref.success);
+
+    std::vector<Cell> buffer{Cell{99, 99}}; // contenuto vecchio: sostituito
+    SearchOptions opts;
+    opts.output.buffer = &buffer;
+    const AStarResult viaBuffer = find(g, s, t, opts);
+    EXPECT_TRUE(viaBuffer.path.empty());
+    EXPECT_EQ(buffer, ref.path);
+    EXPECT_EQ(viaBuffer.pathLength, ref.path.size());
+
+    std::vector<Cell> storage(ref.path.size() + 5, Cell{-1, -1});
+    opts.output.span = std::span<Cell>(storage); // precedenza sul buffer
+    const AStarResult viaSpan = find(g, s, t, opts);
+    EXPECT_TRUE(viaSpan.success);
+    EXPECT_EQ(viaSpan.pathLength, ref.path.size());
+    EXPECT_TRUE(std::equal(ref.path.begin(), ref.path.end(), storage.begin()));
+    EXPECT_TRUE(storage.back() == (Cell{-1, -1}));
+
+    // span troppo corto: non toccato, success resta vero
+    std::vector<Cell> small(3, Cell{-1, -1});
+    opts.output.span = std::span<Cell>(small);
+    const AStarResult truncated = find(g, s, t, opts);
+    EXPECT_TRUE(truncated.success);
+    EXPECT_EQ(truncated.pathLength, ref.path.size());
+    EXPECT_TRUE(small.front() == (Cell{-1, -1}));
+
+    // nessun percorso: il buffer viene svuotato
+    opts.output.span = {};
+    g.fillRect(Cell{10, 0}, 1, 2, true);
+    EXPECT_FALSE(find(g, s, t, opts).success);
+    EXPECT_TRUE(buffer.empty());
+}
+
+//15. waypoint: start, svolte e goal; ripercorrendo i tratti dritti/diagonali si ottiene il path completo
+TEST_P(AStar, Waypoints_ExpandBackToFullPath) {
+    std::mt19937 rng(17);
+    for (int map = 0; map < 4; ++map) {
+        GridMap g(50, 40);
+        std::bernoulli_distribution blocked(0.2);
+        for (int y = 0; y < 40; ++y)
+            for (int x = 0; x < 50; ++x) g.setBlocked(Cell{x, y}, blocked(rng));
+        std::uniform_int_distribution<int> rx(0, 49), ry(0, 39);
+        for (int q = 0; q < 10; ++q) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            SearchOptions opts;
+            opts.connectivity = map % 2 ? Connectivity::Eight : Connectivity::Four;
+            const AStarResult full = find(g, s, t, opts);
+            opts.output.format = PathFormat::Waypoints;
+            const AStarResult wp = find(g, s, t, opts);
+            ASSERT_EQ(wp.success, full.success);
+            if (!full.success) continue;
+            EXPECT_EQ(wp.cost, full.cost);
+            EXPECT_EQ(wp.pathLength, wp.path.size());
+            ASSERT_FALSE(wp.path.empty());
+            EXPECT_TRUE(wp.path.front() == s);
+            EXPECT_TRUE(wp.path.back() == t);
+
+            std::vector<Cell> expanded{wp.path.front()};
+            int pdx = 0, pdy = 0;
+            for (size_t i = 1; i < wp.path.size(); ++i) {
+                const Cell a = wp.path[i - 1], b = wp.path[i];
+                const int dx = (b.x > a.x) - (b.x < a.x), dy = (b.y > a.y) - (b.y < a.y);
+                ASSERT_TRUE(a.x == b.x || a.y == b.y || std::abs(b.x - a.x) == std::abs(b.y - a.y));
+                EXPECT_FALSE(dx == pdx && dy == pdy) << "waypoint senza svolta";
+                pdx = dx;
+                pdy = dy;
+                for (Cell c = a; !(c == b);) {
+                    c = Cell{c.x + dx, c.y + dy};
+                    expanded.push_back(c);
+                }
+            }
+            EXPECT_EQ(expanded, full.path);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Api, AStar, ::testing::Values(Api::Static, Api::Context),
+                         [](const ::testing::TestParamInfo<Api>& info) {
+                             return info.param == Api::Static ? "Static" : "Context";
+                         });
@@ -0,0 +1,85 @@
+// tests/test_batch.cpp
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+
+#include "taikutsu/core/PathBatch.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+static std::vector<PathRequest> randomRequests(const GridMap& g, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    std::vector<PathRequest> out;
+    for (int i = 0; i < count; ++i) out.push_back({Cell{rx(rng), ry(rng)}, Cell{rx(rng), ry(rng)}});
+    return out;
+}
+
+// ===================== tests =====================
+
+//1. tutti i task vengono eseguiti, anche quelli inviati da dentro un worker
+TEST(ThreadPool, RunsAllTasks_IncludingNested) {
+    ThreadPool pool(4);
+    std::atomic<int> count{0};
+    EXPECT_FALSE(pool.onWorkerThread());
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&](unsigned worker) {
+            EXPECT_LT(worker, pool.size());
+            EXPECT_TRUE(pool.onWorkerThread()); // qui PathBatch::run / wait() sarebbero deadlock
+            ++count;
+            pool.submit([&](unsigned) { ++count; });
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 200);
+}
+
+//2. il batch dà gli stessi risultati delle query sequenziali (anche riusando il buffer)
+TEST(PathBatch, MatchesSequentialFindPath) {
+    const GridMap g = randomGrid(120, 90, 0.25, 3);
+    const auto requests = randomRequests(g, 300, 7);
+
+    ThreadPool pool(4);
+    PathBatch batch(pool);
+    std::vector<AStarResult> results(requests.size());
+
+    for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+        SearchOptions opts;
+        opts.connectivity = c;
+        batch.run(g, requests, results, opts);
+
+        AStarSearchContext ctx;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const AStarResult& ref = AStarPathfinder::findPath(ctx, g, requests[i].start, requests[i].goal, opts);
+            ASSERT_EQ(results[i].success, ref.success) << "query " << i;
+            EXPECT_EQ(results[i].cost, ref.cost) << "query " << i;
+            EXPECT_EQ(results[i].path, ref.path) << "query " << i;
+            EXPECT_TRUE(results[i].closed.empty());
+        }
+    }
+
+    // stesso batch di nuovo: i percorsi vengono scritti al loro posto, senza riallocare
+    std::vector<const Cell*> before;
+    for (const AStarResult& r : results) before.push_back(r.path.data());
+    SearchOptions eight;
+    eight.connectivity = Connectivity::Eight;
+    batch.run(g, requests, results, eight);
+    for (size_t i = 0; i < results.size(); ++i) EXPECT_EQ(results[i].path.data(), before[i]) << "query " << i;
+}
+
+//3. batch vuoto e pool con un solo worker
+TEST(PathBatch, EmptyAndSingleWorker) {
+    GridMap g(10, 10);
+    ThreadPool pool(1);
+    PathBatch batch(pool);
+
+    batch.run(g, {}, {});
+
+    const std::vector<PathRequest> requests{{Cell{0, 0}, Cell{9, 9}}, {Cell{0, 0}, Cell{20, 20}}};
+    std::vector<AStarResult> results(2);
+    batch.run(g, requests, results);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_EQ(results[0].path.size(), 19u);
+    EXPECT_FALSE(results[1].success);
+}
@@ -0,0 +1,194 @@
+// tests/test_bidirectional.cpp
+#include <gtest/gtest.h>
+#include <bit>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/BidirectionalAStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// query sempre a due lati (soglia 0) confrontate con A* unidirezionale
+static void expectSameCosts(const GridMap& g, const SearchOptions& opts, int queries, unsigned seed) {
+    const std::vector<Cell> cells = freeCells(g, 2 * queries, seed);
+    AStarSearchContext ref;
+    BidirectionalSearchContext ctx(0);
+    for (int i = 0; i < queries; ++i) {
+        const Cell s = cells[static_cast<size_t>(2 * i)], t = cells[static_cast<size_t>(2 * i + 1)];
+        const AStarResult& a = AStarPathfinder::findPath(ref, g, s, t, opts);
+        const AStarResult& b = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+        ASSERT_EQ(b.success, a.success) << s.x << "," << s.y << " -> " << t.x << "," << t.y;
+        ASSERT_EQ(b.cost, a.cost) << s.x << "," << s.y << " -> " << t.x << "," << t.y;
+        if (!b.success) continue;
+        ASSERT_TRUE(b.path.front() == s);
+        ASSERT_TRUE(b.path.back() == t);
+        EXPECT_EQ(pathCost(g, b.path, opts), b.cost);
+        EXPECT_EQ(b.pathLength, b.path.size());
+    }
+}
+
+// ===================== tests =====================
+
+//1. mappe casuali (densità, terreno, 4/8 direzioni, corner-cutting): stesso esito e stesso
+//   costo di AStarPathfinder, percorso valido
+TEST(BidirectionalAStar, MatchesUnidirectional_RandomMaps) {
+    unsigned seed = 110;
+    for (const double density : {0.15, 0.3, 0.4}) {
+        GridMap g = makeRandomMap(72, 56, density, ++seed);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> rx(0, 71), ry(0, 55), rc(1, 8);
+        if (density > 0.2)
+            for (int i = 0; i < 800; ++i) g.setCost(Cell{rx(rng), ry(rng)}, static_cast<std::uint8_t>(rc(rng)));
+        for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+            for (const bool cut : {false, true}) {
+                if (conn == Connectivity::Four && cut) continue;
+                SearchOptions opts;
+                opts.connectivity = conn;
+                opts.cornerCutting = cut;
+                expectSameCosts(g, opts, 60, ++seed);
+                opts.useTerrainCost = false;
+                expectSameCosts(g, opts, 30, ++seed);
+            }
+        }
+    }
+    SearchOptions octile4; // Octile con 4 direzioni: ammissibile, solo meno informata
+    octile4.heuristic = HeuristicKind::Octile;
+    expectSameCosts(makeMazeMap(64, 64, 2, 120), octile4, 40, 121);
+}
+
+//2. nessun percorso: regioni separate (con e senza ConnectivityIndex), celle bloccate o fuori
+TEST(BidirectionalAStar, NoPath) {
+    GridMap g(60, 40);
+    g.fillRect(Cell{30, 0}, 1, 40, true); // muro: due metà
+    const ConnectivityIndex cc(g);
+    BidirectionalSearchContext ctx(0);
+    SearchOptions opts;
+    opts.recordClosed = ClosedRecording::List;
+    const AStarResult& r = BidirectionalAStar::findPath(ctx, g, Cell{2, 20}, Cell{55, 20}, opts);
+    EXPECT_FALSE(r.success);
+    EXPECT_TRUE(r.path.empty());
+    EXPECT_GT(r.expanded, 0u); // un lato ha esaurito la sua metà
+    EXPECT_EQ(r.closed.size(), r.expanded);
+
+    opts.components = &cc;
+    const AStarResult& fast = BidirectionalAStar::findPath(ctx, g, Cell{2, 20}, Cell{55, 20}, opts);
+    EXPECT_FALSE(fast.success);
+    EXPECT_EQ(fast.expanded, 0u);
+    EXPECT_FALSE(BidirectionalAStar::findPath(ctx, g, Cell{30, 5}, Cell{55, 20}).success);
+    EXPECT_FALSE(BidirectionalAStar::findPath(ctx, g, Cell{2, 20}, Cell{60, 20}).success);
+
+    g.setBlocked(Cell{30, 39}, false); // varco in fondo
+    const AStarResult& open = BidirectionalAStar::findPath(ctx, g, Cell{2, 20}, Cell{55, 20});
+    ASSERT_TRUE(open.success);
+    EXPECT_EQ(open.cost, AStarPathfinder::findPath(g, Cell{2, 20}, Cell{55, 20}).cost);
+}
+
+//3. query corte: A* normale (stessi nodi espansi dell'unidirezionale, nessun thread di aiuto);
+//   sopra la soglia due lati. Stesso comportamento dall'overload senza contesto
+TEST(BidirectionalAStar, ShortQueriesFallBackToSingleThread) {
+    const GridMap g = makeRoomsMap(128, 128, 16, 130);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    BidirectionalSearchContext ctx; // soglia di default
+    AStarSearchContext ref;
+    const std::vector<Cell> cells = freeCells(g, 400, 131);
+    int shortQueries = 0, longQueries = 0;
+    for (size_t i = 0; i + 1 < cells.size(); i += 2) {
+        const Cell s = cells[i], t = cells[i + 1];
+        const AStarResult& a = AStarPathfinder::findPath(ref, g, s, t, opts);
+        const AStarResult& b = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+        ASSERT_EQ(b.cost, a.cost);
+        const AStarResult once = BidirectionalAStar::findPath(g, s, t, opts);
+        ASSERT_EQ(once.cost, a.cost);
+        if (octileCost(s, t) < ctx.minParallelEstimate()) {
+            EXPECT_EQ(b.expanded, a.expanded);
+            EXPECT_EQ(once.expanded, a.expanded);
+            EXPECT_NE(&b, &ctx.result());
+            EXPECT_EQ(ctx.helperStarted(), longQueries > 0); // il thread parte con la prima query lunga
+            ++shortQueries;
+        } else {
+            EXPECT_EQ(&b, &ctx.result());
+            ++longQueries;
+        }
+    }
+    EXPECT_GT(shortQueries, 0);
+    EXPECT_GT(longQueries, 0);
+    EXPECT_TRUE(ctx.helperStarted());
+
+    // Manhattan con 8 direzioni non è ammissibile: sempre A* normale
+    opts.heuristic = HeuristicKind::Manhattan;
+    ctx.setMinParallelEstimate(0);
+    const AStarResult& m = BidirectionalAStar::findPath(ctx, g, cells[0], cells[1], opts);
+    EXPECT_NE(&m, &ctx.result());
+}
+
+//4. PathOutput e closed set come AStarPathfinder: waypoint, buffer, span troppo piccolo, bitmap
+TEST(BidirectionalAStar, PathOutputAndClosedRecording) {
+    GridMap g(80, 60);
+    g.fillRect(Cell{20, 10}, 40, 2, true);
+    g.fillRect(Cell{40, 12}, 2, 40, true);
+    const Cell s{2, 2}, t{77, 57};
+    BidirectionalSearchContext ctx(0);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    const AStarResult full = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+    ASSERT_TRUE(full.success);
+
+    std::vector<Cell> waypoints;
+    opts.output.format = PathFormat::Waypoints;
+    opts.output.buffer = &waypoints;
+    const AStarResult& w = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+    ASSERT_TRUE(w.success);
+    EXPECT_TRUE(w.path.empty());
+    ASSERT_GE(waypoints.size(), 2u);
+    EXPECT_TRUE(waypoints.front() == s);
+    EXPECT_TRUE(waypoints.back() == t);
+    EXPECT_LT(waypoints.size(), full.path.size());
+    EXPECT_EQ(w.pathLength, waypoints.size());
+    std::vector<Cell> expanded{waypoints.front()}; // tratti dritti tra i waypoint
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        Cell c = waypoints[i - 1];
+        const int sx = (waypoints[i].x > c.x) - (waypoints[i].x < c.x), sy = (waypoints[i].y > c.y) - (waypoints[i].y < c.y);
+        while (!(c == waypoints[i])) {
+            c = Cell{c.x + sx, c.y + sy};
+            expanded.push_back(c);
+        }
+    }
+    opts.output = {};
+    EXPECT_EQ(pathCost(g, expanded, opts), full.cost);
+
+    std::vector<Cell> small(3);
+    opts.output.span = small;
+    const AStarResult& tooLong = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+    EXPECT_TRUE(tooLong.success);
+    EXPECT_EQ(tooLong.pathLength, full.path.size());
+    EXPECT_TRUE(small[0] == Cell{});
+
+    opts.output = {};
+    opts.recordClosed = ClosedRecording::Bitmap;
+    const AStarResult& bits = BidirectionalAStar::findPath(ctx, g, s, t, opts);
+    size_t set = 0;
+    for (const std::uint64_t word : bits.closedBits) set += static_cast<size_t>(std::popcount(word));
+    EXPECT_GT(set, 0u);
+    EXPECT_LE(set, bits.expanded); // una cella può essere espansa da entrambi i lati
+    // un lato può finire da solo prima che l'altro parta (es. un solo core): almeno uno dei due
+    EXPECT_TRUE(bits.closedAt(g, s) || bits.closedAt(g, t));
+}
+
+//5. molte query sullo stesso contesto (generazioni, thread di aiuto riusato), anche su un
+//   labirinto dove i due lati si incontrano lontano dal centro
+TEST(BidirectionalAStar, RepeatedQueriesOnOneContext) {
+    const GridMap maze = makeMazeMap(96, 96, 1, 140);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    expectSameCosts(maze, opts, 150, 141);
+
+    GridMap weighted = makeRoomsMap(96, 96, 12, 142);
+    std::mt19937 rng(143);
+    std::uniform_int_distribution<int> r(0, 95), rc(1, 20);
+    for (int i = 0; i < 3000; ++i) weighted.setCost(Cell{r(rng), r(rng)}, static_cast<std::uint8_t>(rc(rng)));
+    expectSameCosts(weighted, opts, 150, 144);
+}
@@ -0,0 +1,173 @@
+// tests/test_chunkedgrid.cpp
+#include <gtest/gtest.h>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ChunkedAStar.h"
+#include "taikutsu/core/ChunkedGridMap.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+static void expectSameCells(const ChunkedGridMap& c, const GridMap& g) {
+    ASSERT_EQ(c.width(), g.width());
+    ASSERT_EQ(c.height(), g.height());
+    for (int y = -1; y <= g.height(); ++y)
+        for (int x = -1; x <= g.width(); ++x) ASSERT_EQ(c.isWalkable(Cell{x, y}), g.isWalkable(Cell{x, y})) << x << "," << y;
+}
+
+// ===================== tests =====================
+
+//1. conversione da/verso GridMap (dimensioni non multiple di 64) e tile canoniche
+TEST(ChunkedGridMap, FromGridMap_SameCellsAndUniformTiles) {
+    GridMap g = randomGrid(200, 150, 0.3, 1);
+    g.fillRect(Cell{0, 0}, 64, 64, false);   // tile (0,0) tutta libera
+    g.fillRect(Cell{64, 64}, 64, 64, true);  // tile (1,1) tutta bloccata
+    g.fillRect(Cell{192, 128}, 8, 22, true); // tile di bordo (3,2) bloccata (solo le celle nella mappa)
+    const ChunkedGridMap c(g);
+    expectSameCells(c, g);
+    EXPECT_EQ(c.tilesX(), 4);
+    EXPECT_EQ(c.tilesY(), 3);
+    EXPECT_EQ(c.tileState(0, 0), ChunkedGridMap::TileState::Free);
+    EXPECT_EQ(c.tileState(1, 1), ChunkedGridMap::TileState::Blocked);
+    EXPECT_EQ(c.tileState(3, 2), ChunkedGridMap::TileState::Blocked);
+    EXPECT_EQ(c.tileState(2, 0), ChunkedGridMap::TileState::Mixed);
+    EXPECT_EQ(c.mixedTileCount(), 9u);
+
+    const GridMap back = c.window(Cell{0, 0}, 200, 150);
+    for (int y = 0; y < 150; ++y)
+        for (int x = 0; x < 200; ++x) ASSERT_EQ(back.isWalkable(Cell{x, y}), g.isWalkable(Cell{x, y}));
+    // finestra sporgente: fuori mappa = bloccato
+    const GridMap win = c.window(Cell{-10, 140}, 40, 20);
+    EXPECT_FALSE(win.isWalkable(Cell{5, 0}));
+    EXPECT_EQ(win.isWalkable(Cell{10, 0}), g.isWalkable(Cell{0, 140}));
+    EXPECT_FALSE(win.isWalkable(Cell{15, 15}));
+}
+
+//2. modifiche: stesse celle di un GridMap con le stesse operazioni; le tile tornate uniformi
+//   rilasciano il payload (e lo slot viene riusato)
+TEST(ChunkedGridMap, Edits_MatchGridMapAndCollapse) {
+    GridMap g(300, 130);
+    ChunkedGridMap c(300, 130);
+    EXPECT_EQ(c.mixedTileCount(), 0u);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> rx(-5, 304), ry(-5, 134), rs(1, 90);
+    for (int i = 0; i < 3000; ++i) {
+        const Cell p{rx(rng), ry(rng)};
+        switch (rng() % 4) {
+            case 0: g.setBlocked(p, true); c.setBlocked(p, true); break;
+            case 1: g.setBlocked(p, false); c.setBlocked(p, false); break;
+            case 2: g.toggleBlocked(p); c.toggleBlocked(p); break;
+            default: {
+                const int w = rs(rng), h = rs(rng);
+                const bool b = rng() % 2;
+                g.fillRect(p, w, h, b);
+                c.fillRect(p, w, h, b);
+            }
+        }
+    }
+    expectSameCells(c, g);
+
+    // una cella bloccata in una tile libera: tile mista; sbloccata: di nuovo uniforme
+    c.clear();
+    EXPECT_EQ(c.mixedTileCount(), 0u);
+    c.setBlocked(Cell{70, 70}, true);
+    EXPECT_EQ(c.tileStateAt(Cell{70, 70}), ChunkedGridMap::TileState::Mixed);
+    EXPECT_EQ(c.mixedTileCount(), 1u);
+    c.toggleBlocked(Cell{70, 70});
+    EXPECT_EQ(c.tileStateAt(Cell{70, 70}), ChunkedGridMap::TileState::Free);
+    EXPECT_EQ(c.mixedTileCount(), 0u);
+    // fillRect che copre la tile intera: nessun payload
+    c.fillRect(Cell{64, 0}, 64, 64, true);
+    EXPECT_EQ(c.tileState(1, 0), ChunkedGridMap::TileState::Blocked);
+    EXPECT_EQ(c.mixedTileCount(), 0u);
+}
+
+//3. mask dei vicini identiche a quelle di GridMap, anche ai bordi delle tile e della mappa
+TEST(ChunkedGridMap, Masks_MatchGridMap) {
+    GridMap g = randomGrid(140, 70, 0.35, 3);
+    g.fillRect(Cell{64, 0}, 64, 64, false);
+    const ChunkedGridMap c(g);
+    for (int y = 0; y < 70; ++y) {
+        for (int x = 0; x < 140; ++x) {
+            const Cell p{x, y};
+            ASSERT_EQ(c.walkableMask8(p), g.walkableMask8(g.index(p))) << x << "," << y;
+            ASSERT_EQ(c.moveMask8(p, false), g.moveMask8(g.index(p), false));
+            ASSERT_EQ(c.moveMask8(p, true), g.moveMask8(g.index(p), true));
+            ASSERT_EQ(c.neighbors4(p), g.neighbors4(p));
+        }
+    }
+}
+
+//4. ChunkedAStar == AStarPathfinder (costo ed espansioni) con 4/8 direzioni e corner-cutting
+TEST(ChunkedAStar, MatchesAStarPathfinder) {
+    GridMap g = randomGrid(180, 120, 0.3, 4);
+    g.fillRect(Cell{20, 20}, 100, 70, false);
+    const ChunkedGridMap c(g);
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> rx(0, 179), ry(0, 119);
+    ChunkedSearchContext cctx;
+    AStarSearchContext actx;
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        for (const bool cut : {false, true}) {
+            SearchOptions opts;
+            opts.connectivity = conn;
+            opts.cornerCutting = cut;
+            for (int i = 0; i < 60; ++i) {
+                const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+                const AStarResult& ref = AStarPathfinder::findPath(actx, g, s, t, opts);
+                const AStarResult& r = ChunkedAStar::findPath(cctx, c, s, t, opts);
+                ASSERT_EQ(r.success, ref.success);
+                EXPECT_EQ(r.cost, ref.cost);
+                EXPECT_EQ(r.expanded, ref.expanded); // stesso ordine di espansione
+                EXPECT_EQ(r.path, ref.path);
+            }
+        }
+    }
+    SearchOptions list;
+    list.recordClosed = ClosedRecording::List;
+    list.connectivity = Connectivity::Eight;
+    const AStarResult r = ChunkedAStar::findPath(c, Cell{20, 20}, Cell{20, 20}, list);
+    const AStarResult ref = AStarPathfinder::findPath(g, Cell{20, 20}, Cell{20, 20}, list);
+    EXPECT_TRUE(r.success);
+    EXPECT_EQ(r.path.size(), 1u);
+    EXPECT_EQ(r.closed, ref.closed); // start == goal: nessuna espansione, come AStarPathfinder
+    EXPECT_EQ(r.expanded, ref.expanded);
+    const AStarResult far = ChunkedAStar::findPath(c, Cell{20, 20}, Cell{110, 80}, list);
+    EXPECT_EQ(far.closed, AStarPathfinder::findPath(g, Cell{20, 20}, Cell{110, 80}, list).closed);
+
+    // percorso nel buffer del chiamante, anche a waypoint
+    std::vector<Cell> buffer, refBuffer;
+    SearchOptions out;
+    out.output.format = PathFormat::Waypoints;
+    out.output.buffer = &refBuffer;
+    AStarPathfinder::findPath(g, Cell{20, 20}, Cell{110, 25}, out);
+    out.output.buffer = &buffer;
+    const AStarResult w = ChunkedAStar::findPath(c, Cell{20, 20}, Cell{110, 25}, out);
+    ASSERT_TRUE(w.success);
+    EXPECT_TRUE(w.path.empty());
+    EXPECT_EQ(w.pathLength, buffer.size());
+    EXPECT_EQ(buffer, refBuffer);
+}
+
+//5. mondo oltre i limiti di GridMap: memoria proporzionale al dettaglio, indici a 64 bit
+TEST(ChunkedAStar, HugeSparseWorld) {
+    constexpr int kSide = 100000; // 10^10 celle: GridMap non ci sta
+    EXPECT_FALSE(GridMap::fits(kSide, kSide));
+    EXPECT_TRUE(GridMap::fits(4000, 4000));
+    ChunkedGridMap c(kSide, kSide);
+    // un muro con un varco vicino al fondo, lontano dall'origine
+    c.fillRect(Cell{99000, 0}, 3, 99900, true);
+    EXPECT_LT(c.memoryBytes(), size_t{16} << 20); // directory (~9.5 MB) + tile del bordo
+    EXPECT_EQ(c.index(Cell{kSide - 1, kSide - 1}), std::int64_t{kSide} * kSide - 1);
+    EXPECT_TRUE(c.cellAt(c.index(Cell{kSide - 1, kSide - 2})) == (Cell{kSide - 1, kSide - 2}));
+
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    const AStarResult r = ChunkedAStar::findPath(c, Cell{98990, 99800}, Cell{99010, 99800}, opts);
+    ASSERT_TRUE(r.success);
+    EXPECT_EQ(r.path.front(), (Cell{98990, 99800}));
+    EXPECT_EQ(r.path.back(), (Cell{99010, 99800}));
+    for (const Cell& p : r.path) EXPECT_TRUE(c.isWalkable(p));
+    EXPECT_GE(r.path.size(), 101u); // deve scendere fino al varco (y >= 99900)
+}
@@ -0,0 +1,135 @@
+// tests/test_connectivity.cpp
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/JumpPoint.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// etichette di riferimento: flood fill a 4 direzioni (0 = ostacolo)
+static std::vector<int> floodLabels(const GridMap& g) {
+    std::vector<int> label(static_cast<size_t>(g.width() * g.height()), 0);
+    int next = 0;
+    for (int y = 0; y < g.height(); ++y) {
+        for (int x = 0; x < g.width(); ++x) {
+            if (!g.isWalkable(Cell{x, y}) || label[static_cast<size_t>(y * g.width() + x)] != 0) continue;
+            ++next;
+            std::vector<Cell> stack{Cell{x, y}};
+            label[static_cast<size_t>(y * g.width() + x)] = next;
+            while (!stack.empty()) {
+                const Cell c = stack.back();
+                stack.pop_back();
+                for (const Cell& nb : g.neighbors4(c)) {
+                    int& l = label[static_cast<size_t>(nb.y * g.width() + nb.x)];
+                    if (l == 0) {
+                        l = next;
+                        stack.push_back(nb);
+                    }
+                }
+            }
+        }
+    }
+    return label;
+}
+
+// stessa partizione: due celle hanno lo stesso id nell'indice sse hanno la stessa etichetta
+static void expectSamePartition(const GridMap& g, const ConnectivityIndex& index) {
+    const std::vector<int> ref = floodLabels(g);
+    std::vector<std::uint32_t> idOf(ref.size() + 1, 0); // etichetta di riferimento -> id dell'indice
+    int refCount = 0;
+    for (int y = 0; y < g.height(); ++y) {
+        for (int x = 0; x < g.width(); ++x) {
+            const int l = ref[static_cast<size_t>(y * g.width() + x)];
+            const std::uint32_t id = index.component(Cell{x, y});
+            ASSERT_EQ(l == 0, id == 0) << "(" << x << "," << y << ")";
+            if (l == 0) continue;
+            refCount = std::max(refCount, l);
+            if (idOf[static_cast<size_t>(l)] == 0) idOf[static_cast<size_t>(l)] = id;
+            ASSERT_EQ(idOf[static_cast<size_t>(l)], id) << "(" << x << "," << y << ")";
+        }
+    }
+    // id diversi per etichette diverse
+    std::vector<std::uint32_t> ids(idOf.begin() + 1, idOf.begin() + 1 + refCount);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_TRUE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+    EXPECT_EQ(index.componentCount(), static_cast<size_t>(refCount));
+}
+
+// ===================== tests =====================
+
+//1. costruzione da zero = flood fill (anche larghezze non multiple di 64)
+TEST(ConnectivityIndex, Build_MatchesFloodFill) {
+    for (int map = 0; map < 10; ++map) {
+        const GridMap g = randomGrid(70 + map * 13, 40 + map * 3, 0.3 + 0.03 * map, static_cast<unsigned>(map));
+        const ConnectivityIndex index(g);
+        expectSamePartition(g, index);
+    }
+}
+
+//2. modifiche incrementali (blocchi e sblocchi casuali) = ricostruzione da zero
+TEST(ConnectivityIndex, IncrementalUpdates_MatchFloodFill) {
+    std::mt19937 rng(77);
+    for (int map = 0; map < 10; ++map) {
+        GridMap g = randomGrid(60, 45, 0.35 + 0.02 * map, static_cast<unsigned>(40 + map));
+        ConnectivityIndex index(g);
+        std::uniform_int_distribution<int> rx(0, 59), ry(0, 44);
+        for (int round = 0; round < 40; ++round) {
+            for (int e = 0; e < 10; ++e) {
+                const Cell c{rx(rng), ry(rng)};
+                g.toggleBlocked(c);
+                index.notifyChanged(c);
+            }
+            expectSamePartition(g, index);
+        }
+    }
+}
+
+//3. un muro che chiude e riapre una stanza
+TEST(ConnectivityIndex, WallSplitsAndMerges) {
+    GridMap g(20, 10);
+    ConnectivityIndex index(g);
+    EXPECT_EQ(index.componentCount(), 1u);
+
+    for (int y = 0; y < 10; ++y) {
+        g.setBlocked(Cell{7, y}, true);
+        index.notifyChanged(Cell{7, y});
+    }
+    EXPECT_EQ(index.componentCount(), 2u);
+    EXPECT_FALSE(index.connected(Cell{0, 0}, Cell{19, 9}));
+    EXPECT_TRUE(index.connected(Cell{8, 0}, Cell{19, 9}));
+    EXPECT_FALSE(index.connected(Cell{7, 3}, Cell{7, 3})); // ostacolo
+
+    g.setBlocked(Cell{7, 4}, false);
+    index.notifyChanged(Cell{7, 4});
+    EXPECT_EQ(index.componentCount(), 1u);
+    EXPECT_TRUE(index.connected(Cell{0, 0}, Cell{19, 9}));
+}
+
+//4. A* e JPS con l'indice: query irraggiungibili scartate senza espandere nulla
+TEST(ConnectivityIndex, SearchRejectsUnreachableWithoutExpanding) {
+    GridMap g(50, 50);
+    g.fillRect(Cell{25, 0}, 1, 50, true);
+    const ConnectivityIndex index(g);
+
+    SearchOptions opts;
+    opts.components = &index;
+    for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+        opts.connectivity = c;
+        const AStarResult a = AStarPathfinder::findPath(g, Cell{0, 0}, Cell{49, 49}, opts);
+        EXPECT_FALSE(a.success);
+        EXPECT_TRUE(a.closed.empty());
+        const AStarResult j = JumpPointPathfinder::findPath(g, Cell{0, 0}, Cell{49, 49}, opts);
+        EXPECT_FALSE(j.success);
+        EXPECT_TRUE(j.closed.empty());
+
+        // raggiungibile: stesso risultato di prima
+        SearchOptions plain = opts;
+        plain.components = nullptr;
+        EXPECT_EQ(AStarPathfinder::findPath(g, Cell{0, 0}, Cell{24, 49}, opts).cost,
+                  AStarPathfinder::findPath(g, Cell{0, 0}, Cell{24, 49}, plain).cost);
+    }
+}
@@ -0,0 +1,240 @@
+// tests/test_cooperative.cpp
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/CooperativePlanner.h"
+#include "taikutsu/core/FlatHashMap.h"
+#include "taikutsu/core/MapGenerators.h"
+
+// ===================== helpers =====================
+
+// celle libere distinte
+static std::vector<Cell> distinctCells(const GridMap& g, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    std::vector<Cell> out;
+    while (static_cast<int>(out.size()) < count) {
+        const Cell c{rx(rng), ry(rng)};
+        if (g.isWalkable(c) && std::find(out.begin(), out.end(), c) == out.end()) out.push_back(c);
+    }
+    return out;
+}
+
+// ogni passo del piano è un'attesa o una mossa permessa verso una cella libera
+static void expectValidPlan(const GridMap& g, const std::vector<Cell>& plan, Connectivity conn) {
+    for (size_t i = 1; i < plan.size(); ++i) {
+        const Cell a = plan[i - 1], b = plan[i];
+        ASSERT_TRUE(g.isWalkable(b));
+        const int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+        EXPECT_LE(std::max(dx, dy), 1);
+        if (conn == Connectivity::Four) {
+            EXPECT_LE(dx + dy, 1);
+        }
+    }
+}
+
+// percorsi indipendenti (A*) seguiti in parallelo, fermi sul goal: conflitti totali
+static size_t independentConflicts(const GridMap& g, const std::vector<Cell>& starts, const std::vector<Cell>& goals,
+                                   const SearchOptions& opts, int ticks) {
+    std::vector<std::vector<Cell>> paths;
+    for (size_t i = 0; i < starts.size(); ++i) paths.push_back(AStarPathfinder::findPath(g, starts[i], goals[i], opts).path);
+    auto at = [&](size_t i, int t) {
+        const std::vector<Cell>& p = paths[i];
+        return p.empty() ? starts[i] : p[std::min(static_cast<size_t>(t), p.size() - 1)];
+    };
+    size_t conflicts = 0;
+    std::vector<Cell> from(starts.size()), to(starts.size());
+    for (int t = 0; t < ticks; ++t) {
+        for (size_t i = 0; i < starts.size(); ++i) {
+            from[i] = at(i, t);
+            to[i] = at(i, t + 1);
+        }
+        conflicts += countConflicts(g, from, to);
+    }
+    return conflicts;
+}
+
+// ===================== tests =====================
+
+//1. corridoio largo 1 con una nicchia: i percorsi indipendenti si scontrano, quelli cooperativi
+//   no (B si fa da parte nella nicchia e aspetta che A passi)
+TEST(CooperativePlanner, CorridorSwapUsesPocket) {
+    GridMap g(11, 3);
+    g.fillRect(Cell{0, 0}, 11, 3, true);
+    g.fillRect(Cell{0, 1}, 11, 1, false);
+    g.setBlocked(Cell{8, 0}, false); // nicchia
+    const std::vector<Cell> starts{Cell{0, 1}, Cell{10, 1}}, goals{Cell{10, 1}, Cell{0, 1}};
+    EXPECT_GT(independentConflicts(g, starts, goals, {}, 20), 0u);
+
+    CooperativePlanner planner(g);
+    const int a = planner.addAgent(starts[0], goals[0]);
+    const int b = planner.addAgent(starts[1], goals[1]);
+    ASSERT_NE(a, CooperativePlanner::kNoAgent);
+    ASSERT_NE(b, CooperativePlanner::kNoAgent);
+    EXPECT_EQ(planner.addAgent(starts[0], goals[1]), CooperativePlanner::kNoAgent); // cella occupata
+    size_t conflicts = 0;
+    bool visitedPocket = false;
+    for (int t = 0; t < 40 && !(planner.atGoal(a) && planner.atGoal(b)); ++t) {
+        planner.plan();
+        conflicts += planner.advance();
+        visitedPocket |= planner.position(b) == Cell{8, 0};
+    }
+    EXPECT_TRUE(planner.atGoal(a));
+    EXPECT_TRUE(planner.atGoal(b));
+    EXPECT_TRUE(visitedPocket);
+    EXPECT_EQ(conflicts, 0u);
+}
+
+//2. molti agenti su una mappa casuale: nessun conflitto (vertice o scambio) a budget illimitato,
+//   piani fatti di mosse valide, quasi tutti arrivano; con i percorsi indipendenti i conflitti ci sono
+TEST(CooperativePlanner, ManyAgents_NoConflicts) {
+    const GridMap g = makeRandomMap(48, 48, 0.2, 160);
+    const std::vector<Cell> cells = distinctCells(g, 160, 161);
+    const std::vector<Cell> starts(cells.begin(), cells.begin() + 80), goals(cells.begin() + 80, cells.end());
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        CooperativeOptions opts;
+        opts.connectivity = conn;
+        opts.window = 12;
+        CooperativePlanner planner(g, opts);
+        for (size_t i = 0; i < starts.size(); ++i) ASSERT_EQ(planner.addAgent(starts[i], goals[i]), static_cast<int>(i));
+        size_t conflicts = 0;
+        for (int t = 0; t < 160; ++t) {
+            const CooperativeTickStats stats = planner.plan();
+            EXPECT_EQ(stats.deferred, 0u);
+            for (int i = 0; i < static_cast<int>(starts.size()); ++i) {
+                const std::vector<Cell> plan = planner.plannedPath(i);
+                ASSERT_TRUE(plan.front() == planner.position(i));
+                expectValidPlan(g, plan, conn);
+            }
+            conflicts += planner.advance();
+        }
+        EXPECT_EQ(conflicts, 0u);
+        int arrived = 0;
+        for (int i = 0; i < static_cast<int>(starts.size()); ++i) arrived += planner.atGoal(i);
+        EXPECT_GE(arrived, 76);
+        SearchOptions so;
+        so.connectivity = conn;
+        EXPECT_GT(independentConflicts(g, starts, goals, so, 160), 0u);
+    }
+}
+
+//3. incrocio di due corridoi: chi pianifica dopo aspetta un tick (attesa nel piano) invece di
+//   girare intorno, e arriva un tick dopo il percorso indipendente
+TEST(CooperativePlanner, WaitActionAtCrossing) {
+    GridMap g(11, 11);
+    g.fillRect(Cell{0, 0}, 11, 11, true);
+    g.fillRect(Cell{0, 5}, 11, 1, false);
+    g.fillRect(Cell{5, 0}, 1, 11, false);
+    CooperativePlanner planner(g);
+    const int a = planner.addAgent(Cell{0, 5}, Cell{10, 5});
+    const int b = planner.addAgent(Cell{5, 0}, Cell{5, 10});
+    planner.plan();
+    const std::vector<Cell> planB = planner.plannedPath(b);
+    bool waits = false;
+    for (size_t i = 1; i < planB.size(); ++i) waits |= planB[i] == planB[i - 1] && !(planB[i] == Cell{5, 10});
+    EXPECT_TRUE(waits);
+    size_t conflicts = 0;
+    int arrivedA = -1, arrivedB = -1;
+    for (int t = 1; t <= 20; ++t) {
+        planner.plan();
+        conflicts += planner.advance();
+        if (arrivedA < 0 && planner.atGoal(a)) arrivedA = t;
+        if (arrivedB < 0 && planner.atGoal(b)) arrivedB = t;
+    }
+    EXPECT_EQ(conflicts, 0u);
+    EXPECT_EQ(arrivedA, 10);
+    EXPECT_EQ(arrivedB, 11);
+}
+
+//4. budget: con 0 us si pianifica un agente per plan() e gli altri restano in coda (i rimasti per
+//   primi); dopo un giro completo nessuno ha più bisogno di ripianificare
+TEST(CooperativePlanner, BudgetDefersAgents) {
+    const GridMap g(64, 64);
+    const std::vector<Cell> cells = distinctCells(g, 400, 162);
+    CooperativeOptions opts;
+    opts.window = 8;
+    CooperativePlanner planner(g, opts);
+    for (size_t i = 0; i < 200; ++i) planner.addAgent(cells[i], cells[i + 200]);
+    const CooperativeTickStats first = planner.plan(std::chrono::microseconds(0));
+    EXPECT_EQ(first.planned, 1u);
+    EXPECT_EQ(first.deferred, 199u);
+    EXPECT_EQ(planner.plannedPath(0).size(), 9u);
+    EXPECT_EQ(planner.plannedPath(1).size(), 1u); // ancora fermo
+    for (int i = 1; i < 200; ++i) {
+        const CooperativeTickStats s = planner.plan(std::chrono::microseconds(0));
+        ASSERT_EQ(s.planned, 1u);
+        ASSERT_EQ(s.deferred, static_cast<size_t>(199 - i));
+    }
+    for (int i = 0; i < 200; ++i) EXPECT_EQ(planner.plannedPath(i).size(), 9u);
+    EXPECT_EQ(planner.plan().planned, 0u);
+    EXPECT_EQ(planner.reservationCount(), 200u * 8u); // i tick dopo quello corrente
+
+    // dopo window / 2 tick tutti di nuovo da ripianificare, in un solo plan() senza budget
+    for (int t = 0; t < 4; ++t) EXPECT_EQ(planner.advance(), 0u);
+    EXPECT_EQ(planner.plan().planned, 200u);
+}
+
+//5. distanze vere: uguali al costo di A* (terreno, 8 direzioni), kUnreachable fuori componente;
+//   con la cache piena si butta il goal meno recente; una modifica del grid le ricalcola
+TEST(CooperativePlanner, TrueDistanceCache) {
+    GridMap g = makeRoomsMap(40, 40, 10, 163);
+    std::mt19937 rng(164);
+    std::uniform_int_distribution<int> r(0, 39), rc(1, 9);
+    for (int i = 0; i < 400; ++i) g.setCost(Cell{r(rng), r(rng)}, static_cast<std::uint8_t>(rc(rng)));
+    g.fillRect(Cell{0, 0}, 3, 3, true);
+    g.setBlocked(Cell{1, 1}, false); // isolata
+    CooperativeOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    opts.heuristicGoals = 2;
+    CooperativePlanner planner(g, opts);
+    SearchOptions so;
+    so.connectivity = Connectivity::Eight;
+    const std::vector<Cell> cells = distinctCells(g, 63, 165);
+    for (int k = 0; k < 3; ++k) {
+        const Cell goal = cells[static_cast<size_t>(k)];
+        for (size_t i = 3; i < cells.size(); ++i) {
+            const AStarResult ref = AStarPathfinder::findPath(g, cells[i], goal, so);
+            ASSERT_EQ(planner.trueDistance(cells[i], goal), ref.success ? ref.cost : CooperativePlanner::kUnreachable);
+        }
+    }
+    EXPECT_EQ(planner.cachedGoals(), 2u);
+    EXPECT_EQ(planner.trueDistance(Cell{1, 1}, cells[0]), CooperativePlanner::kUnreachable);
+    EXPECT_EQ(planner.trueDistance(Cell{0, 0}, cells[0]), CooperativePlanner::kUnreachable);
+    EXPECT_EQ(planner.trueDistance(cells[0], cells[0]), 0);
+
+    g.fillRect(Cell{10, 0}, 1, 40, true); // muro: le distanze vecchie non valgono più
+    for (size_t i = 3; i < cells.size(); ++i) {
+        const AStarResult ref = AStarPathfinder::findPath(g, cells[i], cells[0], so);
+        ASSERT_EQ(planner.trueDistance(cells[i], cells[0]), ref.success ? ref.cost : CooperativePlanner::kUnreachable);
+    }
+}
+
+//6. FlatHashMap64: inserimenti e cancellazioni casuali (backward shift) come std::unordered_map
+TEST(CooperativePlanner, FlatHashMapMatchesUnorderedMap) {
+    FlatHashMap64 map;
+    std::unordered_map<std::uint64_t, std::uint32_t> ref;
+    std::mt19937_64 rng(166);
+    std::uniform_int_distribution<std::uint64_t> keys(0, 3000);
+    for (std::uint32_t i = 0; i < 200000; ++i) {
+        const std::uint64_t k = keys(rng) << 20 | (keys(rng) & 7); // catene lunghe sugli stessi bit bassi
+        if (rng() & 1) {
+            EXPECT_EQ(map.insert(k, i), ref.emplace(k, i).second);
+        } else {
+            EXPECT_EQ(map.erase(k), ref.erase(k) == 1);
+        }
+        if (i % 1000 == 0) {
+            ASSERT_EQ(map.size(), ref.size());
+            for (const auto& [key, value] : ref) {
+                const std::uint32_t* v = map.find(key);
+                ASSERT_NE(v, nullptr);
+                ASSERT_EQ(*v, value);
+            }
+        }
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(ref.begin()->first), nullptr);
+}
@@ -0,0 +1,125 @@
+// tests/test_dstarlite.cpp
+#include <gtest/gtest.h>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/DStarLite.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// stesso esito e stesso costo di un A* da zero sul grid attuale
+static void expectSameAsFresh(const GridMap& g, const AStarResult& r, Cell s, Cell t, const SearchOptions& opts) {
+    const AStarResult ref = AStarPathfinder::findPath(g, s, t, opts);
+    ASSERT_EQ(r.success, ref.success) << "(" << s.x << "," << s.y << ")->(" << t.x << "," << t.y << ")";
+    if (!r.success) return;
+    EXPECT_EQ(r.cost, ref.cost);
+    ASSERT_FALSE(r.path.empty());
+    EXPECT_TRUE(r.path.front() == s);
+    EXPECT_TRUE(r.path.back() == t);
+    for (const Cell& c : r.path) EXPECT_TRUE(g.isWalkable(c));
+}
+
+// ===================== tests =====================
+
+//1. prima pianificazione = A*
+TEST(DStarLite, Plan_MatchesAStar) {
+    for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+        const GridMap g = randomGrid(60, 40, 0.3, 2);
+        SearchOptions opts;
+        opts.connectivity = c;
+        DStarLitePathfinder planner(g, opts);
+
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> rx(0, 59), ry(0, 39);
+        for (int q = 0; q < 30; ++q) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            expectSameAsFresh(g, planner.plan(s, t), s, t, opts);
+        }
+    }
+}
+
+//2. sequenze casuali di modifiche (ostacoli e costi): replan = findPath da zero
+TEST(DStarLite, RandomEdits_MatchFreshSearch) {
+    std::mt19937 rng(13);
+    for (int map = 0; map < 20; ++map) {
+        for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+            GridMap g = randomGrid(50, 50, 0.25, static_cast<unsigned>(100 + map));
+            SearchOptions opts;
+            opts.connectivity = c;
+            DStarLitePathfinder planner(g, opts);
+
+            std::uniform_int_distribution<int> r(0, 49);
+            Cell s{r(rng), r(rng)}, t{r(rng), r(rng)};
+            g.setBlocked(s, false);
+            g.setBlocked(t, false);
+            planner.plan(s, t);
+
+            for (int round = 0; round < 15; ++round) {
+                std::vector<Cell> changed;
+                for (int e = 0; e < 6; ++e) {
+                    const Cell cell{r(rng), r(rng)};
+                    if (cell == s || cell == t) continue;
+                    if (map % 4 == 0 && e == 0) g.setCost(cell, static_cast<std::uint8_t>(1 + r(rng) % 5));
+                    else g.toggleBlocked(cell);
+                    changed.push_back(cell);
+                }
+                const AStarResult& res = planner.replan(changed);
+                expectSameAsFresh(g, res, s, t, opts);
+            }
+        }
+    }
+}
+
+//3. lo start si sposta lungo il percorso mentre il grid cambia (agente che ripianifica)
+TEST(DStarLite, MovingStart_MatchesFreshSearch) {
+    GridMap g = randomGrid(80, 80, 0.2, 7);
+    const Cell t{79, 79};
+    Cell s{0, 0};
+    g.setBlocked(s, false);
+    g.setBlocked(t, false);
+
+    DStarLitePathfinder planner(g);
+    AStarResult res = planner.plan(s, t);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> r(0, 79);
+    for (int step = 0; step < 40 && res.success && res.path.size() > 3; ++step) {
+        s = res.path[2]; // due passi avanti
+        res = planner.moveStart(s);
+        expectSameAsFresh(g, res, s, t, {});
+
+        std::vector<Cell> changed;
+        for (int e = 0; e < 4; ++e) {
+            const Cell cell{r(rng), r(rng)};
+            if (cell == s || cell == t) continue;
+            g.toggleBlocked(cell);
+            changed.push_back(cell);
+        }
+        res = planner.replan(changed);
+        expectSameAsFresh(g, res, s, t, {});
+    }
+}
+
+//4. una porta che si chiude: la riparazione espande meno di una ricerca completa
+TEST(DStarLite, Replan_ExpandsFewerNodes) {
+    GridMap g(100, 100);
+    g.fillRect(Cell{50, 0}, 1, 100, true);
+    g.setBlocked(Cell{50, 90}, false); // porta in basso
+    g.setBlocked(Cell{50, 10}, false); // porta in alto
+
+    DStarLitePathfinder planner(g);
+    const AStarResult& first = planner.plan(Cell{0, 5}, Cell{99, 5});
+    ASSERT_TRUE(first.success);
+    const size_t full = first.closed.size();
+
+    g.setBlocked(Cell{50, 10}, true);
+    const std::vector<Cell> changed{Cell{50, 10}};
+    const AStarResult& again = planner.replan(changed);
+    expectSameAsFresh(g, again, Cell{0, 5}, Cell{99, 5}, {});
+
+    // riaprire la porta: solo una piccola riparazione
+    g.setBlocked(Cell{50, 10}, false);
+    const AStarResult& reopened = planner.replan(changed);
+    expectSameAsFresh(g, reopened, Cell{0, 5}, Cell{99, 5}, {});
+    EXPECT_LT(reopened.closed.size(), full);
+}
@@ -0,0 +1,139 @@
+// tests/test_flowfield.cpp
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/FlowField.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// distanza = costo di A* verso il goal e seguire next() arriva al goal con quel costo
+static void expectMatchesAStar(const GridMap& g, const FlowField& field, Cell goal, const SearchOptions& opts) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    for (int q = 0; q < 40; ++q) {
+        const Cell s{rx(rng), ry(rng)};
+        const AStarResult ref = AStarPathfinder::findPath(g, s, goal, opts);
+        ASSERT_EQ(field.reachable(s), ref.success) << "(" << s.x << "," << s.y << ")";
+        if (!ref.success) continue;
+        EXPECT_EQ(field.distance(s), static_cast<std::uint32_t>(ref.cost));
+
+        Cell c = s;
+        std::uint32_t walked = 0;
+        while (!(c == goal)) {
+            const Cell n = field.next(c);
+            ASSERT_FALSE(n == c);
+            ASSERT_TRUE(g.isWalkable(n));
+            const bool diagonal = n.x != c.x && n.y != c.y;
+            walked += static_cast<std::uint32_t>((diagonal ? kCostDiagonal : kCostStraight) * (g.hasCosts() ? g.cost(n) : 1));
+            c = n;
+        }
+        EXPECT_EQ(walked, field.distance(s));
+        EXPECT_EQ(field.direction(goal), FlowField::kNoDir);
+    }
+}
+
+// ===================== tests =====================
+
+//1. 4 direzioni a costo unitario (wavefront bit-parallelo), larghezza non multipla di 64
+TEST(FlowField, UnitCost_MatchesAStar) {
+    const GridMap g = randomGrid(150, 90, 0.3, 4);
+    const Cell goal{70, 40};
+    GridMap open = g;
+    open.setBlocked(goal, false);
+
+    FlowField field;
+    const Cell goals[] = {goal};
+    field.build(open, goals);
+    expectMatchesAStar(open, field, goal, {});
+}
+
+//2. 8 direzioni e terreno pesato (bucket di Dial)
+TEST(FlowField, EightAndWeighted_MatchAStar) {
+    GridMap g = randomGrid(90, 70, 0.25, 6);
+    const Cell goal{10, 60};
+    g.setBlocked(goal, false);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> rx(0, 89), ry(0, 69), rc(1, 9);
+
+    FlowField field;
+    const Cell goals[] = {goal};
+    for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+        SearchOptions opts;
+        opts.connectivity = c;
+        field.build(g, goals, opts);
+        expectMatchesAStar(g, field, goal, opts);
+    }
+
+    for (int i = 0; i < 800; ++i) g.setCost(Cell{rx(rng), ry(rng)}, static_cast<std::uint8_t>(rc(rng)));
+    for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+        SearchOptions opts;
+        opts.connectivity = c;
+        field.build(g, goals, opts);
+        expectMatchesAStar(g, field, goal, opts);
+    }
+}
+
+//3. più goal: distanza = minimo sui goal
+TEST(FlowField, MultiSource_MinOverGoals) {
+    const GridMap g = randomGrid(60, 60, 0.2, 9);
+    std::vector<Cell> goals;
+    for (const Cell c : {Cell{5, 5}, Cell{50, 10}, Cell{30, 55}})
+        if (g.isWalkable(c)) goals.push_back(c);
+    ASSERT_FALSE(goals.empty());
+
+    for (Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        SearchOptions opts;
+        opts.connectivity = conn;
+        FlowField field;
+        field.build(g, goals, opts);
+        for (int y = 0; y < 60; y += 3) {
+            for (int x = 0; x < 60; x += 3) {
+                int best = -1;
+                for (const Cell& t : goals) {
+                    const AStarResult r = AStarPathfinder::findPath(g, Cell{x, y}, t, opts);
+                    if (r.success && (best < 0 || r.cost < best)) best = r.cost;
+                }
+                if (best < 0) EXPECT_FALSE(field.reachable(Cell{x, y}));
+                else EXPECT_EQ(field.distance(Cell{x, y}), static_cast<std::uint32_t>(best));
+            }
+        }
+    }
+}
+
+//4. ricostruzione su un worker: i lettori vedono sempre un campo completo
+TEST(FlowField, SharedAsyncRebuild_ReadersSeeCompleteField) {
+    GridMap g(200, 200);
+    ThreadPool pool(2);
+    SharedFlowField shared;
+    EXPECT_EQ(shared.current(), nullptr);
+
+    const std::vector<Cell> first{Cell{0, 0}};
+    shared.rebuild(g, first);
+    ASSERT_NE(shared.current(), nullptr);
+    EXPECT_EQ(shared.version(), 1u);
+
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        while (!stop) {
+            const auto field = shared.current();
+            // ogni campo pubblicato è completo: l'angolo opposto ha sempre una distanza
+            EXPECT_TRUE(field->reachable(Cell{199, 199}));
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        g.setBlocked(Cell{i + 5, 5}, true); // il grid cambia mentre si ricostruisce (copia)
+        shared.rebuildAsync(pool, g, {Cell{i, 199 - i}});
+    }
+    shared.wait();
+    stop = true;
+    reader.join();
+
+    // vince l'ultima richiesta (quelle superate possono non essere pubblicate)
+    EXPECT_GE(shared.version(), 2u);
+    EXPECT_LE(shared.version(), 11u);
+    EXPECT_EQ(shared.current()->distance(Cell{9, 190}), 0u);
+}
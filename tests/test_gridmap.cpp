@@ -0,0 +1,113 @@
+// tests/test_gridmap.cpp
+#include <gtest/gtest.h>
+
+#include "taikutsu/core/GridMap.h"
+#include "TestHelpers.h"
+
+// ===================== tests =====================
+
+//1. i bordi sono sentinelle bloccate: la mask non esce mai dal grid
+TEST(GridMap, NeighborMask_BordersAreBlocked) {
+    GridMap g(64, 3); // 64 colonne: il padding a destra sta nella word successiva
+    EXPECT_EQ(g.neighborMask(Cell{0, 0}), (1u << kRight) | (1u << kDown));
+    EXPECT_EQ(g.neighborMask(Cell{63, 2}), (1u << kLeft) | (1u << kUp));
+    EXPECT_EQ(g.neighborMask(Cell{10, 1}), 0xFu);
+
+    GridMap line(1, 1);
+    EXPECT_EQ(line.neighborMask(Cell{0, 0}), 0u);
+    EXPECT_EQ(line.walkableMask8(line.index(Cell{0, 0})), 0u);
+}
+
+//2. mask == isWalkable sui vicini, anche con 8 direzioni
+TEST(GridMap, WalkableMask_MatchesIsWalkable) {
+    GridMap g(70, 9);
+    randomize(g, 7, 0.3);
+
+    for (int y = 0; y < g.height(); ++y) {
+        for (int x = 0; x < g.width(); ++x) {
+            const unsigned m = g.walkableMask8(g.index(Cell{x, y}));
+            for (int d = 0; d < 8; ++d) {
+                const Cell nb{x + kDirDx[d], y + kDirDy[d]};
+                EXPECT_EQ(((m >> d) & 1u) != 0, g.isWalkable(nb)) << "(" << x << "," << y << ") dir " << d;
+            }
+        }
+    }
+}
+
+//3. fillRect viene clippato e non tocca celle fuori dal rettangolo
+TEST(GridMap, FillRect_ClipsAndOnlyTouchesRect) {
+    GridMap g(130, 6);
+    g.fillRect(Cell{-3, 1}, 200, 2, true); // righe 1..2 intere
+    g.fillRect(Cell{60, 1}, 10, 1, false); // buco che attraversa il bordo di word
+
+    for (int y = 0; y < g.height(); ++y) {
+        for (int x = 0; x < g.width(); ++x) {
+            const bool expected = (y == 1 && !(x >= 60 && x < 70)) || y == 2;
+            EXPECT_EQ(g.isBlocked(Cell{x, y}), expected) << "(" << x << "," << y << ")";
+        }
+    }
+
+    g.clear();
+    for (int x = 0; x < g.width(); ++x) EXPECT_TRUE(g.isWalkable(Cell{x, 1}));
+    EXPECT_FALSE(g.isWalkable(Cell{g.width(), 1})); // padding resta bloccato
+}
+
+//4. copyRegion con offset non allineati == copia cella per cella
+TEST(GridMap, CopyRegion_MatchesPerCellCopy) {
+    GridMap src(150, 12);
+    randomize(src, 42, 0.5);
+
+    GridMap fast(140, 15);
+    GridMap slow(140, 15);
+    randomize(fast, 3, 0.2);
+    randomize(slow, 3, 0.2);
+
+    const Cell srcMin{5, 2};
+    const Cell dstMin{-7, 4}; // parte fuori: va clippato
+    const int w = 139;
+    const int h = 20;
+    fast.copyRegion(src, srcMin, w, h, dstMin);
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const Cell s{srcMin.x + x, srcMin.y + y};
+            const Cell d{dstMin.x + x, dstMin.y + y};
+            if (src.inBounds(s) && slow.inBounds(d)) slow.setBlocked(d, src.isBlocked(s));
+        }
+    }
+
+    for (int y = 0; y < fast.height(); ++y)
+        for (int x = 0; x < fast.width(); ++x)
+            EXPECT_EQ(fast.isBlocked(Cell{x, y}), slow.isBlocked(Cell{x, y})) << "(" << x << "," << y << ")";
+}
+
+//5. versioni per regione: solo le modifiche effettive le incrementano, e solo dove cadono
+TEST(GridMap, RegionVersions_TrackEffectiveChanges) {
+    GridMap g(100, 40); // 4 x 2 regioni
+    ASSERT_EQ(g.regionsX(), 4);
+    ASSERT_EQ(g.regionsY(), 2);
+    const int r = g.regionOf(Cell{40, 5});
+    EXPECT_EQ(r, 1);
+    const std::uint64_t v0 = g.version(); // la costruzione conta come modifica di tutto
+
+    g.setBlocked(Cell{40, 5}, true);
+    const std::uint64_t v = g.version();
+    EXPECT_EQ(g.regionVersion(r), v);
+    EXPECT_EQ(g.regionVersion(0), v0);
+    EXPECT_EQ(g.relaxVersion(), v0); // un blocco non accorcia nessun percorso
+
+    g.setBlocked(Cell{40, 5}, true); // nessun cambiamento
+    EXPECT_EQ(g.version(), v);
+
+    g.toggleBlocked(Cell{40, 5}); // sblocco = relax
+    EXPECT_GT(g.version(), v);
+    EXPECT_EQ(g.regionRelaxVersion(r), g.version());
+    EXPECT_EQ(g.relaxVersion(), g.version());
+
+    g.fillRect(Cell{40, 35}, 40, 3, true); // regioni 5 e 6
+    for (int i : {5, 6}) EXPECT_EQ(g.regionVersion(i), g.version());
+    for (int i : {4, 7}) EXPECT_EQ(g.regionVersion(i), v0);
+
+    const GridMap copy = g; // copia = altra identità: versioni non confrontabili
+    EXPECT_NE(copy.epoch(), g.epoch());
+}
@@ -0,0 +1,211 @@
+// tests/test_gridsnapshot.cpp
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ChunkedAStar.h"
+#include "taikutsu/core/GridSnapshot.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+static void expectSameCells(const GridSnapshot& s, const GridMap& g) {
+    ASSERT_EQ(s.width(), g.width());
+    ASSERT_EQ(s.height(), g.height());
+    for (int y = -1; y <= g.height(); ++y)
+        for (int x = -1; x <= g.width(); ++x) ASSERT_EQ(s.isWalkable(Cell{x, y}), g.isWalkable(Cell{x, y})) << x << "," << y;
+}
+
+// i primi 16 bit della riga 0 portano il numero di versione (bit libero = 1)
+static void writeStamp(VersionedGrid& v, std::uint64_t version) {
+    for (int b = 0; b < 16; ++b) v.setBlocked(Cell{b, 0}, ((version >> b) & 1u) == 0);
+}
+
+static std::uint64_t readStamp(const GridSnapshot& s) {
+    std::uint64_t stamp = 0;
+    for (int b = 0; b < 16; ++b) stamp |= static_cast<std::uint64_t>(s.isWalkable(Cell{b, 0})) << b;
+    return stamp;
+}
+
+// ===================== tests =====================
+
+//1. publish() rifà solo le tile toccate: le altre sono le stesse in memoria, la vecchia versione non cambia
+TEST(VersionedGrid, Publish_SharesUntouchedTiles) {
+    const GridMap g = randomGrid(200, 150, 0.3, 1);
+    VersionedGrid v(g);
+    const auto v0 = v.snapshot();
+    EXPECT_EQ(v0->version(), 0u);
+    expectSameCells(*v0, g);
+    EXPECT_EQ(v.publish(), v0); // nessuna modifica: stessa versione
+
+    const bool was = v.isWalkable(Cell{100, 70});
+    v.setBlocked(Cell{100, 70}, was);  // tile (1, 1)
+    v.toggleBlocked(Cell{199, 149});   // tile di bordo (3, 2)
+    EXPECT_EQ(v.isWalkable(Cell{100, 70}), !was); // la bozza vede la modifica...
+    EXPECT_EQ(v.snapshot(), v0);                   // ...i lettori no
+    EXPECT_EQ(v.pendingTiles(), 2u);
+
+    const auto v1 = v.publish();
+    EXPECT_EQ(v1->version(), 1u);
+    EXPECT_EQ(v.version(), 1u);
+    EXPECT_EQ(v.snapshot(), v1);
+    EXPECT_EQ(v.pendingTiles(), 0u);
+    for (int ty = 0; ty < v1->tilesY(); ++ty)
+        for (int tx = 0; tx < v1->tilesX(); ++tx)
+            EXPECT_EQ(v1->sharesTile(*v0, tx, ty), !((tx == 1 && ty == 1) || (tx == 3 && ty == 2))) << tx << "," << ty;
+    EXPECT_EQ(v1->isWalkable(Cell{100, 70}), !was);
+    expectSameCells(*v0, g);
+
+    // una scrittura dopo publish() copia di nuovo la tile: v1 resta com'era
+    v.toggleBlocked(Cell{100, 70});
+    EXPECT_EQ(v1->isWalkable(Cell{100, 70}), !was);
+    EXPECT_EQ(v.publish()->isWalkable(Cell{100, 70}), was);
+}
+
+//2. modifiche casuali (anche fillRect su tile intere) == GridMap, tile canoniche dopo publish()
+TEST(VersionedGrid, Edits_MatchGridMapAndCollapse) {
+    GridMap g = randomGrid(150, 140, 0.25, 2);
+    VersionedGrid v(g);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> rx(-5, 154), ry(-5, 144), op(0, 9), len(1, 80);
+    for (int round = 0; round < 8; ++round) {
+        for (int i = 0; i < 300; ++i) {
+            const Cell c{rx(rng), ry(rng)};
+            const int o = op(rng);
+            if (o < 5) {
+                g.setBlocked(c, o & 1);
+                v.setBlocked(c, o & 1);
+            } else if (o < 8) {
+                if (g.inBounds(c)) g.toggleBlocked(c);
+                v.toggleBlocked(c);
+            } else {
+                const int w = len(rng), h = len(rng);
+                g.fillRect(c, w, h, o == 8);
+                v.fillRect(c, w, h, o == 8);
+            }
+        }
+        expectSameCells(*v.publish(), g);
+    }
+
+    g.fillRect(Cell{0, 0}, 150, 140, true);
+    v.fillRect(Cell{0, 0}, 150, 140, true);
+    v.fillRect(Cell{64, 0}, 64, 64, false);   // tile (1, 0) libera senza copie
+    g.fillRect(Cell{64, 0}, 64, 64, false);
+    v.toggleBlocked(Cell{10, 10});             // tile (0, 0) copiata e poi di nuovo uniforme
+    v.toggleBlocked(Cell{10, 10});
+    v.fillRect(Cell{128, 128}, 22, 12, false); // tile d'angolo: solo le celle nella mappa
+    g.fillRect(Cell{128, 128}, 22, 12, false);
+    const auto s = v.publish();
+    expectSameCells(*s, g);
+    EXPECT_EQ(s->mixedTileCount(), 0u);
+    EXPECT_EQ(s->tileState(0, 0), GridSnapshot::TileState::Blocked);
+    EXPECT_EQ(s->tileState(1, 0), GridSnapshot::TileState::Free);
+    EXPECT_EQ(s->tileState(2, 2), GridSnapshot::TileState::Free);
+    for (int y = 0; y < 140; ++y) {
+        for (int x = 0; x < 150; ++x) {
+            const Cell p{x, y};
+            ASSERT_EQ(s->walkableMask8(p), g.walkableMask8(g.index(p))) << x << "," << y;
+            ASSERT_EQ(s->moveMask8(p, true), g.moveMask8(g.index(p), true));
+        }
+    }
+}
+
+//3. ChunkedAStar su uno snapshot == AStarPathfinder sul GridMap equivalente
+TEST(VersionedGrid, ChunkedAStarOnSnapshot_MatchesAStar) {
+    GridMap g = randomGrid(180, 120, 0.3, 4);
+    g.fillRect(Cell{20, 20}, 100, 70, false);
+    VersionedGrid v(g);
+    const auto s = v.snapshot();
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> rx(0, 179), ry(0, 119);
+    ChunkedSearchContext cctx;
+    AStarSearchContext actx;
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        SearchOptions opts;
+        opts.connectivity = conn;
+        for (int i = 0; i < 60; ++i) {
+            const Cell a{rx(rng), ry(rng)}, b{rx(rng), ry(rng)};
+            const AStarResult& ref = AStarPathfinder::findPath(actx, g, a, b, opts);
+            const AStarResult& r = ChunkedAStar::findPath(cctx, *s, a, b, opts);
+            ASSERT_EQ(r.success, ref.success);
+            EXPECT_EQ(r.cost, ref.cost);
+            EXPECT_EQ(r.expanded, ref.expanded);
+            EXPECT_EQ(r.path, ref.path);
+        }
+    }
+}
+
+//4. uno snapshot vive più a lungo del VersionedGrid che l'ha pubblicato
+TEST(VersionedGrid, SnapshotOutlivesWriter) {
+    std::shared_ptr<const GridSnapshot> s;
+    {
+        VersionedGrid v(300, 300, false);
+        v.fillRect(Cell{150, 0}, 2, 290, true);
+        s = v.publish();
+        v.fillRect(Cell{150, 290}, 2, 10, true); // mai pubblicato
+    }
+    EXPECT_EQ(s->version(), 1u);
+    EXPECT_EQ(s->tileState(0, 0), GridSnapshot::TileState::Free);
+    EXPECT_EQ(s->mixedTileCount(), 5u); // la colonna di tile x = 2 (150..151)
+    const AStarResult r = ChunkedAStar::findPath(*s, Cell{140, 10}, Cell{160, 10});
+    ASSERT_TRUE(r.success);
+    EXPECT_GE(r.path.size(), 2u * 280u); // giù fino al varco e su
+}
+
+//5. uno scrittore modifica e pubblica mentre più lettori cercano: ogni snapshot resta coerente
+// (da far girare anche con -DTAIKUTSU_SANITIZE=thread)
+TEST(VersionedGrid, ConcurrentEditsAndSearches) {
+    constexpr int kSide = 256;
+    constexpr std::uint64_t kVersions = 300;
+    VersionedGrid v(kSide, kSide, false);
+    writeStamp(v, 1);
+    v.publish();
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> searches{0};
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r] {
+            ChunkedSearchContext ctx;
+            std::mt19937 rng(10 + r);
+            std::uniform_int_distribution<int> coord(1, kSide - 1);
+            std::uint64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto s = v.snapshot();
+                EXPECT_GE(s->version(), last); // versioni in ordine
+                last = s->version();
+                const std::uint64_t stamp = readStamp(*s);
+                EXPECT_EQ(stamp, s->version() & 0xFFFFu);
+
+                const Cell a{coord(rng), coord(rng)}, b{coord(rng), coord(rng)};
+                const AStarResult& res = ChunkedAStar::findPath(ctx, *s, a, b);
+                if (res.success) {
+                    for (const Cell& p : res.path) EXPECT_TRUE(s->isWalkable(p)); // sullo snapshot cercato
+                }
+                EXPECT_EQ(readStamp(*s), stamp); // nessuna modifica durante la ricerca
+                searches.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(1, kSide - 1), len(1, 40), op(0, 3);
+    for (std::uint64_t ver = 2; ver <= kVersions; ++ver) {
+        for (int i = 0; i < 32; ++i) {
+            const Cell c{coord(rng), coord(rng)};
+            if (op(rng) == 0) v.fillRect(c, len(rng), len(rng), (i & 1) != 0);
+            else v.toggleBlocked(c);
+        }
+        writeStamp(v, ver);
+        EXPECT_EQ(v.publish()->version(), ver);
+        if (ver % 16 == 0) std::this_thread::yield(); // su una CPU sola lascia girare i lettori
+    }
+    // almeno qualche ricerca sull'ultima versione
+    while (searches.load(std::memory_order_relaxed) < 3 * 20) std::this_thread::yield();
+    stop = true;
+    for (std::thread& t : readers) t.join();
+    EXPECT_EQ(readStamp(*v.snapshot()), kVersions);
+}
@@ -0,0 +1,95 @@
+// tests/test_hierarchical.cpp
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/Hierarchical.h"
+#include "TestHelpers.h"
+
+// ===================== tests =====================
+
+//1. grid vuoto: percorso valido e vicino all'ottimo
+TEST(Hierarchical, EmptyGrid_ValidNearOptimal) {
+    GridMap g(200, 150);
+    HierarchicalPathfinder hpa(g, 16);
+    const Cell s{3, 5}, t{190, 140};
+
+    const AStarResult& r = hpa.findPath(s, t);
+    ASSERT_TRUE(r.success);
+    EXPECT_EQ(pathCost(g, r.path, s, t, SearchOptions{}), r.cost);
+    EXPECT_LE(r.cost, manhattanCost(s, t) * 13 / 10);
+    EXPECT_GE(r.cost, manhattanCost(s, t));
+}
+
+//2. mappe casuali: stessa raggiungibilità di A*, costo >= ottimo e coerente col path
+TEST(Hierarchical, RandomMaps_AgreeWithAStar) {
+    std::mt19937 rng(21);
+    for (int map = 0; map < 30; ++map) {
+        for (Connectivity c : {Connectivity::Four, Connectivity::Eight}) {
+            GridMap g = randomGrid(70, 55, 0.3, static_cast<unsigned>(map));
+            if (map % 3 == 0) g.setCost(Cell{10, 10}, 9); // qualche mappa pesata
+            SearchOptions opts;
+            opts.connectivity = c;
+            HierarchicalPathfinder hpa(g, 8 + map % 3 * 4, opts);
+
+            std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+            for (int q = 0; q < 20; ++q) {
+                const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+                const AStarResult ref = AStarPathfinder::findPath(g, s, t, opts);
+                const AStarResult& r = hpa.findPath(s, t);
+                ASSERT_EQ(r.success, ref.success) << "map " << map << " (" << s.x << "," << s.y << ")->(" << t.x << "," << t.y << ")";
+                if (!r.success) continue;
+                EXPECT_EQ(pathCost(g, r.path, s, t, opts), r.cost);
+                EXPECT_GE(r.cost, ref.cost);
+            }
+        }
+    }
+}
+
+//3. modifiche incrementali: ricostruisce pochi cluster e risponde come un'astrazione nuova
+TEST(Hierarchical, IncrementalRebuild_MatchesFreshBuild) {
+    GridMap g = randomGrid(128, 128, 0.25, 4);
+    HierarchicalPathfinder hpa(g, 16);
+    EXPECT_EQ(hpa.clusterCount(), 64u);
+
+    std::mt19937 rng(8);
+    std::uniform_int_distribution<int> r(0, 127);
+    for (int round = 0; round < 20; ++round) {
+        for (int e = 0; e < 5; ++e) {
+            const Cell c{r(rng), r(rng)};
+            g.toggleBlocked(c);
+            hpa.notifyChanged(c);
+        }
+        hpa.update();
+        EXPECT_LE(hpa.lastRebuiltClusters(), 5u * 3u); // cluster della cella + al più 2 vicini
+
+        HierarchicalPathfinder fresh(g, 16);
+        for (int q = 0; q < 10; ++q) {
+            const Cell s{r(rng), r(rng)}, t{r(rng), r(rng)};
+            const AStarResult& a = hpa.findPath(s, t);
+            const AStarResult& b = fresh.findPath(s, t);
+            ASSERT_EQ(a.success, b.success);
+            EXPECT_EQ(a.cost, b.cost);
+        }
+    }
+}
+
+//4. start/goal bloccati o uguali, grid ridimensionato
+TEST(Hierarchical, EdgeCases) {
+    GridMap g(40, 40);
+    HierarchicalPathfinder hpa(g, 10);
+    g.setBlocked(Cell{5, 5}, true);
+    hpa.notifyChanged(Cell{5, 5});
+
+    EXPECT_FALSE(hpa.findPath(Cell{5, 5}, Cell{30, 30}).success);
+    EXPECT_FALSE(hpa.findPath(Cell{0, 0}, Cell{40, 0}).success);
+    const AStarResult& same = hpa.findPath(Cell{7, 7}, Cell{7, 7});
+    ASSERT_TRUE(same.success);
+    EXPECT_EQ(same.path.size(), 1u);
+
+    g = GridMap(25, 13); // update() si accorge delle nuove dimensioni
+    const AStarResult& r = hpa.findPath(Cell{0, 0}, Cell{24, 12});
+    ASSERT_TRUE(r.success);
+    EXPECT_EQ(pathCost(g, r.path, Cell{0, 0}, Cell{24, 12}, SearchOptions{}), r.cost);
+}
@@ -0,0 +1,112 @@
+// tests/test_jps.cpp
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/JumpPoint.h"
+#include "TestHelpers.h"
+
+// ===================== tests =====================
+
+//1. grid vuoto: lunghezza = manhattan + 1, pochi jump point espansi
+TEST(JumpPoint, EmptyGrid_OptimalAndFewExpansions) {
+    GridMap g(200, 150);
+    const Cell s{3, 5};
+    const Cell t{190, 140};
+
+    AStarResult jps = JumpPointPathfinder::findPath(g, s, t);
+    AStarResult astar = AStarPathfinder::findPath(g, s, t);
+
+    ASSERT_TRUE(jps.success);
+    assertValidPath(g, jps.path, s, t);
+    EXPECT_EQ(jps.path.size(), astar.path.size());
+    EXPECT_LT(jps.expanded, astar.expanded);
+}
+
+//2. muro verticale che divide il grid: nessun path
+TEST(JumpPoint, NoPath_WhenWallSplitsGrid) {
+    GridMap g(70, 10);
+    g.fillRect(Cell{40, 0}, 1, 10, true);
+
+    AStarResult res = JumpPointPathfinder::findPath(g, Cell{1, 1}, Cell{69, 9});
+    EXPECT_FALSE(res.success);
+    EXPECT_TRUE(res.path.empty());
+}
+
+//3. mappe casuali (diverse densità e larghezze a cavallo delle word): stessa lunghezza di A*
+TEST(JumpPoint, RandomMaps_PathLengthMatchesAStar) {
+    std::mt19937 rng(2024);
+    AStarSearchContext astarCtx;
+    AStarSearchContext jpsCtx;
+
+    for (int map = 0; map < 60; ++map) {
+        const int w = std::uniform_int_distribution<int>(5, 140)(rng);
+        const int h = std::uniform_int_distribution<int>(5, 60)(rng);
+        const double density = 0.05 * (map % 8);
+
+        GridMap g(w, h);
+        std::bernoulli_distribution blocked(density);
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x) g.setBlocked(Cell{x, y}, blocked(rng));
+
+        std::uniform_int_distribution<int> rx(0, w - 1), ry(0, h - 1);
+        for (int q = 0; q < 20; ++q) {
+            const Cell s{rx(rng), ry(rng)};
+            const Cell t{rx(rng), ry(rng)};
+
+            const AStarResult& a = AStarPathfinder::findPath(astarCtx, g, s, t);
+            const AStarResult& j = JumpPointPathfinder::findPath(jpsCtx, g, s, t);
+
+            ASSERT_EQ(a.success, j.success) << "map " << map << " query " << q;
+            if (!a.success) continue;
+            assertValidPath(g, j.path, s, t);
+            ASSERT_EQ(a.path.size(), j.path.size()) << "map " << map << " query " << q;
+        }
+    }
+}
+
+//4. 8 direzioni: stesso costo (octile) di A* 8 direzioni, path valido senza corner-cutting
+TEST(JumpPoint, RandomMaps_EightConnected_CostMatchesAStar) {
+    std::mt19937 rng(99);
+    AStarSearchContext astarCtx;
+    AStarSearchContext jpsCtx;
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+
+    for (int map = 0; map < 60; ++map) {
+        const int w = std::uniform_int_distribution<int>(5, 140)(rng);
+        const int h = std::uniform_int_distribution<int>(5, 60)(rng);
+        GridMap g(w, h);
+        std::bernoulli_distribution blocked(0.05 * (map % 8));
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x) g.setBlocked(Cell{x, y}, blocked(rng));
+
+        std::uniform_int_distribution<int> rx(0, w - 1), ry(0, h - 1);
+        for (int q = 0; q < 20; ++q) {
+            const Cell s{rx(rng), ry(rng)};
+            const Cell t{rx(rng), ry(rng)};
+
+            const AStarResult& a = AStarPathfinder::findPath(astarCtx, g, s, t, opts);
+            const AStarResult& j = JumpPointPathfinder::findPath(jpsCtx, g, s, t, opts);
+
+            ASSERT_EQ(a.success, j.success) << "map " << map << " query " << q;
+            if (!a.success) continue;
+            ASSERT_EQ(a.cost, j.cost) << "map " << map << " query " << q;
+
+            ASSERT_FALSE(j.path.empty());
+            EXPECT_TRUE(j.path.front() == s);
+            EXPECT_TRUE(j.path.back() == t);
+            for (size_t i = 1; i < j.path.size(); ++i) {
+                const Cell p = j.path[i - 1], c = j.path[i];
+                ASSERT_TRUE(g.isWalkable(c));
+                ASSERT_LE(std::abs(c.x - p.x), 1);
+                ASSERT_LE(std::abs(c.y - p.y), 1);
+                if (c.x != p.x && c.y != p.y) {
+                    EXPECT_TRUE(g.isWalkable(Cell{c.x, p.y}) && g.isWalkable(Cell{p.x, c.y})) << "corner cut";
+                }
+            }
+        }
+    }
+}
+
@@ -0,0 +1,194 @@
+// tests/test_landmarks.cpp
+#include <gtest/gtest.h>
+#include <random>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/FlowField.h"
+#include "taikutsu/core/Landmarks.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/ResumableSearch.h"
+#include "taikutsu/core/ThreadPool.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// stessi costi di A* senza landmark, espansioni totali restituite in (plain, alt)
+static std::pair<size_t, size_t> compareWithPlain(const GridMap& g, const LandmarkTable& table, SearchOptions opts,
+                                                  int queries, unsigned seed) {
+    const std::vector<Cell> cells = freeCells(g, 2 * queries, seed);
+    AStarSearchContext a, b;
+    SearchOptions alt = opts;
+    alt.landmarks = &table;
+    size_t plain = 0, withLandmarks = 0;
+    for (int i = 0; i < queries; ++i) {
+        const Cell s = cells[static_cast<size_t>(2 * i)], t = cells[static_cast<size_t>(2 * i + 1)];
+        const AStarResult& ref = AStarPathfinder::findPath(a, g, s, t, opts);
+        const AStarResult& r = AStarPathfinder::findPath(b, g, s, t, alt);
+        EXPECT_EQ(r.success, ref.success);
+        EXPECT_EQ(r.cost, ref.cost);
+        plain += ref.expanded;
+        withLandmarks += r.expanded;
+    }
+    return {plain, withLandmarks};
+}
+
+// ===================== tests =====================
+
+//1. farthest-point: K landmark distinti, liberi, nella componente più grande; il primo è il più
+//   lontano dal seed, quindi in un corridoio a U sta in fondo a uno dei due rami
+TEST(Landmarks, FarthestPointSelection) {
+    GridMap g(40, 21);
+    g.fillRect(Cell{0, 0}, 40, 21, true);
+    g.fillRect(Cell{0, 0}, 40, 1, false);  // riga in alto
+    g.fillRect(Cell{39, 0}, 1, 21, false); // colonna a destra
+    g.fillRect(Cell{0, 20}, 40, 1, false); // riga in basso
+    g.setBlocked(Cell{5, 10}, false);      // cella isolata: mai un landmark
+    LandmarkTable table;
+    LandmarkOptions opts;
+    opts.count = 3;
+    table.build(g, opts);
+    ASSERT_EQ(table.count(), 3);
+    EXPECT_EQ(table.landmarks()[0], (Cell{0, 20})); // seed (0,0): il più lontano è l'altra estremità
+    EXPECT_EQ(table.landmarks()[1], (Cell{0, 0}));
+    for (const Cell& l : table.landmarks()) {
+        EXPECT_TRUE(g.isWalkable(l));
+        EXPECT_FALSE(l == (Cell{5, 10}));
+    }
+    EXPECT_FALSE(table.wide()); // 98 passi (corridoio largo 1: niente diagonali): uint16
+    EXPECT_EQ(table.distance(0, Cell{0, 0}), 98u * kCostStraight);
+    EXPECT_EQ(table.distance(1, Cell{0, 20}), 98u * kCostStraight);
+    EXPECT_EQ(table.distance(0, Cell{5, 10}), LandmarkTable::kUnreachable);
+}
+
+//2. la stima ALT è ammissibile e consistente (4/8 direzioni, con e senza terreno)
+TEST(Landmarks, EstimateAdmissibleAndConsistent) {
+    GridMap g = makeRoomsMap(96, 64, 12, 2);
+    std::mt19937 rng(3);
+    for (int i = 0; i < 800; ++i) g.setCost(freeCells(g, 1, rng())[0], static_cast<std::uint8_t>(1 + rng() % 6));
+    for (const bool eight : {false, true}) {
+        for (const bool terrain : {false, true}) {
+            LandmarkOptions lo;
+            lo.count = 6;
+            lo.connectivity = eight ? Connectivity::Eight : Connectivity::Four;
+            lo.useTerrainCost = terrain;
+            LandmarkTable table;
+            table.build(g, lo);
+            SearchOptions so;
+            so.connectivity = lo.connectivity;
+            so.useTerrainCost = terrain;
+            ASSERT_TRUE(table.usableFor(g, so));
+
+            for (const Cell& goal : freeCells(g, 4, 10 + eight + 2 * terrain)) {
+                FlowField truth;
+                truth.build(g, std::span<const Cell>(&goal, 1), so);
+                const LandmarkHeuristic<ZeroHeuristic> h(table, goal);
+                for (int y = 0; y < g.height(); ++y) {
+                    for (int x = 0; x < g.width(); ++x) {
+                        const Cell c{x, y};
+                        if (!truth.reachable(c)) continue;
+                        const int hc = h.estimate(c, goal);
+                        ASSERT_LE(hc, static_cast<int>(truth.distance(c)));
+                        // consistenza: h(c) <= costo del passo + h(vicino)
+                        const unsigned m = eight ? g.moveMask8(g.index(c)) : g.walkableMask(g.index(c));
+                        for (int d = 0; d < (eight ? 8 : 4); ++d) {
+                            if (!((m >> d) & 1u)) continue;
+                            const Cell n{x + kDirDx[d], y + kDirDy[d]};
+                            const int step = (d >= kDownRight ? kCostDiagonal : kCostStraight) * (terrain ? g.cost(n) : 1);
+                            ASSERT_LE(hc, step + h.estimate(n, goal));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//3. con i landmark A* trova gli stessi costi e su labirinti e stanze espande molto meno;
+//   anche le altre open list e la ricerca a fette usano la tabella
+TEST(Landmarks, AStar_SameCostFewerExpansions) {
+    const GridMap maze = makeMazeMap(128, 128, 2, 4);
+    LandmarkTable table;
+    table.build(maze);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    const auto [plain, alt] = compareWithPlain(maze, table, opts, 40, 5);
+    EXPECT_LT(alt * 2, plain) << plain << " -> " << alt;
+
+    for (const OpenListKind open : {OpenListKind::IndexedHeap, OpenListKind::Radix}) {
+        opts.openList = open;
+        compareWithPlain(maze, table, opts, 20, 6);
+    }
+
+    // 4 direzioni su tabelle a 8: ammissibile (mosse in meno), stessi costi
+    SearchOptions four;
+    compareWithPlain(maze, table, four, 20, 7);
+
+    ResumableSearch search;
+    SearchOptions alt8;
+    alt8.connectivity = Connectivity::Eight;
+    alt8.landmarks = &table;
+    const std::vector<Cell> cells = freeCells(maze, 2, 8);
+    search.start(maze, cells[0], cells[1], alt8);
+    while (search.running()) search.step(64);
+    const AStarResult ref = AStarPathfinder::findPath(maze, cells[0], cells[1], opts);
+    EXPECT_EQ(search.result().cost, ref.cost);
+}
+
+//4. tabelle in parallelo identiche a quelle sequenziali
+TEST(Landmarks, ParallelBuild_SameTables) {
+    const GridMap g = makeRoomsMap(160, 120, 16, 9);
+    LandmarkTable seq, par;
+    LandmarkOptions opts;
+    opts.count = 12;
+    seq.build(g, opts);
+    ThreadPool pool(4);
+    opts.pool = &pool;
+    par.build(g, opts);
+    ASSERT_EQ(par.count(), seq.count());
+    for (int k = 0; k < seq.count(); ++k) {
+        ASSERT_EQ(par.landmarks()[static_cast<size_t>(k)], seq.landmarks()[static_cast<size_t>(k)]);
+        for (int y = 0; y < g.height(); ++y)
+            for (int x = 0; x < g.width(); ++x) ASSERT_EQ(par.distance(k, Cell{x, y}), seq.distance(k, Cell{x, y}));
+    }
+}
+
+//5. tabella non valida per la query: ignorata (grid modificato, mosse in più, terreno più economico)
+TEST(Landmarks, StaleOrIncompatibleTable_Ignored) {
+    GridMap g = makeMazeMap(64, 64, 2, 11);
+    LandmarkTable table;
+    LandmarkOptions four;
+    four.connectivity = Connectivity::Four;
+    table.build(g, four);
+    SearchOptions q4, q8;
+    q8.connectivity = Connectivity::Eight;
+    EXPECT_TRUE(table.usableFor(g, q4));
+    EXPECT_FALSE(table.usableFor(g, q8)); // diagonali: distanze più corte di quelle in tabella
+    EXPECT_FALSE(table.usableFor(GridMap(g), q4)); // copia: altro epoch
+
+    // apriamo una scorciatoia: con la tabella vecchia la stima sarebbe troppo alta
+    g.fillRect(Cell{0, 30}, 64, 2, false);
+    EXPECT_FALSE(table.usableFor(g, q4));
+    SearchOptions alt = q4;
+    alt.landmarks = &table;
+    const Cell s{0, 30}, t{63, 31};
+    ASSERT_TRUE(g.isWalkable(s));
+    const AStarResult r = AStarPathfinder::findPath(g, s, t, alt);
+    EXPECT_EQ(r.cost, 64 * kCostStraight);
+
+    // tabelle con terreno non valgono per query senza (costi più bassi), il contrario sì
+    g.setCost(Cell{1, 30}, 9);
+    LandmarkTable weighted, unit;
+    weighted.build(g);
+    LandmarkOptions noTerrain;
+    noTerrain.useTerrainCost = false;
+    unit.build(g, noTerrain);
+    SearchOptions withTerrain, withoutTerrain;
+    withTerrain.connectivity = withoutTerrain.connectivity = Connectivity::Eight;
+    withoutTerrain.useTerrainCost = false;
+    EXPECT_TRUE(weighted.usableFor(g, withTerrain));
+    EXPECT_FALSE(weighted.usableFor(g, withoutTerrain));
+    EXPECT_TRUE(unit.usableFor(g, withTerrain));
+    EXPECT_TRUE(unit.usableFor(g, withoutTerrain));
+    compareWithPlain(g, weighted, withTerrain, 20, 12);
+    compareWithPlain(g, unit, withTerrain, 20, 13);
+}
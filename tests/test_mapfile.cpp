@@ -0,0 +1,228 @@
+// tests/test_mapfile.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapFile.h"
+#include "taikutsu/core/MovingAI.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// file temporaneo, cancellato a fine test
+struct TempFile {
+    std::string path;
+    explicit TempFile(const char* name)
+        : path((std::filesystem::temp_directory_path() / (std::string("taikutsu_") + name)).string()) {}
+    ~TempFile() { std::filesystem::remove(path); }
+};
+
+static std::string readBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+static void writeBytes(const std::string& path, const std::string& bytes) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// ===================== tests =====================
+
+//1. andata e ritorno: bit e costi identici, A* sulla vista == A* sull'originale
+TEST(MapFile, RoundTrip_ViewSearchesLikeOriginal) {
+    GridMap g = randomGrid(130, 70, 0.25, 1); // 130 + 2 colonne: due word per riga
+    std::mt19937 rng(2);
+    for (int i = 0; i < 500; ++i) g.setCost(Cell{static_cast<int>(rng() % 130), static_cast<int>(rng() % 70)}, 1 + rng() % 9);
+    TempFile file("roundtrip.tkmap");
+    std::string error;
+    ASSERT_TRUE(saveMapFile(file.path, g, {}, &error)) << error;
+
+    const auto view = GridMapView::open(file.path, &error);
+    ASSERT_NE(view, nullptr) << error;
+    const GridMap& v = *view;
+    ASSERT_EQ(v.width(), 130);
+    ASSERT_EQ(v.height(), 70);
+    EXPECT_EQ(view->version(), kMapFileVersion);
+    EXPECT_FALSE(view->hasComponents());
+    EXPECT_TRUE(v.hasCosts());
+    EXPECT_EQ(std::memcmp(v.words(), g.words(), g.wordCount() * sizeof(std::uint64_t)), 0);
+    for (int y = 0; y < 70; ++y)
+        for (int x = 0; x < 130; ++x) ASSERT_EQ(v.cost(Cell{x, y}), g.cost(Cell{x, y}));
+
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    AStarSearchContext a, b;
+    std::uniform_int_distribution<int> rx(0, 129), ry(0, 69);
+    for (int i = 0; i < 40; ++i) {
+        const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+        const AStarResult& ref = AStarPathfinder::findPath(a, g, s, t, opts);
+        const AStarResult& r = AStarPathfinder::findPath(b, v, s, t, opts);
+        ASSERT_EQ(r.success, ref.success);
+        EXPECT_EQ(r.cost, ref.cost);
+        EXPECT_EQ(r.path, ref.path);
+    }
+
+    // senza costi: la vista non ha il layer e il file è più piccolo
+    TempFile plain("plain.tkmap");
+    ASSERT_TRUE(saveMapFile(plain.path, g, MapFileOptions{false, false}, &error)) << error;
+    const auto pv = GridMapView::open(plain.path, &error);
+    ASSERT_NE(pv, nullptr) << error;
+    EXPECT_FALSE(pv->grid().hasCosts());
+    EXPECT_LT(pv->fileBytes(), view->fileBytes());
+}
+
+//2. componenti precalcolate: stesse risposte di un ConnectivityIndex costruito sul grid
+TEST(MapFile, Components_MatchFreshIndex) {
+    const GridMap g = randomGrid(90, 60, 0.4, 3); // molte componenti
+    TempFile file("components.tkmap");
+    ASSERT_TRUE(saveMapFile(file.path, g, MapFileOptions{true, true}));
+    const auto view = GridMapView::open(file.path);
+    ASSERT_NE(view, nullptr);
+    ASSERT_TRUE(view->hasComponents());
+
+    const std::optional<ConnectivityIndex> loaded = view->components();
+    ASSERT_TRUE(loaded.has_value());
+    const ConnectivityIndex fresh(g);
+    EXPECT_EQ(loaded->componentCount(), fresh.componentCount());
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int> rx(0, 89), ry(0, 59);
+    for (int i = 0; i < 2000; ++i) {
+        const Cell a{rx(rng), ry(rng)}, b{rx(rng), ry(rng)};
+        ASSERT_EQ(loaded->connected(a, b), fresh.connected(a, b));
+    }
+}
+
+//3. la copia di una vista è un GridMap normale: modificarla non tocca la vista né il file
+TEST(MapFile, CopyOfView_IsMutableAndIndependent) {
+    const GridMap g = randomGrid(40, 40, 0.0, 5);
+    TempFile file("copy.tkmap");
+    ASSERT_TRUE(saveMapFile(file.path, g));
+    const std::string before = readBytes(file.path);
+    const auto view = GridMapView::open(file.path);
+    ASSERT_NE(view, nullptr);
+
+    GridMap copy = view->grid();
+    copy.setBlocked(Cell{10, 10}, true);
+    copy.setCost(Cell{11, 11}, 7);
+    EXPECT_FALSE(copy.isWalkable(Cell{10, 10}));
+    EXPECT_TRUE(view->grid().isWalkable(Cell{10, 10}));
+    EXPECT_EQ(view->grid().cost(Cell{11, 11}), 1);
+    EXPECT_FALSE(view->grid().hasCosts());
+
+    const std::optional<GridMap> loaded = loadMapFile(file.path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_TRUE(loaded->isWalkable(Cell{10, 10}));
+    EXPECT_EQ(readBytes(file.path), before);
+}
+
+//4. file rovinati: rifiutati con un messaggio, mai una vista che esce dal grid
+TEST(MapFile, Open_RejectsCorruptFiles) {
+    const GridMap g = randomGrid(50, 30, 0.2, 6);
+    std::ostringstream out;
+    ASSERT_TRUE(saveMapFile(out, g, MapFileOptions{true, true}));
+    const std::string good = out.str();
+    TempFile file("corrupt.tkmap");
+
+    auto rejected = [&](std::string bytes) {
+        writeBytes(file.path, bytes);
+        std::string error;
+        const bool failed = GridMapView::open(file.path, &error) == nullptr;
+        EXPECT_EQ(failed, !error.empty());
+        return failed;
+    };
+    EXPECT_FALSE(rejected(good));
+
+    std::string bad = good;
+    bad[0] = 'X'; // magic
+    EXPECT_TRUE(rejected(bad));
+    bad = good;
+    bad[8] = static_cast<char>(kMapFileVersion + 1); // versione futura
+    EXPECT_TRUE(rejected(bad));
+    EXPECT_TRUE(rejected(good.substr(0, good.size() - 4))); // troncato
+    EXPECT_TRUE(rejected(good.substr(0, 40)));               // header incompleto
+    bad = good;
+    bad[64] = 1; // primo bit della cornice sentinella (riga 0)
+    EXPECT_TRUE(rejected(bad));
+    // id di componente fuori range: la vista si apre, le componenti no
+    bad = good;
+    std::uint64_t componentsOffset = 0;
+    std::memcpy(&componentsOffset, good.data() + 48, sizeof(componentsOffset));
+    const std::uint32_t badLabel = 1000000;
+    std::memcpy(bad.data() + componentsOffset + 8, &badLabel, sizeof(badLabel));
+    EXPECT_FALSE(rejected(bad));
+    const auto view = GridMapView::open(file.path);
+    ASSERT_NE(view, nullptr);
+    EXPECT_TRUE(view->hasComponents());
+    EXPECT_FALSE(view->components().has_value());
+    // id nel range ma incoerenti con i bit: ostacolo con id, cella libera senza id, conteggi
+    auto word = [&](std::uint64_t at) {
+        std::uint32_t v = 0;
+        std::memcpy(&v, good.data() + at, sizeof(v));
+        return v;
+    };
+    const std::uint32_t componentCount = word(componentsOffset);
+    ASSERT_GE(componentCount, 2u);
+    size_t blockedAt = 0, freeAt = 0; // celle y * width + x
+    for (size_t c = 0; c < 50u * 30u; ++c) (word(componentsOffset + 8 + c * 4) == 0 ? blockedAt : freeAt) = c;
+    const std::uint32_t freeLabel = word(componentsOffset + 8 + freeAt * 4);
+    auto componentsRejected = [&](size_t cell, std::uint32_t label) {
+        std::string patched = good;
+        std::memcpy(patched.data() + componentsOffset + 8 + cell * 4, &label, sizeof(label));
+        writeBytes(file.path, patched);
+        const auto v = GridMapView::open(file.path);
+        return v != nullptr && v->hasComponents() && !v->components().has_value();
+    };
+    EXPECT_TRUE(componentsRejected(blockedAt, freeLabel));           // ostacolo con un id
+    EXPECT_TRUE(componentsRejected(freeAt, 0));                      // cella libera senza id
+    EXPECT_TRUE(componentsRejected(freeAt, freeLabel == 1 ? 2 : 1)); // id valido, conteggi sbagliati
+
+    // costo 0 nel layer dei costi (GridMap::setCost non lo scrive mai)
+    GridMap weighted = g;
+    weighted.setCost(Cell{3, 2}, 5);
+    std::ostringstream weightedOut;
+    ASSERT_TRUE(saveMapFile(weightedOut, weighted, MapFileOptions{true, false}));
+    bad = weightedOut.str();
+    EXPECT_FALSE(rejected(bad));
+    std::uint64_t costOffset = 0;
+    std::memcpy(&costOffset, bad.data() + 40, sizeof(costOffset));
+    bad[costOffset + static_cast<size_t>(weighted.index(Cell{7, 4}))] = 0;
+    EXPECT_TRUE(rejected(bad));
+
+    std::string error;
+    EXPECT_EQ(GridMapView::open(file.path + ".missing", &error), nullptr);
+    EXPECT_FALSE(error.empty());
+}
+
+//5. ASCII semplice: ostacoli, costi, righe corte completate con celle libere
+TEST(MapFile, AsciiLoader_CostsAndBlocked) {
+    std::istringstream in("..#.5\n"
+                          "@ 9\n"
+                          "\n"
+                          "T..W.\n"
+                          "\n");
+    std::string error;
+    const std::optional<GridMap> g = loadAsciiMap(in, &error);
+    ASSERT_TRUE(g.has_value()) << error;
+    EXPECT_EQ(g->width(), 5);
+    EXPECT_EQ(g->height(), 4); // righe vuote in fondo ignorate, quella in mezzo no
+    EXPECT_FALSE(g->isWalkable(Cell{2, 0}));
+    EXPECT_FALSE(g->isWalkable(Cell{0, 1}));
+    EXPECT_FALSE(g->isWalkable(Cell{0, 3}));
+    EXPECT_FALSE(g->isWalkable(Cell{3, 3}));
+    EXPECT_TRUE(g->isWalkable(Cell{1, 1}));
+    EXPECT_TRUE(g->isWalkable(Cell{4, 1})); // completata
+    EXPECT_TRUE(g->isWalkable(Cell{0, 2}));
+    EXPECT_EQ(g->cost(Cell{4, 0}), 5);
+    EXPECT_EQ(g->cost(Cell{2, 1}), 9);
+    EXPECT_EQ(g->cost(Cell{1, 0}), 1);
+
+    std::istringstream bad("..x.\n");
+    EXPECT_FALSE(loadAsciiMap(bad, &error).has_value());
+    EXPECT_NE(error.find("line 1"), std::string::npos) << error;
+}
@@ -0,0 +1,97 @@
+// tests/test_movingai.cpp
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/MovingAI.h"
+
+// ===================== tests =====================
+
+//1. .map: header in qualsiasi ordine, terreni percorribili e non, CRLF
+TEST(MovingAI, LoadMap_ParsesTerrain) {
+    std::istringstream in("type octile\r\nwidth 5\r\nheight 3\r\nmap\r\n"
+                          ".G@S.\r\n"
+                          "TTW..\r\n"
+                          "....O\r\n");
+    std::string error;
+    const auto g = loadMovingAIMap(in, &error);
+    ASSERT_TRUE(g.has_value()) << error;
+    EXPECT_EQ(g->width(), 5);
+    EXPECT_EQ(g->height(), 3);
+    const char* expected[3] = {"..@..", "@@@..", "....@"};
+    for (int y = 0; y < 3; ++y)
+        for (int x = 0; x < 5; ++x) EXPECT_EQ(g->isBlocked(Cell{x, y}), expected[y][x] == '@') << x << "," << y;
+}
+
+//2. .map malformati: nessun grid, errore con numero di riga
+TEST(MovingAI, LoadMap_RejectsMalformedInput) {
+    std::string error;
+    std::istringstream missingRows("type octile\nheight 3\nwidth 2\nmap\n..\n..\n");
+    EXPECT_FALSE(loadMovingAIMap(missingRows, &error).has_value());
+    EXPECT_NE(error.find("rows"), std::string::npos);
+
+    std::istringstream badTerrain("type octile\nheight 1\nwidth 3\nmap\n.x.\n");
+    EXPECT_FALSE(loadMovingAIMap(badTerrain, &error).has_value());
+    EXPECT_EQ(error.rfind("line 5", 0), 0u) << error;
+
+    std::istringstream noSize("type octile\nmap\n");
+    EXPECT_FALSE(loadMovingAIMap(noSize, &error).has_value());
+}
+
+//3. save -> load restituisce lo stesso grid
+TEST(MovingAI, SaveLoad_RoundTrip) {
+    const GridMap src = makeRandomMap(70, 33, 0.3, 5);
+    std::stringstream buf;
+    saveMovingAIMap(buf, src);
+    const auto g = loadMovingAIMap(buf);
+    ASSERT_TRUE(g.has_value());
+    for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x) ASSERT_EQ(g->isBlocked(Cell{x, y}), src.isBlocked(Cell{x, y}));
+}
+
+//4. .scen: versione opzionale, righe vuote ignorate, campi nell'ordine standard
+TEST(MovingAI, LoadScenarios_ParsesFields) {
+    std::istringstream in("version 1\n"
+                          "0\tmaps/arena.map\t49\t49\t1\t11\t1\t12\t1\n"
+                          "\n"
+                          "3\tmaps/arena.map\t49\t49\t5\t6\t15\t13\t12.89949494\n");
+    std::string error;
+    const auto s = loadMovingAIScenarios(in, &error);
+    ASSERT_TRUE(s.has_value()) << error;
+    ASSERT_EQ(s->size(), 2u);
+    EXPECT_EQ((*s)[1].bucket, 3);
+    EXPECT_EQ((*s)[1].map, "maps/arena.map");
+    EXPECT_EQ((*s)[1].mapWidth, 49);
+    EXPECT_TRUE((*s)[1].start == (Cell{5, 6}));
+    EXPECT_TRUE((*s)[1].goal == (Cell{15, 13}));
+    EXPECT_NEAR((*s)[1].optimalLength, 12.89949494, 1e-9);
+
+    std::istringstream bad("version 1\n0\tm.map\t4\t4\t1\t1\n");
+    EXPECT_FALSE(loadMovingAIScenarios(bad, &error).has_value());
+}
+
+//5. generatori: riproducibili, densità circa giusta, labirinti e stanze connessi
+TEST(MapGenerators, Families_HaveExpectedShape) {
+    const GridMap r1 = makeRandomMap(200, 200, 0.25, 9);
+    const GridMap r2 = makeRandomMap(200, 200, 0.25, 9);
+    int blocked = 0;
+    for (int y = 0; y < 200; ++y) {
+        for (int x = 0; x < 200; ++x) {
+            blocked += r1.isBlocked(Cell{x, y});
+            ASSERT_EQ(r1.isBlocked(Cell{x, y}), r2.isBlocked(Cell{x, y}));
+        }
+    }
+    EXPECT_NEAR(blocked / 40000.0, 0.25, 0.02);
+
+    const GridMap maze = makeMazeMap(101, 77, 3, 10);
+    EXPECT_EQ(ConnectivityIndex(maze).componentCount(), 1u);
+    EXPECT_TRUE(maze.isWalkable(Cell{0, 0}));
+    EXPECT_TRUE(maze.isBlocked(Cell{3, 3})); // angolo di muro tra quattro celle del labirinto
+
+    const GridMap rooms = makeRoomsMap(150, 90, 16, 11, 0.0);
+    EXPECT_EQ(ConnectivityIndex(rooms).componentCount(), 1u);
+    EXPECT_TRUE(rooms.isBlocked(Cell{16, 16}));
+
+    EXPECT_EQ(ConnectivityIndex(makeOpenMap(40, 30)).componentCount(), 1u);
+}
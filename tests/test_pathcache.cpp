@@ -0,0 +1,164 @@
+// tests/test_pathcache.cpp
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/PathCache.h"
+#include "TestHelpers.h"
+
+// ===================== tests =====================
+
+//1. hit: stesso path e costo di A*, closed vuoto; i contatori tornano
+TEST(PathCache, Hit_ReturnsSamePathAsAStar) {
+    GridMap g(96, 64);
+    randomize(g, 1, 0.2);
+    g.fillRect(Cell{0, 0}, 3, 3, false);
+    g.fillRect(Cell{93, 61}, 3, 3, false);
+    PathCache cache(g, 16);
+
+    const AStarResult ref = AStarPathfinder::findPath(g, Cell{0, 0}, Cell{95, 63});
+    ASSERT_TRUE(ref.success);
+    const AStarResult first = cache.findPath(Cell{0, 0}, Cell{95, 63});
+    EXPECT_EQ(first.path, ref.path);
+
+    const AStarResult& hit = cache.findPath(Cell{0, 0}, Cell{95, 63});
+    EXPECT_TRUE(hit.success);
+    EXPECT_EQ(hit.path, ref.path);
+    EXPECT_EQ(hit.cost, ref.cost);
+    EXPECT_TRUE(hit.closed.empty());
+    EXPECT_EQ(cache.stats().hits, 1u);
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+//2. un blocco su una regione attraversata invalida; uno in una regione lontana no
+TEST(PathCache, Block_InvalidatesOnlyCrossedRegions) {
+    GridMap g(128, 128);
+    PathCache cache(g, 8);
+    const Cell s{0, 5}, t{100, 5}; // corridoio in alto: regioni della prima riga
+    cache.findPath(s, t);
+
+    g.setBlocked(Cell{10, 120}, true); // regione mai attraversata
+    cache.findPath(s, t);
+    EXPECT_EQ(cache.stats().hits, 1u);
+
+    const AStarResult before = cache.findPath(s, t);
+    g.setBlocked(before.path[before.path.size() / 2], true);
+    const AStarResult& after = cache.findPath(s, t);
+    EXPECT_EQ(cache.stats().invalidations, 1u);
+    EXPECT_EQ(after.cost, AStarPathfinder::findPath(g, s, t).cost);
+}
+
+//3. uno sblocco lontano non tocca il percorso; uno che apre una scorciatoia sì
+TEST(PathCache, Unblock_InvalidatesOnlyPossibleShortcuts) {
+    GridMap g(128, 256);
+    for (int y = 0; y < 90; ++y) g.setBlocked(Cell{64, y}, true); // muro con passaggio sotto
+    g.setBlocked(Cell{5, 250}, true);                             // ostacolo lontano dal percorso
+    PathCache cache(g, 8);
+    const Cell s{10, 10}, t{120, 10};
+    const int detour = cache.findPath(s, t).cost;
+
+    g.setBlocked(Cell{5, 250}, false); // non può accorciare (lower bound >= costo)
+    EXPECT_EQ(cache.findPath(s, t).cost, detour);
+    EXPECT_EQ(cache.stats().hits, 1u);
+    EXPECT_EQ(cache.stats().invalidations, 0u);
+
+    g.setBlocked(Cell{64, 10}, false); // buco nel muro: scorciatoia
+    const AStarResult& r = cache.findPath(s, t);
+    EXPECT_EQ(cache.stats().invalidations, 1u);
+    EXPECT_LT(r.cost, detour);
+    EXPECT_EQ(r.cost, AStarPathfinder::findPath(g, s, t).cost);
+}
+
+//4. LRU: alla capacità esce la coppia usata meno di recente
+TEST(PathCache, Capacity_EvictsLeastRecentlyUsed) {
+    GridMap g(40, 40);
+    PathCache cache(g, 2);
+    cache.findPath(Cell{0, 0}, Cell{10, 0}); // A
+    cache.findPath(Cell{0, 1}, Cell{10, 1}); // B
+    cache.findPath(Cell{0, 0}, Cell{10, 0}); // A più recente di B
+    cache.findPath(Cell{0, 2}, Cell{10, 2}); // C: esce B
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(cache.size(), 2u);
+
+    const std::uint64_t hits = cache.stats().hits;
+    cache.findPath(Cell{0, 0}, Cell{10, 0});
+    EXPECT_EQ(cache.stats().hits, hits + 1);
+    cache.findPath(Cell{0, 1}, Cell{10, 1});
+    EXPECT_EQ(cache.stats().hits, hits + 1); // B era uscita
+}
+
+//5. grid riassegnato / ridimensionato: tutto scartato
+TEST(PathCache, GridReassigned_ClearsEverything) {
+    GridMap g(50, 50);
+    PathCache cache(g, 8);
+    cache.findPath(Cell{0, 0}, Cell{49, 49});
+    cache.findPath(Cell{0, 49}, Cell{49, 0});
+
+    GridMap other(50, 50);
+    other.fillRect(Cell{25, 0}, 1, 50, true);
+    g = other;
+    EXPECT_FALSE(cache.findPath(Cell{0, 0}, Cell{49, 49}).success);
+    EXPECT_EQ(cache.stats().invalidations, 2u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+//6. casuale: query ripetute e modifiche (blocchi, sblocchi, costi) intercalate;
+//   il costo restituito è sempre quello di A* sul grid attuale
+TEST(PathCache, Randomized_AlwaysMatchesFreshSearch) {
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        GridMap g(150, 110);
+        randomize(g, 7, 0.25);
+        SearchOptions opts;
+        opts.connectivity = conn;
+        PathCache cache(g, 24, opts);
+
+        std::mt19937 rng(8);
+        std::uniform_int_distribution<int> rx(0, 149), ry(0, 109), pick(0, 39), edit(0, 5), cost(1, 4);
+        std::vector<std::pair<Cell, Cell>> pairs;
+        for (int i = 0; i < 40; ++i) pairs.emplace_back(Cell{rx(rng), ry(rng)}, Cell{rx(rng), ry(rng)});
+
+        for (int i = 0; i < 1500; ++i) {
+            if (edit(rng) == 0) {
+                const Cell c{rx(rng), ry(rng)};
+                if (i % 3 == 0) g.setCost(c, static_cast<std::uint8_t>(cost(rng)));
+                else g.toggleBlocked(c);
+            }
+            const auto& q = pairs[static_cast<size_t>(pick(rng))];
+            const AStarResult& r = cache.findPath(q.first, q.second);
+            const AStarResult ref = AStarPathfinder::findPath(g, q.first, q.second, opts);
+            ASSERT_EQ(r.success, ref.success) << "query " << i;
+            if (!r.success) continue;
+            ASSERT_EQ(r.cost, ref.cost) << "query " << i;
+            for (size_t k = 1; k < r.path.size(); ++k) ASSERT_TRUE(g.isWalkable(r.path[k]));
+        }
+        EXPECT_GT(cache.stats().hits, 0u);
+        EXPECT_GT(cache.stats().invalidations, 0u);
+    }
+}
+
+//7. 8 direzioni: una diagonale dipende dalle due celle d'angolo, anche in regioni dove il percorso
+//   non entra (qui (32, 31) sta nella regione 1, il percorso in 0 e 3)
+TEST(PathCache, DiagonalCornerInOtherRegion_Invalidates) {
+    GridMap g(64, 64);
+    SearchOptions opts;
+    opts.connectivity = Connectivity::Eight;
+    PathCache cache(g, 8, opts);
+    const Cell s{31, 31}, t{32, 32}, corner{32, 31};
+    ASSERT_NE(g.regionOf(corner), g.regionOf(s));
+    ASSERT_NE(g.regionOf(corner), g.regionOf(t));
+    EXPECT_EQ(cache.findPath(s, t).cost, kCostDiagonal);
+
+    g.setBlocked(corner, true); // la diagonale non è più legale
+    const AStarResult& blocked = cache.findPath(s, t);
+    EXPECT_EQ(cache.stats().invalidations, 1u);
+    EXPECT_EQ(blocked.cost, 2 * kCostStraight);
+    EXPECT_EQ(blocked.path.size(), 3u);
+    EXPECT_EQ(blocked.cost, AStarPathfinder::findPath(g, s, t, opts).cost);
+
+    g.setBlocked(corner, false); // di nuovo legale: lo sblocco nella regione 1 deve scartare i 200
+    const AStarResult& relaxed = cache.findPath(s, t);
+    EXPECT_EQ(cache.stats().invalidations, 2u);
+    EXPECT_EQ(relaxed.cost, kCostDiagonal);
+}
@@ -0,0 +1,211 @@
+// tests/test_pathdatabase.cpp
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/MapGenerators.h"
+#include "taikutsu/core/PathDatabase.h"
+#include "taikutsu/core/ThreadPool.h"
+
+// ===================== helpers =====================
+
+// stanze con porte, qualche ostacolo sparso, terreno a chiazze e una cella isolata
+static GridMap arena(int w, int h, unsigned seed) {
+    GridMap g = makeRoomsMap(w, h, 8, seed);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> rx(0, w - 1), ry(0, h - 1), rc(1, 6);
+    for (int i = 0; i < w * h / 12; ++i) g.setBlocked(Cell{rx(rng), ry(rng)}, true);
+    for (int i = 0; i < w * h / 6; ++i) g.setCost(Cell{rx(rng), ry(rng)}, static_cast<std::uint8_t>(rc(rng)));
+    g.fillRect(Cell{0, 0}, 3, 3, true);
+    g.setBlocked(Cell{1, 1}, false);
+    return g;
+}
+
+static std::vector<Cell> walkableCells(const GridMap& g) {
+    std::vector<Cell> out;
+    for (int y = 0; y < g.height(); ++y)
+        for (int x = 0; x < g.width(); ++x)
+            if (g.isWalkable(Cell{x, y})) out.push_back(Cell{x, y});
+    return out;
+}
+
+// ogni sorgente verso un target ogni targetStep: stesso esito e stesso costo di A*,
+// percorso valido passo per passo
+static void expectSameAsAStar(const GridMap& g, const PathDatabase& db, const SearchOptions& opts, size_t targetStep) {
+    const std::vector<Cell> cells = walkableCells(g);
+    AStarSearchContext ctx;
+    AStarResult r;
+    for (const Cell& s : cells) {
+        for (size_t j = 0; j < cells.size(); j += targetStep) {
+            const Cell t = cells[j];
+            const AStarResult& ref = AStarPathfinder::findPath(ctx, g, s, t, opts);
+            db.findPath(g, s, t, r);
+            ASSERT_EQ(r.success, ref.success) << s.x << "," << s.y << " -> " << t.x << "," << t.y;
+            ASSERT_EQ(r.cost, ref.cost) << s.x << "," << s.y << " -> " << t.x << "," << t.y;
+            if (!r.success) continue;
+            ASSERT_TRUE(r.path.front() == s);
+            ASSERT_TRUE(r.path.back() == t);
+            EXPECT_EQ(r.expanded + 1, r.path.size()); // un lookup per passo
+        }
+    }
+}
+
+static std::string serialized(const PathDatabase& db) {
+    std::ostringstream out;
+    EXPECT_TRUE(db.save(out));
+    return out.str();
+}
+
+// ===================== tests =====================
+
+//1. le coppie di un'arena: stessi costi di A* con 4/8 direzioni, con e senza terreno,
+//   e "nessun percorso" verso la cella isolata
+TEST(PathDatabase, AllPairsMatchAStar) {
+    const GridMap g = arena(22, 16, 91);
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        for (const bool terrain : {false, true}) {
+            PathDatabaseOptions po;
+            po.connectivity = conn;
+            po.useTerrainCost = terrain;
+            PathDatabase db;
+            ASSERT_TRUE(db.build(g, po));
+            SearchOptions so;
+            so.connectivity = conn;
+            so.useTerrainCost = terrain;
+            ASSERT_TRUE(db.usableFor(so));
+            expectSameAsAStar(g, db, so, 3);
+        }
+    }
+    PathDatabase db;
+    ASSERT_TRUE(db.build(g));
+    EXPECT_EQ(db.firstMove(Cell{1, 1}, Cell{10, 10}), PathDatabase::kNoMove); // cella isolata
+    EXPECT_EQ(db.firstMove(Cell{10, 10}, Cell{1, 1}), PathDatabase::kNoMove);
+    EXPECT_EQ(db.firstMove(Cell{0, 0}, Cell{10, 10}), PathDatabase::kNoMove);  // start bloccato
+    EXPECT_EQ(db.firstMove(Cell{10, 10}, Cell{10, 10}), PathDatabase::kNoMove); // start == goal
+    EXPECT_EQ(db.firstMove(Cell{-1, 0}, Cell{10, 10}), PathDatabase::kNoMove);
+    const AStarResult same = db.findPath(g, Cell{10, 10}, Cell{10, 10});
+    EXPECT_TRUE(same.success);
+    EXPECT_EQ(same.path.size(), 1u);
+}
+
+//2. compressione: su una mappa aperta le prime mosse cambiano poco da un target al vicino,
+//   quindi i run sono molti meno dei target
+TEST(PathDatabase, RunLengthCompression) {
+    const GridMap open(40, 40);
+    PathDatabase db;
+    ASSERT_TRUE(db.build(open));
+    const size_t cells = 40 * 40;
+    EXPECT_LT(db.runCount(), cells * cells / 20);
+
+    const GridMap maze = makeMazeMap(40, 40, 1, 92);
+    PathDatabase mdb;
+    ASSERT_TRUE(mdb.build(maze));
+    EXPECT_LT(mdb.runCount(), walkableCells(maze).size() * walkableCells(maze).size() / 4);
+}
+
+//3. con un ThreadPool: stesso database byte per byte
+TEST(PathDatabase, ParallelBuild_SameDatabase) {
+    const GridMap g = arena(48, 40, 93);
+    ThreadPool pool(4);
+    for (const Connectivity conn : {Connectivity::Four, Connectivity::Eight}) {
+        PathDatabaseOptions po;
+        po.connectivity = conn;
+        PathDatabase seq, par;
+        ASSERT_TRUE(seq.build(g, po));
+        po.pool = &pool;
+        ASSERT_TRUE(par.build(g, po));
+        EXPECT_EQ(serialized(seq), serialized(par));
+    }
+}
+
+//4. salvataggio e caricamento: stesse prime mosse; matches() riconosce il grid (anche copiato)
+//   e rifiuta quello modificato; usableFor() solo con le stesse regole
+TEST(PathDatabase, SaveLoadRoundTrip) {
+    GridMap g = arena(30, 22, 94);
+    PathDatabaseOptions po;
+    po.connectivity = Connectivity::Eight;
+    po.cornerCutting = true;
+    PathDatabase db;
+    ASSERT_TRUE(db.build(g, po));
+    std::istringstream in(serialized(db));
+    std::string error;
+    const auto loaded = PathDatabase::load(in, &error);
+    ASSERT_TRUE(loaded.has_value()) << error;
+    EXPECT_EQ(loaded->runCount(), db.runCount());
+    const std::vector<Cell> cells = walkableCells(g);
+    for (size_t i = 0; i < cells.size(); i += 3)
+        for (size_t j = 0; j < cells.size(); j += 5) ASSERT_EQ(loaded->firstMove(cells[i], cells[j]), db.firstMove(cells[i], cells[j]));
+
+    EXPECT_TRUE(loaded->matches(GridMap(g)));
+    SearchOptions so;
+    so.connectivity = Connectivity::Eight;
+    so.cornerCutting = true;
+    EXPECT_TRUE(loaded->usableFor(so));
+    so.cornerCutting = false;
+    EXPECT_FALSE(loaded->usableFor(so));
+    so.cornerCutting = true;
+    so.useTerrainCost = false;
+    EXPECT_FALSE(loaded->usableFor(so)); // tabelle con il terreno
+    so.connectivity = Connectivity::Four;
+    EXPECT_FALSE(loaded->usableFor(so));
+
+    const std::uint8_t before = g.cost(cells[7]);
+    g.setCost(cells[7], before == 9 ? 8 : 9);
+    EXPECT_FALSE(loaded->matches(g));
+    g.setCost(cells[7], before);
+    EXPECT_TRUE(loaded->matches(g));
+    g.setBlocked(cells[8], true);
+    EXPECT_FALSE(loaded->matches(g));
+}
+
+//5. file sbagliati o rovinati: rifiutati con un errore, mai un database a metà
+TEST(PathDatabase, CorruptOrTruncatedFilesRejected) {
+    const GridMap g = arena(20, 16, 95);
+    PathDatabase db;
+    ASSERT_TRUE(db.build(g));
+    const std::string good = serialized(db);
+
+    auto rejected = [](const std::string& bytes) {
+        std::istringstream in(bytes);
+        std::string error;
+        const bool failed = !PathDatabase::load(in, &error).has_value();
+        EXPECT_EQ(failed, !error.empty());
+        return failed;
+    };
+    EXPECT_FALSE(rejected(good));
+    EXPECT_TRUE(rejected(good.substr(0, good.size() - 4)));  // run troncati
+    EXPECT_TRUE(rejected(good.substr(0, 40)));               // header troncato
+    std::string magic = good;
+    magic[0] = 'X';
+    EXPECT_TRUE(rejected(magic));
+    std::string version = good;
+    version[8] = 99; // versione futura
+    EXPECT_TRUE(rejected(version));
+    std::string run = good;
+    run[run.size() - 4] = 0x0E; // mossa 14 nell'ultimo run
+    EXPECT_TRUE(rejected(run));
+    std::string offsets = good;
+    const size_t cells = 20 * 16;
+    const size_t offsetsAt = (64 + cells * 4 + 63) / 64 * 64;
+    offsets[offsetsAt + cells * 8] ^= 1; // offsets[cells] != runCount
+    EXPECT_TRUE(rejected(offsets));
+    std::string farOffsets = good; // offsets {0, 1e8, 2e8, ...}: crescenti ma fuori dai run
+    for (const auto& [i, v] : {std::pair<size_t, std::uint64_t>{1, 100000000}, {2, 200000000}})
+        std::memcpy(farOffsets.data() + offsetsAt + i * 8, &v, sizeof(v));
+    EXPECT_TRUE(rejected(farOffsets));
+
+    // runCount enorme su un file corto: rifiutato dall'header, prima di allocare i run
+    auto withHeader = [&](std::uint64_t runCount, std::uint64_t fileBytes) {
+        std::string bytes = good;
+        std::memcpy(bytes.data() + 40, &runCount, sizeof(runCount));
+        std::memcpy(bytes.data() + 48, &fileBytes, sizeof(fileBytes));
+        return bytes;
+    };
+    const std::uint64_t runsAt = (offsetsAt + (cells + 1) * 8 + 63) / 64 * 64;
+    const std::uint64_t huge = std::uint64_t{1} << 40;
+    EXPECT_TRUE(rejected(withHeader(huge, good.size())));         // fileBytes non torna col layout
+    EXPECT_TRUE(rejected(withHeader(huge, runsAt + huge * 4)));   // torna, ma oltre la fine dello stream
+    EXPECT_TRUE(rejected(withHeader(db.runCount(), good.size() + 4)));
+}
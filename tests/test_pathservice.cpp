@@ -0,0 +1,220 @@
+// tests/test_pathservice.cpp
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/PathService.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+// le callback girano dopo che il future è pronto: attende che il servizio sia fermo
+static void waitIdle(const PathService& service) {
+    while (service.stats().inFlight != 0) std::this_thread::yield();
+}
+
+// tiene occupato l'unico worker dentro una callback finché open() non viene chiamato,
+// così le richieste successive restano in coda
+class WorkerGate {
+public:
+    PathService::PathTicket block(PathService& service) {
+        auto ticket = service.submit(Cell{0, 0}, Cell{0, 0}, [this](const PathResponse&) {
+            entered_.set_value();
+            released_.wait();
+        });
+        entered_.get_future().wait();
+        return ticket;
+    }
+    void open() { gate_.set_value(); }
+
+private:
+    std::promise<void> entered_, gate_;
+    std::shared_future<void> released_{gate_.get_future().share()};
+};
+
+// ===================== tests =====================
+
+//1. le risposte sono quelle di AStarPathfinder (path e costo)
+TEST(PathService, Responses_MatchAStar) {
+    const auto g = std::make_shared<GridMap>(randomGrid(80, 60, 0.25, 1));
+    PathService service(g, 4);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> rx(0, 79), ry(0, 59);
+
+    std::vector<std::pair<Cell, Cell>> queries;
+    std::vector<PathService::PathTicket> tickets;
+    for (int i = 0; i < 200; ++i) {
+        const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+        queries.emplace_back(s, t);
+        tickets.push_back(service.submit(s, t));
+    }
+    for (size_t i = 0; i < tickets.size(); ++i) {
+        const PathResponse& r = tickets[i].get();
+        const AStarResult ref = AStarPathfinder::findPath(*g, queries[i].first, queries[i].second);
+        ASSERT_EQ(r.status, ref.success ? SearchStatus::Found : SearchStatus::NoPath);
+        EXPECT_EQ(r.path, ref.path);
+        EXPECT_EQ(r.cost, ref.cost);
+        EXPECT_EQ(r.gridVersion, service.gridVersion());
+    }
+    waitIdle(service);
+    const PathServiceStats st = service.stats();
+    EXPECT_EQ(st.submitted, 200u);
+    EXPECT_EQ(st.completed + st.coalesced, 200u);
+    EXPECT_EQ(st.queueDepth, 0u);
+    EXPECT_EQ(st.inFlight, 0u);
+    EXPECT_GT(st.p99Us, 0.0);
+    EXPECT_LE(st.p50Us, st.p99Us);
+}
+
+//2. richieste identiche in volo condividono la ricerca; callback chiamate una volta ciascuna
+TEST(PathService, IdenticalRequests_AreCoalesced) {
+    const auto g = std::make_shared<GridMap>(randomGrid(40, 40, 0.2, 3));
+    PathService service(g, 1);
+    WorkerGate gate;
+    auto blocker = gate.block(service);
+
+    std::atomic<int> calls{0};
+    auto a = service.submit(Cell{1, 1}, Cell{38, 38}, [&](const PathResponse&) { ++calls; });
+    auto b = service.submit(Cell{1, 1}, Cell{38, 38}, [&](const PathResponse&) { ++calls; });
+    auto c = service.submit(Cell{38, 38}, Cell{1, 1}); // coppia diversa
+    EXPECT_FALSE(a.coalesced());
+    EXPECT_TRUE(b.coalesced());
+    EXPECT_FALSE(c.coalesced());
+    EXPECT_EQ(service.stats().queueDepth, 2u);
+
+    gate.open();
+    EXPECT_EQ(&a.get(), &b.get()); // stesso risultato condiviso
+    c.get();
+    waitIdle(service);
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_EQ(service.stats().coalesced, 1u);
+}
+
+//3. cancel: la ricerca abbandonata da tutti viene saltata, senza callback;
+//   se un altro richiedente la condivide continua per lui
+TEST(PathService, Cancel_SkipsSearchOnlyWhenNobodyWaits) {
+    const auto g = std::make_shared<GridMap>(randomGrid(40, 40, 0.2, 4));
+    PathService service(g, 1);
+    WorkerGate gate;
+    auto blocker = gate.block(service);
+
+    std::atomic<int> calls{0};
+    auto lone = service.submit(Cell{0, 1}, Cell{39, 39}, [&](const PathResponse&) { ++calls; });
+    auto shared1 = service.submit(Cell{1, 0}, Cell{39, 38}, [&](const PathResponse&) { ++calls; });
+    auto shared2 = service.submit(Cell{1, 0}, Cell{39, 38}, [&](const PathResponse&) { ++calls; });
+    lone.cancel();
+    shared1.cancel();
+    lone.cancel(); // idempotente
+
+    gate.open();
+    EXPECT_EQ(lone.get().status, SearchStatus::Cancelled);
+    EXPECT_NE(shared2.get().status, SearchStatus::Cancelled);
+    EXPECT_EQ(shared1.get().status, shared2.get().status); // il future resta valido
+    waitIdle(service);
+    EXPECT_EQ(calls.load(), 1);                           // solo shared2
+    EXPECT_EQ(service.stats().cancelled, 1u);
+}
+
+//4. publish: le richieste nuove usano (e riportano) la nuova versione, senza agganciarsi alle vecchie
+TEST(PathService, Publish_NewVersionIsNotCoalescedWithOld) {
+    auto g = std::make_shared<GridMap>(20, 10);
+    PathService service(g, 1);
+    WorkerGate gate;
+    auto blocker = gate.block(service);
+
+    auto before = service.submit(Cell{0, 5}, Cell{19, 5});
+    auto wall = std::make_shared<GridMap>(*g);
+    for (int y = 0; y < 10; ++y) wall->setBlocked(Cell{10, y}, true);
+    const std::uint64_t v = service.publish(wall);
+    EXPECT_EQ(v, service.gridVersion());
+    auto after = service.submit(Cell{0, 5}, Cell{19, 5});
+    EXPECT_FALSE(after.coalesced());
+
+    gate.open();
+    EXPECT_EQ(after.get().status, SearchStatus::NoPath);
+    EXPECT_EQ(after.get().gridVersion, v);
+    // la richiesta vecchia era in coda: gira sul grid più recente e lo dichiara
+    EXPECT_EQ(before.get().gridVersion, v);
+}
+
+//5. stress: molti producer, richieste ripetute (coalescenza) e cancellazioni casuali.
+//   Ogni ticket riceve una risposta; chi non ha cancellato riceve la sua callback una volta sola
+//   e il costo giusto
+TEST(PathService, Stress_ManyProducers) {
+    const auto g = std::make_shared<GridMap>(randomGrid(64, 64, 0.25, 5));
+    PathService service(g, 4);
+
+    // poche coppie, così richieste identiche si sovrappongono spesso
+    std::mt19937 rng(6);
+    std::uniform_int_distribution<int> rc(0, 63);
+    std::vector<std::pair<Cell, Cell>> pairs;
+    std::vector<int> refCost;
+    for (int i = 0; i < 40; ++i) {
+        const Cell s{rc(rng), rc(rng)}, t{rc(rng), rc(rng)};
+        pairs.emplace_back(s, t);
+        const AStarResult ref = AStarPathfinder::findPath(*g, s, t);
+        refCost.push_back(ref.success ? ref.cost : -1);
+    }
+
+    constexpr int kProducers = 8;
+    constexpr int kPerProducer = 400;
+    struct Slot {
+        PathService::PathTicket ticket;
+        int pair{0};
+        bool cancelled{false};
+        std::atomic<int> calls{0};
+    };
+    std::vector<std::vector<Slot>> slots(kProducers);
+    for (auto& v : slots) v = std::vector<Slot>(kPerProducer);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            std::mt19937 r(100u + static_cast<unsigned>(p));
+            std::uniform_int_distribution<int> pick(0, static_cast<int>(pairs.size()) - 1);
+            std::bernoulli_distribution cancel(0.2);
+            for (int i = 0; i < kPerProducer; ++i) {
+                Slot& slot = slots[static_cast<size_t>(p)][static_cast<size_t>(i)];
+                slot.pair = pick(r);
+                const auto& q = pairs[static_cast<size_t>(slot.pair)];
+                slot.ticket = service.submit(q.first, q.second, [&slot](const PathResponse&) { ++slot.calls; });
+                if (cancel(r)) {
+                    slot.ticket.cancel();
+                    slot.cancelled = true;
+                }
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+
+    for (auto& v : slots) {
+        for (Slot& slot : v) {
+            const PathResponse& r = slot.ticket.get();
+            if (slot.cancelled) {
+                EXPECT_LE(slot.calls.load(), 1); // poteva essere già finita prima del cancel
+                continue;
+            }
+            ASSERT_NE(r.status, SearchStatus::Cancelled);
+            const int ref = refCost[static_cast<size_t>(slot.pair)];
+            EXPECT_EQ(r.status == SearchStatus::Found ? r.cost : -1, ref);
+        }
+    }
+
+    waitIdle(service);
+    for (auto& v : slots) {
+        for (Slot& slot : v) {
+            if (!slot.cancelled) {
+                EXPECT_EQ(slot.calls.load(), 1);
+            }
+        }
+    }
+
+    const PathServiceStats st = service.stats();
+    EXPECT_EQ(st.submitted, static_cast<std::uint64_t>(kProducers * kPerProducer));
+    EXPECT_EQ(st.completed + st.cancelled + st.coalesced, st.submitted);
+    EXPECT_EQ(st.queueDepth, 0u);
+}
@@ -0,0 +1,173 @@
+// tests/test_resumable.cpp
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ConnectivityIndex.h"
+#include "taikutsu/core/ResumableSearch.h"
+#include "TestHelpers.h"
+
+// ===================== helpers =====================
+
+static Cell randomFree(const GridMap& g, std::mt19937& rng) {
+    std::uniform_int_distribution<int> rx(0, g.width() - 1), ry(0, g.height() - 1);
+    for (;;) {
+        const Cell c{rx(rng), ry(rng)};
+        if (g.isWalkable(c)) return c;
+    }
+}
+
+// il closed set in ordine serve a confrontare le ricerche
+static SearchOptions recording() {
+    SearchOptions o;
+    o.recordClosed = ClosedRecording::List;
+    return o;
+}
+
+// esegue la query a fette di budget nodi, contando le chiamate
+static SearchStatus runSliced(ResumableSearch& search, size_t budget, int& calls) {
+    calls = 0;
+    while (search.running()) {
+        search.step(budget);
+        ++calls;
+    }
+    return search.status();
+}
+
+// ===================== tests =====================
+
+//1. a fette (qualsiasi budget) = ricerca in un colpo: stesso path, costo e closed nello stesso ordine
+TEST(ResumableSearch, Sliced_MatchesOneShotForAllOptions) {
+    std::vector<SearchOptions> variants;
+    for (int v = 0; v < 6; ++v) {
+        SearchOptions o = recording();
+        o.connectivity = v % 2 ? Connectivity::Eight : Connectivity::Four;
+        o.cornerCutting = v == 3;
+        o.openList = v < 2 ? OpenListKind::BinaryHeap : v < 4 ? OpenListKind::IndexedHeap : OpenListKind::Radix;
+        variants.push_back(o);
+    }
+
+    for (int map = 0; map < 4; ++map) {
+        const GridMap g = randomGrid(60, 45, 0.25, static_cast<unsigned>(map), map % 2 == 1);
+        std::mt19937 rng(100u + static_cast<unsigned>(map));
+        for (int q = 0; q < 10; ++q) {
+            const Cell s = randomFree(g, rng), t = randomFree(g, rng);
+            for (const SearchOptions& opts : variants) {
+                const AStarResult ref = AStarPathfinder::findPath(g, s, t, opts);
+                for (size_t budget : {size_t{1}, size_t{7}, size_t{1000}}) {
+                    ResumableSearch search;
+                    search.start(g, s, t, opts);
+                    int calls = 0;
+                    const SearchStatus st = runSliced(search, budget, calls);
+
+                    const AStarResult& r = search.result();
+                    ASSERT_EQ(st, ref.success ? SearchStatus::Found : SearchStatus::NoPath);
+                    EXPECT_EQ(r.success, ref.success);
+                    EXPECT_EQ(r.cost, ref.cost);
+                    EXPECT_EQ(r.path, ref.path);
+                    EXPECT_EQ(r.closed, ref.closed);
+                    EXPECT_EQ(search.expanded(), ref.closed.size());
+                    // ogni fetta (tranne l'ultima) consuma tutto il budget
+                    // (+1 se restano solo copie stale dopo l'ultima espansione)
+                    const size_t n = ref.closed.size();
+                    EXPECT_GE(static_cast<size_t>(calls), (n + budget - 1) / budget);
+                    EXPECT_LE(static_cast<size_t>(calls), n / budget + 1);
+                }
+            }
+        }
+    }
+}
+
+//2. il closed parziale cresce al massimo di budget per step ed è un prefisso di quello finale
+TEST(ResumableSearch, PartialResult_IsPrefixOfFinalExploration) {
+    const GridMap g = randomGrid(80, 60, 0.2, 7);
+    std::mt19937 rng(3);
+    const Cell a = randomFree(g, rng), b = randomFree(g, rng);
+    const AStarResult ref = AStarPathfinder::findPath(g, a, b, recording());
+    ASSERT_GT(ref.closed.size(), 20u);
+
+    ResumableSearch search;
+    search.start(g, a, b, recording());
+    EXPECT_EQ(search.status(), SearchStatus::Running);
+    size_t seen = 0;
+    while (search.running()) {
+        search.step(5);
+        const auto& closed = search.result().closed;
+        ASSERT_LE(closed.size(), seen + 5);
+        for (size_t i = seen; i < closed.size(); ++i) ASSERT_EQ(closed[i], ref.closed[i]);
+        seen = closed.size();
+        if (search.running()) {
+            EXPECT_TRUE(search.result().path.empty());
+        }
+    }
+    EXPECT_EQ(search.result().path, ref.path);
+}
+
+//3. cancel: si ferma, tiene le celle espanse, step() non riprende; start() riparte da zero
+TEST(ResumableSearch, Cancel_StopsAndRestartWorks) {
+    const GridMap g = randomGrid(100, 100, 0.1, 11);
+    std::mt19937 rng(5);
+    const Cell a = randomFree(g, rng), b = randomFree(g, rng);
+    const AStarResult ref = AStarPathfinder::findPath(g, a, b, recording());
+    ASSERT_GT(ref.closed.size(), 10u);
+
+    ResumableSearch search;
+    EXPECT_EQ(search.status(), SearchStatus::Idle);
+    search.start(g, a, b, recording());
+    search.step(10);
+    search.cancel();
+    EXPECT_EQ(search.status(), SearchStatus::Cancelled);
+    EXPECT_EQ(search.step(1000), SearchStatus::Cancelled);
+    EXPECT_EQ(search.result().closed.size(), 10u);
+    EXPECT_EQ(search.expanded(), 10u);
+    EXPECT_EQ(search.result().expanded, 10u);
+    EXPECT_FALSE(search.result().success);
+
+    search.start(g, a, b, recording());
+    int calls = 0;
+    runSliced(search, 64, calls);
+    EXPECT_EQ(search.result().path, ref.path);
+    EXPECT_EQ(search.result().closed, ref.closed);
+}
+
+//4. casi immediati: start = goal, start bloccato, componenti diverse (nessuna espansione)
+TEST(ResumableSearch, TrivialQueries_FinishInStart) {
+    GridMap g(10, 10);
+    for (int y = 0; y < 10; ++y) g.setBlocked(Cell{5, y}, true);
+    ConnectivityIndex components(g);
+    SearchOptions opts;
+    opts.components = &components;
+
+    ResumableSearch search;
+    search.start(g, Cell{1, 1}, Cell{1, 1}, opts);
+    EXPECT_EQ(search.status(), SearchStatus::Found);
+    EXPECT_EQ(search.result().path.size(), 1u);
+
+    search.start(g, Cell{5, 1}, Cell{1, 1}, opts);
+    EXPECT_EQ(search.status(), SearchStatus::NoPath);
+
+    search.start(g, Cell{1, 1}, Cell{8, 8}, opts);
+    EXPECT_EQ(search.status(), SearchStatus::NoPath);
+    EXPECT_EQ(search.expanded(), 0u);
+    EXPECT_TRUE(search.result().closed.empty());
+}
+
+//5. stepFor: rispetta il tetto di nodi e con budget di tempo arriva comunque in fondo
+TEST(ResumableSearch, StepFor_RespectsNodeCapAndCompletes) {
+    const GridMap g = randomGrid(200, 200, 0.2, 21);
+    std::mt19937 rng(9);
+    const Cell a = randomFree(g, rng), b = randomFree(g, rng);
+    const AStarResult ref = AStarPathfinder::findPath(g, a, b);
+
+    ResumableSearch search;
+    search.start(g, a, b);
+    if (ref.expanded > 300) {
+        search.stepFor(std::chrono::seconds(10), 300);
+        EXPECT_EQ(search.expanded(), 300u);
+        EXPECT_TRUE(search.running());
+    }
+    while (search.running()) search.stepFor(std::chrono::microseconds(200));
+    EXPECT_EQ(search.result().path, ref.path);
+    EXPECT_EQ(search.expanded(), ref.expanded);
+}
@@ -0,0 +1,172 @@
+// tests/test_searchstats.cpp
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "taikutsu/core/AStar.h"
+#include "taikutsu/core/ResumableSearch.h"
+#include "taikutsu/core/SearchStats.h"
+#include "TestHelpers.h"
+
+// ===================== tests =====================
+
+//0. con un recorder senza kProfile il cronometro non occupa spazio né legge il clock
+static_assert(std::is_empty_v<PhaseClock<false>>);
+static_assert(!NoRecorder::kProfile && !RecordClosed::kProfile && StatsRecorder<>::kProfile);
+
+//1. i contatori tornano con il risultato: espansi = closed, open finale = push - pop
+TEST(SearchStats, Recorder_CountsMatchSearch) {
+    GridMap g = randomGrid(120, 90, 0.25, 1);
+    g.fillRect(Cell{0, 0}, 3, 3, false);
+    g.fillRect(Cell{117, 87}, 3, 3, false);
+    AStarSearchContext ctx;
+    SearchStatsCollector collector;
+    StatsRecorder<> recorder(&collector);
+    using Finder = BasicAStar<Neighbors8, OctileHeuristic, UnitCost, TieBreakLargerG, StatsRecorder<>>;
+
+    const AStarResult& r = Finder::findPath(ctx, g, Cell{0, 0}, Cell{119, 89}, recorder);
+    const SearchStats& s = collector.last();
+    EXPECT_EQ(s.found, r.success);
+    EXPECT_EQ(s.expanded, r.closed.size()); // Inner = RecordClosed: il closed set c'è ancora
+    EXPECT_GE(s.pushes, s.expanded + s.stalePops);
+    EXPECT_GE(s.peakOpen, 1u);
+    EXPECT_LE(s.peakOpen, s.pushes);
+    EXPECT_GT(s.bytesAllocated, 0u); // contesto nuovo: nodi e heap allocati ora
+    EXPECT_GT(s.expandNs, 0u);
+    EXPECT_EQ(s.totalNs(), s.setupNs + s.expandNs + s.pathNs);
+
+    // stessa query, contesto già dimensionato: nessuna allocazione, stesse misure di lavoro
+    Finder::findPath(ctx, g, Cell{0, 0}, Cell{119, 89}, recorder);
+    EXPECT_EQ(collector.last().bytesAllocated, 0u);
+    EXPECT_EQ(collector.last().expanded, s.expanded);
+    EXPECT_EQ(collector.summary().queries, 2u);
+}
+
+//2. a runtime (SearchOptions::stats) il risultato non cambia e ogni query conclusa viene registrata
+TEST(SearchStats, RuntimeOption_RecordsEveryQuery) {
+    GridMap g = randomGrid(80, 60, 0.3, 2);
+    g.fillRect(Cell{0, 0}, 2, 2, false);
+    SearchStatsCollector collector;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> rx(0, 79), ry(0, 59);
+
+    for (const OpenListKind open : {OpenListKind::BinaryHeap, OpenListKind::IndexedHeap, OpenListKind::Radix}) {
+        collector.reset();
+        SearchOptions plain;
+        plain.openList = open;
+        plain.recordClosed = ClosedRecording::List;
+        SearchOptions measured = plain;
+        measured.stats = &collector;
+        AStarSearchContext a, b;
+
+        int found = 0;
+        for (int i = 0; i < 50; ++i) {
+            const Cell s{rx(rng), ry(rng)}, t{rx(rng), ry(rng)};
+            const AStarResult& ref = AStarPathfinder::findPath(a, g, s, t, plain);
+            const AStarResult& r = AStarPathfinder::findPath(b, g, s, t, measured);
+            ASSERT_EQ(r.success, ref.success);
+            EXPECT_EQ(r.path, ref.path);
+            EXPECT_EQ(r.closed, ref.closed);
+            found += r.success;
+            EXPECT_EQ(collector.last().expanded, r.closed.size());
+        }
+        const SearchStatsSummary sum = collector.summary();
+        EXPECT_EQ(sum.queries, 50u); // anche start/goal bloccati e NoPath
+        EXPECT_EQ(sum.found, static_cast<std::uint64_t>(found));
+        if (open == OpenListKind::IndexedHeap) {
+            EXPECT_EQ(sum.stalePops.max, 0u); // decrease-key in place
+        }
+    }
+}
+
+//3. ricerca a fette: una sola registrazione alla fine, tempi sommati sulle fette;
+//   una ricerca cancellata non viene registrata
+TEST(SearchStats, Resumable_RecordsOnceAtTheEnd) {
+    GridMap g = randomGrid(100, 100, 0.2, 4);
+    g.fillRect(Cell{0, 0}, 3, 3, false);
+    g.fillRect(Cell{97, 97}, 3, 3, false);
+    SearchStatsCollector collector;
+    SearchOptions opts;
+    opts.stats = &collector;
+
+    ResumableSearch search;
+    search.start(g, Cell{1, 1}, Cell{98, 98}, opts);
+    while (search.running()) {
+        search.step(50);
+        if (search.running()) {
+            EXPECT_EQ(collector.summary().queries, 0u);
+        }
+    }
+    ASSERT_EQ(collector.summary().queries, 1u);
+    ASSERT_EQ(search.status(), SearchStatus::Found);
+    EXPECT_EQ(collector.last().expanded, search.expanded());
+
+    search.start(g, Cell{1, 1}, Cell{98, 98}, opts);
+    search.step(10);
+    search.cancel();
+    EXPECT_EQ(collector.summary().queries, 1u);
+}
+
+//4. istogramma: ogni valore cade nel suo bucket, percentili entro l'errore dei bucket
+TEST(SearchStats, Histogram_BucketsAndPercentiles) {
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 10000; ++i) {
+        const std::uint64_t v = rng() >> (rng() % 64);
+        const int b = ValueHistogram::bucketOf(v);
+        ASSERT_LT(b, ValueHistogram::kBuckets);
+        ASSERT_LE(ValueHistogram::lowerBound(b), v);
+        ASSERT_GE(ValueHistogram::upperBound(b), v);
+    }
+    EXPECT_EQ(ValueHistogram::upperBound(ValueHistogram::kBuckets - 1), UINT64_MAX);
+
+    ValueHistogram h;
+    for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    EXPECT_EQ(h.count(), 1000u);
+    EXPECT_EQ(h.min(), 1u);
+    EXPECT_EQ(h.max(), 1000u);
+    EXPECT_DOUBLE_EQ(h.mean(), 500.5);
+    EXPECT_GE(h.percentile(0.5), 500u);
+    EXPECT_LE(h.percentile(0.5), 500u * 9 / 8);
+    EXPECT_EQ(h.percentile(1.0), 1000u);
+
+    // la versione atomica (latenze di PathService) dà gli stessi numeri, anche scritta da più thread
+    ConcurrentHistogram c;
+    std::vector<std::thread> writers;
+    for (std::uint64_t t = 0; t < 4; ++t)
+        writers.emplace_back([&c, t] {
+            for (std::uint64_t v = 1 + t; v <= 1000; v += 4) c.record(v);
+        });
+    for (std::thread& w : writers) w.join();
+    EXPECT_EQ(c.count(), h.count());
+    EXPECT_EQ(c.sum(), h.sum());
+    EXPECT_EQ(c.min(), 1u);
+    EXPECT_EQ(c.max(), 1000u);
+    for (const double p : {0.0, 0.5, 0.9, 0.99, 1.0}) EXPECT_EQ(c.percentile(p), h.percentile(p));
+    c.reset();
+    EXPECT_EQ(c.count(), 0u);
+    EXPECT_EQ(c.percentile(0.5), 0u);
+}
+
+//5. dump: testo con una riga per metrica, JSON con riassunti e bucket
+TEST(SearchStats, Dumps_ContainAllMetrics) {
+    const GridMap g = randomGrid(60, 60, 0.2, 6);
+    SearchStatsCollector collector;
+    SearchOptions opts;
+    opts.stats = &collector;
+    for (int i = 0; i < 10; ++i) AStarPathfinder::findPath(g, Cell{0, i}, Cell{59, 59 - i}, opts);
+
+    const std::string text = collector.toText();
+    const std::string json = collector.toJson();
+    EXPECT_EQ(text.rfind("queries 10", 0), 0u) << text;
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"queries\":10"), std::string::npos);
+    for (const char* m : {"expanded", "pushes", "stale_pops", "peak_open", "bytes_allocated", "setup_ns", "expand_ns",
+                          "path_ns", "total_ns"}) {
+        EXPECT_NE(text.find(m), std::string::npos) << m;
+        EXPECT_NE(json.find(std::string("\"") + m + "\":{\"count\":10"), std::string::npos) << m;
+    }
+    EXPECT_NE(json.find("\"buckets\":[["), std::string::npos);
+}